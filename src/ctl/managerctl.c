@@ -0,0 +1,259 @@
+/**
+ * ovpn-managerctl
+ *
+ * Command-line client for the ovpn-manager control socket. Sends one
+ * request, prints the answer and exits; "watch" keeps printing state
+ * changes until interrupted. Depends on libc and cJSON only.
+ */
+
+#include "../features/control_protocol.h"
+#include "cJSON.h"
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* Exit codes */
+#define EXIT_REQUEST_FAILED  1
+#define EXIT_USAGE           2
+#define EXIT_UNREACHABLE     3
+
+static void usage(FILE *out) {
+    fprintf(out,
+            "Usage: ovpn-managerctl [OPTIONS] COMMAND [NAME]\n"
+            "\n"
+            "Commands:\n"
+            "  list               Connections and their state\n"
+            "  stats              Connection latency statistics\n"
+            "  connect NAME       Start a connection\n"
+            "  disconnect NAME    Stop a connection\n"
+            "  watch              Print state changes as they happen\n"
+            "\n"
+            "Options:\n"
+            "  -j, --json         Print raw JSON lines\n"
+            "  -s, --socket PATH  Control socket (default: $XDG_RUNTIME_DIR/%s/%s)\n"
+            "  -h, --help         Show this help\n",
+            CONTROL_SOCKET_DIR, CONTROL_SOCKET_NAME);
+}
+
+/**
+ * Connect to the daemon
+ *
+ * @return Socket, or -1 with a message printed
+ */
+static int open_socket(const char *path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+    if (path) {
+        if (strlen(path) >= sizeof(addr.sun_path)) {
+            fprintf(stderr, "Socket path too long: %s\n", path);
+            return -1;
+        }
+        strcpy(addr.sun_path, path);
+    } else if (control_socket_path(addr.sun_path, sizeof(addr.sun_path)) < 0) {
+        fprintf(stderr, "Socket path too long\n");
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "Cannot reach ovpn-manager at %s: %s\n"
+                        "Is it running (ovpn-manager --headless)?\n",
+                addr.sun_path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Send a request line
+ */
+static bool send_request(int fd, const char *cmd, const char *name) {
+    cJSON *request = cJSON_CreateObject();
+    cJSON_AddStringToObject(request, "cmd", cmd);
+    if (name) {
+        cJSON_AddStringToObject(request, "name", name);
+    }
+
+    char *text = cJSON_PrintUnformatted(request);
+    cJSON_Delete(request);
+    if (!text) {
+        return false;
+    }
+
+    size_t len = strlen(text);
+    bool ok = send(fd, text, len, MSG_NOSIGNAL) == (ssize_t)len &&
+              send(fd, "\n", 1, MSG_NOSIGNAL) == 1;
+    cJSON_free(text);
+    return ok;
+}
+
+/**
+ * Read one line from the daemon
+ *
+ * @return Line (free with free), or NULL at end of stream
+ */
+static char* read_line(FILE *in) {
+    char *line = NULL;
+    size_t size = 0;
+
+    if (getline(&line, &size, in) < 0) {
+        free(line);
+        return NULL;
+    }
+    line[strcspn(line, "\r\n")] = '\0';
+    return line;
+}
+
+static const char* string_member(const cJSON *object, const char *name) {
+    const char *value = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(object, name));
+    return value ? value : "-";
+}
+
+static double number_member(const cJSON *object, const char *name) {
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(object, name);
+    return cJSON_IsNumber(item) ? item->valuedouble : 0.0;
+}
+
+/* ──── Output ──── */
+
+static void print_list(const cJSON *reply) {
+    const cJSON *item;
+
+    printf("%-28s %-14s %s\n", "NAME", "STATE", "SESSION");
+    cJSON_ArrayForEach(item, cJSON_GetObjectItemCaseSensitive(reply, "connections")) {
+        printf("%-28s %-14s %s\n", string_member(item, "name"),
+               string_member(item, "state"), string_member(item, "session"));
+    }
+}
+
+static void print_stats(const cJSON *reply) {
+    const cJSON *item;
+
+    printf("Uptime %.0f s, %.0f requests, %.0f clients\n\n",
+           number_member(reply, "uptime_s"), number_member(reply, "requests"),
+           number_member(reply, "clients"));
+
+    printf("%-28s %8s %8s %10s %10s %10s %10s\n",
+           "NAME", "CONNECTS", "FAILURES", "AVG ms", "P50 ms", "P95 ms", "LAST ms");
+    cJSON_ArrayForEach(item, cJSON_GetObjectItemCaseSensitive(reply, "connections")) {
+        const cJSON *last = cJSON_GetObjectItemCaseSensitive(item, "last");
+        printf("%-28s %8.0f %8.0f %10.0f %10.0f %10.0f %10.0f\n",
+               string_member(item, "name"),
+               number_member(item, "connects"), number_member(item, "failures"),
+               number_member(item, "connect_avg_ms"), number_member(item, "connect_p50_ms"),
+               number_member(item, "connect_p95_ms"),
+               last ? number_member(last, "total_ms") : 0.0);
+    }
+}
+
+static void print_event(const cJSON *event) {
+    time_t when = (time_t)number_member(event, "time");
+    struct tm tm;
+    char stamp[16] = "";
+
+    if (localtime_r(&when, &tm)) {
+        strftime(stamp, sizeof(stamp), "%H:%M:%S", &tm);
+    }
+    printf("%s %s: %s -> %s\n", stamp, string_member(event, "name"),
+           string_member(event, "old_state"), string_member(event, "state"));
+}
+
+/* ──── Main ──── */
+
+int main(int argc, char *argv[]) {
+    const char *socket_path = NULL;
+    bool json = false;
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--socket") == 0) &&
+                   i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return EXIT_SUCCESS;
+        } else {
+            usage(stderr);
+            return EXIT_USAGE;
+        }
+    }
+
+    if (i >= argc) {
+        usage(stderr);
+        return EXIT_USAGE;
+    }
+    const char *cmd = argv[i++];
+    const char *name = i < argc ? argv[i++] : NULL;
+
+    bool needs_name = strcmp(cmd, CONTROL_CMD_CONNECT) == 0 ||
+                      strcmp(cmd, CONTROL_CMD_DISCONNECT) == 0;
+    bool known = needs_name || strcmp(cmd, CONTROL_CMD_LIST) == 0 ||
+                 strcmp(cmd, CONTROL_CMD_STATS) == 0 || strcmp(cmd, CONTROL_CMD_WATCH) == 0;
+    if (!known || needs_name != (name != NULL) || i < argc) {
+        usage(stderr);
+        return EXIT_USAGE;
+    }
+
+    int fd = open_socket(socket_path);
+    if (fd < 0) {
+        return EXIT_UNREACHABLE;
+    }
+    FILE *in = fdopen(fd, "r");
+    if (!in || !send_request(fd, cmd, name)) {
+        fprintf(stderr, "Failed to send request: %s\n", strerror(errno));
+        return EXIT_UNREACHABLE;
+    }
+
+    char *line = read_line(in);
+    cJSON *reply = line ? cJSON_Parse(line) : NULL;
+    if (!reply) {
+        fprintf(stderr, "No valid answer from ovpn-manager\n");
+        free(line);
+        fclose(in);
+        return EXIT_UNREACHABLE;
+    }
+
+    int status = EXIT_SUCCESS;
+    if (!cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(reply, "ok"))) {
+        fprintf(stderr, "%s: %s\n", cmd, string_member(reply, "error"));
+        status = EXIT_REQUEST_FAILED;
+    } else if (json) {
+        printf("%s\n", line);
+    } else if (strcmp(cmd, CONTROL_CMD_LIST) == 0) {
+        print_list(reply);
+    } else if (strcmp(cmd, CONTROL_CMD_STATS) == 0) {
+        print_stats(reply);
+    } else if (strcmp(cmd, CONTROL_CMD_CONNECT) == 0) {
+        printf("Connecting %s (%s)\n", name, string_member(reply, "session"));
+    } else if (strcmp(cmd, CONTROL_CMD_DISCONNECT) == 0) {
+        printf("Disconnecting %s\n", name);
+    }
+    cJSON_Delete(reply);
+    free(line);
+
+    /* Events until the daemon goes away or we are interrupted */
+    if (status == EXIT_SUCCESS && strcmp(cmd, CONTROL_CMD_WATCH) == 0) {
+        setvbuf(stdout, NULL, _IOLBF, 0);
+        while ((line = read_line(in)) != NULL) {
+            cJSON *event = json ? NULL : cJSON_Parse(line);
+            if (json) {
+                printf("%s\n", line);
+            } else if (event) {
+                print_event(event);
+            }
+            cJSON_Delete(event);
+            free(line);
+        }
+    }
+
+    fclose(in);
+    return status;
+}
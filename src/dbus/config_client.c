@@ -1,9 +1,12 @@
 #include "config_client.h"
+#define LOG_CATEGORY LOG_CAT_DBUS
 #include "../utils/logger.h"
+#include "../storage/profile_cache.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <inttypes.h>
 
 #define OPENVPN3_SERVICE_CONFIG "net.openvpn.v3.configuration"
 #define OPENVPN3_INTERFACE_CONFIG "net.openvpn.v3.configuration"
@@ -22,6 +25,8 @@ void config_free(VpnConfig *config) {
     g_free(config->server_address);
     g_free(config->server_hostname);
     g_free(config->protocol);
+    g_free(config->pinned_host);
+    ovpn_profile_free(config->profile);
     g_free(config);
 }
 
@@ -108,6 +113,185 @@ static bool get_bool_property(sd_bus *bus, const char *path,
     return value != 0;
 }
 
+/**
+ * Get an unsigned 64-bit property from D-Bus object (0 if unavailable)
+ */
+static uint64_t get_uint64_property(sd_bus *bus, const char *path,
+                                    const char *interface, const char *property) {
+    sd_bus_error error = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = NULL;
+    uint64_t value = 0;
+    int r;
+
+    r = sd_bus_get_property(
+        bus,
+        OPENVPN3_SERVICE_CONFIG,
+        path,
+        interface,
+        property,
+        &error,
+        &reply,
+        "t"
+    );
+
+    if (r < 0) {
+        sd_bus_error_free(&error);
+        return 0;
+    }
+
+    if (sd_bus_message_read(reply, "t", &value) < 0) {
+        value = 0;
+    }
+    sd_bus_message_unref(reply);
+
+    return value;
+}
+
+/**
+ * Read the string value of one entry from an "overrides" a{sv} at the
+ * current position of a message, consuming the whole array
+ */
+static char* read_override(sd_bus_message *reply, const char *name) {
+    char *result = NULL;
+
+    int r = sd_bus_message_enter_container(reply, 'a', "{sv}");
+    if (r <= 0) {
+        return NULL;
+    }
+
+    while ((r = sd_bus_message_enter_container(reply, 'e', "sv")) > 0) {
+        const char *key = NULL;
+        const char *contents = NULL;
+
+        r = sd_bus_message_read(reply, "s", &key);
+        if (r >= 0 && !result && key && strcmp(key, name) == 0 &&
+            sd_bus_message_peek_type(reply, NULL, &contents) >= 0 &&
+            contents && strcmp(contents, "s") == 0) {
+            const char *value = NULL;
+            r = sd_bus_message_read(reply, "v", "s", &value);
+            if (r >= 0 && value && *value) {
+                result = g_strdup(value);
+            }
+        } else if (r >= 0) {
+            r = sd_bus_message_skip(reply, "v");
+        }
+
+        if (r < 0 || sd_bus_message_exit_container(reply) < 0) {
+            break;
+        }
+    }
+
+    sd_bus_message_exit_container(reply);
+    return result;
+}
+
+/**
+ * Get the string value of one entry of the "overrides" property
+ */
+static char* get_override(sd_bus *bus, const char *path, const char *name) {
+    sd_bus_error error = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = NULL;
+    int r;
+
+    r = sd_bus_get_property(
+        bus,
+        OPENVPN3_SERVICE_CONFIG,
+        path,
+        OPENVPN3_INTERFACE_CONFIG,
+        "overrides",
+        &error,
+        &reply,
+        "a{sv}"
+    );
+
+    if (r < 0) {
+        sd_bus_error_free(&error);
+        return NULL;
+    }
+
+    char *result = read_override(reply, name);
+    sd_bus_message_unref(reply);
+    return result;
+}
+
+/**
+ * Read the properties config_get_info needs with one GetAll call
+ *
+ * @param imported Output: import_timestamp, 0 if absent
+ * @return 0 on success, negative errno if GetAll failed
+ */
+static int get_config_properties(sd_bus *bus, const char *path,
+                                 VpnConfig *config, uint64_t *imported) {
+    sd_bus_error error = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = NULL;
+    int r;
+
+    r = sd_bus_call_method(
+        bus,
+        OPENVPN3_SERVICE_CONFIG,
+        path,
+        "org.freedesktop.DBus.Properties",
+        "GetAll",
+        &error,
+        &reply,
+        "s",
+        OPENVPN3_INTERFACE_CONFIG
+    );
+
+    if (r < 0) {
+        sd_bus_error_free(&error);
+        return r;
+    }
+
+    r = sd_bus_message_enter_container(reply, 'a', "{sv}");
+    while (r >= 0 && (r = sd_bus_message_enter_container(reply, 'e', "sv")) > 0) {
+        const char *key = NULL;
+        const char *contents = NULL;
+
+        r = sd_bus_message_read(reply, "s", &key);
+        if (r >= 0) {
+            r = sd_bus_message_peek_type(reply, NULL, &contents);
+        }
+        if (r < 0 || !key || !contents) {
+            break;
+        }
+
+        if (strcmp(key, "name") == 0 && strcmp(contents, "s") == 0) {
+            const char *value = NULL;
+            r = sd_bus_message_read(reply, "v", "s", &value);
+            if (r >= 0 && value && !config->config_name) {
+                config->config_name = g_strdup(value);
+            }
+        } else if (strcmp(key, "locked_down") == 0 && strcmp(contents, "b") == 0) {
+            int value = 0;
+            r = sd_bus_message_read(reply, "v", "b", &value);
+            config->locked_down = r >= 0 && value;
+        } else if (strcmp(key, "persistent") == 0 && strcmp(contents, "b") == 0) {
+            int value = 0;
+            r = sd_bus_message_read(reply, "v", "b", &value);
+            config->persistent = r >= 0 && value;
+        } else if (strcmp(key, "import_timestamp") == 0 && strcmp(contents, "t") == 0) {
+            r = sd_bus_message_read(reply, "v", "t", imported);
+        } else if (strcmp(key, "overrides") == 0 && strcmp(contents, "a{sv}") == 0) {
+            r = sd_bus_message_enter_container(reply, 'v', "a{sv}");
+            if (r >= 0) {
+                g_free(config->pinned_host);
+                config->pinned_host = read_override(reply, "server-override");
+                r = sd_bus_message_exit_container(reply);
+            }
+        } else {
+            r = sd_bus_message_skip(reply, "v");
+        }
+
+        if (r >= 0) {
+            r = sd_bus_message_exit_container(reply);
+        }
+    }
+
+    sd_bus_message_unref(reply);
+    return 0;
+}
+
 /**
  * Fetch configuration content from D-Bus
  */
@@ -144,98 +328,33 @@ static char* fetch_config_content(sd_bus *bus, const char *config_path) {
 }
 
 /**
- * Parse server details from OpenVPN config content
- * Looks for: remote <hostname> <port> [protocol]
+ * Take a parsed profile and extract server details
+ *
+ * Every remote endpoint is kept (see ovpn_profile_parse for how port and
+ * proto defaults apply); the first one is mirrored into server_* fields.
  */
-static void parse_server_details(const char *config_content, VpnConfig *config) {
-    if (!config_content || !config) {
-        return;
-    }
-
+static void set_server_details(VpnConfig *config, OvpnProfile *profile) {
     /* Initialize to NULL/default values */
     config->server_address = NULL;
     config->server_hostname = NULL;
     config->server_port = 1194;  /* Default OpenVPN port */
     config->protocol = NULL;
 
-    /* Split config into lines */
-    char **lines = g_strsplit(config_content, "\n", -1);
-    if (!lines) {
-        return;
-    }
-
-    /* Look for "remote" directive */
-    for (int i = 0; lines[i] != NULL; i++) {
-        char *line = g_strstrip(lines[i]);
-
-        /* Skip comments and empty lines */
-        if (line[0] == '#' || line[0] == ';' || line[0] == '\0') {
-            continue;
-        }
+    config->profile = profile;
+    config->remotes = config->profile->remotes;
+    config->remote_count = config->profile->remote_count;
+    config->remote_random = config->profile->remote_random;
 
-        /* Check if line starts with "remote" */
-        if (g_str_has_prefix(line, "remote ")) {
-            /* Parse: remote <hostname> <port> [protocol] */
-            char **parts = g_strsplit_set(line, " \t", -1);
-            int part_count = 0;
-
-            /* Count non-empty parts */
-            for (int j = 0; parts[j] != NULL; j++) {
-                if (strlen(g_strstrip(parts[j])) > 0) {
-                    part_count++;
-                }
-            }
+    if (config->remote_count > 0) {
+        const VpnRemote *first = &config->remotes[0];
 
-            /* We need at least: remote hostname port */
-            if (part_count >= 3) {
-                int part_idx = 0;
-                char *hostname = NULL;
-                char *port_str = NULL;
-                char *protocol = NULL;
-
-                /* Extract non-empty parts */
-                for (int j = 0; parts[j] != NULL && part_idx < 4; j++) {
-                    char *part = g_strstrip(parts[j]);
-                    if (strlen(part) == 0) continue;
-
-                    if (part_idx == 0) {
-                        /* "remote" keyword - skip */
-                    } else if (part_idx == 1) {
-                        hostname = part;
-                    } else if (part_idx == 2) {
-                        port_str = part;
-                    } else if (part_idx == 3) {
-                        protocol = part;
-                    }
-                    part_idx++;
-                }
-
-                /* Store results */
-                if (hostname && port_str) {
-                    config->server_hostname = g_strdup(hostname);
-                    config->server_port = atoi(port_str);
-
-                    /* Build server_address as "hostname:port" */
-                    config->server_address = g_strdup_printf("%s:%d",
-                                                             hostname,
-                                                             config->server_port);
-
-                    if (protocol) {
-                        config->protocol = g_strdup(protocol);
-                    } else {
-                        config->protocol = g_strdup("udp");  /* Default */
-                    }
-
-                    g_strfreev(parts);
-                    break;  /* Use first remote directive found */
-                }
-            }
+        config->server_hostname = g_strdup(first->host);
+        config->server_port = first->port;
+        config->protocol = g_strdup(first->protocol);
 
-            g_strfreev(parts);
-        }
+        /* Build server_address as "hostname:port" */
+        config->server_address = g_strdup_printf("%s:%d", first->host, first->port);
     }
-
-    g_strfreev(lines);
 }
 
 /**
@@ -256,24 +375,59 @@ VpnConfig* config_get_info(sd_bus *bus, const char *config_path) {
     /* Store config path */
     config->config_path = g_strdup(config_path);
 
-    /* Get properties */
-    config->config_name = get_string_property(
-        bus, config_path, OPENVPN3_INTERFACE_CONFIG, "name"
-    );
+    /*
+     * Get properties in one round trip; fall back to one call per
+     * property if the service does not implement GetAll
+     */
+    uint64_t imported = 0;
+    if (get_config_properties(bus, config_path, config, &imported) < 0) {
+        config->config_name = get_string_property(
+            bus, config_path, OPENVPN3_INTERFACE_CONFIG, "name"
+        );
 
-    config->locked_down = get_bool_property(
-        bus, config_path, OPENVPN3_INTERFACE_CONFIG, "locked_down"
-    );
+        config->locked_down = get_bool_property(
+            bus, config_path, OPENVPN3_INTERFACE_CONFIG, "locked_down"
+        );
 
-    config->persistent = get_bool_property(
-        bus, config_path, OPENVPN3_INTERFACE_CONFIG, "persistent"
-    );
+        config->persistent = get_bool_property(
+            bus, config_path, OPENVPN3_INTERFACE_CONFIG, "persistent"
+        );
 
-    /* Fetch config content and extract server details */
-    char *config_content = fetch_config_content(bus, config_path);
-    if (config_content) {
-        parse_server_details(config_content, config);
-        g_free(config_content);
+        config->pinned_host = get_override(bus, config_path, "server-override");
+
+        imported = get_uint64_property(
+            bus, config_path, OPENVPN3_INTERFACE_CONFIG, "import_timestamp"
+        );
+    }
+
+    /*
+     * Profile content cannot change after import, so the path and import
+     * time identify it; a cached parse saves the Fetch round trip.
+     */
+    char *source = imported > 0 ?
+        g_strdup_printf("%s@%" PRIu64, config_path, imported) : NULL;
+
+    OvpnProfile *profile = profile_cache_lookup(source, &config->content_hash);
+    if (!profile) {
+        /* Fetch config content and parse it */
+        char *config_content = fetch_config_content(bus, config_path);
+        if (config_content) {
+            gint64 start = g_get_monotonic_time();
+            profile = profile_cache_parse(config_content, strlen(config_content),
+                                          source, &config->content_hash);
+
+            if (logger_verbose(2)) {
+                logger_debug("Parsed profile %s in %.3f ms (%u remotes, %u inline blocks)",
+                             config_path, (g_get_monotonic_time() - start) / 1000.0,
+                             profile->remote_count, profile->inline_blocks);
+            }
+            g_free(config_content);
+        }
+    }
+    g_free(source);
+
+    if (profile) {
+        set_server_details(config, profile);
     }
 
     return config;
@@ -334,6 +488,83 @@ int config_import(sd_bus *bus, const char *name, const char *config_content,
     return 0;
 }
 
+/**
+ * Pending asynchronous import
+ */
+typedef struct {
+    char *name;
+    ConfigImportCallback callback;
+    void *user_data;
+} ImportCall;
+
+/**
+ * Reply to an asynchronous Import call
+ */
+static int on_import_reply(sd_bus_message *reply, void *userdata, sd_bus_error *ret_error) {
+    ImportCall *call = (ImportCall *)userdata;
+    const sd_bus_error *error = sd_bus_message_get_error(reply);
+    const char *path = NULL;
+    (void)ret_error;
+
+    if (error) {
+        int r = sd_bus_message_get_errno(reply);
+        logger_error("Failed to import config '%s': %s", call->name,
+                     error->message ? error->message : strerror(r));
+        call->callback(NULL, r > 0 ? -r : -EIO, error->message, call->user_data);
+    } else if (sd_bus_message_read(reply, "o", &path) < 0 || !path) {
+        logger_error("Failed to read import reply for '%s'", call->name);
+        call->callback(NULL, -EIO, NULL, call->user_data);
+    } else {
+        logger_info("Imported config '%s' -> %s", call->name, path);
+        call->callback(path, 0, NULL, call->user_data);
+    }
+
+    g_free(call->name);
+    g_free(call);
+    return 0;
+}
+
+/**
+ * Import an OVPN configuration without waiting for the reply
+ */
+int config_import_async(sd_bus *bus, const char *name, const char *config_content,
+                        bool single_use, bool persistent,
+                        ConfigImportCallback callback, void *user_data) {
+    if (!bus || !name || !config_content || !callback) {
+        return -EINVAL;
+    }
+
+    ImportCall *call = g_malloc0(sizeof(ImportCall));
+    call->name = g_strdup(name);
+    call->callback = callback;
+    call->user_data = user_data;
+
+    int r = sd_bus_call_method_async(
+        bus,
+        NULL,
+        OPENVPN3_SERVICE_CONFIG,
+        OPENVPN3_ROOT_PATH,
+        OPENVPN3_INTERFACE_CONFIG,
+        "Import",
+        on_import_reply,
+        call,
+        "ssbb",
+        name,
+        config_content,
+        single_use ? 1 : 0,
+        persistent ? 1 : 0
+    );
+
+    if (r < 0) {
+        logger_error("Failed to send import for '%s': %s", name, strerror(-r));
+        g_free(call->name);
+        g_free(call);
+        return r;
+    }
+
+    return 0;
+}
+
 /**
  * List all available VPN configurations
  */
@@ -460,3 +691,125 @@ int config_delete(sd_bus *bus, const char *config_path) {
 
     return 0;
 }
+
+/**
+ * Set a single string override on a configuration
+ */
+static int set_override(sd_bus *bus, const char *config_path,
+                        const char *name, const char *value) {
+    sd_bus_error error = SD_BUS_ERROR_NULL;
+
+    int r = sd_bus_call_method(
+        bus,
+        OPENVPN3_SERVICE_CONFIG,
+        config_path,
+        OPENVPN3_INTERFACE_CONFIG,
+        "SetOverride",
+        &error,
+        NULL,
+        "sv",
+        name,
+        "s", value
+    );
+
+    if (r < 0) {
+        logger_error("Failed to set %s on %s: %s", name, config_path,
+                error.message ? error.message : strerror(-r));
+        sd_bus_error_free(&error);
+    }
+
+    return r;
+}
+
+/**
+ * Pin a configuration to one remote endpoint
+ */
+int config_pin_remote(sd_bus *bus, const char *config_path, const VpnRemote *remote) {
+    if (!bus || !config_path || !remote || !remote->host) {
+        return -EINVAL;
+    }
+
+    char port[16];
+    snprintf(port, sizeof(port), "%d", remote->port);
+
+    int r = set_override(bus, config_path, "server-override", remote->host);
+    if (r >= 0) {
+        r = set_override(bus, config_path, "port-override", port);
+    }
+    if (r >= 0 && remote->protocol) {
+        /* proto-override only knows the bare transport names */
+        r = set_override(bus, config_path, "proto-override",
+                         g_ascii_strncasecmp(remote->protocol, "tcp", 3) == 0 ? "tcp" : "udp");
+    }
+
+    if (r >= 0) {
+        logger_info("Pinned %s to remote %s:%d", config_path, remote->host, remote->port);
+    }
+
+    return r < 0 ? r : 0;
+}
+
+/**
+ * Remove a remote pin set by config_pin_remote
+ */
+int config_unpin_remote(sd_bus *bus, const char *config_path) {
+    static const char *const overrides[] = {
+        "server-override", "port-override", "proto-override"
+    };
+
+    if (!bus || !config_path) {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < G_N_ELEMENTS(overrides); i++) {
+        sd_bus_error error = SD_BUS_ERROR_NULL;
+
+        int r = sd_bus_call_method(
+            bus,
+            OPENVPN3_SERVICE_CONFIG,
+            config_path,
+            OPENVPN3_INTERFACE_CONFIG,
+            "UnsetOverride",
+            &error,
+            NULL,
+            "s",
+            overrides[i]
+        );
+
+        /* Fails when the override was never set, which is fine */
+        if (r < 0 && logger_verbose(1)) {
+            logger_debug("UnsetOverride %s on %s: %s", overrides[i], config_path,
+                         error.message ? error.message : strerror(-r));
+        }
+        sd_bus_error_free(&error);
+    }
+
+    return 0;
+}
+
+/**
+ * Get the host a configuration is pinned to
+ */
+char* config_get_pinned_host(sd_bus *bus, const char *config_path) {
+    if (!bus || !config_path) {
+        return NULL;
+    }
+
+    return get_override(bus, config_path, "server-override");
+}
+
+/**
+ * Remove a remote pin if one is set
+ */
+int config_clear_pin(sd_bus *bus, const char *config_path) {
+    char *host = config_get_pinned_host(bus, config_path);
+    if (!host) {
+        return 0;
+    }
+
+    logger_info("Clearing pin of %s to %s", config_path, host);
+    g_free(host);
+
+    int r = config_unpin_remote(bus, config_path);
+    return r < 0 ? r : 1;
+}
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <glib.h>
+#include "../utils/ovpn_profile.h"
 
 /**
  * Config Client
@@ -12,6 +13,9 @@
  * Manages OpenVPN3 configuration profiles via D-Bus
  */
 
+/* One "remote" endpoint of a profile */
+typedef OvpnRemote VpnRemote;
+
 /* VPN configuration information */
 typedef struct {
     char *config_path;       /* D-Bus object path */
@@ -22,6 +26,12 @@ typedef struct {
     char *server_hostname;   /* Server hostname only */
     int server_port;         /* Server port number */
     char *protocol;          /* Protocol (udp/tcp) */
+    VpnRemote *remotes;      /* All remote endpoints, in profile order (owned by profile) */
+    unsigned int remote_count; /* Number of remotes (server_* mirror the first) */
+    bool remote_random;      /* Profile has remote-random */
+    OvpnProfile *profile;    /* Parsed profile, NULL if content was unavailable */
+    uint64_t content_hash;   /* profile_cache_content_hash of the profile (0 if unavailable) */
+    char *pinned_host;       /* server-override set on the config, NULL if not pinned */
 } VpnConfig;
 
 /**
@@ -38,6 +48,35 @@ typedef struct {
 int config_import(sd_bus *bus, const char *name, const char *config_content,
                   bool single_use, bool persistent, char **config_path);
 
+/**
+ * Completion callback for config_import_async
+ *
+ * @param config_path D-Bus object path of the imported config, NULL on error
+ * @param result 0 on success, negative errno on error
+ * @param error_message D-Bus error message on error, otherwise NULL
+ * @param user_data Data passed to config_import_async
+ */
+typedef void (*ConfigImportCallback)(const char *config_path, int result,
+                                     const char *error_message, void *user_data);
+
+/**
+ * Import an OVPN configuration without waiting for the reply
+ *
+ * The callback runs from D-Bus processing on the main loop.
+ *
+ * @param bus D-Bus connection
+ * @param name Configuration name
+ * @param config_content OVPN file contents
+ * @param single_use Whether config should be single-use
+ * @param persistent Whether config should persist across reboots
+ * @param callback Completion callback
+ * @param user_data Data passed to callback
+ * @return 0 if the call was sent, negative on error (callback not called)
+ */
+int config_import_async(sd_bus *bus, const char *name, const char *config_content,
+                        bool single_use, bool persistent,
+                        ConfigImportCallback callback, void *user_data);
+
 /**
  * List all available VPN configurations
  *
@@ -51,6 +90,10 @@ int config_list(sd_bus *bus, VpnConfig ***configs, unsigned int *count);
 /**
  * Get detailed configuration information
  *
+ * Properties, including the pin and import time, come from one
+ * Properties.GetAll call; the profile is fetched only if it is not in
+ * the profile cache.
+ *
  * @param bus D-Bus connection
  * @param config_path D-Bus object path of configuration
  * @return VpnConfig structure on success, NULL on failure
@@ -66,6 +109,52 @@ VpnConfig* config_get_info(sd_bus *bus, const char *config_path);
  */
 int config_delete(sd_bus *bus, const char *config_path);
 
+/**
+ * Pin a configuration to one remote endpoint
+ *
+ * Sets the server/port/proto overrides on the configuration so the next
+ * session connects to this remote first.
+ *
+ * @param bus D-Bus connection
+ * @param config_path D-Bus object path of configuration
+ * @param remote Remote to pin
+ * @return 0 on success, negative on error
+ */
+int config_pin_remote(sd_bus *bus, const char *config_path, const VpnRemote *remote);
+
+/**
+ * Remove a remote pin set by config_pin_remote
+ *
+ * @param bus D-Bus connection
+ * @param config_path D-Bus object path of configuration
+ * @return 0 on success, negative on error
+ */
+int config_unpin_remote(sd_bus *bus, const char *config_path);
+
+/**
+ * Get the host a configuration is pinned to
+ *
+ * Reads the server-override from the configuration's overrides, so pins
+ * placed by an earlier run or another client are seen too.
+ *
+ * @param bus D-Bus connection
+ * @param config_path D-Bus object path of configuration
+ * @return Pinned host (caller frees), or NULL if not pinned
+ */
+char* config_get_pinned_host(sd_bus *bus, const char *config_path);
+
+/**
+ * Remove a remote pin if one is set
+ *
+ * Called before a user-initiated connect that does not choose a remote,
+ * so the profile's own remote order applies again.
+ *
+ * @param bus D-Bus connection
+ * @param config_path D-Bus object path of configuration
+ * @return 1 if a pin was removed, 0 if none was set, negative on error
+ */
+int config_clear_pin(sd_bus *bus, const char *config_path);
+
 /**
  * Free a VPN configuration structure
  *
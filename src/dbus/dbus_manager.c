@@ -1,38 +1,96 @@
 #include "dbus_manager.h"
+#define LOG_CATEGORY LOG_CAT_DBUS
 #include "../utils/logger.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <poll.h>
 
 /* OpenVPN3 D-Bus service names */
 #define OPENVPN3_SERVICE_CONFIG "net.openvpn.v3.configuration"
 #define OPENVPN3_SERVICE_SESSIONS "net.openvpn.v3.sessions"
 #define OPENVPN3_SERVICE_BACKENDS "net.openvpn.v3.backends"
 
+/* GLib source driving the sd-bus connection from the main context */
+typedef struct {
+    GSource source;
+    sd_bus *bus;
+    gpointer fd_tag;
+} BusSource;
+
 /**
- * GLib I/O watch callback for D-Bus file descriptor
+ * Milliseconds until sd-bus wants to be processed (-1 = no deadline)
+ *
+ * sd-bus reports a zero timeout while replies already read by a
+ * synchronous call are waiting in its queue, so those are dispatched
+ * without waiting for more input on the socket.
  */
-static gboolean dbus_io_callback(GIOChannel *source, GIOCondition condition, gpointer data) {
-    DbusManager *manager = (DbusManager *)data;
-    int r;
+static gint bus_source_timeout(sd_bus *bus) {
+    uint64_t until = UINT64_MAX;
+    if (sd_bus_get_timeout(bus, &until) < 0 || until == UINT64_MAX) {
+        return -1;
+    }
 
-    if (!manager || !manager->bus) {
-        return FALSE;
+    uint64_t now = (uint64_t)g_get_monotonic_time();
+    if (until <= now) {
+        return 0;
     }
+    return (gint)MIN((until - now + 999) / 1000, (uint64_t)G_MAXINT);
+}
+
+static gboolean bus_source_prepare(GSource *source, gint *timeout) {
+    BusSource *bs = (BusSource *)source;
+
+    /* Poll for what sd-bus is waiting on (POLLOUT while writes are queued) */
+    int events = sd_bus_get_events(bs->bus);
+    GIOCondition condition = G_IO_HUP | G_IO_ERR;
+    if (events > 0) {
+        if (events & POLLIN) condition |= G_IO_IN;
+        if (events & POLLOUT) condition |= G_IO_OUT;
+    }
+    g_source_modify_unix_fd(source, bs->fd_tag, condition);
+
+    *timeout = bus_source_timeout(bs->bus);
+    return *timeout == 0;
+}
+
+static gboolean bus_source_check(GSource *source) {
+    BusSource *bs = (BusSource *)source;
+
+    if (g_source_query_unix_fd(source, bs->fd_tag) != 0) {
+        return TRUE;
+    }
+    return bus_source_timeout(bs->bus) == 0;
+}
+
+static gboolean bus_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    BusSource *bs = (BusSource *)source;
+    int r;
+    (void)callback;
+    (void)user_data;
 
     /* Process D-Bus events */
     do {
-        r = sd_bus_process(manager->bus, NULL);
+        r = sd_bus_process(bs->bus, NULL);
         if (r < 0) {
             logger_error("Failed to process D-Bus: %s", strerror(-r));
-            return FALSE;
+            return G_SOURCE_REMOVE;
         }
     } while (r > 0);
 
-    return TRUE;
+    return G_SOURCE_CONTINUE;
 }
 
+static GSourceFuncs bus_source_funcs = {
+    bus_source_prepare,
+    bus_source_check,
+    bus_source_dispatch,
+    NULL,
+    NULL,
+    NULL,
+};
+
 /**
  * Initialize D-Bus manager and connect to system bus
  */
@@ -65,22 +123,13 @@ DbusManager* dbus_manager_init(void) {
         return NULL;
     }
 
-    /* Create GLib I/O channel from the D-Bus fd */
-    manager->bus_channel = g_io_channel_unix_new(fd);
-    if (!manager->bus_channel) {
-        logger_error("Failed to create GLib I/O channel");
-        sd_bus_unref(manager->bus);
-        g_free(manager);
-        return NULL;
-    }
-
-    /* Add watch for D-Bus events */
-    manager->bus_watch_id = g_io_add_watch(
-        manager->bus_channel,
-        G_IO_IN | G_IO_HUP | G_IO_ERR,
-        dbus_io_callback,
-        manager
-    );
+    /* Attach the bus to the default main context */
+    BusSource *bs = (BusSource *)g_source_new(&bus_source_funcs, sizeof(BusSource));
+    bs->bus = manager->bus;
+    bs->fd_tag = g_source_add_unix_fd((GSource *)bs, fd, G_IO_IN | G_IO_HUP | G_IO_ERR);
+    g_source_set_name((GSource *)bs, "sd-bus");
+    g_source_attach((GSource *)bs, NULL);
+    manager->bus_source = (GSource *)bs;
 
     manager->connected = true;
 
@@ -175,16 +224,11 @@ void dbus_manager_cleanup(DbusManager *manager) {
         return;
     }
 
-    /* Remove GLib watch */
-    if (manager->bus_watch_id > 0) {
-        g_source_remove(manager->bus_watch_id);
-        manager->bus_watch_id = 0;
-    }
-
-    /* Unref GLib I/O channel */
-    if (manager->bus_channel) {
-        g_io_channel_unref(manager->bus_channel);
-        manager->bus_channel = NULL;
+    /* Detach from the main context */
+    if (manager->bus_source) {
+        g_source_destroy(manager->bus_source);
+        g_source_unref(manager->bus_source);
+        manager->bus_source = NULL;
     }
 
     /* Close D-Bus connection */
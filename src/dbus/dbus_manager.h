@@ -14,8 +14,7 @@
 
 typedef struct {
     sd_bus *bus;
-    GIOChannel *bus_channel;
-    guint bus_watch_id;
+    GSource *bus_source;   /* Dispatches the bus from the main context */
     bool connected;
 } DbusManager;
 
@@ -1,7 +1,9 @@
 #include "session_client.h"
 #include "config_client.h"
 #include "signal_handlers.h"
+#define LOG_CATEGORY LOG_CAT_DBUS
 #include "../utils/logger.h"
+#include "../utils/connection_fsm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +45,29 @@ void session_list_free(VpnSession **sessions, unsigned int count) {
     g_free(sessions);
 }
 
+/**
+ * Map a session state to a connection state
+ */
+ConnectionState session_connection_state(SessionState state) {
+    switch (state) {
+        case SESSION_STATE_CONNECTING:
+            return CONN_STATE_CONNECTING;
+        case SESSION_STATE_CONNECTED:
+            return CONN_STATE_CONNECTED;
+        case SESSION_STATE_PAUSED:
+            return CONN_STATE_PAUSED;
+        case SESSION_STATE_AUTH_REQUIRED:
+            return CONN_STATE_AUTH_REQUIRED;
+        case SESSION_STATE_ERROR:
+            return CONN_STATE_ERROR;
+        case SESSION_STATE_RECONNECTING:
+            return CONN_STATE_RECONNECTING;
+        case SESSION_STATE_DISCONNECTED:
+        default:
+            return CONN_STATE_DISCONNECTED;
+    }
+}
+
 /**
  * Get a string property from D-Bus object
  */
@@ -277,7 +302,7 @@ VpnSession* session_get_info(sd_bus *bus, const char *session_path) {
     int auth_check = session_get_auth_url(bus, session_path, &auth_url);
     bool needs_auth = (auth_check == 0);
 
-    if (logger_get_verbosity() >= 1) {
+    if (logger_verbose(1)) {
         logger_debug("Session %s", session->config_name ? session->config_name : "unknown");
         logger_debug("  Status message: '%s'", session->status_message ? session->status_message : "(null)");
         logger_debug("  Auth check result: %d (0=has auth, negative=no auth)", auth_check);
@@ -314,19 +339,19 @@ VpnSession* session_get_info(sd_bus *bus, const char *session_path) {
 
     if (needs_auth) {
         /* Session is waiting for authentication */
-        if (logger_get_verbosity() >= 1) {
+        if (logger_verbose(1)) {
             logger_debug("  -> Setting state: AUTH_REQUIRED");
         }
         session->state = SESSION_STATE_AUTH_REQUIRED;
     } else if (is_paused) {
         /* PAUSED — must be before connected check */
-        if (logger_get_verbosity() >= 1) {
+        if (logger_verbose(1)) {
             logger_debug("  -> Setting state: PAUSED (major=%u, msg='%s')",
                          major, session->status_message ? session->status_message : "");
         }
         session->state = SESSION_STATE_PAUSED;
     } else if (connected) {
-        if (logger_get_verbosity() >= 1) {
+        if (logger_verbose(1)) {
             logger_debug("  -> Setting state: CONNECTED");
         }
         /* Session has active connection */
@@ -336,13 +361,13 @@ VpnSession* session_get_info(sd_bus *bus, const char *session_path) {
                 strstr(session->status_message, "Failed") ||
                 strstr(session->status_message, "Error"))) {
         /* Check for failure/error messages FIRST, before status codes */
-        if (logger_get_verbosity() >= 1) {
+        if (logger_verbose(1)) {
             logger_debug("  -> Setting state: ERROR (failed/error in message)");
         }
         session->state = SESSION_STATE_ERROR;
     } else if (major == 2) {
         /* CONNECTING status */
-        if (logger_get_verbosity() >= 1) {
+        if (logger_verbose(1)) {
             logger_debug("  -> Setting state: CONNECTING (major=2)");
         }
         session->state = SESSION_STATE_CONNECTING;
@@ -351,33 +376,33 @@ VpnSession* session_get_info(sd_bus *bus, const char *session_path) {
         if (strstr(session->status_message, "authentication required") ||
             strstr(session->status_message, "Web authentication") ||
             strstr(session->status_message, "https://")) {
-            if (logger_get_verbosity() >= 1) {
+            if (logger_verbose(1)) {
                 logger_debug("  -> Setting state: AUTH_REQUIRED (from message)");
             }
             session->state = SESSION_STATE_AUTH_REQUIRED;
         } else if (strstr(session->status_message, "Connecting")) {
-            if (logger_get_verbosity() >= 1) {
+            if (logger_verbose(1)) {
                 logger_debug("  -> Setting state: CONNECTING (from message)");
             }
             session->state = SESSION_STATE_CONNECTING;
         } else if (strstr(session->status_message, "Reconnecting")) {
-            if (logger_get_verbosity() >= 1) {
+            if (logger_verbose(1)) {
                 logger_debug("  -> Setting state: RECONNECTING (from message)");
             }
             session->state = SESSION_STATE_RECONNECTING;
         } else if (strstr(session->status_message, "Paused")) {
-            if (logger_get_verbosity() >= 1) {
+            if (logger_verbose(1)) {
                 logger_debug("  -> Setting state: PAUSED (from message)");
             }
             session->state = SESSION_STATE_PAUSED;
         } else {
-            if (logger_get_verbosity() >= 1) {
+            if (logger_verbose(1)) {
                 logger_debug("  -> Setting state: DISCONNECTED (default from message)");
             }
             session->state = SESSION_STATE_DISCONNECTED;
         }
     } else {
-        if (logger_get_verbosity() >= 1) {
+        if (logger_verbose(1)) {
             logger_debug("  -> Setting state: DISCONNECTED (no message)");
         }
         session->state = SESSION_STATE_DISCONNECTED;
@@ -471,6 +496,7 @@ int session_disconnect(sd_bus *bus, const char *session_path) {
         return -EINVAL;
     }
 
+    gint64 start = g_get_monotonic_time();
     r = sd_bus_call_method(
         bus,
         OPENVPN3_SERVICE_SESSIONS,
@@ -483,12 +509,25 @@ int session_disconnect(sd_bus *bus, const char *session_path) {
     );
 
     if (r < 0) {
-        logger_error("Failed to disconnect session: %s",
+        logger_log_fields(LOG_LEVEL_ERROR,
+                LOG_FIELDS(.session_path = session_path, .dbus_method = "Disconnect",
+                           .latency_us = g_get_monotonic_time() - start),
+                "Failed to disconnect session: %s",
                 error.message ? error.message : strerror(-r));
         sd_bus_error_free(&error);
         return r;
     }
 
+    logger_log_fields(LOG_LEVEL_INFO,
+            LOG_FIELDS(.session_path = session_path, .dbus_method = "Disconnect",
+                       .latency_us = g_get_monotonic_time() - start),
+            "Disconnected session: %s", session_path);
+
+    ConnectionFsm *fsm = connection_fsm_find_session(session_path);
+    if (fsm) {
+        connection_fsm_process_event(fsm, FSM_EVENT_DISCONNECT_REQUESTED);
+    }
+
     return 0;
 }
 
@@ -557,6 +596,46 @@ int session_resume(sd_bus *bus, const char *session_path) {
     return 0;
 }
 
+/**
+ * Restart the tunnel of an existing session
+ */
+int session_restart(sd_bus *bus, const char *session_path) {
+    sd_bus_error error = SD_BUS_ERROR_NULL;
+    int r;
+
+    if (!bus || !session_path) {
+        return -EINVAL;
+    }
+
+    gint64 start = g_get_monotonic_time();
+    r = sd_bus_call_method(
+        bus,
+        OPENVPN3_SERVICE_SESSIONS,
+        session_path,
+        OPENVPN3_INTERFACE_SESSION,
+        "Restart",
+        &error,
+        NULL,
+        ""
+    );
+
+    if (r < 0) {
+        logger_log_fields(LOG_LEVEL_WARN,
+                LOG_FIELDS(.session_path = session_path, .dbus_method = "Restart",
+                           .latency_us = g_get_monotonic_time() - start),
+                "Failed to restart session: %s",
+                error.message ? error.message : strerror(-r));
+        sd_bus_error_free(&error);
+        return r;
+    }
+
+    logger_log_fields(LOG_LEVEL_INFO,
+            LOG_FIELDS(.session_path = session_path, .dbus_method = "Restart",
+                       .latency_us = g_get_monotonic_time() - start),
+            "Restarted session: %s", session_path);
+    return 0;
+}
+
 /**
  * Check if session requires authentication and get auth URL
  */
@@ -565,7 +644,7 @@ int session_get_auth_url(sd_bus *bus, const char *session_path, char **auth_url)
     sd_bus_message *reply = NULL;
     int r;
 
-    if (logger_get_verbosity() >= 1) {
+    if (logger_verbose(1)) {
         logger_debug("session_get_auth_url called for %s", session_path);
     }
 
@@ -616,13 +695,13 @@ int session_get_auth_url(sd_bus *bus, const char *session_path, char **auth_url)
     sd_bus_message_unref(reply);
 
     if (!found_auth) {
-        if (logger_get_verbosity() >= 1) {
+        if (logger_verbose(1)) {
             logger_debug("session_get_auth_url: No auth requests found in queue");
         }
         return -ENOENT;
     }
 
-    if (logger_get_verbosity() >= 1) {
+    if (logger_verbose(1)) {
         logger_debug("session_get_auth_url: Found auth request type=%u, group=%u", type, group);
     }
 
@@ -778,6 +857,7 @@ int session_start(sd_bus *bus, const char *config_path, char **session_path) {
     disconnect_existing_sessions(bus, config_path);
 
     /* Call NewTunnel method to create session from config */
+    gint64 start = g_get_monotonic_time();
     r = sd_bus_call_method(
         bus,
         OPENVPN3_SERVICE_SESSIONS,
@@ -791,7 +871,10 @@ int session_start(sd_bus *bus, const char *config_path, char **session_path) {
     );
 
     if (r < 0) {
-        logger_error("Failed to create session: %s",
+        logger_log_fields(LOG_LEVEL_ERROR,
+                LOG_FIELDS(.dbus_method = "NewTunnel",
+                           .latency_us = g_get_monotonic_time() - start),
+                "Failed to create session: %s",
                 error.message ? error.message : strerror(-r));
         sd_bus_error_free(&error);
         return r;
@@ -808,10 +891,20 @@ int session_start(sd_bus *bus, const char *config_path, char **session_path) {
     *session_path = g_strdup(path);
     sd_bus_message_unref(reply);
 
-    logger_info("Created session: %s", *session_path);
+    logger_log_fields(LOG_LEVEL_INFO,
+            LOG_FIELDS(.session_path = *session_path, .dbus_method = "NewTunnel",
+                       .latency_us = g_get_monotonic_time() - start),
+            "Created session: %s", *session_path);
+
+    /* Time the attempt from the request; phases follow from StatusChange */
+    char *config_name = get_string_property(bus, *session_path, OPENVPN3_INTERFACE_SESSION,
+                                            "config_name");
+    connection_fsm_connect_requested(connection_fsm_get(config_name), *session_path, start);
+    g_free(config_name);
 
     /* Now connect the session */
     sd_bus_error_free(&error);
+    start = g_get_monotonic_time();
     r = sd_bus_call_method(
         bus,
         OPENVPN3_SERVICE_SESSIONS,
@@ -824,13 +917,19 @@ int session_start(sd_bus *bus, const char *config_path, char **session_path) {
     );
 
     if (r < 0) {
-        logger_error("Failed to connect session: %s",
+        logger_log_fields(LOG_LEVEL_ERROR,
+                LOG_FIELDS(.session_path = *session_path, .dbus_method = "Connect",
+                           .latency_us = g_get_monotonic_time() - start),
+                "Failed to connect session: %s",
                 error.message ? error.message : strerror(-r));
         sd_bus_error_free(&error);
         return r;
     }
 
-    logger_info("Connected session: %s", *session_path);
+    logger_log_fields(LOG_LEVEL_INFO,
+            LOG_FIELDS(.session_path = *session_path, .dbus_method = "Connect",
+                       .latency_us = g_get_monotonic_time() - start),
+            "Connected session: %s", *session_path);
 
     /* Subscribe to AttentionRequired signals for OAuth detection */
     r = signals_subscribe_attention_required(bus, *session_path);
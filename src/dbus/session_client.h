@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <glib.h>
+#include "../utils/connection_fsm.h"
 
 /**
  * Session Client
@@ -82,6 +83,18 @@ int session_pause(sd_bus *bus, const char *session_path, const char *reason);
  */
 int session_resume(sd_bus *bus, const char *session_path);
 
+/**
+ * Restart the tunnel of an existing session
+ *
+ * Reconnects without tearing the session down, keeping its config and
+ * credentials.
+ *
+ * @param bus D-Bus connection
+ * @param session_path D-Bus object path of session
+ * @return 0 on success, negative on error
+ */
+int session_restart(sd_bus *bus, const char *session_path);
+
 /**
  * Start a new VPN session from a configuration
  *
@@ -107,6 +120,14 @@ void session_free(VpnSession *session);
  */
 void session_list_free(VpnSession **sessions, unsigned int count);
 
+/**
+ * Map a session state to the connection state it corresponds to
+ *
+ * @param state Session state
+ * @return Connection state
+ */
+ConnectionState session_connection_state(SessionState state);
+
 /**
  * Check if session requires authentication and get auth URL
  *
@@ -1,5 +1,7 @@
 #include "signal_handlers.h"
+#define LOG_CATEGORY LOG_CAT_DBUS
 #include "../utils/logger.h"
+#include "../utils/connection_fsm.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -75,3 +77,62 @@ int signals_subscribe_attention_required(sd_bus *bus, const char *session_path)
 
     return 0;
 }
+
+/**
+ * StatusChange signal callback
+ */
+int status_change_handler(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    unsigned int major, minor;
+    const char *message;
+    int r;
+
+    r = sd_bus_message_read(m, "uus", &major, &minor, &message);
+    if (r < 0) {
+        logger_error("Failed to parse StatusChange signal: %s", strerror(-r));
+        return 0;
+    }
+
+    const char *session_path = sd_bus_message_get_path(m);
+    if (logger_verbose(2)) {
+        logger_info("StatusChange signal: session=%s, major=%u, minor=%u, msg='%s'",
+                    session_path, major, minor, message ? message : "");
+    }
+
+    /* Only sessions bound to a connection (started here or seen by a poll) */
+    ConnectionFsm *fsm = connection_fsm_find_session(session_path);
+    if (fsm) {
+        connection_fsm_note_status(fsm, major, minor, message);
+    }
+
+    return 0;
+}
+
+/**
+ * Subscribe to StatusChange signals of all sessions
+ */
+int signals_subscribe_status_change(sd_bus *bus) {
+    int r;
+
+    if (!bus) {
+        return -EINVAL;
+    }
+
+    /* No path: one match covers every session. The slot is floating and
+     * lives as long as the bus. */
+    r = sd_bus_add_match(bus, NULL,
+            "type='signal',"
+            "sender='net.openvpn.v3.sessions',"
+            "interface='net.openvpn.v3.sessions',"
+            "member='StatusChange'",
+            status_change_handler, NULL);
+    if (r < 0) {
+        logger_error("Failed to subscribe to StatusChange: %s", strerror(-r));
+        return r;
+    }
+
+    logger_info("Subscribed to session status signals");
+    return 0;
+}
@@ -23,4 +23,20 @@ int signals_subscribe_attention_required(sd_bus *bus, const char *session_path);
  */
 int attention_required_handler(sd_bus_message *m, void *userdata, sd_bus_error *ret_error);
 
+/**
+ * Subscribe to StatusChange signals of all sessions
+ *
+ * Status changes are fed to the connection FSM of the session, which
+ * times the phases of connection attempts from them.
+ *
+ * @param bus D-Bus connection
+ * @return 0 on success, negative on error
+ */
+int signals_subscribe_status_change(sd_bus *bus);
+
+/**
+ * StatusChange signal callback
+ */
+int status_change_handler(sd_bus_message *m, void *userdata, sd_bus_error *ret_error);
+
 #endif /* SIGNAL_HANDLERS_H */
@@ -0,0 +1,582 @@
+#include "auto_reconnect.h"
+#include "../dbus/session_client.h"
+#include "../dbus/config_client.h"
+#include "../utils/connection_fsm.h"
+#include "../monitoring/network_monitor.h"
+#define LOG_CATEGORY LOG_CAT_FSM
+#include "../utils/logger.h"
+#include <string.h>
+#include <errno.h>
+
+/* openvpn3 StatusMinor codes that retrying cannot fix */
+#define STATUS_CFG_ERROR        1
+#define STATUS_CONN_AUTH_FAILED 11
+
+/**
+ * Reconnect state of one config
+ */
+typedef struct {
+    char *name;
+    char *config_path;              /* Cached from config_list, or NULL */
+
+    unsigned int attempts;          /* Failed attempts since the drop */
+    unsigned int delay_ms;          /* Previous backoff delay, 0 = none yet */
+    bool in_flight;                 /* Attempt made, outcome pending */
+    bool held;                      /* Attempt due while offline */
+    bool net_paused;                /* Paused by us when the network went away */
+    guint timer_id;                 /* Scheduled attempt or attempt timeout */
+    gint64 down_since_us;           /* Monotonic time of the drop, 0 = up */
+
+    ReconnectBreakerState breaker;
+    unsigned int trips;             /* Consecutive breaker trips */
+} ReconnectEntry;
+
+/**
+ * Engine state (main thread only)
+ */
+typedef struct {
+    sd_bus *bus;
+    unsigned int max_attempts;      /* Breaker threshold, 0 = no breaker */
+    GHashTable *entries;            /* config name -> ReconnectEntry* (owned) */
+    bool offline;                   /* No usable uplink */
+} AutoReconnect;
+
+static AutoReconnect *engine = NULL;
+
+/**
+ * Free an entry
+ */
+static void entry_free(gpointer data) {
+    ReconnectEntry *entry = (ReconnectEntry *)data;
+    if (!entry) return;
+
+    if (entry->timer_id > 0) {
+        g_source_remove(entry->timer_id);
+    }
+    g_free(entry->name);
+    g_free(entry->config_path);
+    g_free(entry);
+}
+
+/**
+ * Get the entry of a config, creating it on first use
+ */
+static ReconnectEntry* entry_get(const char *name) {
+    ReconnectEntry *entry = g_hash_table_lookup(engine->entries, name);
+    if (!entry) {
+        entry = g_malloc0(sizeof(ReconnectEntry));
+        entry->name = g_strdup(name);
+        g_hash_table_insert(engine->entries, g_strdup(name), entry);
+    }
+    return entry;
+}
+
+/**
+ * Cancel pending work and forget the drop (breaker history included)
+ */
+static void entry_reset(ReconnectEntry *entry) {
+    if (entry->timer_id > 0) {
+        g_source_remove(entry->timer_id);
+        entry->timer_id = 0;
+    }
+    entry->attempts = 0;
+    entry->delay_ms = 0;
+    entry->in_flight = false;
+    entry->held = false;
+    entry->net_paused = false;
+    entry->down_since_us = 0;
+    entry->breaker = RECONNECT_BREAKER_CLOSED;
+    entry->trips = 0;
+}
+
+/**
+ * Next backoff delay: decorrelated jitter, min(cap, random(base, 3 * prev))
+ */
+static unsigned int next_delay_ms(ReconnectEntry *entry) {
+    guint64 prev = entry->delay_ms ? entry->delay_ms : AUTO_RECONNECT_BASE_MS;
+    guint64 upper = MIN(prev * 3, (guint64)AUTO_RECONNECT_CAP_MS);
+
+    unsigned int delay = AUTO_RECONNECT_BASE_MS;
+    if (upper > AUTO_RECONNECT_BASE_MS) {
+        delay = (unsigned int)g_random_int_range(AUTO_RECONNECT_BASE_MS, (gint32)upper + 1);
+    }
+
+    entry->delay_ms = delay;
+    return delay;
+}
+
+static gboolean on_attempt_timer(gpointer user_data);
+static gboolean on_attempt_timeout(gpointer user_data);
+
+/**
+ * Schedule the next attempt
+ */
+static void schedule_attempt(ReconnectEntry *entry, unsigned int delay_ms) {
+    if (entry->timer_id > 0) {
+        g_source_remove(entry->timer_id);
+    }
+    entry->timer_id = g_timeout_add(delay_ms, on_attempt_timer, entry);
+}
+
+/**
+ * Give a running attempt until the timeout to reach a verdict
+ */
+static void watch_attempt(ReconnectEntry *entry) {
+    if (entry->timer_id > 0) {
+        g_source_remove(entry->timer_id);
+    }
+    entry->timer_id = g_timeout_add_seconds(AUTO_RECONNECT_ATTEMPT_TIMEOUT_SEC,
+                                            on_attempt_timeout, entry);
+}
+
+/**
+ * Open the breaker and wait out the cooldown
+ */
+static void trip_breaker(ReconnectEntry *entry) {
+    unsigned int shift = MIN(entry->trips, 8u);
+    unsigned int cooldown = MIN((unsigned int)AUTO_RECONNECT_COOLDOWN_SEC << shift,
+                                (unsigned int)AUTO_RECONNECT_COOLDOWN_MAX_SEC);
+
+    entry->breaker = RECONNECT_BREAKER_OPEN;
+    entry->trips++;
+    entry->delay_ms = 0;
+
+    logger_log_fields(LOG_LEVEL_WARN,
+            LOG_FIELDS(.config_name = entry->name),
+            "Auto-reconnect '%s': %u attempts failed, pausing retries for %u s",
+            entry->name, entry->attempts, cooldown);
+
+    schedule_attempt(entry, cooldown * 1000);
+}
+
+/**
+ * Count a failed attempt and schedule the next one
+ */
+static void attempt_failed(ReconnectEntry *entry) {
+    entry->in_flight = false;
+    entry->attempts++;
+
+    if (entry->breaker == RECONNECT_BREAKER_HALF_OPEN ||
+        (engine->max_attempts > 0 && entry->attempts >= engine->max_attempts)) {
+        trip_breaker(entry);
+        return;
+    }
+
+    unsigned int delay = next_delay_ms(entry);
+    if (logger_verbose(1)) {
+        logger_info("Auto-reconnect '%s': attempt %u failed, retrying in %.1f s",
+                    entry->name, entry->attempts, delay / 1000.0);
+    }
+    schedule_attempt(entry, delay);
+}
+
+/**
+ * Find the OpenVPN3 config path of a config name (cached)
+ */
+static const char* lookup_config_path(ReconnectEntry *entry) {
+    if (entry->config_path) {
+        return entry->config_path;
+    }
+
+    VpnConfig **configs = NULL;
+    unsigned int count = 0;
+    if (config_list(engine->bus, &configs, &count) < 0) {
+        return NULL;
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (configs[i]->config_name && strcmp(configs[i]->config_name, entry->name) == 0) {
+            entry->config_path = g_strdup(configs[i]->config_path);
+            break;
+        }
+    }
+    config_list_free(configs, count);
+
+    return entry->config_path;
+}
+
+/**
+ * Bring the connection back: resume or restart the existing session,
+ * otherwise tear it down and start a new one
+ */
+static int run_attempt(ReconnectEntry *entry, ConnectionFsm *fsm) {
+    int r = -ENOENT;
+    char *old_path = g_strdup(connection_fsm_get_session(fsm));
+
+    if (old_path) {
+        VpnSession *session = session_get_info(engine->bus, old_path);
+        if (session) {
+            if (session->state == SESSION_STATE_PAUSED) {
+                r = session_resume(engine->bus, old_path);
+            } else {
+                r = session_restart(engine->bus, old_path);
+            }
+            session_free(session);
+
+            if (r < 0) {
+                /* Unbind first so the teardown is not taken for a user disconnect */
+                connection_fsm_bind_session(fsm, NULL);
+                session_disconnect(engine->bus, old_path);
+            }
+        }
+    }
+
+    if (r < 0) {
+        const char *config_path = lookup_config_path(entry);
+        if (!config_path) {
+            logger_warn("Auto-reconnect '%s': config not found", entry->name);
+            g_free(old_path);
+            return -ENOENT;
+        }
+
+        char *session_path = NULL;
+        r = session_start(engine->bus, config_path, &session_path);
+        g_free(session_path);
+        if (r < 0) {
+            /* The config may have been re-imported under a new path */
+            g_free(entry->config_path);
+            entry->config_path = NULL;
+        }
+    }
+
+    g_free(old_path);
+    return r;
+}
+
+/**
+ * Backoff timer: make one attempt
+ */
+static gboolean on_attempt_timer(gpointer user_data) {
+    ReconnectEntry *entry = (ReconnectEntry *)user_data;
+    entry->timer_id = 0;
+
+    ConnectionFsm *fsm = connection_fsm_lookup(entry->name);
+    if (!fsm || connection_fsm_user_disconnected(fsm)) {
+        entry_reset(entry);
+        return G_SOURCE_REMOVE;
+    }
+
+    /* Came back (or the user reconnected) meanwhile */
+    ConnectionState state = connection_fsm_get_state(fsm);
+    if (state != CONN_STATE_ERROR && state != CONN_STATE_DISCONNECTED) {
+        return G_SOURCE_REMOVE;
+    }
+
+    /* Pointless without a network; the restore makes the attempt */
+    if (engine->offline) {
+        entry->held = true;
+        return G_SOURCE_REMOVE;
+    }
+
+    if (entry->breaker == RECONNECT_BREAKER_OPEN) {
+        entry->breaker = RECONNECT_BREAKER_HALF_OPEN;
+    }
+
+    logger_log_fields(LOG_LEVEL_INFO,
+            LOG_FIELDS(.config_name = entry->name,
+                       .fsm_state = connection_fsm_state_name(state)),
+            "Auto-reconnect '%s': attempt %u%s",
+            entry->name, entry->attempts + 1,
+            entry->breaker == RECONNECT_BREAKER_HALF_OPEN ? " (trial)" : "");
+
+    entry->in_flight = true;
+    if (run_attempt(entry, fsm) >= 0) {
+        watch_attempt(entry);
+    } else {
+        state = connection_fsm_get_state(fsm);
+        if (state == CONN_STATE_ERROR || state == CONN_STATE_DISCONNECTED) {
+            attempt_failed(entry);
+        } else {
+            /* The new session was requested but never connected;
+             * the listener counts the failure */
+            connection_fsm_process_event(fsm, FSM_EVENT_SESSION_ERROR);
+        }
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Attempt timeout: no status change settled the attempt
+ */
+static gboolean on_attempt_timeout(gpointer user_data) {
+    ReconnectEntry *entry = (ReconnectEntry *)user_data;
+    entry->timer_id = 0;
+
+    ConnectionFsm *fsm = connection_fsm_lookup(entry->name);
+    if (!entry->in_flight || !fsm) {
+        return G_SOURCE_REMOVE;
+    }
+
+    /* Waiting for the user to authenticate is not a failure */
+    if (connection_fsm_get_state(fsm) == CONN_STATE_AUTH_REQUIRED) {
+        watch_attempt(entry);
+        return G_SOURCE_REMOVE;
+    }
+
+    logger_warn("Auto-reconnect '%s': attempt %u timed out after %d s",
+                entry->name, entry->attempts + 1, AUTO_RECONNECT_ATTEMPT_TIMEOUT_SEC);
+    attempt_failed(entry);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Handle a connection entering ERROR or DISCONNECTED
+ */
+static void on_connection_down(ConnectionFsm *fsm, ConnectionState old_state) {
+    const char *name = connection_fsm_get_name(fsm);
+    ReconnectEntry *entry = g_hash_table_lookup(engine->entries, name);
+
+    if (connection_fsm_user_disconnected(fsm)) {
+        if (entry) {
+            entry_reset(entry);
+        }
+        return;
+    }
+
+    bool in_flight = entry && entry->in_flight;
+    if (!in_flight) {
+        /* Retry only connections that were up, once per drop */
+        if (entry && entry->timer_id > 0) {
+            return;
+        }
+        if (old_state != CONN_STATE_CONNECTED && old_state != CONN_STATE_RECONNECTING &&
+            old_state != CONN_STATE_PAUSED) {
+            return;
+        }
+    }
+
+    unsigned int status = connection_fsm_get_last_status(fsm);
+    if (status == STATUS_CONN_AUTH_FAILED || status == STATUS_CFG_ERROR) {
+        logger_log_fields(LOG_LEVEL_WARN,
+                LOG_FIELDS(.config_name = name),
+                "Auto-reconnect '%s': %s, not retrying", name,
+                status == STATUS_CONN_AUTH_FAILED ? "authentication failed" : "configuration error");
+        if (entry) {
+            entry_reset(entry);
+        }
+        return;
+    }
+
+    if (in_flight) {
+        attempt_failed(entry);
+        return;
+    }
+
+    entry = entry_get(name);
+    entry->down_since_us = g_get_monotonic_time();
+    entry->attempts = 0;
+    entry->delay_ms = 0;
+
+    unsigned int delay = next_delay_ms(entry);
+    logger_log_fields(LOG_LEVEL_INFO,
+            LOG_FIELDS(.config_name = name,
+                       .fsm_state = connection_fsm_state_name(connection_fsm_get_state(fsm))),
+            "Auto-reconnect '%s': connection lost (%s), reconnecting in %.1f s",
+            name, connection_fsm_state_name(old_state), delay / 1000.0);
+    schedule_attempt(entry, delay);
+}
+
+/**
+ * FSM listener
+ */
+static void on_fsm_changed(ConnectionFsm *fsm, ConnectionState old_state, void *user_data) {
+    (void)user_data;
+
+    const char *name = connection_fsm_get_name(fsm);
+    if (!engine || !name) {
+        return;
+    }
+
+    switch (connection_fsm_get_state(fsm)) {
+        case CONN_STATE_CONNECTED: {
+            ReconnectEntry *entry = g_hash_table_lookup(engine->entries, name);
+            if (entry && entry->down_since_us > 0) {
+                gint64 down_us = g_get_monotonic_time() - entry->down_since_us;
+                logger_log_fields(LOG_LEVEL_INFO,
+                        LOG_FIELDS(.config_name = name, .latency_us = down_us),
+                        "Auto-reconnect '%s': recovered after %.1f s (%u failed attempts)",
+                        name, down_us / 1000000.0, entry->attempts);
+            }
+            if (entry) {
+                entry_reset(entry);
+            }
+            break;
+        }
+        case CONN_STATE_ERROR:
+        case CONN_STATE_DISCONNECTED:
+            on_connection_down(fsm, old_state);
+            break;
+        default:
+            break;
+    }
+}
+
+/* ──────────────────────────────────────────────────────────────
+ * Network changes
+ * ────────────────────────────────────────────────────────────── */
+
+/**
+ * Get a session going again after a network change: resume, else
+ * restart, else hand it to the backoff loop as failed
+ */
+static void recover_session(ReconnectEntry *entry, ConnectionFsm *fsm, const char *session_path) {
+    entry->net_paused = false;
+
+    if (session_resume(engine->bus, session_path) == 0 ||
+        session_restart(engine->bus, session_path) == 0) {
+        return;
+    }
+
+    logger_warn("Auto-reconnect '%s': could not resume or restart session after network change",
+                entry->name);
+    connection_fsm_process_event(fsm, FSM_EVENT_SESSION_ERROR);
+}
+
+/**
+ * Network lost: pause live sessions so they do not time out into errors
+ */
+static void pause_for_outage(ConnectionFsm *fsm, void *user_data) {
+    (void)user_data;
+
+    ConnectionState state = connection_fsm_get_state(fsm);
+    const char *session_path = connection_fsm_get_session(fsm);
+    if (!session_path ||
+        (state != CONN_STATE_CONNECTED && state != CONN_STATE_CONNECTING &&
+         state != CONN_STATE_RECONNECTING)) {
+        return;
+    }
+
+    ReconnectEntry *entry = entry_get(connection_fsm_get_name(fsm));
+    if (session_pause(engine->bus, session_path, "Network unavailable") == 0) {
+        entry->net_paused = true;
+    }
+}
+
+/**
+ * Network back or changed: resume what we paused and move live sessions
+ * onto the new uplink
+ */
+static void recover_after_change(ConnectionFsm *fsm, void *user_data) {
+    NetworkChangeKind kind = (NetworkChangeKind)GPOINTER_TO_INT(user_data);
+    const char *session_path = connection_fsm_get_session(fsm);
+    ReconnectEntry *entry = g_hash_table_lookup(engine->entries, connection_fsm_get_name(fsm));
+
+    if (!session_path) {
+        return;
+    }
+
+    ConnectionState state = connection_fsm_get_state(fsm);
+    if (entry && entry->net_paused) {
+        if (state == CONN_STATE_PAUSED) {
+            recover_session(entry, fsm, session_path);
+            return;
+        }
+        /* Resumed by the user, or failed into the backoff loop meanwhile */
+        entry->net_paused = false;
+    }
+
+    if (kind == NETWORK_CHANGE_ROAMED &&
+        (state == CONN_STATE_CONNECTED || state == CONN_STATE_CONNECTING ||
+         state == CONN_STATE_RECONNECTING)) {
+        /* The tunnel is bound to the old path: bounce it */
+        entry = entry_get(connection_fsm_get_name(fsm));
+        session_pause(engine->bus, session_path, "Network changed");
+        recover_session(entry, fsm, session_path);
+    }
+}
+
+/**
+ * Retry waiting reconnects now, with backoff and breaker reset
+ */
+static void kick_waiting(void) {
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init(&iter, engine->entries);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        ReconnectEntry *entry = (ReconnectEntry *)value;
+        if (entry->in_flight || (!entry->held && entry->timer_id == 0)) {
+            continue;
+        }
+
+        entry->held = false;
+        entry->attempts = 0;
+        entry->delay_ms = 0;
+        entry->breaker = RECONNECT_BREAKER_CLOSED;
+        entry->trips = 0;
+        schedule_attempt(entry, 0);
+    }
+}
+
+/**
+ * Network monitor callback
+ */
+static void on_network_change(NetworkChangeKind kind, const NetworkUplink *uplink,
+                              void *user_data) {
+    (void)uplink;
+    (void)user_data;
+
+    if (!engine) {
+        return;
+    }
+
+    if (kind == NETWORK_CHANGE_LOST) {
+        engine->offline = true;
+        connection_fsm_foreach(pause_for_outage, NULL);
+        return;
+    }
+
+    engine->offline = false;
+    connection_fsm_foreach(recover_after_change, GINT_TO_POINTER(kind));
+    kick_waiting();
+}
+
+/**
+ * Start the engine
+ */
+int auto_reconnect_init(sd_bus *bus, bool enabled, unsigned int max_attempts) {
+    if (!bus) {
+        return -EINVAL;
+    }
+    if (engine) {
+        return 0;
+    }
+    if (!enabled) {
+        logger_info("Auto-reconnect disabled");
+        return 0;
+    }
+
+    engine = g_malloc0(sizeof(AutoReconnect));
+    engine->bus = bus;
+    engine->max_attempts = max_attempts;
+    engine->entries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, entry_free);
+
+    connection_fsm_add_listener(on_fsm_changed, NULL);
+
+    /* Without netlink, drops are still caught by the FSM */
+    if (network_monitor_subscribe(on_network_change, NULL) == 0) {
+        NetworkUplink uplink;
+        network_monitor_get_uplink(&uplink);
+        engine->offline = !uplink.online;
+    }
+
+    logger_info("Auto-reconnect enabled (max %u attempts before backing off)",
+                max_attempts);
+    return 0;
+}
+
+/**
+ * Stop the engine
+ */
+void auto_reconnect_cleanup(void) {
+    if (!engine) {
+        return;
+    }
+
+    network_monitor_unsubscribe(on_network_change, NULL);
+    connection_fsm_remove_listener(on_fsm_changed, NULL);
+    g_hash_table_destroy(engine->entries);
+    g_free(engine);
+    engine = NULL;
+}
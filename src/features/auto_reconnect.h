@@ -0,0 +1,73 @@
+#ifndef AUTO_RECONNECT_H
+#define AUTO_RECONNECT_H
+
+#include <systemd/sd-bus.h>
+#include <stdbool.h>
+#include <glib.h>
+
+/**
+ * Auto-Reconnect Engine
+ *
+ * Watches the connection FSMs and brings a connection back when it drops
+ * to ERROR or DISCONNECTED without the user asking for it. Retries are
+ * spaced by exponential backoff with decorrelated jitter
+ * (delay = min(cap, random(base, 3 * previous delay))).
+ *
+ * An attempt reuses the existing session when it is still there: a
+ * paused session is resumed, a failed one restarted. Only when that is
+ * not possible is the session torn down and a new one started from the
+ * config.
+ *
+ * Each config has a circuit breaker: after max_attempts failed attempts
+ * in a row it opens and retries stop for a cooldown, after which one
+ * trial attempt is made (half-open). Success closes the breaker; failure
+ * reopens it with a doubled cooldown. Authentication failures are never
+ * retried.
+ *
+ * Network changes from the network monitor are acted on at once instead
+ * of waiting for openvpn3's own timeouts: live sessions are paused when
+ * the uplink goes away and resumed when it returns, sessions are bounced
+ * (pause, resume) when the uplink changes, and a session that cannot be
+ * resumed is restarted. Waiting retries run immediately once the network
+ * is back.
+ */
+
+/* Backoff bounds */
+#define AUTO_RECONNECT_BASE_MS          1000
+#define AUTO_RECONNECT_CAP_MS           60000
+
+/* An attempt that has not connected or failed by then counts as failed */
+#define AUTO_RECONNECT_ATTEMPT_TIMEOUT_SEC 90
+
+/* Circuit breaker cooldown, doubled on each consecutive trip */
+#define AUTO_RECONNECT_COOLDOWN_SEC     60
+#define AUTO_RECONNECT_COOLDOWN_MAX_SEC 900
+
+/**
+ * Circuit breaker state
+ */
+typedef enum {
+    RECONNECT_BREAKER_CLOSED,    /* Retrying normally */
+    RECONNECT_BREAKER_OPEN,      /* Cooling down, no attempts */
+    RECONNECT_BREAKER_HALF_OPEN  /* One trial attempt in progress */
+} ReconnectBreakerState;
+
+/**
+ * Start the engine
+ *
+ * Registers a connection FSM listener. Does nothing when
+ * enabled is false.
+ *
+ * @param bus D-Bus connection used for reconnect calls
+ * @param enabled auto_reconnect.enabled setting
+ * @param max_attempts Failed attempts before the breaker opens, 0 for no breaker
+ * @return 0 on success, negative errno on failure
+ */
+int auto_reconnect_init(sd_bus *bus, bool enabled, unsigned int max_attempts);
+
+/**
+ * Stop the engine and cancel pending attempts
+ */
+void auto_reconnect_cleanup(void);
+
+#endif /* AUTO_RECONNECT_H */
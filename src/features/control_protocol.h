@@ -0,0 +1,79 @@
+#ifndef CONTROL_PROTOCOL_H
+#define CONTROL_PROTOCOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * Control Socket Protocol
+ *
+ * Shared by the daemon (control_server.c) and ovpn-managerctl; libc
+ * only, so the client stays free of GLib.
+ *
+ * A Unix stream socket carrying JSON objects, one per line. Every
+ * request has a "cmd" member and may have an "id", which is echoed in
+ * the response:
+ *
+ *   {"cmd":"list"}                      -> {"ok":true,"connections":[...]}
+ *   {"cmd":"stats"}                     -> {"ok":true,"uptime_s":..,"connections":[...]}
+ *   {"cmd":"connect","name":"work"}     -> {"ok":true,"session":"/net/openvpn/..."}
+ *   {"cmd":"disconnect","name":"work"}  -> {"ok":true}
+ *   {"cmd":"watch"}                     -> {"ok":true}, then one
+ *       {"event":"state","name":..,"state":..,"old_state":..} line per
+ *       state change until the client disconnects
+ *
+ * Failures are {"ok":false,"error":"..."}. list and stats are answered
+ * from the daemon's in-memory state without a D-Bus round trip.
+ */
+
+#define CONTROL_CMD_LIST        "list"
+#define CONTROL_CMD_STATS       "stats"
+#define CONTROL_CMD_CONNECT     "connect"
+#define CONTROL_CMD_DISCONNECT  "disconnect"
+#define CONTROL_CMD_WATCH       "watch"
+
+/* Longest request line accepted */
+#define CONTROL_MAX_LINE        4096
+
+/* Socket location below $XDG_RUNTIME_DIR (or /tmp/ovpn-manager-<uid>) */
+#define CONTROL_SOCKET_DIR      "ovpn-manager"
+#define CONTROL_SOCKET_NAME     "control.sock"
+
+/**
+ * Directory holding the control socket
+ *
+ * @param buf Output buffer
+ * @param size Size of buf
+ * @return 0 on success, -1 if the path does not fit
+ */
+static inline int control_socket_dir(char *buf, size_t size) {
+    const char *runtime = getenv("XDG_RUNTIME_DIR");
+    int n;
+
+    if (runtime && runtime[0] == '/') {
+        n = snprintf(buf, size, "%s/%s", runtime, CONTROL_SOCKET_DIR);
+    } else {
+        n = snprintf(buf, size, "/tmp/%s-%u", CONTROL_SOCKET_DIR, (unsigned int)getuid());
+    }
+    return (n < 0 || (size_t)n >= size) ? -1 : 0;
+}
+
+/**
+ * Default control socket path
+ *
+ * @param buf Output buffer (sizeof(sockaddr_un.sun_path) is enough)
+ * @param size Size of buf
+ * @return 0 on success, -1 if the path does not fit
+ */
+static inline int control_socket_path(char *buf, size_t size) {
+    char dir[256];
+    if (control_socket_dir(dir, sizeof(dir)) < 0) {
+        return -1;
+    }
+
+    int n = snprintf(buf, size, "%s/%s", dir, CONTROL_SOCKET_NAME);
+    return (n < 0 || (size_t)n >= size) ? -1 : 0;
+}
+
+#endif /* CONTROL_PROTOCOL_H */
@@ -0,0 +1,824 @@
+#include "control_server.h"
+#include "../dbus/session_client.h"
+#include "../dbus/config_client.h"
+#include "../monitoring/dns_cache.h"
+#include "../utils/connection_fsm.h"
+#include "../utils/logger.h"
+#include "cJSON.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/**
+ * Connected client
+ */
+typedef struct {
+    int fd;
+    GIOChannel *channel;
+    guint watch_id;
+    GString *input;                 /* Bytes of the unfinished request line */
+    bool watching;                  /* Receives state change events */
+    bool dead;                      /* Send failed; freed when its watch fires */
+} ControlClient;
+
+/**
+ * Server state (main thread only)
+ */
+typedef struct {
+    sd_bus *bus;
+    char *socket_path;
+    int fd;
+    GIOChannel *channel;
+    guint watch_id;
+    GPtrArray *clients;             /* ControlClient* (owned) */
+    GHashTable *config_paths;       /* config name -> OpenVPN3 config path */
+    sd_bus_slot *slots[3];          /* OpenVPN3 signal matches */
+    guint refresh_id;               /* Pending signal-triggered refresh */
+    bool configs_stale;             /* Pending refresh re-reads configs too */
+    gint64 started_us;
+    guint64 requests;
+    bool remotes_prefetched;        /* DNS cache warmed for every remote */
+} ControlServer;
+
+static ControlServer *server = NULL;
+
+/**
+ * Command handler
+ *
+ * @return 0 on success, negative errno on failure (with "error" set in
+ *         reply, or the errno text is used)
+ */
+typedef int (*ControlHandler)(ControlClient *client, const cJSON *request, cJSON *reply);
+
+/* ──── Clients ──── */
+
+static void client_free(gpointer data) {
+    ControlClient *client = (ControlClient *)data;
+
+    if (client->watch_id > 0) {
+        g_source_remove(client->watch_id);
+    }
+    if (client->channel) {
+        g_io_channel_unref(client->channel);
+    }
+    close(client->fd);
+    g_string_free(client->input, TRUE);
+    g_free(client);
+}
+
+/**
+ * Send one JSON line
+ *
+ * A client whose socket buffer is full has stopped reading; it is shut
+ * down instead of queueing for it, and freed when its watch sees the
+ * hangup.
+ */
+static bool client_send(ControlClient *client, const cJSON *message) {
+    if (client->dead) {
+        return false;
+    }
+
+    char *text = cJSON_PrintUnformatted(message);
+    if (!text) {
+        return true;
+    }
+    char *line = g_strconcat(text, "\n", NULL);
+    cJSON_free(text);
+
+    size_t len = strlen(line);
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t n = send(client->fd, line + sent, len - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        sent += (size_t)n;
+    }
+    g_free(line);
+
+    if (sent < len) {
+        if (logger_verbose(1)) {
+            logger_info("Control: dropping client (fd %d) that stopped reading", client->fd);
+        }
+        client->dead = true;
+        shutdown(client->fd, SHUT_RDWR);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Set an error reply
+ */
+static int fail(cJSON *reply, int err, const char *message) {
+    cJSON_AddStringToObject(reply, "error", message);
+    return err;
+}
+
+/**
+ * Get the "name" member of a request
+ */
+static const char* request_name(const cJSON *request) {
+    const char *name = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(request, "name"));
+    return (name && name[0]) ? name : NULL;
+}
+
+/* ──── Commands ──── */
+
+static void collect_fsm(ConnectionFsm *fsm, void *user_data) {
+    g_ptr_array_add((GPtrArray *)user_data, fsm);
+}
+
+static gint compare_fsm_names(gconstpointer a, gconstpointer b) {
+    return g_strcmp0(connection_fsm_get_name(*(ConnectionFsm *const *)a),
+                     connection_fsm_get_name(*(ConnectionFsm *const *)b));
+}
+
+/**
+ * All FSMs, sorted by name
+ */
+static GPtrArray* sorted_fsms(void) {
+    GPtrArray *fsms = g_ptr_array_new();
+    connection_fsm_foreach(collect_fsm, fsms);
+    g_ptr_array_sort(fsms, compare_fsm_names);
+    return fsms;
+}
+
+static int handle_list(ControlClient *client, const cJSON *request, cJSON *reply) {
+    (void)client;
+    (void)request;
+
+    cJSON *list = cJSON_AddArrayToObject(reply, "connections");
+    GPtrArray *fsms = sorted_fsms();
+
+    for (guint i = 0; i < fsms->len; i++) {
+        ConnectionFsm *fsm = g_ptr_array_index(fsms, i);
+        const char *session = connection_fsm_get_session(fsm);
+
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "name", connection_fsm_get_name(fsm));
+        cJSON_AddStringToObject(item, "state",
+                                connection_fsm_state_name(connection_fsm_get_state(fsm)));
+        if (session) {
+            cJSON_AddStringToObject(item, "session", session);
+        } else {
+            cJSON_AddNullToObject(item, "session");
+        }
+        cJSON_AddNumberToObject(item, "status", connection_fsm_get_last_status(fsm));
+        cJSON_AddBoolToObject(item, "user_disconnected", connection_fsm_user_disconnected(fsm));
+        cJSON_AddItemToArray(list, item);
+    }
+
+    g_ptr_array_free(fsms, TRUE);
+    return 0;
+}
+
+/**
+ * Latency statistics of one connection
+ */
+static cJSON* connection_stats_json(ConnectionFsm *fsm) {
+    const ConnectionLatencyStats *stats = connection_fsm_get_stats(fsm);
+
+    cJSON *item = cJSON_CreateObject();
+    cJSON_AddStringToObject(item, "name", connection_fsm_get_name(fsm));
+    cJSON_AddNumberToObject(item, "connects", stats->connects);
+    cJSON_AddNumberToObject(item, "failures", stats->failures);
+
+    if (stats->connects > 0) {
+        cJSON_AddNumberToObject(item, "connect_avg_ms",
+                                stats->connected_sum_us / 1000.0 / stats->connects);
+        cJSON_AddNumberToObject(item, "connect_p50_ms",
+                                (double)connection_fsm_histogram_quantile(stats->connected_hist, 0.5));
+        cJSON_AddNumberToObject(item, "connect_p95_ms",
+                                (double)connection_fsm_histogram_quantile(stats->connected_hist, 0.95));
+    }
+
+    unsigned int auths = 0;
+    for (int i = 0; i < FSM_HISTOGRAM_BUCKETS; i++) {
+        auths += stats->auth_hist[i];
+    }
+    if (auths > 0) {
+        cJSON_AddNumberToObject(item, "auth_avg_ms", stats->auth_sum_us / 1000.0 / auths);
+    }
+
+    if (stats->has_last) {
+        cJSON *last = cJSON_AddObjectToObject(item, "last");
+        cJSON_AddNumberToObject(last, "total_ms", stats->last.total_us / 1000.0);
+        for (int p = 0; p < FSM_PHASE_COUNT; p++) {
+            char key[32];
+            snprintf(key, sizeof(key), "%s_ms", connection_fsm_phase_name((ConnectionPhase)p));
+            cJSON_AddNumberToObject(last, key, stats->last.phase_us[p] / 1000.0);
+        }
+    }
+    return item;
+}
+
+static int handle_stats(ControlClient *client, const cJSON *request, cJSON *reply) {
+    (void)client;
+    (void)request;
+
+    cJSON_AddNumberToObject(reply, "uptime_s",
+                            (g_get_monotonic_time() - server->started_us) / (double)G_USEC_PER_SEC);
+    cJSON_AddNumberToObject(reply, "requests", (double)server->requests);
+    cJSON_AddNumberToObject(reply, "clients", server->clients->len);
+
+    cJSON *list = cJSON_AddArrayToObject(reply, "connections");
+    GPtrArray *fsms = sorted_fsms();
+    for (guint i = 0; i < fsms->len; i++) {
+        cJSON_AddItemToArray(list, connection_stats_json(g_ptr_array_index(fsms, i)));
+    }
+    g_ptr_array_free(fsms, TRUE);
+    return 0;
+}
+
+static int handle_connect(ControlClient *client, const cJSON *request, cJSON *reply) {
+    (void)client;
+
+    const char *name = request_name(request);
+    if (!name) {
+        return fail(reply, -EINVAL, "missing name");
+    }
+
+    ConnectionFsm *fsm = connection_fsm_lookup(name);
+    if (fsm) {
+        ConnectionState state = connection_fsm_get_state(fsm);
+        if (state != CONN_STATE_DISCONNECTED && state != CONN_STATE_ERROR) {
+            return fail(reply, -EALREADY, "connection is already active");
+        }
+    }
+
+    /* A config imported since the last refresh is not cached yet */
+    const char *config_path = g_hash_table_lookup(server->config_paths, name);
+    if (!config_path) {
+        control_server_refresh();
+        config_path = g_hash_table_lookup(server->config_paths, name);
+    }
+    if (!config_path) {
+        return fail(reply, -ENOENT, "unknown connection");
+    }
+
+    logger_info("Control: connecting '%s'", name);
+    config_clear_pin(server->bus, config_path);
+
+    char *session_path = NULL;
+    int r = session_start(server->bus, config_path, &session_path);
+    if (r < 0) {
+        return r;
+    }
+
+    cJSON_AddStringToObject(reply, "session", session_path);
+    g_free(session_path);
+    return 0;
+}
+
+static int handle_disconnect(ControlClient *client, const cJSON *request, cJSON *reply) {
+    (void)client;
+
+    const char *name = request_name(request);
+    if (!name) {
+        return fail(reply, -EINVAL, "missing name");
+    }
+
+    ConnectionFsm *fsm = connection_fsm_lookup(name);
+    if (!fsm) {
+        return fail(reply, -ENOENT, "unknown connection");
+    }
+
+    const char *session = connection_fsm_get_session(fsm);
+    if (!session || connection_fsm_get_state(fsm) == CONN_STATE_DISCONNECTED) {
+        return fail(reply, -ENOTCONN, "not connected");
+    }
+
+    logger_info("Control: disconnecting '%s'", name);
+    return session_disconnect(server->bus, session);
+}
+
+static int handle_watch(ControlClient *client, const cJSON *request, cJSON *reply) {
+    (void)request;
+    (void)reply;
+
+    client->watching = true;
+    return 0;
+}
+
+static const struct {
+    const char *name;
+    ControlHandler handler;
+} commands[] = {
+    { CONTROL_CMD_LIST,       handle_list },
+    { CONTROL_CMD_STATS,      handle_stats },
+    { CONTROL_CMD_CONNECT,    handle_connect },
+    { CONTROL_CMD_DISCONNECT, handle_disconnect },
+    { CONTROL_CMD_WATCH,      handle_watch },
+};
+
+/**
+ * Answer one request line
+ */
+static void handle_line(ControlClient *client, const char *line) {
+    gint64 start = g_get_monotonic_time();
+    server->requests++;
+
+    cJSON *request = cJSON_Parse(line);
+    cJSON *reply = cJSON_CreateObject();
+    const char *cmd = NULL;
+    int r;
+
+    if (!cJSON_IsObject(request)) {
+        r = fail(reply, -EINVAL, "invalid JSON");
+    } else {
+        const cJSON *id = cJSON_GetObjectItemCaseSensitive(request, "id");
+        if (id) {
+            cJSON_AddItemToObject(reply, "id", cJSON_Duplicate(id, true));
+        }
+
+        cmd = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(request, "cmd"));
+        ControlHandler handler = NULL;
+        for (size_t i = 0; cmd && i < G_N_ELEMENTS(commands); i++) {
+            if (strcmp(cmd, commands[i].name) == 0) {
+                handler = commands[i].handler;
+                break;
+            }
+        }
+        r = handler ? handler(client, request, reply) : fail(reply, -EINVAL, "unknown command");
+    }
+
+    cJSON_AddBoolToObject(reply, "ok", r == 0);
+    if (r < 0 && !cJSON_HasObjectItem(reply, "error")) {
+        cJSON_AddStringToObject(reply, "error", strerror(-r));
+    }
+    client_send(client, reply);
+
+    if (logger_verbose(2)) {
+        logger_debug("Control: '%s' answered in %" G_GINT64_FORMAT " us (%s)",
+                     cmd ? cmd : "?", g_get_monotonic_time() - start,
+                     r == 0 ? "ok" : "error");
+    }
+
+    cJSON_Delete(reply);
+    cJSON_Delete(request);
+}
+
+/**
+ * Read what the client sent and answer complete lines
+ *
+ * @return false once the client is gone or misbehaved
+ */
+static bool client_read(ControlClient *client) {
+    char buf[CONTROL_MAX_LINE];
+
+    for (;;) {
+        ssize_t n = recv(client->fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+        g_string_append_len(client->input, buf, n);
+        if ((size_t)n < sizeof(buf)) {
+            break;
+        }
+    }
+
+    char *newline;
+    while (!client->dead &&
+           (newline = memchr(client->input->str, '\n', client->input->len)) != NULL) {
+        gsize consumed = (gsize)(newline - client->input->str) + 1;
+        *newline = '\0';
+        if (newline > client->input->str && newline[-1] == '\r') {
+            newline[-1] = '\0';
+        }
+        if (client->input->str[0]) {
+            handle_line(client, client->input->str);
+        }
+        g_string_erase(client->input, 0, consumed);
+    }
+
+    if (client->input->len > CONTROL_MAX_LINE) {
+        cJSON *reply = cJSON_CreateObject();
+        cJSON_AddBoolToObject(reply, "ok", false);
+        cJSON_AddStringToObject(reply, "error", "request too long");
+        client_send(client, reply);
+        cJSON_Delete(reply);
+        return false;
+    }
+    return !client->dead;
+}
+
+static gboolean on_client_readable(GIOChannel *channel, GIOCondition condition,
+                                   gpointer user_data) {
+    (void)channel;
+    (void)condition;
+    ControlClient *client = (ControlClient *)user_data;
+
+    if (client_read(client)) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    /* Returning G_SOURCE_REMOVE destroys the watch */
+    client->watch_id = 0;
+    g_ptr_array_remove(server->clients, client);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * New connection: admit processes of the same user (and root)
+ */
+static gboolean on_listen_readable(GIOChannel *channel, GIOCondition condition,
+                                   gpointer user_data) {
+    (void)channel;
+    (void)condition;
+    (void)user_data;
+
+    for (;;) {
+        int fd = accept4(server->fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logger_warn("Control: accept failed: %s", strerror(errno));
+            }
+            break;
+        }
+
+        struct ucred cred;
+        socklen_t len = sizeof(cred);
+        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0 ||
+            (cred.uid != getuid() && cred.uid != 0)) {
+            logger_warn("Control: rejected client of another user");
+            close(fd);
+            continue;
+        }
+        if (server->clients->len >= CONTROL_MAX_CLIENTS) {
+            logger_warn("Control: rejected client, %d already connected", CONTROL_MAX_CLIENTS);
+            close(fd);
+            continue;
+        }
+
+        ControlClient *client = g_malloc0(sizeof(ControlClient));
+        client->fd = fd;
+        client->input = g_string_new(NULL);
+        client->channel = g_io_channel_unix_new(fd);
+        client->watch_id = g_io_add_watch(client->channel, G_IO_IN | G_IO_HUP | G_IO_ERR,
+                                          on_client_readable, client);
+        g_ptr_array_add(server->clients, client);
+
+        if (logger_verbose(2)) {
+            logger_debug("Control: client connected (pid %d)", (int)cred.pid);
+        }
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/* ──── State change events ──── */
+
+static void on_fsm_changed(ConnectionFsm *fsm, ConnectionState old_state, void *user_data) {
+    (void)user_data;
+
+    if (!server) {
+        return;
+    }
+
+    cJSON *event = NULL;
+    for (guint i = 0; i < server->clients->len; i++) {
+        ControlClient *client = g_ptr_array_index(server->clients, i);
+        if (!client->watching || client->dead) {
+            continue;
+        }
+
+        if (!event) {
+            const char *session = connection_fsm_get_session(fsm);
+            event = cJSON_CreateObject();
+            cJSON_AddStringToObject(event, "event", "state");
+            cJSON_AddStringToObject(event, "name", connection_fsm_get_name(fsm));
+            cJSON_AddStringToObject(event, "state",
+                                    connection_fsm_state_name(connection_fsm_get_state(fsm)));
+            cJSON_AddStringToObject(event, "old_state", connection_fsm_state_name(old_state));
+            if (session) {
+                cJSON_AddStringToObject(event, "session", session);
+            } else {
+                cJSON_AddNullToObject(event, "session");
+            }
+            cJSON_AddNumberToObject(event, "status", connection_fsm_get_last_status(fsm));
+            cJSON_AddNumberToObject(event, "time", g_get_real_time() / (double)G_USEC_PER_SEC);
+        }
+        client_send(client, event);
+    }
+    cJSON_Delete(event);
+}
+
+/* ──── Cache refresh ──── */
+
+/**
+ * Sync the FSM of every cached config with its session
+ */
+static void sync_sessions(void) {
+    VpnSession **sessions = NULL;
+    unsigned int session_count = 0;
+    if (session_list(server->bus, &sessions, &session_count) < 0) {
+        sessions = NULL;
+        session_count = 0;
+    }
+
+    GHashTableIter iter;
+    gpointer name;
+    g_hash_table_iter_init(&iter, server->config_paths);
+    while (g_hash_table_iter_next(&iter, &name, NULL)) {
+        VpnSession *session = NULL;
+        for (unsigned int i = 0; i < session_count; i++) {
+            if (sessions[i]->config_name && strcmp(sessions[i]->config_name, name) == 0) {
+                session = sessions[i];
+                break;
+            }
+        }
+
+        ConnectionFsm *fsm = connection_fsm_get(name);
+        if (session && session->session_path) {
+            connection_fsm_bind_session(fsm, session->session_path);
+        }
+        connection_fsm_observe(fsm, session ? session_connection_state(session->state)
+                                            : CONN_STATE_DISCONNECTED);
+    }
+
+    if (sessions) {
+        session_list_free(sessions, session_count);
+    }
+}
+
+static gboolean on_refresh(gpointer user_data) {
+    (void)user_data;
+
+    server->refresh_id = 0;
+    if (server->configs_stale) {
+        server->configs_stale = false;
+        control_server_refresh();
+    } else {
+        sync_sessions();
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Refresh shortly, folding in any signals that arrive meanwhile
+ */
+static void schedule_refresh(bool configs) {
+    if (!server) {
+        return;
+    }
+    server->configs_stale |= configs;
+    if (server->refresh_id == 0) {
+        server->refresh_id = g_timeout_add(CONTROL_REFRESH_DELAY_MS, on_refresh, NULL);
+    }
+}
+
+static int on_session_signal(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)m;
+    (void)userdata;
+    (void)ret_error;
+
+    schedule_refresh(false);
+    return 0;
+}
+
+static int on_config_signal(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)m;
+    (void)userdata;
+    (void)ret_error;
+
+    schedule_refresh(true);
+    return 0;
+}
+
+/**
+ * Match the signals that change what the cache holds
+ *
+ * Sessions coming and going (SessionManagerEvent) and their state
+ * (StatusChange) only need the sessions re-read. Anything the
+ * configuration service announces may add, remove or rename a config.
+ */
+static void subscribe_signals(void) {
+    static const struct {
+        const char *match;
+        sd_bus_message_handler_t handler;
+    } matches[] = {
+        { "type='signal',sender='net.openvpn.v3.sessions',"
+          "interface='net.openvpn.v3.sessions',member='SessionManagerEvent'",
+          on_session_signal },
+        { "type='signal',sender='net.openvpn.v3.sessions',"
+          "interface='net.openvpn.v3.sessions',member='StatusChange'",
+          on_session_signal },
+        { "type='signal',sender='net.openvpn.v3.configuration'",
+          on_config_signal },
+    };
+    for (size_t i = 0; i < G_N_ELEMENTS(matches); i++) {
+        int r = sd_bus_add_match(server->bus, &server->slots[i], matches[i].match,
+                                 matches[i].handler, NULL);
+        if (r < 0) {
+            logger_warn("Control: cannot subscribe to OpenVPN3 signals: %s", strerror(-r));
+        }
+    }
+}
+
+/* ──── Socket ──── */
+
+/**
+ * Create the socket directory, or check that an existing one is private
+ */
+static int prepare_socket_dir(const char *socket_path) {
+    char *dir = g_path_get_dirname(socket_path);
+    int r = 0;
+
+    if (mkdir(dir, 0700) < 0 && errno != EEXIST) {
+        r = -errno;
+        logger_warn("Control: cannot create %s: %s", dir, strerror(errno));
+    } else {
+        struct stat st;
+        if (lstat(dir, &st) < 0) {
+            r = -errno;
+        } else if (!S_ISDIR(st.st_mode) || st.st_uid != getuid() || (st.st_mode & 077)) {
+            logger_warn("Control: %s is not a private directory of this user", dir);
+            r = -EPERM;
+        }
+    }
+
+    g_free(dir);
+    return r;
+}
+
+/**
+ * Check whether a daemon answers on the socket
+ */
+static bool socket_in_use(const struct sockaddr_un *addr) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    bool in_use = connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) == 0;
+    close(fd);
+    return in_use;
+}
+
+/* ──── Public API ──── */
+
+/**
+ * Start listening
+ */
+int control_server_init(sd_bus *bus, const char *socket_path) {
+    if (!bus) {
+        return -EINVAL;
+    }
+    if (server) {
+        return 0;
+    }
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (!socket_path) {
+        if (control_socket_path(addr.sun_path, sizeof(addr.sun_path)) < 0) {
+            return -ENAMETOOLONG;
+        }
+    } else if (g_strlcpy(addr.sun_path, socket_path, sizeof(addr.sun_path)) >= sizeof(addr.sun_path)) {
+        return -ENAMETOOLONG;
+    }
+
+    int r = prepare_socket_dir(addr.sun_path);
+    if (r < 0) {
+        return r;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    r = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    if (r < 0 && errno == EADDRINUSE) {
+        if (socket_in_use(&addr)) {
+            logger_warn("Control: another instance is listening on %s", addr.sun_path);
+            close(fd);
+            return -EADDRINUSE;
+        }
+        /* Left behind by a daemon that did not shut down cleanly */
+        unlink(addr.sun_path);
+        r = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    }
+    if (r < 0 || chmod(addr.sun_path, 0600) < 0 || listen(fd, CONTROL_MAX_CLIENTS) < 0) {
+        int err = -errno;
+        logger_warn("Control: cannot listen on %s: %s", addr.sun_path, strerror(errno));
+        close(fd);
+        return err;
+    }
+
+    server = g_malloc0(sizeof(ControlServer));
+    server->bus = bus;
+    server->socket_path = g_strdup(addr.sun_path);
+    server->fd = fd;
+    server->clients = g_ptr_array_new_with_free_func(client_free);
+    server->config_paths = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    server->started_us = g_get_monotonic_time();
+
+    server->channel = g_io_channel_unix_new(fd);
+    server->watch_id = g_io_add_watch(server->channel, G_IO_IN, on_listen_readable, NULL);
+    connection_fsm_add_listener(on_fsm_changed, NULL);
+
+    subscribe_signals();
+    control_server_refresh();
+
+    logger_info("Control socket listening on %s", server->socket_path);
+    return 0;
+}
+
+/**
+ * Check whether a daemon answers on the socket
+ */
+bool control_server_running(const char *socket_path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (!socket_path) {
+        if (control_socket_path(addr.sun_path, sizeof(addr.sun_path)) < 0) {
+            return false;
+        }
+    } else if (g_strlcpy(addr.sun_path, socket_path, sizeof(addr.sun_path)) >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    return socket_in_use(&addr);
+}
+
+/**
+ * Re-read configs and sessions from D-Bus
+ */
+void control_server_refresh(void) {
+    if (!server) {
+        return;
+    }
+
+    VpnConfig **configs = NULL;
+    unsigned int config_count = 0;
+    if (config_list(server->bus, &configs, &config_count) < 0 || !configs) {
+        return;
+    }
+
+    g_hash_table_remove_all(server->config_paths);
+    for (unsigned int i = 0; i < config_count; i++) {
+        VpnConfig *config = configs[i];
+        if (!server->remotes_prefetched) {
+            for (unsigned int j = 0; j < config->remote_count; j++) {
+                dns_cache_prefetch(config->remotes[j].host);
+            }
+        }
+        if (!config->config_name || !config->config_path) {
+            continue;
+        }
+        g_hash_table_replace(server->config_paths, g_strdup(config->config_name),
+                             g_strdup(config->config_path));
+    }
+
+    server->remotes_prefetched = true;
+    config_list_free(configs, config_count);
+
+    sync_sessions();
+}
+
+/**
+ * Stop listening
+ */
+void control_server_cleanup(void) {
+    if (!server) {
+        return;
+    }
+
+    connection_fsm_remove_listener(on_fsm_changed, NULL);
+
+    for (size_t i = 0; i < G_N_ELEMENTS(server->slots); i++) {
+        sd_bus_slot_unref(server->slots[i]);
+    }
+    if (server->refresh_id > 0) {
+        g_source_remove(server->refresh_id);
+    }
+    if (server->watch_id > 0) {
+        g_source_remove(server->watch_id);
+    }
+    if (server->channel) {
+        g_io_channel_unref(server->channel);
+    }
+    close(server->fd);
+    unlink(server->socket_path);
+
+    g_ptr_array_free(server->clients, TRUE);
+    g_hash_table_destroy(server->config_paths);
+    g_free(server->socket_path);
+    g_free(server);
+    server = NULL;
+}
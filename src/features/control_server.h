@@ -0,0 +1,70 @@
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <systemd/sd-bus.h>
+#include <stdbool.h>
+#include <glib.h>
+#include "control_protocol.h"
+
+/**
+ * Control Socket Server
+ *
+ * Serves the JSON-lines protocol in control_protocol.h on a Unix socket
+ * for ovpn-managerctl and scripts. Only the user running the daemon may
+ * connect (checked with SO_PEERCRED).
+ *
+ * Queries are answered from the connection FSM registry and a cache of
+ * config paths, so they never wait on the system bus; only connect and
+ * disconnect make D-Bus calls. Watchers receive every FSM state change
+ * as it happens. A watcher that stops reading is dropped rather than
+ * buffered for.
+ *
+ * The cache is not polled: session signals from OpenVPN3 re-read the
+ * sessions, and signals from the configuration manager re-read the
+ * configs as well. A burst of signals is coalesced into one refresh.
+ */
+
+/* Clients served at once */
+#define CONTROL_MAX_CLIENTS 16
+
+/* Coalescing window for refreshes triggered by D-Bus signals */
+#define CONTROL_REFRESH_DELAY_MS 250
+
+/**
+ * Start listening
+ *
+ * Fails with -EADDRINUSE if another daemon answers on the socket; a
+ * stale socket file is replaced.
+ *
+ * @param bus D-Bus connection for connect/disconnect and refreshes
+ * @param socket_path Socket path, NULL for control_socket_path()
+ * @return 0 on success, negative errno on failure
+ */
+int control_server_init(sd_bus *bus, const char *socket_path);
+
+/**
+ * Check whether a daemon (headless instance) answers on the socket
+ *
+ * Lets the tray refuse to start next to a headless instance, which
+ * would otherwise run a second auto-reconnect engine.
+ *
+ * @param socket_path Socket path, NULL for control_socket_path()
+ * @return true if something accepts connections on the socket
+ */
+bool control_server_running(const char *socket_path);
+
+/**
+ * Re-read configs and sessions from D-Bus into the cache
+ *
+ * Creates an FSM for every config and syncs it with its session, the
+ * way the tray does when it is running. Called at startup and when a
+ * connect names an unknown config; signals keep the cache current.
+ */
+void control_server_refresh(void);
+
+/**
+ * Stop listening, disconnect clients and remove the socket file
+ */
+void control_server_cleanup(void);
+
+#endif /* CONTROL_SERVER_H */
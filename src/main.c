@@ -1,13 +1,26 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <signal.h>
 #include <glib.h>
 #include <gio/gio.h>
+#include <glib-unix.h>
 #include "dbus/dbus_manager.h"
+#include "dbus/signal_handlers.h"
 #include "tray.h"
 #include "ui/theme.h"
 #include "ui/dashboard.h"
+#include "monitoring/icmp_prober.h"
+#include "monitoring/ovpn_probe.h"
+#include "monitoring/dns_cache.h"
+#include "monitoring/network_monitor.h"
+#include "storage/profile_cache.h"
+#include "storage/config_storage.h"
+#include "features/auto_reconnect.h"
+#include "features/control_server.h"
 #include "utils/logger.h"
+#include "utils/connection_fsm.h"
+#include "utils/scheduler.h"
 
 /* Application ID for single-instance support */
 #define APP_ID "com.github.rennykoshy.ovpntool"
@@ -18,15 +31,17 @@ Dashboard *dashboard = NULL;  /* Non-static so tray.c can access it */
 GApplication *app = NULL;     /* Non-static so tray.c can access it */
 static DbusManager *dbus_manager = NULL;
 static TrayIcon *tray_icon = NULL;
-static guint tray_timer_id = 0;
-static guint session_timer_id = 0;
-static guint timer_update_id = 0;
-static guint dashboard_timer_id = 0;
+static AppConfig *app_config = NULL;
+static guint session_job_id = 0;
+static guint timer_job_id = 0;
 static gboolean app_held = FALSE;  /* Track if g_application_hold was called */
+static gint64 startup_begin = 0;   /* Monotonic time at process start */
 
 /* Command-line options */
 static gchar *log_level_str = NULL;
 static gint verbosity = 0;
+static gchar *log_categories_str = NULL;
+static gboolean headless = FALSE;
 
 /* Command-line option entries */
 static GOptionEntry option_entries[] = {
@@ -34,6 +49,10 @@ static GOptionEntry option_entries[] = {
       "Set log level (debug, info, warn, error). Default: warn", "LEVEL" },
     { "verbose", 'v', 0, G_OPTION_ARG_INT, &verbosity,
       "Set verbosity level (0=quiet, 1=changes only, 2=detailed, 3=debug). Default: 0", "LEVEL" },
+    { "log-categories", 'c', 0, G_OPTION_ARG_STRING, &log_categories_str,
+      "Debug/info categories to log (general, dbus, fsm, bw, ui, ping, all; '-' disables). Default: all", "LIST" },
+    { "headless", 0, 0, G_OPTION_ARG_NONE, &headless,
+      "Run without tray or windows, controlled through ovpn-managerctl", NULL },
     { NULL }
 };
 
@@ -85,25 +104,41 @@ static gint on_command_line(GApplication *application,
         verbosity = verb;
     }
 
+    /* Extract log categories if provided */
+    const gchar *categories = NULL;
+    if (g_variant_dict_lookup(options, "log-categories", "&s", &categories)) {
+        g_free(log_categories_str);
+        log_categories_str = g_strdup(categories);
+        if (dashboard) {
+            /* Already running: apply to the live logger */
+            logger_set_categories(log_categories_str);
+        }
+    }
+
     /* Activate the application (which will initialize everything) */
     g_application_activate(application);
 
     return 0;  /* Success */
 }
 
-/**
- * GTK/Tray event processing callback
- */
-static gboolean tray_update_callback(gpointer user_data) {
-    TrayIcon *tray = (TrayIcon *)user_data;
-    if (tray) {
-        tray_icon_run(tray);
-    }
-    return TRUE;  /* Continue calling */
-}
+/* Tray session poll: 1 s while connecting, 5 s normally, 10 s when idle */
+static const SchedJobSpec session_job = {
+    .name = "sessions",
+    .period_ms = { 1000, 5000, 10000 },
+    .tolerance_ms = 1000,
+    .priority = SCHED_PRIORITY_NORMAL
+};
+
+/* Tray timer labels: every second unless idle */
+static const SchedJobSpec timer_job = {
+    .name = "timers",
+    .period_ms = { 1000, 1000, 2000 },
+    .tolerance_ms = 250,
+    .priority = SCHED_PRIORITY_HIGH
+};
 
 /**
- * Session update callback - checks for session changes every 5 seconds
+ * Session update callback - checks for session changes
  * (only rebuilds menu if sessions actually changed)
  */
 static gboolean session_update_callback(gpointer user_data) {
@@ -120,7 +155,7 @@ static gboolean session_update_callback(gpointer user_data) {
 }
 
 /**
- * Timer update callback - updates timer labels every 1 second
+ * Timer update callback - updates timer labels
  * (efficient label updates, no menu rebuild)
  */
 static gboolean timer_update_callback(gpointer user_data) {
@@ -137,50 +172,90 @@ static gboolean timer_update_callback(gpointer user_data) {
 }
 
 /**
- * Dashboard update callback - updates dashboard data every 2 seconds
+ * Fold one connection into the scheduler activity level
+ */
+static void classify_connection(ConnectionFsm *fsm, void *user_data) {
+    SchedActivity *activity = user_data;
+
+    switch (connection_fsm_get_state(fsm)) {
+        case CONN_STATE_CONNECTING:
+        case CONN_STATE_RECONNECTING:
+        case CONN_STATE_AUTH_REQUIRED:
+            *activity = SCHED_ACTIVITY_ACTIVE;
+            break;
+        case CONN_STATE_CONNECTED:
+        case CONN_STATE_PAUSED:
+        case CONN_STATE_ERROR:
+            if (*activity == SCHED_ACTIVITY_IDLE) {
+                *activity = SCHED_ACTIVITY_NORMAL;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Scheduler activity: fast while a connection is changing, slow when
+ * nothing is up or on battery
  */
-static gboolean dashboard_update_callback(gpointer user_data) {
+static SchedActivity get_activity(gpointer user_data) {
     (void)user_data;
 
-    if (dashboard && dbus_manager) {
-        sd_bus *bus = dbus_manager_get_bus(dbus_manager);
-        if (bus) {
-            dashboard_update(dashboard, bus);
-        }
+    SchedActivity activity = SCHED_ACTIVITY_IDLE;
+    connection_fsm_foreach(classify_connection, &activity);
+
+    if (activity == SCHED_ACTIVITY_NORMAL && scheduler_on_battery()) {
+        activity = SCHED_ACTIVITY_IDLE;
     }
+    return activity;
+}
 
-    return TRUE;  /* Continue calling */
+/**
+ * Log how long a startup phase took and start timing the next one
+ */
+static void log_startup_phase(const char *phase, gint64 *phase_start) {
+    gint64 now = g_get_monotonic_time();
+    logger_info("Startup: %s took %.1f ms (%.1f ms since launch)", phase,
+                (now - *phase_start) / 1000.0, (now - startup_begin) / 1000.0);
+    *phase_start = now;
 }
 
 /**
- * Signal handler for SIGINT and SIGTERM
+ * SIGINT/SIGTERM handler, dispatched from the main loop
  */
-static void signal_handler(int signum) {
-    const char *signal_name = (signum == SIGINT) ? "SIGINT" : "SIGTERM";
+static gboolean on_quit_signal(gpointer user_data) {
+    const char *signal_name = (const char *)user_data;
     logger_info("Received %s, shutting down gracefully...", signal_name);
 
     if (app) {
         g_application_quit(app);
     }
+    return G_SOURCE_CONTINUE;
 }
 
 /**
  * Setup signal handlers for graceful shutdown
  */
 static void setup_signal_handlers(void) {
-    struct sigaction sa;
+    g_unix_signal_add(SIGINT, on_quit_signal, "SIGINT");
+    g_unix_signal_add(SIGTERM, on_quit_signal, "SIGTERM");
+}
 
-    sa.sa_handler = signal_handler;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
+/**
+ * Remember the last connection that came up, whichever way it was
+ * started, and let the scheduler pick its pace for the new state
+ */
+static void on_fsm_changed(ConnectionFsm *fsm, ConnectionState old_state, void *user_data) {
+    (void)user_data;
 
-    if (sigaction(SIGINT, &sa, NULL) == -1) {
-        logger_error("Failed to setup SIGINT handler");
+    if (connection_fsm_get_state(fsm) == CONN_STATE_CONNECTED &&
+        old_state != CONN_STATE_CONNECTED) {
+        config_set_last_connected(app_config, connection_fsm_get_name(fsm));
     }
 
-    if (sigaction(SIGTERM, &sa, NULL) == -1) {
-        logger_error("Failed to setup SIGTERM handler");
-    }
+    /* Poll faster as soon as a connect starts, not at the next idle-rate wakeup */
+    scheduler_update_activity();
 }
 
 /**
@@ -189,28 +264,14 @@ static void setup_signal_handlers(void) {
 static void cleanup(void) {
     logger_info("Cleaning up resources...");
 
-    /* Remove dashboard update timer */
-    if (dashboard_timer_id > 0) {
-        g_source_remove(dashboard_timer_id);
-        dashboard_timer_id = 0;
-    }
-
-    /* Remove timer update timer */
-    if (timer_update_id > 0) {
-        g_source_remove(timer_update_id);
-        timer_update_id = 0;
+    /* Remove tray update jobs */
+    if (timer_job_id > 0) {
+        scheduler_remove(timer_job_id);
+        timer_job_id = 0;
     }
-
-    /* Remove session update timer */
-    if (session_timer_id > 0) {
-        g_source_remove(session_timer_id);
-        session_timer_id = 0;
-    }
-
-    /* Remove tray update timer */
-    if (tray_timer_id > 0) {
-        g_source_remove(tray_timer_id);
-        tray_timer_id = 0;
+    if (session_job_id > 0) {
+        scheduler_remove(session_job_id);
+        session_job_id = 0;
     }
 
     /* Cleanup dashboard */
@@ -225,8 +286,21 @@ static void cleanup(void) {
         tray_icon = NULL;
     }
 
-    /* Cleanup theme system */
-    theme_cleanup();
+    /* Cleanup theme system (headless never initialized GTK) */
+    if (!headless) {
+        theme_cleanup();
+    }
+
+    /* Abort outstanding latency probes */
+    ovpn_probe_cleanup();
+    icmp_prober_cleanup();
+    dns_cache_cleanup();
+    profile_cache_cleanup();
+
+    /* Stop serving and reconnecting before the bus goes away */
+    control_server_cleanup();
+    auto_reconnect_cleanup();
+    network_monitor_cleanup();
 
     /* Cleanup D-Bus manager */
     if (dbus_manager) {
@@ -234,6 +308,20 @@ static void cleanup(void) {
         dbus_manager = NULL;
     }
 
+    /* Connection FSMs (after the bus: its signal handlers use them) */
+    connection_fsm_registry_cleanup();
+
+    /* Periodic jobs (after everything that registers them) */
+    scheduler_cleanup();
+
+    /* Write pending settings */
+    if (app_config) {
+        connection_fsm_remove_listener(on_fsm_changed, NULL);
+        config_flush(app_config);
+        app_config_free(app_config);
+        app_config = NULL;
+    }
+
     /* Cleanup main loop */
     if (main_loop) {
         g_main_loop_unref(main_loop);
@@ -246,6 +334,109 @@ static void cleanup(void) {
     logger_cleanup();
 }
 
+/**
+ * Load application settings, falling back to defaults
+ */
+static void load_settings(void) {
+    app_config = config_load(NULL);
+    if (!app_config) {
+        logger_warn("Failed to load settings, using defaults");
+        app_config = config_create_default();
+    }
+    connection_fsm_add_listener(on_fsm_changed, NULL);
+}
+
+/**
+ * Check whether the tray owns the application ID on the session bus
+ *
+ * Headless runs without claiming the ID, so GApplication does not stop
+ * it from starting next to the tray. Without a session bus there is no
+ * tray to find.
+ */
+static bool gui_instance_running(void) {
+    sd_bus *session = NULL;
+    sd_bus_error error = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = NULL;
+    int has_owner = 0;
+
+    if (sd_bus_open_user(&session) < 0) {
+        return false;
+    }
+
+    int r = sd_bus_call_method(session,
+                               "org.freedesktop.DBus",
+                               "/org/freedesktop/DBus",
+                               "org.freedesktop.DBus",
+                               "NameHasOwner",
+                               &error,
+                               &reply,
+                               "s",
+                               APP_ID);
+    if (r >= 0 && sd_bus_message_read(reply, "b", &has_owner) < 0) {
+        has_owner = 0;
+    }
+
+    sd_bus_error_free(&error);
+    sd_bus_message_unref(reply);
+    sd_bus_flush_close_unref(session);
+    return has_owner != 0;
+}
+
+/**
+ * Headless startup: D-Bus, monitoring, auto-reconnect and the control
+ * socket. GTK is never initialized, so no display is needed.
+ */
+static void activate_headless(GApplication *application, gint64 phase_start) {
+    /* Two instances would each run auto-reconnect on the same sessions */
+    if (gui_instance_running()) {
+        logger_error("The tray application is running; quit it before starting headless");
+        g_application_quit(application);
+        return;
+    }
+
+    logger_info("Initializing D-Bus manager...");
+    dbus_manager = dbus_manager_init();
+    if (!dbus_manager) {
+        logger_error("Failed to initialize D-Bus manager");
+        g_application_quit(application);
+        return;
+    }
+    log_startup_phase("D-Bus connection", &phase_start);
+
+    sd_bus *bus = dbus_manager_get_bus(dbus_manager);
+    if (!bus || !dbus_manager_check_openvpn3(dbus_manager)) {
+        logger_error("OpenVPN3 services not available; nothing to manage headless");
+        g_application_quit(application);
+        return;
+    }
+
+    load_settings();
+    signals_subscribe_status_change(bus);
+    network_monitor_init();
+    auto_reconnect_init(bus, app_config->auto_reconnect.enabled,
+                        app_config->auto_reconnect.max_attempts);
+
+    /* Also the single-instance check: the app ID is not registered */
+    int r = control_server_init(bus, NULL);
+    if (r < 0) {
+        logger_error("Failed to open control socket: %s", strerror(-r));
+        g_application_quit(application);
+        return;
+    }
+    log_startup_phase("control socket", &phase_start);
+    /* No polling: the control server refreshes on OpenVPN3 signals */
+
+    logger_info("Startup complete in %.1f ms (headless)",
+                (g_get_monotonic_time() - startup_begin) / 1000.0);
+
+    /* Nothing else keeps a windowless application alive */
+    g_application_hold(application);
+    app_held = TRUE;
+
+    logger_info("OpenVPN3 Manager running headless");
+    logger_info("Use ovpn-managerctl to list, connect and watch; Ctrl+C to quit");
+}
+
 /**
  * Application activation callback
  * Called when app is launched or when a second instance tries to launch
@@ -260,6 +451,8 @@ static void on_app_activate(GApplication *application, gpointer user_data) {
         return;
     }
 
+    gint64 phase_start = startup_begin;
+
     /* Setup signal handlers */
     setup_signal_handlers();
 
@@ -268,9 +461,26 @@ static void on_app_activate(GApplication *application, gpointer user_data) {
     /* Enable file logging for debugging (logs to ~/.local/share/ovpn-manager/app.log) */
     logger_init(true, NULL, log_level, true);
     logger_set_verbosity(verbosity);
+    if (log_categories_str) {
+        logger_set_categories(log_categories_str);
+    }
 
     logger_info("=== OpenVPN3 Manager Starting ===");
     logger_info("Log level: %d, Verbosity: %d", log_level, verbosity);
+    log_startup_phase("logger", &phase_start);
+
+    /* Headless stays off the terminal and never initializes GTK */
+    if (headless) {
+        activate_headless(application, phase_start);
+        return;
+    }
+
+    /* A headless instance already runs auto-reconnect for this user */
+    if (control_server_running(NULL)) {
+        logger_error("A headless instance is running; use ovpn-managerctl or stop it first");
+        g_application_quit(application);
+        return;
+    }
 
     /* Print banner to terminal (keep as printf for direct user output) */
     printf("OpenVPN3 Manager v0.4.0\n");
@@ -284,6 +494,17 @@ static void on_app_activate(GApplication *application, gpointer user_data) {
         g_application_quit(application);
         return;
     }
+    log_startup_phase("theme", &phase_start);
+
+    /* Initialize system tray icon first so it appears as early as possible */
+    logger_info("Initializing system tray icon...");
+    tray_icon = tray_icon_init("OpenVPN3 Manager");
+    if (!tray_icon) {
+        logger_error("Failed to initialize system tray icon");
+        g_application_quit(application);
+        return;
+    }
+    log_startup_phase("tray icon", &phase_start);
 
     /* Initialize D-Bus manager */
     logger_info("Initializing D-Bus manager...");
@@ -293,52 +514,52 @@ static void on_app_activate(GApplication *application, gpointer user_data) {
         g_application_quit(application);
         return;
     }
+    log_startup_phase("D-Bus connection", &phase_start);
 
     /* Check if OpenVPN3 is available (non-fatal warning) */
     logger_info("Checking for OpenVPN3 services...");
-    if (!dbus_manager_check_openvpn3(dbus_manager)) {
+    bool openvpn3_available = dbus_manager_check_openvpn3(dbus_manager);
+    if (!openvpn3_available) {
         logger_warn("OpenVPN3 services not available. Some features may not work.");
         logger_warn("Install openvpn3-linux if you need VPN functionality.");
     }
 
-    /* Initialize dashboard window */
-    logger_info("Initializing dashboard window...");
-    dashboard = dashboard_create();
-    if (!dashboard) {
-        logger_error("Failed to initialize dashboard window");
-        g_application_quit(application);
-        return;
+    load_settings();
+
+    /* Uplink changes; runs whether or not auto-reconnect is enabled */
+    network_monitor_init();
+
+    /* Update session list initially */
+    sd_bus *bus = dbus_manager_get_bus(dbus_manager);
+    if (openvpn3_available && bus) {
+        signals_subscribe_status_change(bus);
+        auto_reconnect_init(bus, app_config->auto_reconnect.enabled,
+                            app_config->auto_reconnect.max_attempts);
+        logger_info("Loading active VPN sessions...");
+        tray_icon_update_sessions(tray_icon, bus);
     }
+    log_startup_phase("session list", &phase_start);
 
-    /* Initialize system tray icon */
-    logger_info("Initializing system tray icon...");
-    tray_icon = tray_icon_init("OpenVPN3 Manager");
-    if (!tray_icon) {
-        logger_error("Failed to initialize system tray icon");
+    /* Dashboard window and pages are built on first show */
+    dashboard = dashboard_create();
+    if (!dashboard) {
+        logger_error("Failed to initialize dashboard");
         g_application_quit(application);
         return;
     }
-
-    /* Add timer to process GTK events (50ms = 20 times per second) */
-    tray_timer_id = g_timeout_add(50, tray_update_callback, tray_icon);
-
-    /* Update session list initially */
-    if (dbus_manager_check_openvpn3(dbus_manager)) {
-        sd_bus *bus = dbus_manager_get_bus(dbus_manager);
-        if (bus) {
-            logger_info("Loading active VPN sessions...");
-            tray_icon_update_sessions(tray_icon, bus);
-        }
+    dashboard_set_probe_concurrency(dashboard, app_config->server_probes.max_concurrent);
+    if (bus) {
+        dashboard_update(dashboard, bus);  /* Only records the bus until shown */
     }
+    /* The dashboard schedules its own refreshes while it is on screen */
 
-    /* Add timer to check for session changes every 5 seconds */
-    session_timer_id = g_timeout_add_seconds(5, session_update_callback, NULL);
+    /* Periodic tray updates share the scheduler's wakeups */
+    scheduler_set_activity_func(get_activity, NULL);
+    session_job_id = scheduler_add(&session_job, session_update_callback, NULL);
+    timer_job_id = scheduler_add(&timer_job, timer_update_callback, NULL);
 
-    /* Add timer to update timer labels every 1 second (efficient, no rebuild) */
-    timer_update_id = g_timeout_add_seconds(1, timer_update_callback, NULL);
-
-    /* Add timer to update dashboard every 2 seconds */
-    dashboard_timer_id = g_timeout_add_seconds(2, dashboard_update_callback, NULL);
+    logger_info("Startup complete in %.1f ms",
+                (g_get_monotonic_time() - startup_begin) / 1000.0);
 
     /* Hold the application - prevent it from exiting (we use tray icon, not windows) */
     g_application_hold(application);
@@ -374,8 +595,21 @@ static void on_app_shutdown(GApplication *application, gpointer user_data) {
 int main(int argc, char *argv[]) {
     int status;
 
+    startup_begin = g_get_monotonic_time();
+
+    /* A headless daemon may have no session bus to claim the app ID on;
+     * it relies on its control socket to detect a second instance, and
+     * checks for the tray on the bus itself (see activate_headless) */
+    GApplicationFlags flags = G_APPLICATION_HANDLES_COMMAND_LINE;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            flags |= G_APPLICATION_NON_UNIQUE;
+            break;
+        }
+    }
+
     /* Create GApplication for single-instance support */
-    app = g_application_new(APP_ID, G_APPLICATION_HANDLES_COMMAND_LINE);
+    app = g_application_new(APP_ID, flags);
     if (!app) {
         /* Logger not initialized yet, use fprintf */
         fprintf(stderr, "Failed to create GApplication\n");
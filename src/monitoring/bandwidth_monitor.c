@@ -1,4 +1,5 @@
 #include "bandwidth_monitor.h"
+#define LOG_CATEGORY LOG_CAT_BW
 #include "../utils/logger.h"
 #include "../dbus/session_client.h"
 #include <stdlib.h>
@@ -0,0 +1,217 @@
+#include "burst_probe.h"
+#include "ovpn_probe.h"
+#define LOG_CATEGORY LOG_CAT_PING
+#include "../utils/logger.h"
+#include <glib.h>
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * A burst in progress
+ */
+typedef struct {
+    char *hostname;
+    int port;
+    char *protocol;
+    unsigned int count;
+    unsigned int spacing_ms;
+    int timeout_ms;
+    BurstCallback callback;
+    void *user_data;
+
+    unsigned int sent;          /* Shots started */
+    unsigned int completed;     /* Shots finished */
+    int *results;               /* Per-shot RTT in ms or negative PING_* code */
+    guint spacing_id;
+
+    /* Arrival-order state for jitter and reordering */
+    int highest_arrived;        /* Highest shot index answered so far */
+    bool have_prev_transit;
+    gint64 prev_transit_us;     /* Send-to-callback time of the previous reply */
+    double transit_diff_us;     /* Sum of |D| over consecutive replies */
+    unsigned int transit_diffs;
+    unsigned int reordered;
+    int last_error;
+} BurstProbe;
+
+/**
+ * One probe of a burst
+ */
+typedef struct {
+    BurstProbe *burst;
+    unsigned int index;
+    gint64 sent_us;             /* Monotonic send time */
+} BurstShot;
+
+static void start_shot(BurstProbe *burst);
+
+/**
+ * Free a burst
+ */
+static void burst_probe_free(BurstProbe *burst) {
+    if (!burst) return;
+
+    if (burst->spacing_id > 0) {
+        g_source_remove(burst->spacing_id);
+    }
+    g_free(burst->results);
+    g_free(burst->protocol);
+    g_free(burst->hostname);
+    g_free(burst);
+}
+
+/**
+ * All shots are in - summarise and report
+ */
+static void finish_burst(BurstProbe *burst) {
+    BurstStats stats = {0};
+    double sum = 0.0;
+    double sum_sq = 0.0;
+
+    stats.sent = burst->count;
+    for (unsigned int i = 0; i < burst->count; i++) {
+        int rtt = burst->results[i];
+        if (rtt < 0) {
+            continue;
+        }
+
+        if (stats.received == 0 || rtt < stats.min_ms) stats.min_ms = rtt;
+        if (stats.received == 0 || rtt > stats.max_ms) stats.max_ms = rtt;
+        sum += rtt;
+        sum_sq += (double)rtt * rtt;
+        stats.received++;
+    }
+
+    if (stats.received > 0) {
+        stats.status = PING_SUCCESS;
+        stats.avg_ms = sum / stats.received;
+        double variance = sum_sq / stats.received - stats.avg_ms * stats.avg_ms;
+        stats.stddev_ms = variance > 0.0 ? sqrt(variance) : 0.0;
+    } else {
+        stats.status = burst->last_error < 0 ? burst->last_error : PING_TIMEOUT;
+    }
+
+    stats.loss_percent = 100.0 * (stats.sent - stats.received) / stats.sent;
+    if (burst->transit_diffs > 0) {
+        stats.jitter_ms = burst->transit_diff_us / burst->transit_diffs / 1000.0;
+    }
+    stats.reordered = burst->reordered;
+
+    if (logger_verbose(2)) {
+        logger_debug("Burst %s: %u/%u, avg %.1f ms, jitter %.2f ms, %u reordered",
+                     burst->hostname, stats.received, stats.sent, stats.avg_ms,
+                     stats.jitter_ms, stats.reordered);
+    }
+
+    burst->callback(burst->hostname, &stats, burst->user_data);
+    burst_probe_free(burst);
+}
+
+/**
+ * One shot completed
+ */
+static void on_shot_done(const char *hostname, int latency_ms, void *user_data) {
+    BurstShot *shot = (BurstShot *)user_data;
+    BurstProbe *burst = shot->burst;
+    gint64 now = g_get_monotonic_time();
+    (void)hostname;
+
+    burst->results[shot->index] = latency_ms;
+
+    if (latency_ms >= 0) {
+        /* An answer for an earlier probe after a later one's is a reorder */
+        if ((int)shot->index < burst->highest_arrived) {
+            burst->reordered++;
+        } else {
+            burst->highest_arrived = (int)shot->index;
+        }
+
+        /*
+         * RFC 3550 transit-time difference D of consecutive arrivals, from
+         * microsecond stamps. A burst gives only K-1 samples, too few for
+         * the RFC's 1/16 running estimate to settle, so take their mean.
+         */
+        gint64 transit_us = now - shot->sent_us;
+        if (burst->have_prev_transit) {
+            burst->transit_diff_us += fabs((double)(transit_us - burst->prev_transit_us));
+            burst->transit_diffs++;
+        }
+        burst->prev_transit_us = transit_us;
+        burst->have_prev_transit = true;
+    } else {
+        burst->last_error = latency_ms;
+    }
+
+    g_free(shot);
+
+    if (++burst->completed == burst->count) {
+        finish_burst(burst);
+    }
+}
+
+/**
+ * Spacing timer - send the next shot
+ */
+static gboolean on_spacing_timer(gpointer user_data) {
+    BurstProbe *burst = (BurstProbe *)user_data;
+
+    burst->spacing_id = 0;
+    start_shot(burst);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Start the next shot and arm the spacing timer for the one after
+ */
+static void start_shot(BurstProbe *burst) {
+    BurstShot *shot = g_malloc0(sizeof(BurstShot));
+    shot->burst = burst;
+    shot->index = burst->sent++;
+    shot->sent_us = g_get_monotonic_time();
+
+    /* Arm first: a shot failing synchronously may complete the burst */
+    if (burst->sent < burst->count) {
+        burst->spacing_id = g_timeout_add(burst->spacing_ms, on_spacing_timer, burst);
+    }
+
+    int r;
+    if (burst->port > 0) {
+        r = ovpn_probe_async(burst->hostname, burst->port, burst->protocol,
+                             burst->timeout_ms, on_shot_done, shot);
+    } else {
+        r = ping_host_async(burst->hostname, burst->timeout_ms, on_shot_done, shot);
+    }
+
+    if (r != PING_SUCCESS) {
+        on_shot_done(burst->hostname, r, shot);
+    }
+}
+
+/**
+ * Probe a server with a burst of probes
+ */
+int burst_probe_async(const char *hostname, int port, const char *protocol,
+                      unsigned int count, unsigned int spacing_ms, int timeout_ms,
+                      BurstCallback callback, void *user_data) {
+    if (!hostname || !callback) {
+        return PING_PARSE_ERROR;
+    }
+
+    BurstProbe *burst = g_malloc0(sizeof(BurstProbe));
+    burst->hostname = g_strdup(hostname);
+    burst->port = port;
+    burst->protocol = g_strdup(protocol);
+    burst->count = count > 0 ? count : 1;
+    burst->spacing_ms = spacing_ms;
+    burst->timeout_ms = timeout_ms;
+    burst->callback = callback;
+    burst->user_data = user_data;
+    burst->results = g_new(int, burst->count);
+    burst->highest_arrived = -1;
+
+    /* Defer the first shot so the callback never runs inside this call */
+    burst->spacing_id = g_idle_add(on_spacing_timer, burst);
+
+    return PING_SUCCESS;
+}
@@ -0,0 +1,58 @@
+#ifndef BURST_PROBE_H
+#define BURST_PROBE_H
+
+#include <stdbool.h>
+#include "ping_util.h"
+
+/**
+ * Burst Probe
+ *
+ * Sends K probes to one server at a fixed spacing and summarises them,
+ * so a single lost packet no longer reads as "Timeout" and jitter becomes
+ * visible. Each probe is an OpenVPN handshake when a port is given,
+ * otherwise an ICMP echo.
+ */
+
+/**
+ * Summary of a burst
+ */
+typedef struct {
+    int status;                 /* PING_SUCCESS, or last error if nothing came back */
+    unsigned int sent;          /* Probes sent */
+    unsigned int received;      /* Probes answered */
+    double min_ms;              /* Round-trip statistics over answered probes */
+    double avg_ms;
+    double max_ms;
+    double stddev_ms;
+    double loss_percent;        /* Unanswered probes, percent of sent */
+    double jitter_ms;           /* Mean |D| of consecutive replies (RFC 3550 transit difference) */
+    unsigned int reordered;     /* Replies that arrived after a later probe's reply */
+} BurstStats;
+
+/**
+ * Called on the main loop when every probe of a burst has completed
+ *
+ * @param hostname Host that was probed
+ * @param stats Burst summary (only valid during the callback)
+ * @param user_data Data passed to burst_probe_async
+ */
+typedef void (*BurstCallback)(const char *hostname, const BurstStats *stats, void *user_data);
+
+/**
+ * Probe a server with a burst of probes
+ *
+ * @param hostname Server hostname or IP
+ * @param port Server port (0 to probe with ICMP)
+ * @param protocol OpenVPN proto string, or NULL
+ * @param count Number of probes (K, at least 1)
+ * @param spacing_ms Delay between consecutive probes
+ * @param timeout_ms Timeout for each probe
+ * @param callback Completion callback
+ * @param user_data Data passed to callback
+ * @return PING_SUCCESS if the burst was started, negative error code on failure
+ */
+int burst_probe_async(const char *hostname, int port, const char *protocol,
+                      unsigned int count, unsigned int spacing_ms, int timeout_ms,
+                      BurstCallback callback, void *user_data);
+
+#endif /* BURST_PROBE_H */
@@ -0,0 +1,392 @@
+#include "dns_cache.h"
+#define LOG_CATEGORY LOG_CAT_PING
+#include "../utils/logger.h"
+#include <string.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+
+/* Resolver worker threads */
+#define DNS_CACHE_THREADS 4
+
+/**
+ * Pending callback
+ */
+typedef struct {
+    DnsResolveCallback callback;
+    void *user_data;
+} DnsWaiter;
+
+/**
+ * Cache entry for one hostname
+ */
+typedef struct {
+    char *hostname;
+    bool resolving;             /* Lookup queued or running */
+    bool has_result;
+    DnsResult result;
+    gint64 expires_us;          /* Monotonic expiry of result */
+    GSList *waiters;            /* DnsWaiter*, oldest last */
+    guint flush_id;             /* Idle delivering a cached result */
+} DnsEntry;
+
+/**
+ * Lookup handed to, and returned from, a worker thread
+ */
+typedef struct {
+    char *hostname;
+    gint epoch;                 /* cache.epoch when queued */
+    DnsResult result;
+} DnsJob;
+
+static struct {
+    GHashTable *entries;        /* hostname -> DnsEntry* */
+    GThreadPool *pool;
+    gint epoch;                 /* Bumped by cleanup; older jobs are dropped */
+    gint64 next_sweep_us;       /* Monotonic time of the next expiry sweep */
+} cache;
+
+/**
+ * Free a cache entry
+ */
+static void dns_entry_free(DnsEntry *entry) {
+    if (!entry) return;
+
+    if (entry->flush_id > 0) {
+        g_source_remove(entry->flush_id);
+    }
+    g_slist_free_full(entry->waiters, g_free);
+    g_free(entry->hostname);
+    g_free(entry);
+}
+
+/**
+ * Free a job
+ */
+static void dns_job_free(DnsJob *job) {
+    if (!job) return;
+
+    g_free(job->hostname);
+    g_free(job);
+}
+
+/**
+ * Invoke and drop every waiter on an entry
+ */
+static void fire_waiters(DnsEntry *entry) {
+    /* Callbacks may queue new lookups on this entry, so detach the list first */
+    GSList *waiters = g_slist_reverse(entry->waiters);
+    entry->waiters = NULL;
+
+    DnsResult result = entry->result;
+    for (GSList *l = waiters; l; l = l->next) {
+        DnsWaiter *waiter = (DnsWaiter *)l->data;
+        if (waiter->callback) {
+            waiter->callback(entry->hostname, &result, waiter->user_data);
+        }
+    }
+    g_slist_free_full(waiters, g_free);
+}
+
+/**
+ * Main loop: a worker finished a lookup
+ */
+static gboolean deliver_job(gpointer user_data) {
+    DnsJob *job = (DnsJob *)user_data;
+    DnsEntry *entry = NULL;
+
+    if (job->epoch == g_atomic_int_get(&cache.epoch) && cache.entries) {
+        entry = g_hash_table_lookup(cache.entries, job->hostname);
+    }
+    if (!entry) {
+        /* Cache was torn down while the lookup ran */
+        dns_job_free(job);
+        return G_SOURCE_REMOVE;
+    }
+
+    entry->resolving = false;
+    entry->has_result = true;
+    entry->result = job->result;
+    entry->expires_us = g_get_monotonic_time() +
+        (gint64)(job->result.error ? DNS_CACHE_NEGATIVE_TTL_SEC : DNS_CACHE_TTL_SEC) *
+        G_USEC_PER_SEC;
+
+    if (job->result.error) {
+        logger_debug("DNS: %s failed after %.1f ms: %s", entry->hostname,
+                     job->result.resolve_us / 1000.0, gai_strerror(job->result.error));
+    } else if (logger_verbose(1)) {
+        logger_debug("DNS: %s resolved in %.1f ms (%u addresses)", entry->hostname,
+                     job->result.resolve_us / 1000.0, job->result.count);
+    }
+
+    dns_job_free(job);
+    fire_waiters(entry);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Worker thread: run getaddrinfo and post the result to the main loop
+ */
+static void resolve_worker(gpointer data, gpointer pool_data) {
+    DnsJob *job = (DnsJob *)data;
+    struct addrinfo hints = {0};
+    struct addrinfo *res = NULL;
+    (void)pool_data;
+
+    /* Queued before cleanup: nobody wants the answer */
+    if (job->epoch != g_atomic_int_get(&cache.epoch)) {
+        dns_job_free(job);
+        return;
+    }
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_ADDRCONFIG;
+
+    gint64 start = g_get_monotonic_time();
+    int rc = getaddrinfo(job->hostname, NULL, &hints, &res);
+    job->result.resolve_us = g_get_monotonic_time() - start;
+    job->result.error = rc;
+
+    if (rc == 0) {
+        for (struct addrinfo *ai = res; ai && job->result.count < DNS_CACHE_MAX_ADDRS;
+             ai = ai->ai_next) {
+            if ((ai->ai_family != AF_INET && ai->ai_family != AF_INET6) ||
+                ai->ai_addrlen > sizeof(struct sockaddr_storage)) {
+                continue;
+            }
+            unsigned int i = job->result.count++;
+            memcpy(&job->result.addrs[i], ai->ai_addr, ai->ai_addrlen);
+            job->result.addr_lens[i] = ai->ai_addrlen;
+        }
+        freeaddrinfo(res);
+
+        if (job->result.count == 0) {
+            job->result.error = EAI_NODATA;
+        }
+    }
+
+    if (job->epoch != g_atomic_int_get(&cache.epoch)) {
+        dns_job_free(job);
+        return;
+    }
+    g_idle_add(deliver_job, job);
+}
+
+/**
+ * Create the cache and worker pool on first use
+ */
+static bool ensure_cache(void) {
+    if (cache.entries) {
+        return true;
+    }
+
+    GError *error = NULL;
+    cache.pool = g_thread_pool_new(resolve_worker, NULL, DNS_CACHE_THREADS, FALSE, &error);
+    if (!cache.pool) {
+        logger_error("DNS: failed to start resolver threads: %s",
+                     error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        return false;
+    }
+
+    cache.entries = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                          (GDestroyNotify)dns_entry_free);
+    return true;
+}
+
+/**
+ * Idle: deliver a fresh cached result to waiters
+ */
+static gboolean flush_entry(gpointer user_data) {
+    DnsEntry *entry = (DnsEntry *)user_data;
+
+    entry->flush_id = 0;
+    entry->result.from_cache = true;
+    fire_waiters(entry);
+    entry->result.from_cache = false;
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Whether an entry holds nothing but a result (no lookup, waiters or delivery)
+ */
+static bool entry_idle(const DnsEntry *entry) {
+    return !entry->resolving && !entry->waiters && entry->flush_id == 0;
+}
+
+/**
+ * Drop idle entries whose result has expired, at most once per sweep interval
+ */
+static void sweep_expired(void) {
+    gint64 now = g_get_monotonic_time();
+    if (now < cache.next_sweep_us) {
+        return;
+    }
+    cache.next_sweep_us = now + (gint64)DNS_CACHE_NEGATIVE_TTL_SEC * G_USEC_PER_SEC;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, cache.entries);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        DnsEntry *entry = (DnsEntry *)value;
+        if (entry_idle(entry) && (!entry->has_result || now >= entry->expires_us)) {
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+}
+
+/**
+ * Look up or create the entry for a hostname and make sure an answer is coming
+ *
+ * @return Entry, or NULL if the cache is unavailable
+ */
+static DnsEntry* request_entry(const char *hostname) {
+    if (!ensure_cache()) {
+        return NULL;
+    }
+    sweep_expired();
+
+    DnsEntry *entry = g_hash_table_lookup(cache.entries, hostname);
+    if (!entry) {
+        entry = g_malloc0(sizeof(DnsEntry));
+        entry->hostname = g_strdup(hostname);
+        g_hash_table_insert(cache.entries, entry->hostname, entry);
+    }
+
+    if (entry->resolving) {
+        return entry; /* Joins the lookup already in flight */
+    }
+
+    if (entry->has_result && g_get_monotonic_time() < entry->expires_us) {
+        return entry;
+    }
+
+    DnsJob *job = g_malloc0(sizeof(DnsJob));
+    job->hostname = g_strdup(hostname);
+    job->epoch = g_atomic_int_get(&cache.epoch);
+    entry->resolving = true;
+    g_thread_pool_push(cache.pool, job, NULL);
+
+    return entry;
+}
+
+/**
+ * Resolve a hostname, from cache when fresh
+ */
+int dns_cache_resolve(const char *hostname, DnsResolveCallback callback, void *user_data) {
+    if (!hostname || !callback) {
+        return -EINVAL;
+    }
+
+    DnsEntry *entry = request_entry(hostname);
+    if (!entry) {
+        return -ENOMEM;
+    }
+
+    DnsWaiter *waiter = g_malloc0(sizeof(DnsWaiter));
+    waiter->callback = callback;
+    waiter->user_data = user_data;
+    entry->waiters = g_slist_prepend(entry->waiters, waiter);
+
+    if (!entry->resolving && entry->flush_id == 0) {
+        entry->flush_id = g_idle_add(flush_entry, entry);
+    }
+
+    return 0;
+}
+
+/**
+ * Cancel a pending dns_cache_resolve
+ */
+void dns_cache_cancel(const char *hostname, DnsResolveCallback callback, void *user_data) {
+    if (!cache.entries || !hostname) {
+        return;
+    }
+
+    DnsEntry *entry = g_hash_table_lookup(cache.entries, hostname);
+    if (!entry) {
+        return;
+    }
+
+    for (GSList *l = entry->waiters; l; l = l->next) {
+        DnsWaiter *waiter = (DnsWaiter *)l->data;
+        if (waiter->callback == callback && waiter->user_data == user_data) {
+            entry->waiters = g_slist_delete_link(entry->waiters, l);
+            g_free(waiter);
+            return;
+        }
+    }
+}
+
+/**
+ * Warm the cache for a hostname
+ */
+void dns_cache_prefetch(const char *hostname) {
+    if (hostname) {
+        request_entry(hostname);
+    }
+}
+
+/**
+ * Get how long the last lookup of a hostname took
+ */
+gint64 dns_cache_get_resolve_time_us(const char *hostname) {
+    if (!cache.entries || !hostname) {
+        return -1;
+    }
+
+    DnsEntry *entry = g_hash_table_lookup(cache.entries, hostname);
+    if (!entry || !entry->has_result || g_get_monotonic_time() >= entry->expires_us) {
+        return -1;
+    }
+    return entry->result.resolve_us;
+}
+
+/**
+ * Drop the cached answer for a hostname
+ */
+void dns_cache_forget(const char *hostname) {
+    if (!cache.entries || !hostname) {
+        return;
+    }
+
+    DnsEntry *entry = g_hash_table_lookup(cache.entries, hostname);
+    if (entry && entry_idle(entry)) {
+        g_hash_table_remove(cache.entries, hostname);
+    }
+}
+
+/**
+ * Set the port on an address returned in a DnsResult
+ */
+void dns_result_set_port(struct sockaddr_storage *addr, int port) {
+    if (!addr) return;
+
+    if (addr->ss_family == AF_INET6) {
+        ((struct sockaddr_in6 *)addr)->sin6_port = htons((uint16_t)port);
+    } else if (addr->ss_family == AF_INET) {
+        ((struct sockaddr_in *)addr)->sin_port = htons((uint16_t)port);
+    }
+}
+
+/**
+ * Drop all entries and stop the resolver threads
+ */
+void dns_cache_cleanup(void) {
+    if (cache.pool) {
+        /* Queued jobs are still handed to the workers, which see the new
+         * epoch and free them without resolving. Running getaddrinfo calls
+         * are not waited for; their jobs are freed when they return. */
+        g_atomic_int_inc(&cache.epoch);
+        g_thread_pool_free(cache.pool, FALSE, FALSE);
+        cache.pool = NULL;
+    }
+
+    if (cache.entries) {
+        g_hash_table_destroy(cache.entries);
+        cache.entries = NULL;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <glib.h>
+#include <stdbool.h>
+#include <sys/socket.h>
+
+/**
+ * Asynchronous DNS Resolver Cache
+ *
+ * Resolves hostnames on a small worker thread pool (getaddrinfo) and
+ * caches the addresses by hostname, so probes and other callers target
+ * IPs directly instead of resolving on every attempt. Concurrent lookups
+ * for the same name share one resolution, and the time each lookup took
+ * is kept per host so DNS latency can be shown apart from network RTT.
+ *
+ * getaddrinfo() does not expose record TTLs, so successful answers are
+ * kept for DNS_CACHE_TTL_SEC and failures for DNS_CACHE_NEGATIVE_TTL_SEC.
+ */
+
+#define DNS_CACHE_MAX_ADDRS         8
+#define DNS_CACHE_TTL_SEC           300
+#define DNS_CACHE_NEGATIVE_TTL_SEC  30
+
+/**
+ * Resolution result
+ */
+typedef struct {
+    int error;                                      /* 0, or getaddrinfo EAI_* code */
+    unsigned int count;                             /* Number of addresses */
+    struct sockaddr_storage addrs[DNS_CACHE_MAX_ADDRS]; /* Port is 0 */
+    socklen_t addr_lens[DNS_CACHE_MAX_ADDRS];
+    gint64 resolve_us;                              /* How long the lookup took */
+    bool from_cache;                                /* Served without a new lookup */
+} DnsResult;
+
+/**
+ * Called on the main loop when a lookup completes
+ *
+ * @param hostname Hostname that was resolved
+ * @param result Result (only valid during the callback)
+ * @param user_data Data passed to dns_cache_resolve
+ */
+typedef void (*DnsResolveCallback)(const char *hostname, const DnsResult *result,
+                                   void *user_data);
+
+/**
+ * Resolve a hostname, from cache when fresh
+ *
+ * The callback is always invoked from the main loop, never from within
+ * this call.
+ *
+ * @param hostname Hostname or literal address
+ * @param callback Completion callback
+ * @param user_data Data passed to callback
+ * @return 0 on success, negative errno on failure
+ */
+int dns_cache_resolve(const char *hostname, DnsResolveCallback callback, void *user_data);
+
+/**
+ * Cancel a pending dns_cache_resolve; the callback will not be invoked
+ *
+ * @param hostname Hostname passed to dns_cache_resolve
+ * @param callback Callback passed to dns_cache_resolve
+ * @param user_data Data passed to dns_cache_resolve
+ */
+void dns_cache_cancel(const char *hostname, DnsResolveCallback callback, void *user_data);
+
+/**
+ * Warm the cache for a hostname without waiting for the answer
+ *
+ * @param hostname Hostname or literal address
+ */
+void dns_cache_prefetch(const char *hostname);
+
+/**
+ * Get how long the last lookup of a hostname took
+ *
+ * @param hostname Hostname
+ * @return Resolution time in microseconds, or -1 if never resolved or expired
+ */
+gint64 dns_cache_get_resolve_time_us(const char *hostname);
+
+/**
+ * Drop the cached answer for a hostname that is no longer used
+ *
+ * Entries with a lookup or callbacks in flight are kept; expired idle
+ * entries are also swept away on later lookups.
+ *
+ * @param hostname Hostname
+ */
+void dns_cache_forget(const char *hostname);
+
+/**
+ * Set the port on an address returned in a DnsResult
+ *
+ * @param addr Address (AF_INET or AF_INET6)
+ * @param port Port in host byte order
+ */
+void dns_result_set_port(struct sockaddr_storage *addr, int port);
+
+/**
+ * Drop all entries and stop the resolver threads
+ *
+ * Pending callbacks are not invoked.
+ */
+void dns_cache_cleanup(void);
+
+#endif /* DNS_CACHE_H */
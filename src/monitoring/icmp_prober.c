@@ -0,0 +1,698 @@
+#include "icmp_prober.h"
+#include "dns_cache.h"
+#define LOG_CATEGORY LOG_CAT_PING
+#include "../utils/logger.h"
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/icmp6.h>
+
+/* Echo request size, matching ping(8)'s default of 56 payload bytes */
+#define ICMP_PACKET_SIZE   64
+#define ICMP_RECV_BUFFER   1500
+#define ICMP_MAX_READS     64
+
+/* Outstanding probes are keyed by sequence, with the family in bit 16 */
+#define PROBE_KEY(family, seq) \
+    GUINT_TO_POINTER(((family) == AF_INET6 ? 0x10000u : 0u) | (guint)(seq))
+
+/**
+ * Shared ping socket for one address family
+ */
+typedef struct {
+    int family;
+    int fd;
+    GIOChannel *channel;
+    guint watch_id;
+    bool tried;                 /* socket() already attempted */
+} PingSocket;
+
+/**
+ * A single in-flight probe
+ */
+typedef struct {
+    char *hostname;
+    PingCallback callback;
+    void *user_data;
+    int timeout_ms;
+    int family;
+    guint16 sequence;
+    struct timespec sent;       /* CLOCK_REALTIME, to match SO_TIMESTAMPNS */
+    guint timeout_id;
+
+    /* Resolved addresses, tried in order until one answers */
+    struct sockaddr_storage addrs[DNS_CACHE_MAX_ADDRS];
+    socklen_t addr_lens[DNS_CACHE_MAX_ADDRS];
+    unsigned int addr_count;
+    unsigned int next_addr;
+} IcmpProbe;
+
+static struct {
+    PingSocket v4;
+    PingSocket v6;
+    GHashTable *outstanding;    /* PROBE_KEY -> IcmpProbe* */
+    GHashTable *resolving;      /* IcmpProbe* set, awaiting dns_cache */
+    guint16 next_sequence;
+} prober = {
+    .v4 = { .family = AF_INET, .fd = -1 },
+    .v6 = { .family = AF_INET6, .fd = -1 },
+};
+
+static gboolean on_socket_readable(GIOChannel *channel, GIOCondition condition,
+                                   gpointer user_data);
+
+/**
+ * Free a probe (does not touch prober tables)
+ */
+static void icmp_probe_free(IcmpProbe *probe) {
+    if (!probe) return;
+
+    if (probe->timeout_id > 0) {
+        g_source_remove(probe->timeout_id);
+    }
+    g_free(probe->hostname);
+    g_free(probe);
+}
+
+/**
+ * Open a ping socket, optionally non-blocking
+ *
+ * @return fd on success, negative errno on failure
+ */
+static int open_ping_socket(int family, bool nonblock) {
+    int protocol = family == AF_INET6 ? IPPROTO_ICMPV6 : IPPROTO_ICMP;
+    int type = SOCK_DGRAM | SOCK_CLOEXEC | (nonblock ? SOCK_NONBLOCK : 0);
+
+    int fd = socket(family, type, protocol);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0) {
+        logger_debug("SO_TIMESTAMPNS unavailable (%s), using userspace receive time",
+                     strerror(errno));
+    }
+
+    return fd;
+}
+
+/**
+ * Get the shared socket for a family, opening it on first use
+ */
+static PingSocket* get_ping_socket(int family) {
+    PingSocket *sock = family == AF_INET6 ? &prober.v6 : &prober.v4;
+
+    if (sock->tried) {
+        return sock->fd >= 0 ? sock : NULL;
+    }
+    sock->tried = true;
+
+    int fd = open_ping_socket(family, true);
+    if (fd < 0) {
+        if (fd == -EACCES || fd == -EPERM) {
+            logger_info("ICMP%s ping sockets not permitted by net.ipv4.ping_group_range, "
+                        "falling back to ping(8)", family == AF_INET6 ? "v6" : "");
+        } else {
+            logger_warn("Failed to open ICMP%s ping socket: %s",
+                        family == AF_INET6 ? "v6" : "", strerror(-fd));
+        }
+        return NULL;
+    }
+
+    sock->fd = fd;
+    sock->channel = g_io_channel_unix_new(fd);
+    sock->watch_id = g_io_add_watch(sock->channel, G_IO_IN | G_IO_ERR,
+                                    on_socket_readable, sock);
+
+    if (!prober.outstanding) {
+        prober.outstanding = g_hash_table_new(g_direct_hash, g_direct_equal);
+        prober.resolving = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+
+    logger_debug("Opened ICMP%s ping socket (fd %d)", family == AF_INET6 ? "v6" : "", fd);
+    return sock;
+}
+
+/**
+ * Check whether ping sockets can be used for an address family
+ */
+bool icmp_prober_available(int family) {
+    return get_ping_socket(family) != NULL;
+}
+
+/**
+ * Build an echo request; the kernel fills in the identifier and checksum
+ */
+static size_t build_echo_request(int family, guint16 sequence,
+                                 unsigned char packet[ICMP_PACKET_SIZE]) {
+    memset(packet, 0, ICMP_PACKET_SIZE);
+
+    if (family == AF_INET6) {
+        struct icmp6_hdr hdr = {0};
+        hdr.icmp6_type = ICMP6_ECHO_REQUEST;
+        hdr.icmp6_seq = htons(sequence);
+        memcpy(packet, &hdr, sizeof(hdr));
+    } else {
+        struct icmphdr hdr = {0};
+        hdr.type = ICMP_ECHO;
+        hdr.un.echo.sequence = htons(sequence);
+        memcpy(packet, &hdr, sizeof(hdr));
+    }
+
+    return ICMP_PACKET_SIZE;
+}
+
+/**
+ * Parse an echo reply received on a ping socket (no IP header)
+ *
+ * @return true if the datagram is an echo reply, with its sequence in *sequence
+ */
+static bool parse_echo_reply(int family, const unsigned char *buf, ssize_t len,
+                             guint16 *sequence) {
+    if (family == AF_INET6) {
+        struct icmp6_hdr hdr;
+        if (len < (ssize_t)sizeof(hdr)) return false;
+        memcpy(&hdr, buf, sizeof(hdr));
+        if (hdr.icmp6_type != ICMP6_ECHO_REPLY) return false;
+        *sequence = ntohs(hdr.icmp6_seq);
+    } else {
+        struct icmphdr hdr;
+        if (len < (ssize_t)sizeof(hdr)) return false;
+        memcpy(&hdr, buf, sizeof(hdr));
+        if (hdr.type != ICMP_ECHOREPLY) return false;
+        *sequence = ntohs(hdr.un.echo.sequence);
+    }
+
+    return true;
+}
+
+/**
+ * Receive one datagram along with its kernel RX timestamp
+ *
+ * Falls back to the current time when no SCM_TIMESTAMPNS is attached.
+ */
+static ssize_t recv_with_timestamp(int fd, unsigned char *buf, size_t size,
+                                   struct timespec *rx_time, int flags) {
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(struct timespec))];
+    } control;
+    struct iovec iov = { .iov_base = buf, .iov_len = size };
+    struct msghdr msg = {0};
+
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t len = recvmsg(fd, &msg, flags);
+    if (len < 0) {
+        return -errno;
+    }
+
+    bool have_timestamp = false;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            memcpy(rx_time, CMSG_DATA(cmsg), sizeof(*rx_time));
+            have_timestamp = true;
+            break;
+        }
+    }
+    if (!have_timestamp) {
+        clock_gettime(CLOCK_REALTIME, rx_time);
+    }
+
+    return len;
+}
+
+/**
+ * Round-trip time in milliseconds, rounded to nearest
+ */
+static int rtt_ms(const struct timespec *sent, const struct timespec *received) {
+    gint64 usec = (gint64)(received->tv_sec - sent->tv_sec) * G_USEC_PER_SEC +
+                  (received->tv_nsec - sent->tv_nsec) / 1000;
+    if (usec < 0) {
+        usec = 0; /* Wall clock stepped backwards */
+    }
+    return (int)((usec + 500) / 1000);
+}
+
+/**
+ * Finish a probe: unlink it, report the result and free it
+ */
+static void complete_probe(IcmpProbe *probe, int result) {
+    gpointer key = PROBE_KEY(probe->family, probe->sequence);
+    if (g_hash_table_lookup(prober.outstanding, key) == probe) {
+        g_hash_table_remove(prober.outstanding, key);
+    }
+
+    if (probe->callback) {
+        probe->callback(probe->hostname, result, probe->user_data);
+    }
+
+    icmp_probe_free(probe);
+}
+
+static int send_next_address(IcmpProbe *probe, int skip_family);
+
+/**
+ * Per-probe timeout - try the other address family before giving up
+ */
+static gboolean on_probe_timeout(gpointer user_data) {
+    IcmpProbe *probe = (IcmpProbe *)user_data;
+
+    probe->timeout_id = 0;
+    g_hash_table_remove(prober.outstanding, PROBE_KEY(probe->family, probe->sequence));
+
+    if (send_next_address(probe, probe->family) != PING_SUCCESS) {
+        complete_probe(probe, PING_TIMEOUT);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Drain replies from a shared ping socket
+ */
+static gboolean on_socket_readable(GIOChannel *channel, GIOCondition condition,
+                                   gpointer user_data) {
+    PingSocket *sock = (PingSocket *)user_data;
+    unsigned char buf[ICMP_RECV_BUFFER];
+    (void)channel;
+    (void)condition;
+
+    /* G_IO_ERR carries a pending ICMP error; recvmsg() reports and clears it */
+    for (int i = 0; i < ICMP_MAX_READS; i++) {
+        struct timespec rx_time;
+        ssize_t len = recv_with_timestamp(sock->fd, buf, sizeof(buf), &rx_time, MSG_DONTWAIT);
+
+        if (len == -EAGAIN || len == -EWOULDBLOCK) {
+            break;
+        }
+        if (len < 0) {
+            if (logger_verbose(2)) {
+                logger_debug("ICMP socket error: %s", strerror((int)-len));
+            }
+            continue;
+        }
+
+        guint16 sequence;
+        if (!parse_echo_reply(sock->family, buf, len, &sequence)) {
+            continue;
+        }
+
+        IcmpProbe *probe = g_hash_table_lookup(prober.outstanding,
+                                               PROBE_KEY(sock->family, sequence));
+        if (!probe) {
+            continue; /* Late reply for a probe that already timed out */
+        }
+
+        complete_probe(probe, rtt_ms(&probe->sent, &rx_time));
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Allocate a free sequence number for a family
+ */
+static bool allocate_sequence(int family, guint16 *sequence) {
+    for (guint i = 0; i <= G_MAXUINT16; i++) {
+        guint16 seq = prober.next_sequence++;
+        if (!g_hash_table_contains(prober.outstanding, PROBE_KEY(family, seq))) {
+            *sequence = seq;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Send the echo request for a resolved probe
+ *
+ * @return PING_SUCCESS if sent, negative PING_* code otherwise
+ */
+static int send_probe(IcmpProbe *probe, PingSocket *sock,
+                      const struct sockaddr *addr, socklen_t addr_len) {
+    unsigned char packet[ICMP_PACKET_SIZE];
+
+    if (!allocate_sequence(sock->family, &probe->sequence)) {
+        return PING_EXEC_ERROR;
+    }
+    probe->family = sock->family;
+
+    size_t len = build_echo_request(sock->family, probe->sequence, packet);
+
+    clock_gettime(CLOCK_REALTIME, &probe->sent);
+    if (sendto(sock->fd, packet, len, 0, addr, addr_len) < 0) {
+        int err = errno;
+        if (logger_verbose(1)) {
+            logger_debug("ICMP sendto %s failed: %s", probe->hostname, strerror(err));
+        }
+        return (err == EACCES || err == EPERM) ? PING_PERMISSION_ERR : PING_TIMEOUT;
+    }
+
+    g_hash_table_insert(prober.outstanding,
+                        PROBE_KEY(probe->family, probe->sequence), probe);
+    probe->timeout_id = g_timeout_add(probe->timeout_ms, on_probe_timeout, probe);
+
+    return PING_SUCCESS;
+}
+
+/**
+ * Send to the next resolved address that has a usable ping socket
+ *
+ * Addresses that fail to send (e.g. IPv6 without a route) are skipped
+ * at once. After a timeout, skip_family passes over the remaining
+ * addresses of the family that did not answer; they usually share its
+ * fate, and each attempt costs a full timeout.
+ *
+ * @return PING_SUCCESS if sent, otherwise the last send error, or
+ *         PING_PERMISSION_ERR if no address could be tried
+ */
+static int send_next_address(IcmpProbe *probe, int skip_family) {
+    int result = PING_PERMISSION_ERR;
+
+    while (probe->next_addr < probe->addr_count) {
+        unsigned int i = probe->next_addr++;
+        int family = probe->addrs[i].ss_family;
+        if (family == skip_family) {
+            continue;
+        }
+
+        PingSocket *sock = get_ping_socket(family);
+        if (!sock) {
+            continue;
+        }
+
+        result = send_probe(probe, sock, (const struct sockaddr *)&probe->addrs[i],
+                            probe->addr_lens[i]);
+        if (result == PING_SUCCESS) {
+            break;
+        }
+        if (logger_verbose(2)) {
+            logger_debug("ICMP probe %s: address %u of %u failed, trying next",
+                         probe->hostname, i + 1, probe->addr_count);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Name resolution finished - send to the first address we can probe
+ */
+static void on_host_resolved(const char *hostname, const DnsResult *res, void *user_data) {
+    IcmpProbe *probe = (IcmpProbe *)user_data;
+    (void)hostname;
+
+    g_hash_table_remove(prober.resolving, probe);
+
+    if (res->error) {
+        logger_debug("ICMP probe: cannot resolve %s: %s", probe->hostname,
+                     gai_strerror(res->error));
+        probe->callback(probe->hostname, PING_DNS_ERROR, probe->user_data);
+        icmp_probe_free(probe);
+        return;
+    }
+
+    probe->addr_count = MIN(res->count, DNS_CACHE_MAX_ADDRS);
+    memcpy(probe->addrs, res->addrs, sizeof(probe->addrs[0]) * probe->addr_count);
+    memcpy(probe->addr_lens, res->addr_lens, sizeof(probe->addr_lens[0]) * probe->addr_count);
+
+    int result = send_next_address(probe, AF_UNSPEC);
+    if (result != PING_SUCCESS) {
+        probe->callback(probe->hostname, result, probe->user_data);
+        icmp_probe_free(probe);
+    }
+}
+
+/**
+ * Probe a host asynchronously over the shared ping socket
+ */
+int icmp_prober_probe_async(const char *hostname, int timeout_ms,
+                            PingCallback callback, void *user_data) {
+    if (!hostname || !callback) {
+        return PING_PARSE_ERROR;
+    }
+
+    /* Opening either socket also sets up the probe tables */
+    if (!icmp_prober_available(AF_INET) && !icmp_prober_available(AF_INET6)) {
+        return PING_PERMISSION_ERR;
+    }
+
+    IcmpProbe *probe = g_malloc0(sizeof(IcmpProbe));
+    probe->hostname = g_strdup(hostname);
+    probe->callback = callback;
+    probe->user_data = user_data;
+    probe->timeout_ms = timeout_ms > 0 ? timeout_ms : 1000;
+
+    if (dns_cache_resolve(hostname, on_host_resolved, probe) < 0) {
+        icmp_probe_free(probe);
+        return PING_DNS_ERROR;
+    }
+    g_hash_table_add(prober.resolving, probe);
+
+    return PING_SUCCESS;
+}
+
+/**
+ * Blocking name lookup that can be abandoned at a deadline
+ *
+ * getaddrinfo() has no timeout, so it runs on its own thread. Whichever
+ * of the caller and the thread lets go last frees the lookup.
+ */
+typedef struct {
+    gint refs;
+    char *hostname;
+    GMutex lock;
+    GCond done_cond;
+    bool done;
+    int error;
+    struct addrinfo *result;
+} SyncLookup;
+
+static void sync_lookup_unref(SyncLookup *lookup) {
+    if (!g_atomic_int_dec_and_test(&lookup->refs)) {
+        return;
+    }
+    if (lookup->result) {
+        freeaddrinfo(lookup->result);
+    }
+    g_mutex_clear(&lookup->lock);
+    g_cond_clear(&lookup->done_cond);
+    g_free(lookup->hostname);
+    g_free(lookup);
+}
+
+static gpointer sync_lookup_thread(gpointer data) {
+    SyncLookup *lookup = (SyncLookup *)data;
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM };
+    struct addrinfo *result = NULL;
+
+    int error = getaddrinfo(lookup->hostname, NULL, &hints, &result);
+
+    g_mutex_lock(&lookup->lock);
+    lookup->error = error;
+    lookup->result = result;
+    lookup->done = true;
+    g_cond_signal(&lookup->done_cond);
+    g_mutex_unlock(&lookup->lock);
+
+    sync_lookup_unref(lookup);
+    return NULL;
+}
+
+/**
+ * Resolve a hostname, giving up at a monotonic deadline
+ *
+ * @return Addresses (free with freeaddrinfo), or NULL on failure or timeout
+ */
+static struct addrinfo* resolve_until(const char *hostname, gint64 deadline) {
+    SyncLookup *lookup = g_new0(SyncLookup, 1);
+    lookup->refs = 2;
+    lookup->hostname = g_strdup(hostname);
+    g_mutex_init(&lookup->lock);
+    g_cond_init(&lookup->done_cond);
+
+    GThread *thread = g_thread_try_new("icmp-resolve", sync_lookup_thread, lookup, NULL);
+    if (!thread) {
+        lookup->refs = 1;
+        sync_lookup_unref(lookup);
+        return NULL;
+    }
+    g_thread_unref(thread);
+
+    struct addrinfo *result = NULL;
+    g_mutex_lock(&lookup->lock);
+    while (!lookup->done) {
+        if (!g_cond_wait_until(&lookup->done_cond, &lookup->lock, deadline)) {
+            break;
+        }
+    }
+    if (lookup->done && lookup->error == 0) {
+        result = lookup->result;
+        lookup->result = NULL;
+    }
+    g_mutex_unlock(&lookup->lock);
+
+    sync_lookup_unref(lookup);
+    return result;
+}
+
+/**
+ * Probe a host synchronously using private ping sockets
+ *
+ * Every resolved address is pinged at once, one sequence number per
+ * address, and the first reply wins. Resolution and the wait for
+ * replies share the one deadline, so the call never takes much longer
+ * than timeout_ms.
+ */
+int icmp_prober_probe_sync(const char *hostname, int timeout_ms, int *latency_ms) {
+    if (!hostname || !latency_ms) {
+        return PING_PARSE_ERROR;
+    }
+
+    gint64 deadline = g_get_monotonic_time() + (gint64)timeout_ms * 1000;
+
+    struct addrinfo *result = resolve_until(hostname, deadline);
+    if (!result) {
+        return g_get_monotonic_time() >= deadline ? PING_TIMEOUT : PING_DNS_ERROR;
+    }
+
+    /* Private sockets: the kernel-assigned identifier only matches our replies */
+    struct pollfd pfds[2] = { { .fd = -1 }, { .fd = -1 } };
+    int families[2] = { AF_INET, AF_INET6 };
+    struct timespec sent[DNS_CACHE_MAX_ADDRS];
+    int ret = PING_PERMISSION_ERR;
+    guint16 sequence = 0;
+    bool sent_any = false;
+
+    for (struct addrinfo *ai = result; ai && sequence < DNS_CACHE_MAX_ADDRS; ai = ai->ai_next) {
+        int slot = ai->ai_family == AF_INET6 ? 1 : 0;
+        if (ai->ai_family != families[slot]) {
+            continue;
+        }
+        if (pfds[slot].fd < 0) {
+            int fd = open_ping_socket(ai->ai_family, false);
+            if (fd < 0) {
+                if (fd != -EACCES && fd != -EPERM && ret == PING_PERMISSION_ERR) {
+                    ret = PING_EXEC_ERROR;
+                }
+                continue;
+            }
+            pfds[slot] = (struct pollfd){ .fd = fd, .events = POLLIN };
+            ret = PING_TIMEOUT;
+        }
+
+        unsigned char packet[ICMP_PACKET_SIZE];
+        size_t len = build_echo_request(ai->ai_family, sequence + 1, packet);
+
+        clock_gettime(CLOCK_REALTIME, &sent[sequence]);
+        if (sendto(pfds[slot].fd, packet, len, 0, ai->ai_addr, ai->ai_addrlen) >= 0) {
+            sent_any = true;
+        } else if (logger_verbose(2)) {
+            logger_debug("ICMP probe %s: address %u failed: %s",
+                         hostname, sequence + 1, strerror(errno));
+        }
+        sequence++;
+    }
+    freeaddrinfo(result);
+
+    while (sent_any && ret == PING_TIMEOUT) {
+        gint64 remaining_us = deadline - g_get_monotonic_time();
+        if (remaining_us <= 0) {
+            break;
+        }
+
+        int n = poll(pfds, 2, (int)((remaining_us + 999) / 1000));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+
+        for (int slot = 0; slot < 2 && ret == PING_TIMEOUT; slot++) {
+            if (pfds[slot].fd < 0 || !(pfds[slot].revents & POLLIN)) {
+                continue;
+            }
+
+            unsigned char buf[ICMP_RECV_BUFFER];
+            struct timespec rx_time;
+            ssize_t rlen = recv_with_timestamp(pfds[slot].fd, buf, sizeof(buf),
+                                               &rx_time, MSG_DONTWAIT);
+            guint16 reply_seq;
+
+            if (rlen > 0 && parse_echo_reply(families[slot], buf, rlen, &reply_seq) &&
+                reply_seq >= 1 && reply_seq <= sequence) {
+                *latency_ms = rtt_ms(&sent[reply_seq - 1], &rx_time);
+                ret = PING_SUCCESS;
+            }
+        }
+    }
+
+    for (int slot = 0; slot < 2; slot++) {
+        if (pfds[slot].fd >= 0) {
+            close(pfds[slot].fd);
+        }
+    }
+    return ret;
+}
+
+/**
+ * Close one shared socket
+ */
+static void close_ping_socket(PingSocket *sock) {
+    if (sock->watch_id > 0) {
+        g_source_remove(sock->watch_id);
+        sock->watch_id = 0;
+    }
+    if (sock->channel) {
+        g_io_channel_unref(sock->channel);
+        sock->channel = NULL;
+    }
+    if (sock->fd >= 0) {
+        close(sock->fd);
+        sock->fd = -1;
+    }
+    sock->tried = false;
+}
+
+/**
+ * Close the shared sockets and drop any outstanding probes
+ */
+void icmp_prober_cleanup(void) {
+    if (prober.outstanding) {
+        GHashTableIter iter;
+        gpointer value;
+
+        g_hash_table_iter_init(&iter, prober.outstanding);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            icmp_probe_free((IcmpProbe *)value);
+        }
+        g_hash_table_destroy(prober.outstanding);
+        prober.outstanding = NULL;
+
+        g_hash_table_iter_init(&iter, prober.resolving);
+        while (g_hash_table_iter_next(&iter, &value, NULL)) {
+            IcmpProbe *probe = (IcmpProbe *)value;
+            dns_cache_cancel(probe->hostname, on_host_resolved, probe);
+            icmp_probe_free(probe);
+        }
+        g_hash_table_destroy(prober.resolving);
+        prober.resolving = NULL;
+    }
+
+    close_ping_socket(&prober.v4);
+    close_ping_socket(&prober.v6);
+}
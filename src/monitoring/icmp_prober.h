@@ -0,0 +1,72 @@
+#ifndef ICMP_PROBER_H
+#define ICMP_PROBER_H
+
+#include <stdbool.h>
+#include "ping_util.h"
+
+/**
+ * In-process ICMP echo prober
+ *
+ * Uses unprivileged ping sockets (SOCK_DGRAM/IPPROTO_ICMP and
+ * IPPROTO_ICMPV6) so that probing a host costs one sendto() instead of
+ * a fork/exec of ping(8). One socket per address family multiplexes all
+ * outstanding probes by sequence number; replies are matched from a
+ * single GLib fd watch and timed with kernel RX timestamps
+ * (SO_TIMESTAMPNS).
+ *
+ * The kernel only allows ping sockets for groups listed in
+ * net.ipv4.ping_group_range. When that forbids us, probes complete with
+ * PING_PERMISSION_ERR and callers are expected to fall back to ping(8).
+ */
+
+/**
+ * Check whether ping sockets can be used for an address family
+ *
+ * Opens the shared sockets on first use.
+ *
+ * @param family AF_INET or AF_INET6
+ * @return true if a ping socket is available for this family
+ */
+bool icmp_prober_available(int family);
+
+/**
+ * Probe a host asynchronously over the shared ping socket
+ *
+ * The hostname is resolved asynchronously; the callback is always invoked
+ * from the main loop, never from within this call. Resolved addresses
+ * are tried in turn, so a host is only reported down once neither
+ * address family answers.
+ *
+ * @param hostname Hostname or IP address to probe
+ * @param timeout_ms Timeout in milliseconds
+ * @param callback Called with the latency in ms, or a negative PING_* code
+ *                 (PING_PERMISSION_ERR if no ping socket is available for
+ *                 the resolved address family)
+ * @param user_data Data to pass to callback
+ * @return PING_SUCCESS if the probe was started, negative error code on failure
+ */
+int icmp_prober_probe_async(const char *hostname, int timeout_ms,
+                            PingCallback callback, void *user_data);
+
+/**
+ * Probe a host synchronously using private ping sockets
+ *
+ * Every resolved address is pinged and the first reply counts, so an
+ * unreachable first address does not make the host look down. Name
+ * resolution and the wait for replies share one deadline.
+ *
+ * @param hostname Hostname or IP address to probe
+ * @param timeout_ms Timeout in milliseconds
+ * @param latency_ms Output parameter for latency in milliseconds
+ * @return PING_SUCCESS on success, negative PING_* error code on failure
+ */
+int icmp_prober_probe_sync(const char *hostname, int timeout_ms, int *latency_ms);
+
+/**
+ * Close the shared sockets and drop any outstanding probes
+ *
+ * Callbacks of outstanding probes are not invoked.
+ */
+void icmp_prober_cleanup(void);
+
+#endif /* ICMP_PROBER_H */
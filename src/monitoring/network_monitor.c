@@ -0,0 +1,770 @@
+#include "network_monitor.h"
+#include "../utils/logger.h"
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_arp.h>
+
+#define NETLINK_RECV_BUFFER  32768
+#define NETLINK_MAX_READS    64
+#define NETLINK_MAX_LINKS    128
+
+/* From <linux/if.h>, which clashes with <net/if.h> */
+#ifndef IFF_LOWER_UP
+#define IFF_LOWER_UP 0x10000
+#endif
+
+/**
+ * Link attributes needed to judge a default route
+ */
+typedef struct {
+    int ifindex;
+    unsigned int flags;         /* IFF_* */
+    unsigned short type;        /* ARPHRD_* */
+    char name[IF_NAMESIZE];
+} LinkInfo;
+
+/**
+ * Preferred default route of one family
+ */
+typedef struct {
+    int ifindex;                /* 0 if none */
+    unsigned int priority;
+    unsigned char gateway[16];
+} DefaultRoute;
+
+/**
+ * Everything that identifies the uplink; any change is a roam
+ */
+typedef struct {
+    bool online;
+    bool tunneled4;             /* Default route of the family is on a tunnel; */
+    bool tunneled6;             /* v4/v6 then describe the route below it */
+    DefaultRoute v4;
+    DefaultRoute v6;
+    guint32 addr_hash4;         /* IPv4 addresses on the v4 uplink */
+    guint32 addr_hash6;         /* Stable IPv6 addresses on the v6 uplink */
+    char ifname[IF_NAMESIZE];
+} UplinkSnapshot;
+
+/**
+ * One change subscriber
+ */
+typedef struct {
+    NetworkChangeCallback func;
+    void *user_data;
+} Subscriber;
+
+static struct {
+    bool running;               /* Between init and cleanup */
+    int fd;
+    GIOChannel *channel;
+    guint watch_id;
+    guint debounce_id;
+    gint64 first_event_us;      /* First event of the pending burst, 0 if none */
+    guint32 dump_seq;
+    guint retry_id;             /* Pending socket reopen */
+    guint retry_ms;             /* Next reopen delay, 0 after a good read */
+
+    UplinkSnapshot current;
+    Subscriber subscribers[NETWORK_MONITOR_MAX_SUBSCRIBERS];
+} monitor = { .fd = -1 };
+
+/* ──────────────────────────────────────────────────────────────
+ * Kernel state dumps
+ * ────────────────────────────────────────────────────────────── */
+
+typedef void (*DumpFunc)(const struct nlmsghdr *nlh, void *ctx);
+
+/**
+ * Run one rtnetlink dump request on a private socket
+ *
+ * @return 0 on success, negative errno on failure
+ */
+static int netlink_dump(int type, unsigned char family, DumpFunc func, void *ctx) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    struct {
+        struct nlmsghdr nlh;
+        struct rtgenmsg gen;
+    } req = {
+        .nlh = {
+            .nlmsg_len = NLMSG_LENGTH(sizeof(struct rtgenmsg)),
+            .nlmsg_type = type,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = ++monitor.dump_seq,
+        },
+        .gen = { .rtgen_family = family },
+    };
+
+    if (send(fd, &req, req.nlh.nlmsg_len, 0) < 0) {
+        int err = -errno;
+        close(fd);
+        return err;
+    }
+
+    char *buf = g_malloc(NETLINK_RECV_BUFFER);
+    int ret = 0;
+    bool done = false;
+
+    while (!done) {
+        ssize_t len = recv(fd, buf, NETLINK_RECV_BUFFER, 0);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ret = -errno;
+            break;
+        }
+        if (len == 0) {
+            break;
+        }
+
+        for (struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+             NLMSG_OK(nlh, (unsigned int)len);
+             nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_seq != req.nlh.nlmsg_seq) {
+                continue;
+            }
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                done = true;
+                break;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                const struct nlmsgerr *err = NLMSG_DATA(nlh);
+                ret = err->error;
+                done = true;
+                break;
+            }
+            func(nlh, ctx);
+        }
+    }
+
+    g_free(buf);
+    close(fd);
+    return ret;
+}
+
+typedef struct {
+    LinkInfo links[NETLINK_MAX_LINKS];
+    unsigned int count;
+} LinkTable;
+
+static void collect_link(const struct nlmsghdr *nlh, void *ctx) {
+    LinkTable *table = ctx;
+    if (nlh->nlmsg_type != RTM_NEWLINK || table->count >= NETLINK_MAX_LINKS) {
+        return;
+    }
+
+    const struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+    LinkInfo *link = &table->links[table->count++];
+    link->ifindex = ifi->ifi_index;
+    link->flags = ifi->ifi_flags;
+    link->type = ifi->ifi_type;
+    link->name[0] = '\0';
+
+    int len = IFLA_PAYLOAD(nlh);
+    for (const struct rtattr *rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == IFLA_IFNAME) {
+            g_strlcpy(link->name, RTA_DATA(rta), sizeof(link->name));
+        }
+    }
+}
+
+static const LinkInfo* find_link(const LinkTable *table, int ifindex) {
+    for (unsigned int i = 0; i < table->count; i++) {
+        if (table->links[i].ifindex == ifindex) {
+            return &table->links[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Tunnel devices: tun (ARPHRD_NONE), PPP, WireGuard and other
+ * point-to-point links
+ */
+static bool link_is_tunnel(const LinkInfo *link) {
+    return link->type == ARPHRD_NONE || link->type == ARPHRD_PPP ||
+           (link->flags & IFF_POINTOPOINT) ||
+           g_str_has_prefix(link->name, "tun") || g_str_has_prefix(link->name, "wg");
+}
+
+typedef struct {
+    const LinkTable *links;
+    DefaultRoute v4;
+    DefaultRoute v6;
+    bool tunnel4;               /* A tunnel holds a default route of the family */
+    bool tunnel6;
+    DefaultRoute below4;        /* Best physical non-default route of each */
+    DefaultRoute below6;        /* family, for when a tunnel is the default */
+    bool below4_gw;
+    bool below6_gw;
+} RouteScan;
+
+/**
+ * Keep a physical route that could carry the tunnel
+ *
+ * Gatewayed routes (the VPN server route redirect-gateway adds) beat
+ * on-link host routes; then the lower metric wins.
+ */
+static void consider_below(RouteScan *scan, int family, int ifindex, unsigned int priority,
+                           const void *gateway, size_t gw_len) {
+    DefaultRoute *best = family == AF_INET ? &scan->below4 : &scan->below6;
+    bool *best_gw = family == AF_INET ? &scan->below4_gw : &scan->below6_gw;
+    bool has_gw = gateway != NULL;
+
+    if (best->ifindex &&
+        (*best_gw > has_gw || (*best_gw == has_gw && priority >= best->priority))) {
+        return;
+    }
+    best->ifindex = ifindex;
+    best->priority = priority;
+    *best_gw = has_gw;
+    memset(best->gateway, 0, sizeof(best->gateway));
+    if (gateway) {
+        memcpy(best->gateway, gateway, gw_len);
+    }
+}
+
+static void collect_route(const struct nlmsghdr *nlh, void *ctx) {
+    RouteScan *scan = ctx;
+    if (nlh->nlmsg_type != RTM_NEWROUTE) {
+        return;
+    }
+
+    const struct rtmsg *rtm = NLMSG_DATA(nlh);
+    if (rtm->rtm_type != RTN_UNICAST ||
+        (rtm->rtm_family != AF_INET && rtm->rtm_family != AF_INET6)) {
+        return;
+    }
+
+    unsigned int table = rtm->rtm_table;
+    int ifindex = 0;
+    unsigned int priority = 0;
+    const void *gateway = NULL;
+    size_t gw_len = rtm->rtm_family == AF_INET ? 4 : 16;
+
+    int len = RTM_PAYLOAD(nlh);
+    for (const struct rtattr *rta = RTM_RTA(rtm); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        switch (rta->rta_type) {
+            case RTA_TABLE:
+                table = *(const guint32 *)RTA_DATA(rta);
+                break;
+            case RTA_OIF:
+                ifindex = *(const int *)RTA_DATA(rta);
+                break;
+            case RTA_PRIORITY:
+                priority = *(const guint32 *)RTA_DATA(rta);
+                break;
+            case RTA_GATEWAY:
+                gateway = RTA_DATA(rta);
+                break;
+            case RTA_MULTIPATH:
+                /* First nexthop stands for the route */
+                if (!ifindex && RTA_PAYLOAD(rta) >= sizeof(struct rtnexthop)) {
+                    ifindex = ((const struct rtnexthop *)RTA_DATA(rta))->rtnh_ifindex;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (table != RT_TABLE_MAIN || ifindex <= 0) {
+        return;
+    }
+
+    const LinkInfo *link = find_link(scan->links, ifindex);
+    if (!link) {
+        return;
+    }
+    if (link_is_tunnel(link)) {
+        if (rtm->rtm_dst_len == 0) {
+            *(rtm->rtm_family == AF_INET ? &scan->tunnel4 : &scan->tunnel6) = true;
+        }
+        return;
+    }
+    /* A route over a link without carrier goes nowhere */
+    if (!(link->flags & IFF_UP) || !(link->flags & IFF_LOWER_UP)) {
+        return;
+    }
+
+    if (rtm->rtm_dst_len != 0) {
+        if (gateway || rtm->rtm_dst_len == gw_len * 8) {
+            consider_below(scan, rtm->rtm_family, ifindex, priority, gateway, gw_len);
+        }
+        return;
+    }
+
+    DefaultRoute *best = rtm->rtm_family == AF_INET ? &scan->v4 : &scan->v6;
+    if (best->ifindex && priority >= best->priority) {
+        return;
+    }
+    best->ifindex = ifindex;
+    best->priority = priority;
+    memset(best->gateway, 0, sizeof(best->gateway));
+    if (gateway) {
+        memcpy(best->gateway, gateway, gw_len);
+    }
+}
+
+typedef struct {
+    int ifindex4;
+    int ifindex6;
+    guint32 hash4;
+    guint32 hash6;
+} AddrScan;
+
+static void collect_addr(const struct nlmsghdr *nlh, void *ctx) {
+    AddrScan *scan = ctx;
+    if (nlh->nlmsg_type != RTM_NEWADDR) {
+        return;
+    }
+
+    const struct ifaddrmsg *ifa = NLMSG_DATA(nlh);
+    int ifindex = (int)ifa->ifa_index;
+    if (ifa->ifa_scope == RT_SCOPE_LINK || ifa->ifa_scope == RT_SCOPE_HOST ||
+        !((ifa->ifa_family == AF_INET && ifindex == scan->ifindex4) ||
+          (ifa->ifa_family == AF_INET6 && ifindex == scan->ifindex6))) {
+        return;
+    }
+
+    unsigned int flags = ifa->ifa_flags;
+    const struct rtattr *addr = NULL;
+    int len = IFA_PAYLOAD(nlh);
+    for (const struct rtattr *rta = IFA_RTA(ifa); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == IFA_FLAGS) {
+            flags = *(const guint32 *)RTA_DATA(rta);
+        } else if (rta->rta_type == IFA_LOCAL || (rta->rta_type == IFA_ADDRESS && !addr)) {
+            addr = rta;
+        }
+    }
+
+    /* Privacy addresses rotate on their own and do not break tunnels */
+    if (!addr || (flags & (IFA_F_TEMPORARY | IFA_F_TENTATIVE))) {
+        return;
+    }
+
+    /* FNV-1a per address, combined order-independently */
+    guint32 h = 2166136261u;
+    const unsigned char *p = RTA_DATA(addr);
+    for (size_t i = 0; i < RTA_PAYLOAD(addr); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    if (ifa->ifa_family == AF_INET) {
+        scan->hash4 ^= h;
+    } else {
+        scan->hash6 ^= h;
+    }
+}
+
+/**
+ * Read the current uplink from the kernel
+ *
+ * @return 0 on success, negative errno on failure
+ */
+static int read_uplink(UplinkSnapshot *snap) {
+    LinkTable *links = g_malloc0(sizeof(LinkTable));
+    RouteScan routes = { .links = links };
+    int r;
+
+    memset(snap, 0, sizeof(*snap));
+
+    r = netlink_dump(RTM_GETLINK, AF_UNSPEC, collect_link, links);
+    if (r == 0) {
+        r = netlink_dump(RTM_GETROUTE, AF_UNSPEC, collect_route, &routes);
+    }
+    if (r < 0) {
+        g_free(links);
+        return r;
+    }
+
+    /*
+     * With a family's default route on a tunnel, its traffic still leaves
+     * over a physical link; judge it by the routes left below the tunnel
+     */
+    if (routes.tunnel4 && !routes.v4.ifindex) {
+        snap->tunneled4 = true;
+        routes.v4 = routes.below4;
+    }
+    if (routes.tunnel6 && !routes.v6.ifindex) {
+        snap->tunneled6 = true;
+        routes.v6 = routes.below6;
+    }
+
+    snap->v4 = routes.v4;
+    snap->v6 = routes.v6;
+    snap->online = routes.v4.ifindex || routes.v6.ifindex;
+
+    if (snap->online) {
+        AddrScan addrs = { .ifindex4 = routes.v4.ifindex, .ifindex6 = routes.v6.ifindex };
+        if (netlink_dump(RTM_GETADDR, AF_UNSPEC, collect_addr, &addrs) == 0) {
+            snap->addr_hash4 = addrs.hash4;
+            snap->addr_hash6 = addrs.hash6;
+        }
+
+        const LinkInfo *link = find_link(links, routes.v4.ifindex ? routes.v4.ifindex
+                                                                  : routes.v6.ifindex);
+        if (link) {
+            g_strlcpy(snap->ifname, link->name, sizeof(snap->ifname));
+        }
+    }
+
+    g_free(links);
+    return 0;
+}
+
+static bool same_route(const DefaultRoute *a, const DefaultRoute *b) {
+    return a->ifindex == b->ifindex &&
+           memcmp(a->gateway, b->gateway, sizeof(a->gateway)) == 0;
+}
+
+/**
+ * Check that every family the old uplink had is still there unchanged
+ *
+ * Gaining a family (IPv6 router advertisement after DHCPv4) leaves
+ * existing tunnels alone, so it is not a roam. Neither is a family whose
+ * default route a tunnel took over without a physical route left below
+ * it (the VPN server is reached over the other family).
+ */
+static bool same_uplink(const UplinkSnapshot *old, const UplinkSnapshot *snap) {
+    if (old->v4.ifindex && !(snap->tunneled4 && !snap->v4.ifindex) &&
+        (!same_route(&old->v4, &snap->v4) || old->addr_hash4 != snap->addr_hash4)) {
+        return false;
+    }
+    if (old->v6.ifindex && !(snap->tunneled6 && !snap->v6.ifindex) &&
+        (!same_route(&old->v6, &snap->v6) || old->addr_hash6 != snap->addr_hash6)) {
+        return false;
+    }
+    return true;
+}
+
+static void snapshot_to_uplink(const UplinkSnapshot *snap, NetworkUplink *uplink) {
+    uplink->online = snap->online;
+    uplink->ifindex = snap->v4.ifindex ? snap->v4.ifindex : snap->v6.ifindex;
+    g_strlcpy(uplink->ifname, snap->ifname, sizeof(uplink->ifname));
+}
+
+/* ──────────────────────────────────────────────────────────────
+ * Event handling
+ * ────────────────────────────────────────────────────────────── */
+
+/**
+ * Debounce expired: re-read the uplink and report a change
+ */
+static gboolean on_debounce(gpointer user_data) {
+    (void)user_data;
+    monitor.debounce_id = 0;
+
+    gint64 waited_us = g_get_monotonic_time() - monitor.first_event_us;
+    monitor.first_event_us = 0;
+
+    UplinkSnapshot snap;
+    int r = read_uplink(&snap);
+    if (r < 0) {
+        logger_warn("Failed to read network state: %s", strerror(-r));
+        return G_SOURCE_REMOVE;
+    }
+
+    const UplinkSnapshot *old = &monitor.current;
+    NetworkChangeKind kind;
+    if (old->online && !snap.online) {
+        kind = NETWORK_CHANGE_LOST;
+    } else if (!old->online && snap.online) {
+        kind = NETWORK_CHANGE_RESTORED;
+    } else if (snap.online && !same_uplink(old, &snap)) {
+        kind = NETWORK_CHANGE_ROAMED;
+    } else {
+        /* Same uplink, possibly with a family gained */
+        monitor.current = snap;
+        if (logger_verbose(3)) {
+            logger_debug("Network events settled, uplink unchanged");
+        }
+        return G_SOURCE_REMOVE;
+    }
+
+    logger_info("Network %s: %s -> %s (%.0f ms after first event)",
+                kind == NETWORK_CHANGE_LOST ? "lost" :
+                kind == NETWORK_CHANGE_RESTORED ? "restored" : "changed",
+                old->online ? old->ifname : "offline",
+                snap.online ? snap.ifname : "offline",
+                waited_us / 1000.0);
+
+    monitor.current = snap;
+
+    NetworkUplink uplink;
+    snapshot_to_uplink(&snap, &uplink);
+    for (int i = 0; i < NETWORK_MONITOR_MAX_SUBSCRIBERS; i++) {
+        if (monitor.subscribers[i].func) {
+            monitor.subscribers[i].func(kind, &uplink, monitor.subscribers[i].user_data);
+        }
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * (Re)arm the debounce timer, bounded by NETWORK_MONITOR_DEBOUNCE_MAX_MS
+ */
+static void schedule_reread(void) {
+    gint64 now = g_get_monotonic_time();
+    if (monitor.first_event_us == 0) {
+        monitor.first_event_us = now;
+    }
+
+    gint64 deadline_ms = NETWORK_MONITOR_DEBOUNCE_MAX_MS - (now - monitor.first_event_us) / 1000;
+    guint delay_ms = (guint)CLAMP(deadline_ms, 0, NETWORK_MONITOR_DEBOUNCE_MS);
+
+    if (monitor.debounce_id > 0) {
+        g_source_remove(monitor.debounce_id);
+    }
+    monitor.debounce_id = g_timeout_add(delay_ms, on_debounce, NULL);
+}
+
+static bool is_network_event(unsigned short type) {
+    switch (type) {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+        case RTM_NEWROUTE:
+        case RTM_DELROUTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static int open_socket(void);
+
+/**
+ * Close the netlink socket
+ *
+ * @param in_watch Called from the socket's own watch, which is removed
+ *                 by returning G_SOURCE_REMOVE
+ */
+static void close_socket(bool in_watch) {
+    if (monitor.watch_id > 0 && !in_watch) {
+        g_source_remove(monitor.watch_id);
+    }
+    monitor.watch_id = 0;
+    if (monitor.channel) {
+        g_io_channel_unref(monitor.channel);
+        monitor.channel = NULL;
+    }
+    if (monitor.fd >= 0) {
+        close(monitor.fd);
+        monitor.fd = -1;
+    }
+}
+
+/**
+ * Reopen timer: try the socket again, backing off while it keeps failing
+ */
+static gboolean on_reopen(gpointer user_data) {
+    (void)user_data;
+    monitor.retry_id = 0;
+
+    if (open_socket() == 0) {
+        logger_info("Network monitor reconnected to netlink");
+        /* Events were missed while the socket was down */
+        schedule_reread();
+        return G_SOURCE_REMOVE;
+    }
+
+    monitor.retry_ms = MIN(monitor.retry_ms * 2, NETWORK_MONITOR_RETRY_MAX_MS);
+    monitor.retry_id = g_timeout_add(monitor.retry_ms, on_reopen, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Netlink socket readable: drain it and arm the re-read
+ *
+ * A socket that reports an error or hangup without yielding anything is
+ * closed and reopened later, so it cannot keep waking the main loop.
+ */
+static gboolean on_netlink_readable(GIOChannel *channel, GIOCondition condition,
+                                    gpointer user_data) {
+    (void)channel;
+    (void)user_data;
+
+    char buf[NETLINK_RECV_BUFFER];
+    bool changed = false;
+    bool progressed = false;
+    int error = 0;
+
+    for (int i = 0; i < NETLINK_MAX_READS; i++) {
+        ssize_t len = recv(monitor.fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (len < 0) {
+            if (errno == ENOBUFS) {
+                /* Overrun: events were lost, the dump will catch up */
+                changed = true;
+                progressed = true;
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                error = errno;
+                logger_warn("Netlink receive failed: %s", strerror(errno));
+            }
+            break;
+        }
+        if (len == 0) {
+            break;
+        }
+        progressed = true;
+
+        for (struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+             NLMSG_OK(nlh, (unsigned int)len);
+             nlh = NLMSG_NEXT(nlh, len)) {
+            if (is_network_event(nlh->nlmsg_type)) {
+                changed = true;
+            }
+        }
+    }
+
+    if (progressed) {
+        monitor.retry_ms = 0;
+    } else if (error || (condition & (G_IO_ERR | G_IO_HUP | G_IO_NVAL))) {
+        /* Reset only by a good read, so a socket that keeps failing backs off */
+        monitor.retry_ms = monitor.retry_ms ?
+            MIN(monitor.retry_ms * 2, NETWORK_MONITOR_RETRY_MAX_MS) : NETWORK_MONITOR_RETRY_MS;
+        logger_warn("Netlink socket failed, reopening in %u ms", monitor.retry_ms);
+        close_socket(true);
+        monitor.retry_id = g_timeout_add(monitor.retry_ms, on_reopen, NULL);
+        return G_SOURCE_REMOVE;
+    }
+
+    if (changed) {
+        schedule_reread();
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Open, subscribe and watch the netlink socket
+ *
+ * @return 0 on success, negative errno on failure
+ */
+static int open_socket(void) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0) {
+        int err = -errno;
+        logger_warn("Failed to open netlink socket: %s", strerror(errno));
+        return err;
+    }
+
+    struct sockaddr_nl addr = {
+        .nl_family = AF_NETLINK,
+        .nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR |
+                     RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE,
+    };
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = -errno;
+        logger_warn("Failed to subscribe to network changes: %s", strerror(errno));
+        close(fd);
+        return err;
+    }
+
+    monitor.fd = fd;
+    monitor.channel = g_io_channel_unix_new(fd);
+    monitor.watch_id = g_io_add_watch(monitor.channel, G_IO_IN | G_IO_ERR | G_IO_HUP,
+                                      on_netlink_readable, NULL);
+    return 0;
+}
+
+/**
+ * Open the netlink socket and read the initial uplink
+ */
+int network_monitor_init(void) {
+    if (monitor.running) {
+        return 0;
+    }
+
+    int r = open_socket();
+    if (r < 0) {
+        return r;
+    }
+    monitor.running = true;
+
+    r = read_uplink(&monitor.current);
+    if (r < 0) {
+        logger_warn("Failed to read network state: %s", strerror(-r));
+    }
+
+    logger_info("Network monitor started (uplink: %s)",
+                monitor.current.online ? monitor.current.ifname : "offline");
+    return 0;
+}
+
+/**
+ * Add a change subscriber
+ */
+int network_monitor_subscribe(NetworkChangeCallback callback, void *user_data) {
+    if (!callback) {
+        return -EINVAL;
+    }
+    if (!monitor.running) {
+        return -ENOTCONN;
+    }
+
+    for (int i = 0; i < NETWORK_MONITOR_MAX_SUBSCRIBERS; i++) {
+        if (!monitor.subscribers[i].func) {
+            monitor.subscribers[i].func = callback;
+            monitor.subscribers[i].user_data = user_data;
+            return 0;
+        }
+    }
+    return -ENOSPC;
+}
+
+/**
+ * Remove a change subscriber
+ */
+void network_monitor_unsubscribe(NetworkChangeCallback callback, void *user_data) {
+    for (int i = 0; i < NETWORK_MONITOR_MAX_SUBSCRIBERS; i++) {
+        if (monitor.subscribers[i].func == callback &&
+            monitor.subscribers[i].user_data == user_data) {
+            monitor.subscribers[i].func = NULL;
+            monitor.subscribers[i].user_data = NULL;
+        }
+    }
+}
+
+/**
+ * Get the current uplink
+ */
+void network_monitor_get_uplink(NetworkUplink *uplink) {
+    if (!uplink) {
+        return;
+    }
+    snapshot_to_uplink(&monitor.current, uplink);
+}
+
+/**
+ * Stop monitoring
+ */
+void network_monitor_cleanup(void) {
+    if (monitor.debounce_id > 0) {
+        g_source_remove(monitor.debounce_id);
+        monitor.debounce_id = 0;
+    }
+    if (monitor.retry_id > 0) {
+        g_source_remove(monitor.retry_id);
+        monitor.retry_id = 0;
+    }
+    close_socket(false);
+    monitor.running = false;
+    monitor.retry_ms = 0;
+    monitor.first_event_us = 0;
+    memset(&monitor.current, 0, sizeof(monitor.current));
+    memset(monitor.subscribers, 0, sizeof(monitor.subscribers));
+}
@@ -0,0 +1,109 @@
+#ifndef NETWORK_MONITOR_H
+#define NETWORK_MONITOR_H
+
+#include <stdbool.h>
+#include <net/if.h>
+
+/**
+ * Network Change Monitor
+ *
+ * Listens on an rtnetlink socket (link, IPv4/IPv6 address and route
+ * groups) for changes to the machine's uplink. Events are debounced,
+ * then the kernel's links, default routes and addresses are dumped to
+ * work out the uplink: the interface of the preferred non-tunnel
+ * default route with carrier, its gateway and its addresses.
+ *
+ * Subscribers are told when the uplink goes away, comes back, or is
+ * replaced by a different one (Wi-Fi roam, docking), which is what
+ * leaves a VPN tunnel talking into the void.
+ *
+ * Tunnel devices (tun, PPP, WireGuard) are ignored, so a VPN coming up
+ * never looks like a network change. When only a tunnel holds a default
+ * route (redirect-gateway without def1), the uplink is the physical link
+ * carrying the gatewayed or host routes left below it, such as the route
+ * to the VPN server; with none left the machine is offline.
+ *
+ * If the netlink socket fails, it is reopened with exponential backoff
+ * and the uplink re-read.
+ */
+
+/* Quiet time after the last event before the uplink is re-read */
+#define NETWORK_MONITOR_DEBOUNCE_MS      250
+/* Upper bound on the wait during an event storm */
+#define NETWORK_MONITOR_DEBOUNCE_MAX_MS  1000
+
+/* Delay before reopening a failed netlink socket, doubled per failure */
+#define NETWORK_MONITOR_RETRY_MS         1000
+#define NETWORK_MONITOR_RETRY_MAX_MS     60000
+
+/* Change subscribers the monitor can hold */
+#define NETWORK_MONITOR_MAX_SUBSCRIBERS  4
+
+/**
+ * Kind of uplink change
+ */
+typedef enum {
+    NETWORK_CHANGE_LOST,        /* No usable default route any more */
+    NETWORK_CHANGE_RESTORED,    /* A default route is back after a loss */
+    NETWORK_CHANGE_ROAMED       /* Uplink interface, gateway or address changed */
+} NetworkChangeKind;
+
+/**
+ * Current uplink
+ */
+typedef struct {
+    bool online;                /* A usable default route exists */
+    int ifindex;                /* Interface of the preferred default route, 0 if none */
+    char ifname[IF_NAMESIZE];   /* Its name, empty if none */
+} NetworkUplink;
+
+/**
+ * Called on the main loop after the uplink changed
+ *
+ * @param kind What changed
+ * @param uplink New uplink
+ * @param user_data Data passed to network_monitor_subscribe
+ */
+typedef void (*NetworkChangeCallback)(NetworkChangeKind kind, const NetworkUplink *uplink,
+                                      void *user_data);
+
+/**
+ * Open the netlink socket and read the initial uplink
+ *
+ * @return 0 on success, negative errno on failure
+ */
+int network_monitor_init(void);
+
+/**
+ * Add a change subscriber
+ *
+ * Subscribers are called in the order they were added.
+ *
+ * @param callback Change callback
+ * @param user_data Data passed to callback
+ * @return 0 on success, -ENOTCONN if the monitor is not running,
+ *         -ENOSPC if NETWORK_MONITOR_MAX_SUBSCRIBERS are already subscribed
+ */
+int network_monitor_subscribe(NetworkChangeCallback callback, void *user_data);
+
+/**
+ * Remove a subscriber added with the same callback and user_data
+ *
+ * @param callback Change callback
+ * @param user_data Data passed to network_monitor_subscribe
+ */
+void network_monitor_unsubscribe(NetworkChangeCallback callback, void *user_data);
+
+/**
+ * Get the current uplink
+ *
+ * @param uplink Output uplink (offline if the monitor is not running)
+ */
+void network_monitor_get_uplink(NetworkUplink *uplink);
+
+/**
+ * Close the netlink socket, cancel a pending re-read and drop subscribers
+ */
+void network_monitor_cleanup(void);
+
+#endif /* NETWORK_MONITOR_H */
@@ -0,0 +1,504 @@
+#include "ovpn_probe.h"
+#include "dns_cache.h"
+#define LOG_CATEGORY LOG_CAT_PING
+#include "../utils/logger.h"
+#include <glib.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+/* OpenVPN control channel opcodes (high 5 bits of the first byte) */
+#define P_CONTROL_HARD_RESET_CLIENT_V2  7
+#define P_CONTROL_HARD_RESET_SERVER_V2  8
+#define P_OPCODE_SHIFT                  3
+
+/* opcode + session id + ack array length + message packet id */
+#define OVPN_RESET_LEN      (1 + OVPN_SESSION_ID_LEN + 1 + 4)
+#define OVPN_TCP_FRAME_LEN  2
+#define OVPN_RECV_BUFFER    1536
+
+/**
+ * A single in-flight handshake probe
+ */
+typedef struct {
+    char *hostname;
+    int port;
+    OvpnProbeTransport transport;
+    int timeout_ms;
+    PingCallback callback;
+    void *user_data;
+
+    uint8_t session_id[OVPN_SESSION_ID_LEN];
+    int fd;
+    GIOChannel *channel;
+    guint watch_id;
+    guint timeout_id;
+    bool resolving;             /* Waiting on dns_cache */
+
+    gint64 reset_sent_us;       /* Reset written to the socket */
+
+    /* TCP stream bytes of the reply frame read so far */
+    uint8_t rx[OVPN_TCP_FRAME_LEN + OVPN_RECV_BUFFER];
+    size_t rx_len;
+
+    /* Resolved addresses, tried in order until one answers */
+    struct sockaddr_storage addrs[DNS_CACHE_MAX_ADDRS];
+    socklen_t addr_lens[DNS_CACHE_MAX_ADDRS];
+    unsigned int addr_count;
+    unsigned int next_addr;
+    int family;                 /* Family of the current attempt */
+} OvpnProbe;
+
+/* All probes that have not completed yet */
+static GHashTable *active_probes = NULL;
+
+/**
+ * Map an OpenVPN "proto" value to a transport
+ */
+OvpnProbeTransport ovpn_probe_transport_from_proto(const char *protocol) {
+    if (protocol && g_ascii_strncasecmp(protocol, "tcp", 3) == 0) {
+        return OVPN_PROBE_TCP;
+    }
+    return OVPN_PROBE_UDP;
+}
+
+/**
+ * Build a P_CONTROL_HARD_RESET_CLIENT_V2 packet
+ */
+size_t ovpn_probe_build_reset(const uint8_t session_id[OVPN_SESSION_ID_LEN],
+                              OvpnProbeTransport transport,
+                              uint8_t *buf, size_t size) {
+    size_t framing = transport == OVPN_PROBE_TCP ? OVPN_TCP_FRAME_LEN : 0;
+    size_t total = framing + OVPN_RESET_LEN;
+
+    if (!session_id || !buf || size < total) {
+        return 0;
+    }
+
+    uint8_t *p = buf;
+    if (framing) {
+        *p++ = (uint8_t)(OVPN_RESET_LEN >> 8);
+        *p++ = (uint8_t)(OVPN_RESET_LEN & 0xff);
+    }
+
+    *p++ = (uint8_t)(P_CONTROL_HARD_RESET_CLIENT_V2 << P_OPCODE_SHIFT); /* key_id 0 */
+    memcpy(p, session_id, OVPN_SESSION_ID_LEN);
+    p += OVPN_SESSION_ID_LEN;
+    *p++ = 0;                       /* No acks */
+    memset(p, 0, 4);                /* Message packet id 0 */
+
+    return total;
+}
+
+/**
+ * Check whether a packet is the server's reset reply to our session
+ *
+ * Layout: opcode | session_id[8] | ack_len | ack_id[4] * ack_len |
+ *         remote_session_id[8] (if ack_len > 0) | packet_id[4]
+ */
+bool ovpn_probe_is_reset_reply(const uint8_t *buf, size_t len,
+                               const uint8_t session_id[OVPN_SESSION_ID_LEN]) {
+    if (!buf || len < 1 + OVPN_SESSION_ID_LEN + 1) {
+        return false;
+    }
+    if ((buf[0] >> P_OPCODE_SHIFT) != P_CONTROL_HARD_RESET_SERVER_V2) {
+        return false;
+    }
+
+    size_t ack_len = buf[1 + OVPN_SESSION_ID_LEN];
+    if (ack_len == 0) {
+        return true; /* Nothing to correlate; the socket is connected to this peer */
+    }
+
+    size_t remote_sid = 1 + OVPN_SESSION_ID_LEN + 1 + ack_len * 4;
+    if (len < remote_sid + OVPN_SESSION_ID_LEN) {
+        return false;
+    }
+
+    return memcmp(buf + remote_sid, session_id, OVPN_SESSION_ID_LEN) == 0;
+}
+
+/**
+ * Close the socket of the current attempt and stop its watch and timeout
+ */
+static void close_attempt(OvpnProbe *probe) {
+    if (probe->watch_id > 0) {
+        g_source_remove(probe->watch_id);
+        probe->watch_id = 0;
+    }
+    if (probe->timeout_id > 0) {
+        g_source_remove(probe->timeout_id);
+        probe->timeout_id = 0;
+    }
+    if (probe->channel) {
+        g_io_channel_unref(probe->channel);
+        probe->channel = NULL;
+    }
+    if (probe->fd >= 0) {
+        close(probe->fd);
+        probe->fd = -1;
+    }
+}
+
+/**
+ * Free a probe and close its socket (does not touch active_probes)
+ */
+static void ovpn_probe_free(OvpnProbe *probe) {
+    if (!probe) return;
+
+    close_attempt(probe);
+    g_free(probe->hostname);
+    g_free(probe);
+}
+
+/**
+ * Finish a probe: report the result and free it
+ */
+static void complete_probe(OvpnProbe *probe, int result) {
+    if (active_probes) {
+        g_hash_table_remove(active_probes, probe);
+    }
+
+    if (logger_verbose(1)) {
+        logger_debug("OpenVPN %s probe %s:%d -> %d",
+                     probe->transport == OVPN_PROBE_TCP ? "TCP" : "UDP",
+                     probe->hostname, probe->port, result);
+    }
+
+    probe->callback(probe->hostname, result, probe->user_data);
+    ovpn_probe_free(probe);
+}
+
+/**
+ * Microseconds to milliseconds, rounded to nearest
+ */
+static int usec_to_ms(gint64 usec) {
+    return (int)((usec < 0 ? 0 : usec + 500) / 1000);
+}
+
+static int start_next_address(OvpnProbe *probe, int skip_family);
+
+/**
+ * The current address did not answer - move on, or report the host down
+ *
+ * @param timed_out After a timeout the rest of that address family is
+ *                  skipped; it usually fails the same way and each
+ *                  attempt costs a full timeout
+ */
+static void attempt_failed(OvpnProbe *probe, bool timed_out) {
+    int family = probe->family;
+
+    close_attempt(probe);
+    if (start_next_address(probe, timed_out ? family : AF_UNSPEC) < 0) {
+        complete_probe(probe, PING_TIMEOUT);
+    }
+}
+
+/**
+ * Probe timeout
+ */
+static gboolean on_probe_timeout(gpointer user_data) {
+    OvpnProbe *probe = (OvpnProbe *)user_data;
+
+    probe->timeout_id = 0;
+    attempt_failed(probe, true);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Write the reset packet and start waiting for the reply
+ */
+static int send_reset(OvpnProbe *probe) {
+    uint8_t packet[OVPN_TCP_FRAME_LEN + OVPN_RESET_LEN];
+    size_t len = ovpn_probe_build_reset(probe->session_id, probe->transport,
+                                        packet, sizeof(packet));
+
+    probe->reset_sent_us = g_get_monotonic_time();
+    if (send(probe->fd, packet, len, MSG_NOSIGNAL) != (ssize_t)len) {
+        return -errno;
+    }
+
+    return 0;
+}
+
+/**
+ * TCP reply bytes: collect one length-prefixed frame and check it
+ *
+ * A server that closes the connection instead (tls-auth or tls-crypt
+ * without our key) counts as no answer.
+ */
+static gboolean on_tcp_readable(GIOChannel *channel, GIOCondition condition,
+                                gpointer user_data) {
+    OvpnProbe *probe = (OvpnProbe *)user_data;
+    gint64 now_us = g_get_monotonic_time();
+    (void)channel;
+    (void)condition;
+
+    size_t want = OVPN_TCP_FRAME_LEN;
+    if (probe->rx_len >= OVPN_TCP_FRAME_LEN) {
+        want += ((size_t)probe->rx[0] << 8) | probe->rx[1];
+    }
+
+    ssize_t n = recv(probe->fd, probe->rx + probe->rx_len, want - probe->rx_len, MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return G_SOURCE_CONTINUE;
+    }
+    if (n <= 0) {
+        probe->watch_id = 0;
+        attempt_failed(probe, false);
+        return G_SOURCE_REMOVE;
+    }
+
+    probe->rx_len += (size_t)n;
+    if (probe->rx_len == OVPN_TCP_FRAME_LEN) {
+        size_t frame_len = ((size_t)probe->rx[0] << 8) | probe->rx[1];
+        if (frame_len == 0 || frame_len > OVPN_RECV_BUFFER) {
+            probe->watch_id = 0;
+            attempt_failed(probe, false);
+            return G_SOURCE_REMOVE;
+        }
+    }
+    if (probe->rx_len < want || want == OVPN_TCP_FRAME_LEN) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    probe->watch_id = 0;
+    if (!ovpn_probe_is_reset_reply(probe->rx + OVPN_TCP_FRAME_LEN,
+                                   probe->rx_len - OVPN_TCP_FRAME_LEN, probe->session_id)) {
+        attempt_failed(probe, false);
+        return G_SOURCE_REMOVE;
+    }
+
+    complete_probe(probe, usec_to_ms(now_us - probe->reset_sent_us));
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * TCP connect finished - send the framed reset and wait for the reply
+ */
+static gboolean on_tcp_connected(GIOChannel *channel, GIOCondition condition,
+                                 gpointer user_data) {
+    OvpnProbe *probe = (OvpnProbe *)user_data;
+    int err = 0;
+    socklen_t err_len = sizeof(err);
+    (void)channel;
+    (void)condition;
+
+    probe->watch_id = 0;
+    if (getsockopt(probe->fd, SOL_SOCKET, SO_ERROR, &err, &err_len) < 0) {
+        err = errno;
+    }
+    if (err == 0) {
+        int r = send_reset(probe);
+        err = r < 0 ? -r : 0;
+    }
+    if (err != 0) {
+        if (logger_verbose(2)) {
+            logger_debug("OpenVPN probe %s:%d: connect failed: %s",
+                         probe->hostname, probe->port, strerror(err));
+        }
+        attempt_failed(probe, false);
+        return G_SOURCE_REMOVE;
+    }
+
+    probe->watch_id = g_io_add_watch(probe->channel, G_IO_IN | G_IO_HUP | G_IO_ERR,
+                                     on_tcp_readable, probe);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * UDP reply (or ICMP port unreachable)
+ */
+static gboolean on_udp_readable(GIOChannel *channel, GIOCondition condition,
+                                gpointer user_data) {
+    OvpnProbe *probe = (OvpnProbe *)user_data;
+    gint64 now_us = g_get_monotonic_time();
+    uint8_t buf[OVPN_RECV_BUFFER];
+    (void)channel;
+    (void)condition;
+
+    ssize_t n = recv(probe->fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    if (n < 0) {
+        probe->watch_id = 0;
+        attempt_failed(probe, false);
+        return G_SOURCE_REMOVE;
+    }
+
+    if (!ovpn_probe_is_reset_reply(buf, (size_t)n, probe->session_id)) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    probe->watch_id = 0;
+    complete_probe(probe, usec_to_ms(now_us - probe->reset_sent_us));
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Open a non-blocking socket to one address and kick off the probe
+ *
+ * @return 0 on success, negative errno on failure
+ */
+static int start_probe(OvpnProbe *probe, const struct sockaddr_storage *address,
+                       socklen_t address_len) {
+    struct sockaddr_storage native = *address;
+    dns_result_set_port(&native, probe->port);
+
+    int type = (probe->transport == OVPN_PROBE_TCP ? SOCK_STREAM : SOCK_DGRAM) |
+               SOCK_NONBLOCK | SOCK_CLOEXEC;
+    probe->family = native.ss_family;
+    probe->fd = socket(native.ss_family, type, 0);
+    if (probe->fd < 0) {
+        return -errno;
+    }
+
+    probe->rx_len = 0;
+    if (connect(probe->fd, (struct sockaddr *)&native, address_len) < 0 &&
+        errno != EINPROGRESS) {
+        return -errno;
+    }
+
+    probe->channel = g_io_channel_unix_new(probe->fd);
+
+    if (probe->transport == OVPN_PROBE_TCP) {
+        probe->watch_id = g_io_add_watch(probe->channel, G_IO_OUT | G_IO_HUP | G_IO_ERR,
+                                         on_tcp_connected, probe);
+    } else {
+        int r = send_reset(probe);
+        if (r < 0) {
+            return r;
+        }
+        probe->watch_id = g_io_add_watch(probe->channel, G_IO_IN | G_IO_ERR,
+                                         on_udp_readable, probe);
+    }
+
+    probe->timeout_id = g_timeout_add(probe->timeout_ms, on_probe_timeout, probe);
+    return 0;
+}
+
+/**
+ * Start on the next resolved address that accepts a socket
+ *
+ * @return 0 if an attempt is running, otherwise the last negative errno
+ */
+static int start_next_address(OvpnProbe *probe, int skip_family) {
+    int r = -EHOSTUNREACH;
+
+    while (probe->next_addr < probe->addr_count) {
+        unsigned int i = probe->next_addr++;
+        if (probe->addrs[i].ss_family == skip_family) {
+            continue;
+        }
+
+        r = start_probe(probe, &probe->addrs[i], probe->addr_lens[i]);
+        if (r == 0) {
+            return 0;
+        }
+
+        if (logger_verbose(1)) {
+            logger_debug("OpenVPN probe %s:%d: address %u of %u failed to start: %s",
+                         probe->hostname, probe->port, i + 1, probe->addr_count,
+                         strerror(-r));
+        }
+        close_attempt(probe);
+    }
+
+    return r;
+}
+
+/**
+ * Name resolution finished
+ */
+static void on_host_resolved(const char *hostname, const DnsResult *res, void *user_data) {
+    OvpnProbe *probe = (OvpnProbe *)user_data;
+    (void)hostname;
+
+    probe->resolving = false;
+
+    if (res->error) {
+        logger_debug("OpenVPN probe: cannot resolve %s: %s", probe->hostname,
+                     gai_strerror(res->error));
+        complete_probe(probe, PING_DNS_ERROR);
+        return;
+    }
+
+    probe->addr_count = MIN(res->count, DNS_CACHE_MAX_ADDRS);
+    memcpy(probe->addrs, res->addrs, sizeof(probe->addrs[0]) * probe->addr_count);
+    memcpy(probe->addr_lens, res->addr_lens, sizeof(probe->addr_lens[0]) * probe->addr_count);
+
+    int r = start_next_address(probe, AF_UNSPEC);
+    if (r < 0) {
+        complete_probe(probe, r == -ENETUNREACH || r == -EHOSTUNREACH ||
+                              r == -ECONNREFUSED ? PING_TIMEOUT : PING_EXEC_ERROR);
+    }
+}
+
+/**
+ * Probe an OpenVPN server asynchronously
+ */
+int ovpn_probe_async(const char *hostname, int port, const char *protocol,
+                     int timeout_ms, PingCallback callback, void *user_data) {
+    if (!hostname || !callback || port <= 0 || port > 65535) {
+        return PING_PARSE_ERROR;
+    }
+
+    if (!active_probes) {
+        active_probes = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+
+    OvpnProbe *probe = g_malloc0(sizeof(OvpnProbe));
+    probe->hostname = g_strdup(hostname);
+    probe->port = port;
+    probe->transport = ovpn_probe_transport_from_proto(protocol);
+    probe->timeout_ms = timeout_ms > 0 ? timeout_ms : 2000;
+    probe->callback = callback;
+    probe->user_data = user_data;
+    probe->fd = -1;
+
+    for (int i = 0; i < OVPN_SESSION_ID_LEN; i += 4) {
+        guint32 r = g_random_int();
+        memcpy(probe->session_id + i, &r, 4);
+    }
+
+    if (dns_cache_resolve(hostname, on_host_resolved, probe) < 0) {
+        ovpn_probe_free(probe);
+        return PING_DNS_ERROR;
+    }
+    probe->resolving = true;
+    g_hash_table_add(active_probes, probe);
+
+    return PING_SUCCESS;
+}
+
+/**
+ * Abort all outstanding probes without invoking their callbacks
+ */
+void ovpn_probe_cleanup(void) {
+    if (!active_probes) {
+        return;
+    }
+
+    GHashTableIter iter;
+    gpointer key;
+
+    g_hash_table_iter_init(&iter, active_probes);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        OvpnProbe *probe = (OvpnProbe *)key;
+
+        if (probe->resolving) {
+            dns_cache_cancel(probe->hostname, on_host_resolved, probe);
+        }
+        ovpn_probe_free(probe);
+    }
+
+    g_hash_table_destroy(active_probes);
+    active_probes = NULL;
+}
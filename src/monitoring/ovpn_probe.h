@@ -0,0 +1,86 @@
+#ifndef OVPN_PROBE_H
+#define OVPN_PROBE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ping_util.h"
+
+/**
+ * OpenVPN handshake probe
+ *
+ * Measures the round trip of the first handshake packet to the
+ * configured host/port/protocol, the way the tunnel would reach it: a
+ * P_CONTROL_HARD_RESET_CLIENT_V2 is sent and the probe completes on the
+ * server's P_CONTROL_HARD_RESET_SERVER_V2, after which the socket is
+ * dropped without continuing the TLS handshake. Over TCP the reset is
+ * sent once connect() completes, both packets carry the 16-bit length
+ * framing, and the connect itself is not counted. Servers that require
+ * tls-auth/tls-crypt drop the unauthenticated reset, so they time out.
+ *
+ * Every resolved address is tried in turn before the host is reported
+ * down.
+ */
+
+#define OVPN_SESSION_ID_LEN 8
+
+/**
+ * Transport used for the probe
+ */
+typedef enum {
+    OVPN_PROBE_UDP,
+    OVPN_PROBE_TCP
+} OvpnProbeTransport;
+
+/**
+ * Map an OpenVPN "proto" value ("udp", "tcp-client", "udp6", ...) to a transport
+ *
+ * @param protocol Protocol string from the profile (NULL means udp)
+ * @return Transport to probe with
+ */
+OvpnProbeTransport ovpn_probe_transport_from_proto(const char *protocol);
+
+/**
+ * Build a P_CONTROL_HARD_RESET_CLIENT_V2 packet
+ *
+ * @param session_id Client session ID to embed
+ * @param transport OVPN_PROBE_TCP prefixes the 16-bit length framing
+ * @param buf Output buffer
+ * @param size Size of output buffer
+ * @return Packet length, or 0 if the buffer is too small
+ */
+size_t ovpn_probe_build_reset(const uint8_t session_id[OVPN_SESSION_ID_LEN],
+                              OvpnProbeTransport transport,
+                              uint8_t *buf, size_t size);
+
+/**
+ * Check whether a packet is the server's reset reply to our session
+ *
+ * @param buf Packet payload (without TCP length framing)
+ * @param len Payload length
+ * @param session_id Client session ID the reply must acknowledge
+ * @return true if this is a P_CONTROL_HARD_RESET_SERVER_V2 for session_id
+ */
+bool ovpn_probe_is_reset_reply(const uint8_t *buf, size_t len,
+                               const uint8_t session_id[OVPN_SESSION_ID_LEN]);
+
+/**
+ * Probe an OpenVPN server asynchronously
+ *
+ * @param hostname Server hostname or IP address
+ * @param port Server port
+ * @param protocol Protocol string from the profile ("udp", "tcp", ...)
+ * @param timeout_ms Timeout in milliseconds
+ * @param callback Called with the RTT in ms, or a negative PING_* code
+ * @param user_data Data to pass to callback
+ * @return PING_SUCCESS if the probe was started, negative error code on failure
+ */
+int ovpn_probe_async(const char *hostname, int port, const char *protocol,
+                     int timeout_ms, PingCallback callback, void *user_data);
+
+/**
+ * Abort all outstanding probes without invoking their callbacks
+ */
+void ovpn_probe_cleanup(void);
+
+#endif /* OVPN_PROBE_H */
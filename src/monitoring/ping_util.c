@@ -1,4 +1,6 @@
 #include "ping_util.h"
+#include "icmp_prober.h"
+#define LOG_CATEGORY LOG_CAT_PING
 #include "../utils/logger.h"
 #include <stdlib.h>
 #include <string.h>
@@ -63,7 +65,7 @@ static int parse_ping_output(const char *output, int *latency_ms) {
 /**
  * Execute ping command synchronously
  */
-int ping_host(const char *hostname, int timeout_ms, int *latency_ms) {
+static int spawn_ping_sync(const char *hostname, int timeout_ms, int *latency_ms) {
     if (!hostname || !latency_ms) {
         return PING_PARSE_ERROR;
     }
@@ -230,10 +232,10 @@ static gboolean on_stdout_data(GIOChannel *channel, GIOCondition condition, gpoi
 }
 
 /**
- * Ping a host asynchronously
+ * Spawn ping(8) asynchronously
  */
-int ping_host_async(const char *hostname, int timeout_ms,
-                    PingCallback callback, void *user_data) {
+static int spawn_ping_async(const char *hostname, int timeout_ms,
+                            PingCallback callback, void *user_data) {
     if (!hostname || !callback) {
         return PING_PARSE_ERROR;
     }
@@ -300,6 +302,81 @@ int ping_host_async(const char *hostname, int timeout_ms,
     return PING_SUCCESS;
 }
 
+/**
+ * Ping a host synchronously, preferring an unprivileged ICMP socket
+ */
+int ping_host(const char *hostname, int timeout_ms, int *latency_ms) {
+    int result = icmp_prober_probe_sync(hostname, timeout_ms, latency_ms);
+
+    if (result == PING_PERMISSION_ERR) {
+        result = spawn_ping_sync(hostname, timeout_ms, latency_ms);
+    }
+
+    return result;
+}
+
+/**
+ * Native probe context, kept so we can retry via ping(8)
+ */
+typedef struct {
+    char *hostname;
+    int timeout_ms;
+    PingCallback callback;
+    void *user_data;
+} NativePingContext;
+
+/**
+ * Native probe finished - fall back to ping(8) if the socket was refused
+ */
+static void on_native_ping_done(const char *hostname, int latency_ms, void *user_data) {
+    NativePingContext *ctx = (NativePingContext *)user_data;
+
+    if (latency_ms == PING_PERMISSION_ERR) {
+        int result = spawn_ping_async(ctx->hostname, ctx->timeout_ms,
+                                      ctx->callback, ctx->user_data);
+        if (result != PING_SUCCESS) {
+            ctx->callback(hostname, result, ctx->user_data);
+        }
+    } else {
+        ctx->callback(hostname, latency_ms, ctx->user_data);
+    }
+
+    g_free(ctx->hostname);
+    g_free(ctx);
+}
+
+/**
+ * Ping a host asynchronously
+ *
+ * Uses the shared in-process ICMP prober; ping(8) is only spawned when
+ * ping sockets are not permitted for this user.
+ */
+int ping_host_async(const char *hostname, int timeout_ms,
+                    PingCallback callback, void *user_data) {
+    if (!hostname || !callback) {
+        return PING_PARSE_ERROR;
+    }
+
+    NativePingContext *ctx = g_malloc0(sizeof(NativePingContext));
+    ctx->hostname = g_strdup(hostname);
+    ctx->timeout_ms = timeout_ms;
+    ctx->callback = callback;
+    ctx->user_data = user_data;
+
+    int result = icmp_prober_probe_async(hostname, timeout_ms, on_native_ping_done, ctx);
+    if (result == PING_SUCCESS) {
+        return PING_SUCCESS;
+    }
+
+    g_free(ctx->hostname);
+    g_free(ctx);
+
+    if (result == PING_PERMISSION_ERR) {
+        return spawn_ping_async(hostname, timeout_ms, callback, user_data);
+    }
+    return result;
+}
+
 /**
  * Extract hostname from "host:port" format
  */
@@ -16,6 +16,8 @@
 /**
  * Ping a host and return the latency
  *
+ * Uses an unprivileged ICMP ping socket when permitted, otherwise ping(8).
+ *
  * @param hostname Hostname or IP address to ping
  * @param timeout_ms Timeout in milliseconds (typically 1000-5000)
  * @param latency_ms Output parameter for latency in milliseconds
@@ -35,6 +37,9 @@ typedef void (*PingCallback)(const char *hostname, int latency_ms, void *user_da
 /**
  * Ping a host asynchronously
  *
+ * Probes share one in-process ICMP socket per address family; ping(8) is
+ * only spawned when net.ipv4.ping_group_range forbids ping sockets.
+ *
  * @param hostname Hostname or IP address to ping
  * @param timeout_ms Timeout in milliseconds
  * @param callback Function to call when ping completes
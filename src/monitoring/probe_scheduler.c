@@ -0,0 +1,525 @@
+#include "probe_scheduler.h"
+#include "ping_util.h"
+#define LOG_CATEGORY LOG_CAT_PING
+#include "../utils/logger.h"
+#include "../utils/scheduler.h"
+#include <string.h>
+#include <errno.h>
+
+/* Re-probe jitter as a fraction of the interval */
+#define PROBE_JITTER_FRACTION 0.2
+
+/**
+ * A registered target
+ */
+typedef struct {
+    char *id;
+    char *hostname;
+    int port;
+    char *protocol;
+
+    bool priority;              /* Visible/selected in the UI */
+    bool queued;                /* Waiting in one of the queues */
+    bool in_flight;             /* Probe running */
+    guint generation;           /* Changes with the address; stale results are dropped */
+    gint64 next_due_us;         /* Monotonic time of next periodic probe */
+
+    ProbeHistory history;
+} ProbeTarget;
+
+/**
+ * One running probe; outlives its target and scheduler if they go away
+ */
+typedef struct {
+    ProbeScheduler *sched;      /* NULL once the scheduler is freed */
+    char *target_id;
+    guint generation;           /* Target generation the probe was started for */
+    int start_error;            /* Failed to start; reported from an idle source */
+} ProbeRequest;
+
+struct ProbeScheduler {
+    GHashTable *targets;        /* id -> ProbeTarget* */
+    GQueue priority_queue;      /* ProbeTarget* */
+    GQueue normal_queue;        /* ProbeTarget* */
+    GPtrArray *in_flight;       /* ProbeRequest* */
+
+    unsigned int max_concurrent;
+    unsigned int interval_sec;
+    int timeout_ms;
+    unsigned int burst_count;   /* Probes per measurement */
+    unsigned int burst_spacing_ms;
+    guint tick_id;              /* Scheduler job */
+    guint next_generation;
+
+    ProbeResultCallback callback;
+    void *user_data;
+    bool dispatching;           /* Inside the subscriber callback */
+    bool free_pending;          /* Freed from the callback; done once it returns */
+};
+
+static void pump_queue(ProbeScheduler *sched);
+
+/**
+ * Free a target
+ */
+static void probe_target_free(ProbeTarget *target) {
+    if (!target) return;
+
+    g_free(target->id);
+    g_free(target->hostname);
+    g_free(target->protocol);
+    g_free(target);
+}
+
+/**
+ * Free a probe request
+ */
+static void probe_request_free(ProbeRequest *req) {
+    if (!req) return;
+
+    g_free(req->target_id);
+    g_free(req);
+}
+
+/**
+ * Append a result to a history ring
+ */
+static void history_push(ProbeHistory *history, int latency_ms) {
+    history->rtt_ms[history->next] = latency_ms;
+    history->next = (history->next + 1) % PROBE_HISTORY_SIZE;
+    if (history->count < PROBE_HISTORY_SIZE) {
+        history->count++;
+    }
+}
+
+/**
+ * Loss percentage over a history ring
+ */
+double probe_history_loss_percent(const ProbeHistory *history) {
+    if (!history || history->count == 0) {
+        return 0.0;
+    }
+
+    unsigned int lost = 0;
+    for (unsigned int i = 0; i < history->count; i++) {
+        if (history->rtt_ms[i] < 0) {
+            lost++;
+        }
+    }
+
+    return 100.0 * lost / history->count;
+}
+
+/**
+ * Next periodic probe time: interval +/- jitter from now
+ */
+static gint64 next_due_time(ProbeScheduler *sched) {
+    double jitter = g_random_double_range(-PROBE_JITTER_FRACTION, PROBE_JITTER_FRACTION);
+    gint64 interval_us = (gint64)(sched->interval_sec * (1.0 + jitter) * G_USEC_PER_SEC);
+
+    return g_get_monotonic_time() + interval_us;
+}
+
+/**
+ * Put a target on the queue matching its priority
+ */
+static void enqueue_target(ProbeScheduler *sched, ProbeTarget *target) {
+    if (target->queued || target->in_flight) {
+        return;
+    }
+
+    target->queued = true;
+    g_queue_push_tail(target->priority ? &sched->priority_queue : &sched->normal_queue,
+                      target);
+}
+
+/**
+ * Take a target off whichever queue holds it
+ */
+static void dequeue_target(ProbeScheduler *sched, ProbeTarget *target) {
+    if (!target->queued) {
+        return;
+    }
+
+    if (!g_queue_remove(&sched->priority_queue, target)) {
+        g_queue_remove(&sched->normal_queue, target);
+    }
+    target->queued = false;
+}
+
+/**
+ * Burst finished
+ */
+static void on_probe_result(const char *hostname, const BurstStats *stats, void *user_data) {
+    ProbeRequest *req = (ProbeRequest *)user_data;
+    ProbeScheduler *sched = req->sched;
+    int latency_ms = stats->status == PING_SUCCESS ? (int)(stats->avg_ms + 0.5) : stats->status;
+    (void)hostname;
+
+    if (!sched) {
+        /* Scheduler is gone */
+        probe_request_free(req);
+        return;
+    }
+
+    g_ptr_array_remove_fast(sched->in_flight, req);
+
+    /* A target removed and re-added, or given a new address, while this
+     * probe ran has a new generation; the result is not about it */
+    ProbeTarget *target = g_hash_table_lookup(sched->targets, req->target_id);
+    if (target && target->generation != req->generation) {
+        if (logger_verbose(2)) {
+            logger_debug("Probe %s: dropping result for a previous address", req->target_id);
+        }
+        target = NULL;
+    }
+    if (target) {
+        target->in_flight = false;
+        target->next_due_us = next_due_time(sched);
+        history_push(&target->history, latency_ms);
+
+        if (logger_verbose(2)) {
+            logger_debug("Probe %s (%s): %d ms, loss %.0f%%", target->id, target->hostname,
+                         latency_ms, probe_history_loss_percent(&target->history));
+        }
+
+        if (sched->callback) {
+            sched->dispatching = true;
+            sched->callback(target->id, latency_ms, stats, &target->history, sched->user_data);
+            sched->dispatching = false;
+        }
+    }
+
+    probe_request_free(req);
+
+    /* The subscriber may have freed the scheduler (its tab went away) */
+    if (sched->free_pending) {
+        probe_scheduler_free(sched);
+        return;
+    }
+    pump_queue(sched);
+}
+
+/**
+ * Report a probe that could not start as a failed measurement
+ *
+ * Runs from an idle source so the subscriber is never called from inside
+ * add_target/probe_now and the queue pump.
+ */
+static gboolean on_start_failed(gpointer user_data) {
+    ProbeRequest *req = (ProbeRequest *)user_data;
+    BurstStats stats = { .status = req->start_error, .sent = 1, .loss_percent = 100.0 };
+
+    on_probe_result(NULL, &stats, req);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Start a probe for a target
+ */
+static void start_probe(ProbeScheduler *sched, ProbeTarget *target) {
+    ProbeRequest *req = g_malloc0(sizeof(ProbeRequest));
+    req->sched = sched;
+    req->target_id = g_strdup(target->id);
+    req->generation = target->generation;
+
+    int r = burst_probe_async(target->hostname, target->port, target->protocol,
+                              sched->burst_count, sched->burst_spacing_ms,
+                              sched->timeout_ms, on_probe_result, req);
+
+    if (r != PING_SUCCESS) {
+        req->start_error = r;
+        g_idle_add(on_start_failed, req);
+    }
+
+    target->in_flight = true;
+    g_ptr_array_add(sched->in_flight, req);
+}
+
+/**
+ * Start queued probes until the concurrency window is full
+ */
+static void pump_queue(ProbeScheduler *sched) {
+    while (sched->in_flight->len < sched->max_concurrent) {
+        ProbeTarget *target = g_queue_pop_head(&sched->priority_queue);
+        if (!target) {
+            target = g_queue_pop_head(&sched->normal_queue);
+        }
+        if (!target) {
+            break;
+        }
+
+        target->queued = false;
+        start_probe(sched, target);
+    }
+}
+
+/* Re-probe times carry their own jitter, so the tick can run late */
+static const SchedJobSpec tick_job = {
+    .name = "probes",
+    .period_ms = SCHED_PERIOD(1000),
+    .tolerance_ms = 1000,
+    .priority = SCHED_PRIORITY_LOW
+};
+
+/**
+ * Periodic tick - queue targets whose re-probe time has come
+ */
+static gboolean on_scheduler_tick(gpointer user_data) {
+    ProbeScheduler *sched = (ProbeScheduler *)user_data;
+    gint64 now = g_get_monotonic_time();
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init(&iter, sched->targets);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        ProbeTarget *target = (ProbeTarget *)value;
+        if (target->next_due_us <= now) {
+            enqueue_target(sched, target);
+        }
+    }
+
+    pump_queue(sched);
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Create a probe scheduler
+ */
+ProbeScheduler* probe_scheduler_create(unsigned int max_concurrent,
+                                       unsigned int interval_sec,
+                                       int timeout_ms) {
+    ProbeScheduler *sched = g_malloc0(sizeof(ProbeScheduler));
+
+    sched->targets = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                           (GDestroyNotify)probe_target_free);
+    g_queue_init(&sched->priority_queue);
+    g_queue_init(&sched->normal_queue);
+    sched->in_flight = g_ptr_array_new();
+    sched->max_concurrent = max_concurrent > 0 ? max_concurrent : 1;
+    sched->interval_sec = interval_sec > 0 ? interval_sec : 60;
+    sched->timeout_ms = timeout_ms > 0 ? timeout_ms : 2000;
+    sched->burst_count = 1;
+    sched->tick_id = scheduler_add(&tick_job, on_scheduler_tick, sched);
+
+    return sched;
+}
+
+/**
+ * Subscribe to probe results
+ */
+void probe_scheduler_subscribe(ProbeScheduler *sched, ProbeResultCallback callback,
+                               void *user_data) {
+    if (!sched) return;
+
+    sched->callback = callback;
+    sched->user_data = user_data;
+}
+
+/**
+ * Change the concurrency window
+ */
+void probe_scheduler_set_concurrency(ProbeScheduler *sched, unsigned int max_concurrent) {
+    if (!sched) return;
+
+    sched->max_concurrent = max_concurrent > 0 ? max_concurrent : 1;
+    pump_queue(sched);
+}
+
+/**
+ * Measure each target with a burst of probes
+ */
+void probe_scheduler_set_burst(ProbeScheduler *sched, unsigned int count,
+                               unsigned int spacing_ms) {
+    if (!sched) return;
+
+    sched->burst_count = count > 0 ? count : 1;
+    sched->burst_spacing_ms = spacing_ms;
+}
+
+/**
+ * Register a target, or update its address if already registered
+ */
+int probe_scheduler_add_target(ProbeScheduler *sched, const char *target_id,
+                               const char *hostname, int port, const char *protocol) {
+    if (!sched || !target_id || !hostname) {
+        return -EINVAL;
+    }
+
+    ProbeTarget *target = g_hash_table_lookup(sched->targets, target_id);
+    if (target) {
+        if (g_strcmp0(target->hostname, hostname) != 0 || target->port != port ||
+            g_strcmp0(target->protocol, protocol) != 0) {
+            g_free(target->hostname);
+            g_free(target->protocol);
+            target->hostname = g_strdup(hostname);
+            target->protocol = g_strdup(protocol);
+            target->port = port;
+            memset(&target->history, 0, sizeof(target->history));
+
+            /* A probe of the old address may still be running; its result
+             * will be dropped, so measure the new one right away */
+            target->generation = ++sched->next_generation;
+            target->in_flight = false;
+            enqueue_target(sched, target);
+            pump_queue(sched);
+        }
+        return 0;
+    }
+
+    target = g_malloc0(sizeof(ProbeTarget));
+    target->id = g_strdup(target_id);
+    target->hostname = g_strdup(hostname);
+    target->protocol = g_strdup(protocol);
+    target->port = port;
+    target->generation = ++sched->next_generation;
+    g_hash_table_insert(sched->targets, target->id, target);
+
+    enqueue_target(sched, target);
+    pump_queue(sched);
+
+    return 0;
+}
+
+/**
+ * Unregister a target
+ */
+void probe_scheduler_remove_target(ProbeScheduler *sched, const char *target_id) {
+    if (!sched || !target_id) return;
+
+    ProbeTarget *target = g_hash_table_lookup(sched->targets, target_id);
+    if (!target) return;
+
+    dequeue_target(sched, target);
+    g_hash_table_remove(sched->targets, target_id);
+}
+
+/**
+ * Mark a target as priority or normal
+ */
+void probe_scheduler_set_priority(ProbeScheduler *sched, const char *target_id,
+                                  bool priority) {
+    if (!sched || !target_id) return;
+
+    ProbeTarget *target = g_hash_table_lookup(sched->targets, target_id);
+    if (!target || target->priority == priority) return;
+
+    bool was_queued = target->queued;
+    dequeue_target(sched, target);
+    target->priority = priority;
+    if (was_queued) {
+        enqueue_target(sched, target);
+    }
+}
+
+/**
+ * Clear the priority flag on every target
+ */
+void probe_scheduler_clear_priorities(ProbeScheduler *sched) {
+    if (!sched) return;
+
+    GList *prioritized = g_queue_peek_head_link(&sched->priority_queue);
+    for (GList *l = prioritized; l; l = l->next) {
+        g_queue_push_tail(&sched->normal_queue, l->data);
+    }
+    g_queue_clear(&sched->priority_queue);
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, sched->targets);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        ((ProbeTarget *)value)->priority = false;
+    }
+}
+
+/**
+ * Queue a target ahead of its schedule
+ */
+void probe_scheduler_probe_now(ProbeScheduler *sched, const char *target_id) {
+    if (!sched || !target_id) return;
+
+    ProbeTarget *target = g_hash_table_lookup(sched->targets, target_id);
+    if (!target || target->in_flight) return;
+
+    /* Jump the queue regardless of priority */
+    dequeue_target(sched, target);
+    target->queued = true;
+    g_queue_push_head(&sched->priority_queue, target);
+    pump_queue(sched);
+}
+
+/**
+ * Queue every target ahead of schedule
+ */
+void probe_scheduler_probe_all_now(ProbeScheduler *sched) {
+    if (!sched) return;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, sched->targets);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        enqueue_target(sched, (ProbeTarget *)value);
+    }
+
+    pump_queue(sched);
+}
+
+/**
+ * Pause or resume periodic re-probing
+ */
+void probe_scheduler_set_paused(ProbeScheduler *sched, bool paused) {
+    if (!sched) return;
+
+    if (paused) {
+        if (sched->tick_id > 0) {
+            scheduler_remove(sched->tick_id);
+            sched->tick_id = 0;
+        }
+        return;
+    }
+
+    if (sched->tick_id == 0) {
+        sched->tick_id = scheduler_add(&tick_job, on_scheduler_tick, sched);
+        on_scheduler_tick(sched);   /* Catch up on targets that fell due */
+    }
+}
+
+/**
+ * Get a target's history
+ */
+const ProbeHistory* probe_scheduler_get_history(ProbeScheduler *sched, const char *target_id) {
+    if (!sched || !target_id) return NULL;
+
+    ProbeTarget *target = g_hash_table_lookup(sched->targets, target_id);
+    return target ? &target->history : NULL;
+}
+
+/**
+ * Free the scheduler
+ */
+void probe_scheduler_free(ProbeScheduler *sched) {
+    if (!sched) return;
+
+    /* Called from the result callback: finish once it has returned */
+    if (sched->dispatching) {
+        sched->free_pending = true;
+        sched->callback = NULL;
+        return;
+    }
+
+    if (sched->tick_id > 0) {
+        scheduler_remove(sched->tick_id);
+    }
+
+    /* Running probes still hold their requests; detach them */
+    for (guint i = 0; i < sched->in_flight->len; i++) {
+        ProbeRequest *req = g_ptr_array_index(sched->in_flight, i);
+        req->sched = NULL;
+    }
+    g_ptr_array_free(sched->in_flight, TRUE);
+
+    g_queue_clear(&sched->priority_queue);
+    g_queue_clear(&sched->normal_queue);
+    g_hash_table_destroy(sched->targets);
+    g_free(sched);
+}
@@ -0,0 +1,189 @@
+#ifndef PROBE_SCHEDULER_H
+#define PROBE_SCHEDULER_H
+
+#include <glib.h>
+#include <stdbool.h>
+#include "burst_probe.h"
+
+/**
+ * Probe Scheduler
+ *
+ * Keeps every registered server measured continuously at bounded cost:
+ * targets wait in a work queue, at most a fixed number of probes run at
+ * once, and each target is re-probed periodically with jitter so probes
+ * do not synchronise. Priority targets (visible or selected rows) are
+ * served before the rest of the queue.
+ *
+ * Probes use the OpenVPN handshake when a port is known, ICMP otherwise.
+ * Each measurement is a burst of one or more probes (see burst_probe.h).
+ */
+
+/* Number of results kept per target */
+#define PROBE_HISTORY_SIZE 32
+
+/**
+ * Per-target RTT/loss history ring
+ */
+typedef struct {
+    int rtt_ms[PROBE_HISTORY_SIZE];  /* Mean burst RTT in ms, or negative PING_* code */
+    unsigned int count;              /* Valid entries (<= PROBE_HISTORY_SIZE) */
+    unsigned int next;               /* Next slot to write */
+} ProbeHistory;
+
+/**
+ * Called on the main loop whenever a probe for a target completes
+ *
+ * Never called from within a probe_scheduler_* call, including for
+ * probes that fail to start. Results of probes started before the
+ * target was removed, re-added or readdressed are not reported.
+ *
+ * @param target_id Target identifier given to probe_scheduler_add_target
+ * @param latency_ms Mean latency in ms, or negative PING_* error code
+ * @param stats Full burst statistics for this measurement
+ * @param history Target's history including this result
+ * @param user_data Subscriber data
+ */
+typedef void (*ProbeResultCallback)(const char *target_id, int latency_ms,
+                                    const BurstStats *stats,
+                                    const ProbeHistory *history, void *user_data);
+
+/* Opaque scheduler */
+typedef struct ProbeScheduler ProbeScheduler;
+
+/**
+ * Create a probe scheduler
+ *
+ * @param max_concurrent Maximum probes in flight at once
+ * @param interval_sec Mean re-probe interval per target (jittered by +/-20%)
+ * @param timeout_ms Timeout for each probe
+ * @return New scheduler
+ */
+ProbeScheduler* probe_scheduler_create(unsigned int max_concurrent,
+                                       unsigned int interval_sec,
+                                       int timeout_ms);
+
+/**
+ * Subscribe to probe results (one subscriber)
+ *
+ * @param sched Scheduler
+ * @param callback Result callback, or NULL to unsubscribe
+ * @param user_data Data passed to callback
+ */
+void probe_scheduler_subscribe(ProbeScheduler *sched, ProbeResultCallback callback,
+                               void *user_data);
+
+/**
+ * Change the concurrency window
+ *
+ * @param sched Scheduler
+ * @param max_concurrent Maximum probes in flight at once (minimum 1)
+ */
+void probe_scheduler_set_concurrency(ProbeScheduler *sched, unsigned int max_concurrent);
+
+/**
+ * Measure each target with a burst of probes instead of a single one
+ *
+ * @param sched Scheduler
+ * @param count Probes per measurement (1 disables bursts)
+ * @param spacing_ms Delay between probes within a burst
+ */
+void probe_scheduler_set_burst(ProbeScheduler *sched, unsigned int count,
+                               unsigned int spacing_ms);
+
+/**
+ * Register a target, or update its address if already registered
+ *
+ * New targets are queued for an immediate first probe.
+ *
+ * @param sched Scheduler
+ * @param target_id Stable identifier (e.g. config path)
+ * @param hostname Server hostname or IP
+ * @param port Server port (0 to probe with ICMP)
+ * @param protocol OpenVPN proto string, or NULL
+ * @return 0 on success, negative errno on failure
+ */
+int probe_scheduler_add_target(ProbeScheduler *sched, const char *target_id,
+                               const char *hostname, int port, const char *protocol);
+
+/**
+ * Unregister a target; an in-flight probe for it is discarded
+ *
+ * @param sched Scheduler
+ * @param target_id Target identifier
+ */
+void probe_scheduler_remove_target(ProbeScheduler *sched, const char *target_id);
+
+/**
+ * Mark a target as priority (visible/selected) or normal
+ *
+ * Priority targets are taken from the queue before normal ones.
+ *
+ * @param sched Scheduler
+ * @param target_id Target identifier
+ * @param priority true for priority
+ */
+void probe_scheduler_set_priority(ProbeScheduler *sched, const char *target_id,
+                                  bool priority);
+
+/**
+ * Clear the priority flag on every target
+ *
+ * @param sched Scheduler
+ */
+void probe_scheduler_clear_priorities(ProbeScheduler *sched);
+
+/**
+ * Queue a target for probing ahead of its schedule
+ *
+ * @param sched Scheduler
+ * @param target_id Target identifier
+ */
+void probe_scheduler_probe_now(ProbeScheduler *sched, const char *target_id);
+
+/**
+ * Queue every target for probing ahead of schedule
+ *
+ * @param sched Scheduler
+ */
+void probe_scheduler_probe_all_now(ProbeScheduler *sched);
+
+/**
+ * Pause or resume periodic re-probing
+ *
+ * While paused no target is queued on schedule (explicit probe_now
+ * requests still run). Resuming immediately queues every target that
+ * became due in the meantime.
+ *
+ * @param sched Scheduler
+ * @param paused true to pause
+ */
+void probe_scheduler_set_paused(ProbeScheduler *sched, bool paused);
+
+/**
+ * Get a target's history
+ *
+ * @param sched Scheduler
+ * @param target_id Target identifier
+ * @return History (owned by the scheduler), or NULL if unknown
+ */
+const ProbeHistory* probe_scheduler_get_history(ProbeScheduler *sched, const char *target_id);
+
+/**
+ * Loss percentage over a history ring
+ *
+ * @param history History ring
+ * @return Lost probes as a percentage of recorded probes (0 if empty)
+ */
+double probe_history_loss_percent(const ProbeHistory *history);
+
+/**
+ * Free the scheduler; in-flight probes complete silently
+ *
+ * May be called from the result callback; the scheduler is then freed
+ * as soon as the callback returns.
+ *
+ * @param sched Scheduler
+ */
+void probe_scheduler_free(ProbeScheduler *sched);
+
+#endif /* PROBE_SCHEDULER_H */
@@ -28,6 +28,16 @@ typedef struct {
     unsigned int max_attempts;
 } AutoReconnectConfig;
 
+/**
+ * Server latency probing settings
+ */
+#define SERVER_PROBE_CONCURRENCY_DEFAULT  8
+#define SERVER_PROBE_CONCURRENCY_MAX      32
+
+typedef struct {
+    unsigned int max_concurrent;     /* Probes in flight at once (1..MAX) */
+} ServerProbeConfig;
+
 /**
  * Application configuration
  */
@@ -46,8 +56,19 @@ typedef struct {
     /* Auto-reconnect */
     AutoReconnectConfig auto_reconnect;
 
+    /* Servers tab probing */
+    ServerProbeConfig server_probes;
+
     /* Last connected VPN */
     char *last_connected_vpn;
+
+    /* Lookup index over vpn_configs (maintained by config_storage) */
+    GHashTable *vpn_by_name;         /* name -> VpnConfig* */
+
+    /* Write-behind persistence */
+    char *file_path;                 /* Path used by debounced saves, NULL for default */
+    bool dirty;                      /* Changed since last save */
+    guint save_id;                   /* Pending debounced save */
 } AppConfig;
 
 /**
@@ -56,7 +77,7 @@ typedef struct {
 void vpn_config_free(VpnConfig *config);
 
 /**
- * Free application config structure
+ * Free application config structure (pending changes are saved first)
  */
 void app_config_free(AppConfig *config);
 
@@ -5,12 +5,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 
 /* Default config file path */
 #define DEFAULT_CONFIG_PATH "~/.config/ovpn-manager/config.json"
 
+/* Debounce delay for mark_dirty saves */
+#define CONFIG_SAVE_DELAY_MS 1000
+
 /**
  * Free a VPN config structure
  */
@@ -33,6 +39,13 @@ void app_config_free(AppConfig *config) {
         return;
     }
 
+    /* Don't lose a pending write-behind save */
+    config_flush(config);
+
+    if (config->vpn_by_name) {
+        g_hash_table_destroy(config->vpn_by_name);
+    }
+
     /* Free VPN configs */
     if (config->vpn_configs) {
         for (unsigned int i = 0; i < config->vpn_config_count; i++) {
@@ -42,9 +55,47 @@ void app_config_free(AppConfig *config) {
     }
 
     g_free(config->last_connected_vpn);
+    g_free(config->file_path);
     g_free(config);
 }
 
+/**
+ * Add a VPN entry to the name index; the first entry with a given name
+ * wins, as with a front-to-back scan
+ */
+static void index_vpn(AppConfig *config, VpnConfig *vpn) {
+    if (vpn->name && !g_hash_table_contains(config->vpn_by_name, vpn->name)) {
+        g_hash_table_insert(config->vpn_by_name, vpn->name, vpn);
+    }
+}
+
+/**
+ * Drop a VPN entry from the name index, promoting any later duplicate
+ */
+static void unindex_vpn(AppConfig *config, VpnConfig *vpn) {
+    if (!vpn->name || g_hash_table_lookup(config->vpn_by_name, vpn->name) != vpn) {
+        return;
+    }
+
+    g_hash_table_remove(config->vpn_by_name, vpn->name);
+
+    for (unsigned int i = 0; i < config->vpn_config_count; i++) {
+        VpnConfig *other = config->vpn_configs[i];
+        if (other != vpn && other->name && strcmp(other->name, vpn->name) == 0) {
+            g_hash_table_insert(config->vpn_by_name, other->name, other);
+            break;
+        }
+    }
+}
+
+/**
+ * Create the lookup index
+ */
+static void init_indexes(AppConfig *config) {
+    /* Keys are owned by the VpnConfig entries */
+    config->vpn_by_name = g_hash_table_new(g_str_hash, g_str_equal);
+}
+
 /**
  * Create default configuration
  */
@@ -65,11 +116,16 @@ AppConfig* config_create_default(void) {
     config->auto_reconnect.enabled = true;
     config->auto_reconnect.max_attempts = 5;
 
+    /* Server probe defaults */
+    config->server_probes.max_concurrent = SERVER_PROBE_CONCURRENCY_DEFAULT;
+
     /* No VPN configs by default */
     config->vpn_configs = NULL;
     config->vpn_config_count = 0;
     config->last_connected_vpn = NULL;
 
+    init_indexes(config);
+
     return config;
 }
 
@@ -186,6 +242,7 @@ AppConfig* config_load(const char *config_path) {
         if (error->code == G_FILE_ERROR_NOENT) {
             logger_info("Config file not found, creating default: %s", path);
             config = config_create_default();
+            config->file_path = g_strdup(config_path);
             g_free(path);
             g_error_free(error);
             return config;
@@ -209,6 +266,8 @@ AppConfig* config_load(const char *config_path) {
 
     /* Create config structure */
     config = g_malloc0(sizeof(AppConfig));
+    config->file_path = g_strdup(config_path);
+    init_indexes(config);
 
     /* Parse settings */
     cJSON *item;
@@ -246,6 +305,17 @@ AppConfig* config_load(const char *config_path) {
         }
     }
 
+    /* Parse server probing */
+    config->server_probes.max_concurrent = SERVER_PROBE_CONCURRENCY_DEFAULT;
+    cJSON *server_probes = cJSON_GetObjectItem(json, "server_probes");
+    if (server_probes) {
+        item = cJSON_GetObjectItem(server_probes, "max_concurrent");
+        if (item && cJSON_IsNumber(item)) {
+            config->server_probes.max_concurrent =
+                (unsigned int)CLAMP(item->valueint, 1, SERVER_PROBE_CONCURRENCY_MAX);
+        }
+    }
+
     /* Parse VPN configs */
     cJSON *vpn_configs = cJSON_GetObjectItem(json, "vpn_configs");
     if (vpn_configs && cJSON_IsArray(vpn_configs)) {
@@ -260,6 +330,7 @@ AppConfig* config_load(const char *config_path) {
                     VpnConfig *vpn = parse_vpn_config_json(vpn_json);
                     if (vpn) {
                         config->vpn_configs[config->vpn_config_count++] = vpn;
+                        index_vpn(config, vpn);
                     }
                 }
             }
@@ -278,13 +349,73 @@ AppConfig* config_load(const char *config_path) {
     return config;
 }
 
+/**
+ * Replace a file atomically: write a temp file, fsync it, rename it over
+ * the target, then fsync the directory so the rename is durable
+ */
+static int write_file_atomic(const char *path, const char *contents) {
+    char *tmp_path = g_strdup_printf("%s.XXXXXX", path);
+    size_t len = strlen(contents);
+    int ret = -1;
+
+    int fd = g_mkstemp_full(tmp_path, O_WRONLY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        logger_error("Failed to create temporary config file %s: %s",
+                tmp_path, strerror(errno));
+        g_free(tmp_path);
+        return -1;
+    }
+
+    size_t written = 0;
+    while (written < len) {
+        ssize_t n = write(fd, contents + written, len - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        written += (size_t)n;
+    }
+
+    if (written != len) {
+        logger_error("Failed to write config file %s: %s", tmp_path, strerror(errno));
+    } else if (fsync(fd) != 0) {
+        logger_error("Failed to sync config file %s: %s", tmp_path, strerror(errno));
+    } else {
+        ret = 0;
+    }
+
+    if (close(fd) != 0 && ret == 0) {
+        logger_error("Failed to close config file %s: %s", tmp_path, strerror(errno));
+        ret = -1;
+    }
+
+    if (ret == 0 && g_rename(tmp_path, path) != 0) {
+        logger_error("Failed to replace config file %s: %s", path, strerror(errno));
+        ret = -1;
+    }
+
+    if (ret != 0) {
+        g_unlink(tmp_path);
+    } else {
+        char *dir_path = g_path_get_dirname(path);
+        int dir_fd = open(dir_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd >= 0) {
+            fsync(dir_fd);
+            close(dir_fd);
+        }
+        g_free(dir_path);
+    }
+
+    g_free(tmp_path);
+    return ret;
+}
+
 /**
  * Save configuration to file
  */
 int config_save(const AppConfig *config, const char *config_path) {
     char *path = NULL;
     char *json_string = NULL;
-    FILE *file = NULL;
     cJSON *json = NULL;
     int ret = 0;
 
@@ -325,6 +456,11 @@ int config_save(const AppConfig *config, const char *config_path) {
     cJSON_AddNumberToObject(auto_reconnect, "max_attempts", config->auto_reconnect.max_attempts);
     cJSON_AddItemToObject(json, "auto_reconnect", auto_reconnect);
 
+    /* Add server probing */
+    cJSON *server_probes = cJSON_CreateObject();
+    cJSON_AddNumberToObject(server_probes, "max_concurrent", config->server_probes.max_concurrent);
+    cJSON_AddItemToObject(json, "server_probes", server_probes);
+
     /* Add VPN configs */
     cJSON *vpn_configs = cJSON_CreateArray();
     for (unsigned int i = 0; i < config->vpn_config_count; i++) {
@@ -351,33 +487,9 @@ int config_save(const AppConfig *config, const char *config_path) {
         return -1;
     }
 
-    /* Write to file with 0600 permissions */
-    file = fopen(path, "w");
-    if (!file) {
-        logger_error("Failed to open config file for writing %s: %s",
-                path, strerror(errno));
-        free(json_string);
-        g_free(path);
-        return -1;
-    }
-
-    /* Write JSON */
-    if (fputs(json_string, file) == EOF) {
-        logger_error("Failed to write config file %s: %s",
-                path, strerror(errno));
-        ret = -1;
-    }
-
-    fclose(file);
+    ret = write_file_atomic(path, json_string);
     free(json_string);
 
-    /* Set permissions to 0600 */
-    if (chmod(path, S_IRUSR | S_IWUSR) != 0) {
-        logger_error("Failed to set config file permissions %s: %s",
-                path, strerror(errno));
-        ret = -1;
-    }
-
     g_free(path);
     return ret;
 }
@@ -397,6 +509,9 @@ int config_add_vpn(AppConfig *config, VpnConfig *vpn_config) {
     );
 
     config->vpn_configs[config->vpn_config_count++] = vpn_config;
+    if (config->vpn_by_name) {
+        index_vpn(config, vpn_config);
+    }
 
     return 0;
 }
@@ -409,13 +524,20 @@ int config_remove_vpn(AppConfig *config, const char *name) {
         return -1;
     }
 
-    /* Find VPN */
+    VpnConfig *vpn = config_find_vpn(config, name);
+    if (!vpn) {
+        return -1;  /* Not found */
+    }
+
+    /* Locate its slot; the array keeps insertion order for saving */
     for (unsigned int i = 0; i < config->vpn_config_count; i++) {
-        if (config->vpn_configs[i]->name &&
-            strcmp(config->vpn_configs[i]->name, name) == 0) {
+        if (config->vpn_configs[i] == vpn) {
+            if (config->vpn_by_name) {
+                unindex_vpn(config, vpn);
+            }
 
             /* Free the VPN config */
-            vpn_config_free(config->vpn_configs[i]);
+            vpn_config_free(vpn);
 
             /* Shift remaining configs */
             for (unsigned int j = i; j < config->vpn_config_count - 1; j++) {
@@ -439,6 +561,10 @@ VpnConfig* config_find_vpn(const AppConfig *config, const char *name) {
         return NULL;
     }
 
+    if (config->vpn_by_name) {
+        return g_hash_table_lookup(config->vpn_by_name, name);
+    }
+
     for (unsigned int i = 0; i < config->vpn_config_count; i++) {
         if (config->vpn_configs[i]->name &&
             strcmp(config->vpn_configs[i]->name, name) == 0) {
@@ -448,3 +574,65 @@ VpnConfig* config_find_vpn(const AppConfig *config, const char *name) {
 
     return NULL;
 }
+
+/**
+ * Debounce timer - write coalesced changes
+ */
+static gboolean on_save_timeout(gpointer user_data) {
+    AppConfig *config = (AppConfig *)user_data;
+
+    config->save_id = 0;
+    config_flush(config);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Mark the configuration changed and schedule a save
+ *
+ * Bursts of changes are coalesced into one write after
+ * CONFIG_SAVE_DELAY_MS.
+ */
+static void mark_dirty(AppConfig *config) {
+    config->dirty = true;
+    if (config->save_id == 0) {
+        config->save_id = g_timeout_add(CONFIG_SAVE_DELAY_MS, on_save_timeout, config);
+    }
+}
+
+/**
+ * Write pending changes now
+ */
+int config_flush(AppConfig *config) {
+    if (!config) {
+        return -1;
+    }
+
+    if (config->save_id > 0) {
+        g_source_remove(config->save_id);
+        config->save_id = 0;
+    }
+
+    if (!config->dirty) {
+        return 0;
+    }
+
+    int r = config_save(config, config->file_path);
+    if (r == 0) {
+        config->dirty = false;
+    }
+    return r;
+}
+
+/**
+ * Record the last connected VPN and schedule a save
+ */
+void config_set_last_connected(AppConfig *config, const char *name) {
+    if (!config || g_strcmp0(config->last_connected_vpn, name) == 0) {
+        return;
+    }
+
+    g_free(config->last_connected_vpn);
+    config->last_connected_vpn = g_strdup(name);
+    mark_dirty(config);
+}
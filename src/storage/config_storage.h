@@ -6,7 +6,9 @@
 /**
  * Configuration Storage
  *
- * JSON-based configuration persistence
+ * JSON-based configuration persistence. VPN entries are indexed by name;
+ * changes made through the setters are coalesced and written atomically
+ * (temp file, fsync, rename) after a short delay.
  */
 
 /**
@@ -20,6 +22,9 @@ AppConfig* config_load(const char *config_path);
 /**
  * Save configuration to file
  *
+ * The file is replaced atomically: a crash leaves either the old or the
+ * new contents, never a partial file.
+ *
  * @param config AppConfig structure to save
  * @param config_path Path to config file (NULL for default: ~/.config/ovpn-manager/config.json)
  * @return 0 on success, negative on failure
@@ -60,4 +65,20 @@ int config_remove_vpn(AppConfig *config, const char *name);
  */
 VpnConfig* config_find_vpn(const AppConfig *config, const char *name);
 
+/**
+ * Record the last connected VPN and schedule a save
+ *
+ * @param config AppConfig structure
+ * @param name VPN name, or NULL to clear
+ */
+void config_set_last_connected(AppConfig *config, const char *name);
+
+/**
+ * Write pending changes now
+ *
+ * @param config AppConfig structure
+ * @return 0 on success or nothing to write, negative on failure
+ */
+int config_flush(AppConfig *config);
+
 #endif /* CONFIG_STORAGE_H */
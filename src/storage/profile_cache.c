@@ -0,0 +1,804 @@
+#include "profile_cache.h"
+#include "../utils/logger.h"
+#include <glib.h>
+#include <string.h>
+#include <errno.h>
+
+/*
+ * On-disk format: header, entries of (hash, content length, blob), then
+ * source keys of (key, hash)
+ */
+#define PROFILE_CACHE_MAGIC      0x4350564fu    /* "OVPC" */
+#define PROFILE_CACHE_VERSION    3
+#define PROFILE_CACHE_FILE       "profiles.cache"
+
+/* Entries kept on disk; ones not used this session are dropped first */
+#define PROFILE_CACHE_MAX_ENTRIES 256
+
+/* Delay before writing changes back */
+#define PROFILE_CACHE_SAVE_DELAY_SEC 5
+
+/* XXH64 primes */
+#define XXH_PRIME64_1 11400714785074694791ULL
+#define XXH_PRIME64_2 14029467366897019727ULL
+#define XXH_PRIME64_3 1609587929392839161ULL
+#define XXH_PRIME64_4 9650029242287828579ULL
+#define XXH_PRIME64_5 2870177450012600261ULL
+
+/**
+ * Cached parse result
+ */
+typedef struct {
+    uint64_t hash;
+    uint32_t content_len;       /* Canonical length, guards against hash collisions */
+    GBytes *blob;               /* Serialized OvpnProfile */
+    bool used;                  /* Looked up or stored this session */
+} CacheEntry;
+
+static struct {
+    bool loaded;
+    GHashTable *entries;        /* uint64 hash -> CacheEntry* */
+    GHashTable *sources;        /* source key -> uint64 hash (g_new) */
+    bool dirty;
+    guint save_id;
+} cache;
+
+G_LOCK_DEFINE_STATIC(cache);
+
+/* Serializes cache file writes; taken before, never inside, the cache lock */
+G_LOCK_DEFINE_STATIC(cache_file);
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+static inline uint64_t xxh64_merge(uint64_t acc, uint64_t val) {
+    acc ^= xxh64_round(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+/**
+ * Mix in the last (< 32) bytes and avalanche
+ */
+static uint64_t xxh64_finalize(uint64_t h, const uint8_t *p, const uint8_t *end) {
+    while (p + 8 <= end) {
+        h ^= xxh64_round(0, read64(p));
+        h = rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * XXH_PRIME64_1;
+        h = rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * XXH_PRIME64_5;
+        h = rotl64(h, 11) * XXH_PRIME64_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * Fold the four lanes into one accumulator
+ */
+static uint64_t xxh64_converge(const uint64_t v[4]) {
+    uint64_t h = rotl64(v[0], 1) + rotl64(v[1], 7) + rotl64(v[2], 12) + rotl64(v[3], 18);
+    for (int i = 0; i < 4; i++) {
+        h = xxh64_merge(h, v[i]);
+    }
+    return h;
+}
+
+/**
+ * Hash profile content (XXH64, seed 0)
+ */
+uint64_t profile_cache_hash(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t *end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v[4] = {
+            XXH_PRIME64_1 + XXH_PRIME64_2, XXH_PRIME64_2, 0, (uint64_t)0 - XXH_PRIME64_1
+        };
+
+        do {
+            v[0] = xxh64_round(v[0], read64(p));
+            v[1] = xxh64_round(v[1], read64(p + 8));
+            v[2] = xxh64_round(v[2], read64(p + 16));
+            v[3] = xxh64_round(v[3], read64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+
+        h = xxh64_converge(v);
+    } else {
+        h = XXH_PRIME64_5;
+    }
+
+    return xxh64_finalize(h + (uint64_t)len, p, end);
+}
+
+/**
+ * Streaming XXH64: gives the same hash as profile_cache_hash over the
+ * concatenation of everything fed to it, without building that copy
+ */
+typedef struct {
+    uint64_t v[4];
+    uint8_t buf[32];            /* Partial stripe */
+    size_t buf_len;
+    uint64_t total_len;
+} HashState;
+
+static void hash_init(HashState *state) {
+    memset(state, 0, sizeof(*state));
+    state->v[0] = XXH_PRIME64_1 + XXH_PRIME64_2;
+    state->v[1] = XXH_PRIME64_2;
+    state->v[3] = (uint64_t)0 - XXH_PRIME64_1;
+}
+
+static inline void hash_stripe(HashState *state, const uint8_t *p) {
+    state->v[0] = xxh64_round(state->v[0], read64(p));
+    state->v[1] = xxh64_round(state->v[1], read64(p + 8));
+    state->v[2] = xxh64_round(state->v[2], read64(p + 16));
+    state->v[3] = xxh64_round(state->v[3], read64(p + 24));
+}
+
+static void hash_update(HashState *state, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t *end = p + len;
+
+    state->total_len += len;
+
+    if (state->buf_len + len < sizeof(state->buf)) {
+        memcpy(state->buf + state->buf_len, p, len);
+        state->buf_len += len;
+        return;
+    }
+    if (state->buf_len > 0) {
+        size_t fill = sizeof(state->buf) - state->buf_len;
+        memcpy(state->buf + state->buf_len, p, fill);
+        hash_stripe(state, state->buf);
+        p += fill;
+        state->buf_len = 0;
+    }
+    while (p + 32 <= end) {
+        hash_stripe(state, p);
+        p += 32;
+    }
+    memcpy(state->buf, p, (size_t)(end - p));
+    state->buf_len = (size_t)(end - p);
+}
+
+static inline void hash_byte(HashState *state, char c) {
+    if (state->buf_len + 1 < sizeof(state->buf)) {
+        state->buf[state->buf_len++] = (uint8_t)c;
+        state->total_len++;
+    } else {
+        hash_update(state, &c, 1);
+    }
+}
+
+static uint64_t hash_digest(const HashState *state) {
+    uint64_t h = state->total_len >= 32 ? xxh64_converge(state->v) : XXH_PRIME64_5;
+    return xxh64_finalize(h + state->total_len, state->buf, state->buf + state->buf_len);
+}
+
+/**
+ * Feed a span, dropping carriage returns and trailing blanks per line
+ */
+static void hash_trimmed(HashState *out, OvpnSpan span) {
+    const char *p = span.start;
+    const char *end = span.start + span.len;
+
+    while (p < end) {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        const char *stop = eol ? eol : end;
+        const char *last = stop;
+        while (last > p && (last[-1] == '\r' || last[-1] == ' ' || last[-1] == '\t')) {
+            last--;
+        }
+        if (last > p) {
+            hash_update(out, p, (size_t)(last - p));
+            hash_byte(out, '\n');
+        }
+        p = eol ? eol + 1 : end;
+    }
+}
+
+/**
+ * Hash the canonical form of a profile as the tokenizer yields it
+ *
+ * @param canonical_len Output: length of the canonical form
+ */
+static uint64_t canonical_hash(const char *content, size_t len, uint32_t *canonical_len) {
+    HashState out;
+    OvpnTokenizer tok;
+    OvpnToken token;
+
+    hash_init(&out);
+    ovpn_tokenizer_init(&tok, content, len);
+    while (ovpn_tokenizer_next(&tok, &token)) {
+        switch (token.kind) {
+        case OVPN_TOKEN_DIRECTIVE:
+            hash_update(&out, token.name.start, token.name.len);
+            for (unsigned int i = 0; i < token.argc; i++) {
+                hash_byte(&out, '\x1f');
+                hash_update(&out, token.args[i].start, token.args[i].len);
+            }
+            hash_byte(&out, '\n');
+            break;
+        case OVPN_TOKEN_BLOCK_START:
+        case OVPN_TOKEN_BLOCK_END:
+            hash_update(&out, "</", token.kind == OVPN_TOKEN_BLOCK_START ? 1 : 2);
+            hash_update(&out, token.name.start, token.name.len);
+            hash_update(&out, ">\n", 2);
+            break;
+        case OVPN_TOKEN_INLINE:
+            hash_byte(&out, '<');
+            hash_update(&out, token.name.start, token.name.len);
+            hash_update(&out, ">\n", 2);
+            hash_trimmed(&out, token.body);
+            hash_update(&out, "</>\n", 4);
+            break;
+        }
+    }
+
+    if (canonical_len) {
+        *canonical_len = (uint32_t)out.total_len;
+    }
+    return hash_digest(&out);
+}
+
+/**
+ * Hash the canonical form of a profile
+ */
+uint64_t profile_cache_content_hash(const char *content, size_t len) {
+    return canonical_hash(content, len, NULL);
+}
+
+/* ---- Serialization ---- */
+
+static void put_u32(GByteArray *out, uint32_t v) {
+    g_byte_array_append(out, (const guint8 *)&v, sizeof(v));
+}
+
+static void put_i32(GByteArray *out, int32_t v) {
+    g_byte_array_append(out, (const guint8 *)&v, sizeof(v));
+}
+
+static void put_u64(GByteArray *out, uint64_t v) {
+    g_byte_array_append(out, (const guint8 *)&v, sizeof(v));
+}
+
+static void put_str(GByteArray *out, const char *s) {
+    if (!s) {
+        put_u32(out, UINT32_MAX);
+        return;
+    }
+    uint32_t len = (uint32_t)strlen(s);
+    put_u32(out, len);
+    g_byte_array_append(out, (const guint8 *)s, len);
+}
+
+/**
+ * Bounds-checked reader over a byte buffer
+ */
+typedef struct {
+    const guint8 *pos;
+    const guint8 *end;
+    bool ok;
+} Reader;
+
+static bool take(Reader *r, void *dst, size_t len) {
+    if (!r->ok || (size_t)(r->end - r->pos) < len) {
+        r->ok = false;
+        return false;
+    }
+    memcpy(dst, r->pos, len);
+    r->pos += len;
+    return true;
+}
+
+static uint32_t get_u32(Reader *r) {
+    uint32_t v = 0;
+    take(r, &v, sizeof(v));
+    return v;
+}
+
+static int32_t get_i32(Reader *r) {
+    int32_t v = 0;
+    take(r, &v, sizeof(v));
+    return v;
+}
+
+static uint64_t get_u64(Reader *r) {
+    uint64_t v = 0;
+    take(r, &v, sizeof(v));
+    return v;
+}
+
+static char* get_str(Reader *r) {
+    uint32_t len = get_u32(r);
+    if (!r->ok || len == UINT32_MAX) {
+        return NULL;
+    }
+    if ((size_t)(r->end - r->pos) < len) {
+        r->ok = false;
+        return NULL;
+    }
+    char *s = g_strndup((const char *)r->pos, len);
+    r->pos += len;
+    return s;
+}
+
+/**
+ * Serialize a profile
+ */
+static GBytes* profile_serialize(const OvpnProfile *profile) {
+    GByteArray *out = g_byte_array_new();
+
+    put_u32(out, profile->remote_count);
+    for (unsigned int i = 0; i < profile->remote_count; i++) {
+        put_str(out, profile->remotes[i].host);
+        put_i32(out, profile->remotes[i].port);
+        put_str(out, profile->remotes[i].protocol);
+    }
+    put_u32(out, profile->remote_random);
+    put_str(out, profile->proto);
+    put_str(out, profile->dev);
+    put_str(out, profile->cipher);
+    put_str(out, profile->data_ciphers);
+    put_str(out, profile->auth);
+    put_str(out, profile->compression);
+    put_u32(out, profile->route_nopull);
+    put_i32(out, profile->tun_mtu);
+    put_i32(out, profile->link_mtu);
+    put_i32(out, profile->fragment);
+    put_i32(out, profile->mssfix);
+    put_u32(out, profile->inline_blocks);
+
+    return g_byte_array_free_to_bytes(out);
+}
+
+/**
+ * Deserialize a profile
+ *
+ * @return New profile, or NULL if the blob is malformed
+ */
+static OvpnProfile* profile_deserialize(GBytes *blob) {
+    gsize size = 0;
+    Reader r = { .ok = true };
+    r.pos = g_bytes_get_data(blob, &size);
+    r.end = r.pos + size;
+
+    OvpnProfile *profile = g_malloc0(sizeof(OvpnProfile));
+
+    uint32_t count = get_u32(&r);
+    if (r.ok && count > 0 && count <= size / (3 * sizeof(uint32_t))) {
+        profile->remotes = g_new0(OvpnRemote, count);
+        for (uint32_t i = 0; i < count && r.ok; i++) {
+            profile->remotes[i].host = get_str(&r);
+            profile->remotes[i].port = get_i32(&r);
+            profile->remotes[i].protocol = get_str(&r);
+            profile->remote_count = i + 1;
+        }
+    } else if (count > 0) {
+        r.ok = false;
+    }
+
+    profile->remote_random = get_u32(&r) != 0;
+    profile->proto = get_str(&r);
+    profile->dev = get_str(&r);
+    profile->cipher = get_str(&r);
+    profile->data_ciphers = get_str(&r);
+    profile->auth = get_str(&r);
+    profile->compression = get_str(&r);
+    profile->route_nopull = get_u32(&r) != 0;
+    profile->tun_mtu = get_i32(&r);
+    profile->link_mtu = get_i32(&r);
+    profile->fragment = get_i32(&r);
+    profile->mssfix = get_i32(&r);
+    profile->inline_blocks = get_u32(&r);
+
+    if (!r.ok || r.pos != r.end) {
+        ovpn_profile_free(profile);
+        return NULL;
+    }
+    return profile;
+}
+
+/* ---- Cache file ---- */
+
+/**
+ * Free a cache entry
+ */
+static void cache_entry_free(CacheEntry *entry) {
+    if (!entry) return;
+
+    g_bytes_unref(entry->blob);
+    g_free(entry);
+}
+
+/**
+ * Path of the cache file
+ */
+static char* cache_file_path(void) {
+    return g_build_filename(g_get_user_cache_dir(), "ovpn-manager", PROFILE_CACHE_FILE, NULL);
+}
+
+/**
+ * Insert an entry, replacing any with the same hash (lock held)
+ */
+static CacheEntry* cache_insert(uint64_t hash, uint32_t content_len, GBytes *blob) {
+    CacheEntry *entry = g_malloc0(sizeof(CacheEntry));
+    entry->hash = hash;
+    entry->content_len = content_len;
+    entry->blob = blob;
+    g_hash_table_replace(cache.entries, &entry->hash, entry);
+    return entry;
+}
+
+/**
+ * Remember which content a source key maps to (lock held, takes source)
+ */
+static void cache_insert_source(char *source, uint64_t hash) {
+    uint64_t *value = g_new(uint64_t, 1);
+    *value = hash;
+    g_hash_table_replace(cache.sources, source, value);
+}
+
+/**
+ * Load the cache file on first use (lock held)
+ */
+static void cache_load(void) {
+    if (cache.loaded) {
+        return;
+    }
+    cache.loaded = true;
+    cache.entries = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL,
+                                          (GDestroyNotify)cache_entry_free);
+    cache.sources = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+    char *path = cache_file_path();
+    char *data = NULL;
+    gsize size = 0;
+
+    if (!g_file_get_contents(path, &data, &size, NULL)) {
+        g_free(path);
+        return;     /* No cache yet */
+    }
+
+    Reader r = { .pos = (const guint8 *)data, .end = (const guint8 *)data + size, .ok = true };
+    uint32_t magic = get_u32(&r);
+    uint32_t version = get_u32(&r);
+    uint32_t count = get_u32(&r);
+
+    if (!r.ok || magic != PROFILE_CACHE_MAGIC || version != PROFILE_CACHE_VERSION) {
+        logger_info("Profile cache %s is stale or unreadable, ignoring", path);
+        count = 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t hash = get_u64(&r);
+        uint32_t content_len = get_u32(&r);
+        uint32_t blob_len = get_u32(&r);
+        if (!r.ok || (size_t)(r.end - r.pos) < blob_len) {
+            logger_warn("Profile cache %s is truncated", path);
+            r.ok = false;
+            break;
+        }
+        cache_insert(hash, content_len, g_bytes_new(r.pos, blob_len));
+        r.pos += blob_len;
+    }
+
+    uint32_t source_count = r.ok && count > 0 ? get_u32(&r) : 0;
+    for (uint32_t i = 0; i < source_count && r.ok; i++) {
+        char *source = get_str(&r);
+        uint64_t hash = get_u64(&r);
+        if (r.ok && source) {
+            cache_insert_source(source, hash);
+        } else {
+            g_free(source);
+        }
+    }
+
+    logger_debug("Profile cache: loaded %u entries, %u sources",
+                 g_hash_table_size(cache.entries), g_hash_table_size(cache.sources));
+
+    g_free(data);
+    g_free(path);
+}
+
+/**
+ * Order entries used this session first
+ */
+static gint compare_used_first(gconstpointer a, gconstpointer b) {
+    const CacheEntry *ea = *(const CacheEntry * const *)a;
+    const CacheEntry *eb = *(const CacheEntry * const *)b;
+    return (int)eb->used - (int)ea->used;
+}
+
+/**
+ * Serialize the cache for writing (lock held)
+ *
+ * @param saved_count Output: entries in the snapshot
+ * @return File contents, or NULL if there is nothing to write
+ */
+static GByteArray* cache_snapshot(guint *saved_count) {
+    if (!cache.entries || !cache.dirty) {
+        return NULL;
+    }
+    cache.dirty = false;
+
+    GPtrArray *list = g_ptr_array_sized_new(g_hash_table_size(cache.entries));
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, cache.entries);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        g_ptr_array_add(list, value);
+    }
+    g_ptr_array_sort(list, compare_used_first);
+    guint count = MIN(list->len, PROFILE_CACHE_MAX_ENTRIES);
+
+    GByteArray *out = g_byte_array_new();
+    put_u32(out, PROFILE_CACHE_MAGIC);
+    put_u32(out, PROFILE_CACHE_VERSION);
+    put_u32(out, count);
+    for (guint i = 0; i < count; i++) {
+        CacheEntry *entry = g_ptr_array_index(list, i);
+        gsize blob_len = 0;
+        const void *blob = g_bytes_get_data(entry->blob, &blob_len);
+
+        put_u64(out, entry->hash);
+        put_u32(out, entry->content_len);
+        put_u32(out, (uint32_t)blob_len);
+        g_byte_array_append(out, blob, (guint)blob_len);
+    }
+
+    /* Keep only the sources whose content is being written */
+    GHashTable *saved = g_hash_table_new(g_int64_hash, g_int64_equal);
+    for (guint i = 0; i < count; i++) {
+        CacheEntry *entry = g_ptr_array_index(list, i);
+        g_hash_table_add(saved, &entry->hash);
+    }
+    g_ptr_array_free(list, TRUE);
+
+    guint source_pos = out->len;
+    uint32_t source_count = 0;
+    put_u32(out, 0);
+    g_hash_table_iter_init(&iter, cache.sources);
+    gpointer key;
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (g_hash_table_contains(saved, value)) {
+            put_str(out, key);
+            put_u64(out, *(uint64_t *)value);
+            source_count++;
+        }
+    }
+    memcpy(out->data + source_pos, &source_count, sizeof(source_count));
+    g_hash_table_destroy(saved);
+
+    *saved_count = count;
+    return out;
+}
+
+/**
+ * Write pending changes to the cache file
+ *
+ * Only the snapshot is taken under the cache lock, so parses on other
+ * threads do not wait for the disk.
+ */
+static void cache_save(void) {
+    G_LOCK(cache_file);
+
+    G_LOCK(cache);
+    guint count = 0;
+    GByteArray *out = cache_snapshot(&count);
+    G_UNLOCK(cache);
+
+    if (!out) {
+        G_UNLOCK(cache_file);
+        return;
+    }
+
+    char *path = cache_file_path();
+    char *dir = g_path_get_dirname(path);
+    GError *error = NULL;
+
+    if (g_mkdir_with_parents(dir, 0700) != 0 && errno != EEXIST) {
+        logger_error("Failed to create cache directory %s: %s", dir, strerror(errno));
+    } else if (!g_file_set_contents(path, (const char *)out->data, out->len, &error)) {
+        logger_error("Failed to write profile cache %s: %s", path, error->message);
+        g_error_free(error);
+    } else {
+        logger_debug("Profile cache: saved %u entries", count);
+    }
+
+    g_free(dir);
+    g_free(path);
+    g_byte_array_free(out, TRUE);
+
+    G_UNLOCK(cache_file);
+}
+
+/**
+ * Debounced save
+ */
+static gboolean on_save_timeout(gpointer user_data) {
+    (void)user_data;
+
+    G_LOCK(cache);
+    cache.save_id = 0;
+    G_UNLOCK(cache);
+
+    cache_save();
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Schedule a debounced save (lock held)
+ */
+static void cache_mark_dirty(void) {
+    cache.dirty = true;
+    if (cache.save_id == 0) {
+        cache.save_id = g_timeout_add_seconds(PROFILE_CACHE_SAVE_DELAY_SEC, on_save_timeout, NULL);
+    }
+}
+
+/**
+ * Deserialize a cached blob, or NULL if it is malformed
+ */
+static OvpnProfile* load_blob(GBytes *blob, uint64_t hash) {
+    OvpnProfile *profile = profile_deserialize(blob);
+    g_bytes_unref(blob);
+    if (!profile) {
+        logger_warn("Profile cache: discarding malformed entry %016" G_GINT64_MODIFIER "x",
+                    (guint64)hash);
+    }
+    return profile;
+}
+
+/**
+ * Parse a profile, or return the cached result for identical content
+ */
+OvpnProfile* profile_cache_parse(const char *content, size_t len, const char *source,
+                                 uint64_t *content_hash) {
+    if (!content) {
+        return ovpn_profile_parse(NULL, 0);
+    }
+
+    uint32_t canonical_len = 0;
+    uint64_t hash = canonical_hash(content, len, &canonical_len);
+
+    if (content_hash) {
+        *content_hash = hash;
+    }
+    GBytes *blob = NULL;
+
+    G_LOCK(cache);
+    cache_load();
+    CacheEntry *entry = g_hash_table_lookup(cache.entries, &hash);
+    if (entry && entry->content_len == canonical_len) {
+        entry->used = true;
+        blob = g_bytes_ref(entry->blob);
+    }
+    if (source) {
+        uint64_t *known = g_hash_table_lookup(cache.sources, source);
+        if (!known || *known != hash) {
+            cache_insert_source(g_strdup(source), hash);
+            cache_mark_dirty();
+        }
+    }
+    G_UNLOCK(cache);
+
+    if (blob) {
+        OvpnProfile *profile = load_blob(blob, hash);
+        if (profile) {
+            return profile;
+        }
+    }
+
+    OvpnProfile *profile = ovpn_profile_parse(content, len);
+    if (!source) {
+        return profile;     /* Not imported (yet); nothing will look it up again */
+    }
+    blob = profile_serialize(profile);
+
+    G_LOCK(cache);
+    cache_insert(hash, canonical_len, blob)->used = true;
+    cache_mark_dirty();
+    G_UNLOCK(cache);
+
+    return profile;
+}
+
+/**
+ * Look up a profile by source key
+ */
+OvpnProfile* profile_cache_lookup(const char *source, uint64_t *content_hash) {
+    if (!source) {
+        return NULL;
+    }
+
+    uint64_t hash = 0;
+    GBytes *blob = NULL;
+
+    G_LOCK(cache);
+    cache_load();
+    uint64_t *known = g_hash_table_lookup(cache.sources, source);
+    CacheEntry *entry = known ? g_hash_table_lookup(cache.entries, known) : NULL;
+    if (entry) {
+        entry->used = true;
+        hash = entry->hash;
+        blob = g_bytes_ref(entry->blob);
+    }
+    G_UNLOCK(cache);
+
+    if (!blob) {
+        return NULL;
+    }
+
+    OvpnProfile *profile = load_blob(blob, hash);
+    if (profile && content_hash) {
+        *content_hash = hash;
+    }
+    return profile;
+}
+
+/**
+ * Write pending changes to disk now
+ */
+void profile_cache_flush(void) {
+    G_LOCK(cache);
+    if (cache.save_id > 0) {
+        g_source_remove(cache.save_id);
+        cache.save_id = 0;
+    }
+    G_UNLOCK(cache);
+
+    cache_save();
+}
+
+/**
+ * Flush and release the cache
+ */
+void profile_cache_cleanup(void) {
+    profile_cache_flush();
+
+    G_LOCK(cache);
+    if (cache.entries) {
+        g_hash_table_destroy(cache.entries);
+        cache.entries = NULL;
+    }
+    if (cache.sources) {
+        g_hash_table_destroy(cache.sources);
+        cache.sources = NULL;
+    }
+    cache.loaded = false;
+    G_UNLOCK(cache);
+}
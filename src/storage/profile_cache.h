@@ -0,0 +1,83 @@
+#ifndef PROFILE_CACHE_H
+#define PROFILE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../utils/ovpn_profile.h"
+
+/**
+ * Profile Parse Cache
+ *
+ * Memoizes parsed profiles by a 64-bit hash of their content, so
+ * unchanged profiles are not re-parsed after re-imports, renames or a
+ * restart of the configuration service. The content is hashed in a
+ * canonical form, so a file on disk and the configuration service's
+ * re-serialized copy of it hash the same. Profiles can also be looked up by
+ * a source key (configuration path and import stamp), which lets callers
+ * skip fetching the content altogether. The cache is kept in a compact
+ * binary file under the user cache directory
+ * (~/.cache/ovpn-manager/profiles.cache) and written back shortly after
+ * it changes.
+ */
+
+/**
+ * Hash profile content (XXH64)
+ *
+ * @param data Content
+ * @param len Length in bytes
+ * @return 64-bit hash
+ */
+uint64_t profile_cache_hash(const void *data, size_t len);
+
+/**
+ * Hash the canonical form of a profile
+ *
+ * Only the directives, their arguments and inline file bodies count, as
+ * the tokenizer yields them: comments, blank lines, quoting, indentation
+ * and CRLF line ends do not change the hash.
+ *
+ * @param content Profile contents
+ * @param len Length in bytes
+ * @return 64-bit hash
+ */
+uint64_t profile_cache_content_hash(const char *content, size_t len);
+
+/**
+ * Parse a profile, or return the cached result for identical content
+ *
+ * Only parses with a source are added to the cache; without one (e.g. a
+ * file that is not imported yet) the cache is read but left unchanged.
+ * Safe to call from any thread.
+ *
+ * @param content Profile contents
+ * @param len Length in bytes
+ * @param source Source key to remember the content under, or NULL not to store
+ * @param content_hash Output: profile_cache_content_hash of the content (can be NULL)
+ * @return New profile (never NULL; free with ovpn_profile_free)
+ */
+OvpnProfile* profile_cache_parse(const char *content, size_t len, const char *source,
+                                 uint64_t *content_hash);
+
+/**
+ * Look up a profile by the source key given to profile_cache_parse
+ *
+ * The key must change whenever the content can, e.g. include an import
+ * timestamp. Safe to call from any thread.
+ *
+ * @param source Source key
+ * @param content_hash Output: hash of the remembered content (can be NULL)
+ * @return New profile, or NULL if the source is not cached
+ */
+OvpnProfile* profile_cache_lookup(const char *source, uint64_t *content_hash);
+
+/**
+ * Write pending changes to disk now
+ */
+void profile_cache_flush(void);
+
+/**
+ * Flush and release the cache
+ */
+void profile_cache_cleanup(void);
+
+#endif /* PROFILE_CACHE_H */
@@ -1,11 +1,14 @@
 #include "tray.h"
 #include "dbus/session_client.h"
 #include "dbus/config_client.h"
+#include "monitoring/dns_cache.h"
 #include "utils/file_chooser.h"
+#define LOG_CATEGORY LOG_CAT_UI
 #include "utils/logger.h"
 #include "utils/connection_fsm.h"
 #include "ui/icons.h"
 #include "ui/dashboard.h"
+#include "ui/bulk_import.h"
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -23,7 +26,10 @@ extern Dashboard *dashboard;
 /* Per-connection tray indicator */
 typedef struct {
     AppIndicator *indicator;       /* Separate AppIndicator per connection */
-    GtkWidget *menu;               /* Flat menu, rebuilt on state change */
+    GtkWidget *menu;               /* Flat menu, exported once */
+    GtkWidget *status_item;        /* Status label, updated in place */
+    GList *action_items;           /* State-dependent actions */
+    ConnectionState menu_state;    /* State the actions were built for */
     char *config_path;             /* Stable identifier */
     char *config_name;             /* Display name */
     char *session_path;            /* NULL if disconnected */
@@ -71,6 +77,7 @@ static void on_authenticate(GtkMenuItem *item, gpointer data);
 static void quit_callback(GtkMenuItem *item, gpointer user_data);
 static void show_dashboard_callback(GtkMenuItem *item, gpointer user_data);
 static void import_config_callback(GtkMenuItem *item, gpointer user_data);
+static void import_folder_callback(GtkMenuItem *item, gpointer user_data);
 
 /* ──────────────────────────────────────────────────────────────
  * Utility functions
@@ -177,34 +184,9 @@ static ConnectionState get_state_from_session(VpnSession *session) {
         return CONN_STATE_DISCONNECTED;
     }
 
-    ConnectionState state;
+    ConnectionState state = session_connection_state(session->state);
 
-    switch (session->state) {
-        case SESSION_STATE_CONNECTING:
-            state = CONN_STATE_CONNECTING;
-            break;
-        case SESSION_STATE_CONNECTED:
-            state = CONN_STATE_CONNECTED;
-            break;
-        case SESSION_STATE_PAUSED:
-            state = CONN_STATE_PAUSED;
-            break;
-        case SESSION_STATE_AUTH_REQUIRED:
-            state = CONN_STATE_AUTH_REQUIRED;
-            break;
-        case SESSION_STATE_ERROR:
-            state = CONN_STATE_ERROR;
-            break;
-        case SESSION_STATE_RECONNECTING:
-            state = CONN_STATE_RECONNECTING;
-            break;
-        case SESSION_STATE_DISCONNECTED:
-        default:
-            state = CONN_STATE_DISCONNECTED;
-            break;
-    }
-
-    if (logger_get_verbosity() >= 2) {
+    if (logger_verbose(2)) {
         logger_info("D-Bus session state: %d -> Connection state: %s, session_path=%s, config_name=%s",
                     session->state,
                     connection_fsm_state_name(state),
@@ -248,6 +230,18 @@ static ConnectionInfo* merge_connections_data(sd_bus *bus, unsigned int *out_cou
         return NULL;
     }
 
+    /* Resolve every remote once at startup, so the first probes and
+     * connects do not wait on DNS */
+    static bool remotes_prefetched = false;
+    if (!remotes_prefetched) {
+        remotes_prefetched = true;
+        for (unsigned int i = 0; i < config_count; i++) {
+            for (unsigned int j = 0; j < configs[i]->remote_count; j++) {
+                dns_cache_prefetch(configs[i]->remotes[j].host);
+            }
+        }
+    }
+
     /* Get all active sessions */
     VpnSession **sessions = NULL;
     unsigned int session_count = 0;
@@ -260,7 +254,7 @@ static ConnectionInfo* merge_connections_data(sd_bus *bus, unsigned int *out_cou
     /* Allocate array for merged connections */
     ConnectionInfo *connections = g_malloc0(sizeof(ConnectionInfo) * config_count);
 
-    if (logger_get_verbosity() >= 2) {
+    if (logger_verbose(2)) {
         logger_info("Merging connections: %u configs, %u active sessions", config_count, session_count);
     }
 
@@ -289,7 +283,7 @@ static ConnectionInfo* merge_connections_data(sd_bus *bus, unsigned int *out_cou
                 );
                 found_session = true;
 
-                if (logger_get_verbosity() >= 2) {
+                if (logger_verbose(2)) {
                     logger_info("  Config '%s' matched to session (state=%s, session_path=%s)",
                                config->config_name,
                                connection_fsm_state_name(connections[i].state),
@@ -299,7 +293,7 @@ static ConnectionInfo* merge_connections_data(sd_bus *bus, unsigned int *out_cou
             }
         }
 
-        if (!found_session && logger_get_verbosity() >= 2) {
+        if (!found_session && logger_verbose(2)) {
             logger_info("  Config '%s' has no active session (state=DISCONNECTED)",
                        config->config_name);
         }
@@ -414,12 +408,13 @@ static void format_status_label(const char *name, ConnectionState state,
 /**
  * Append a plain menu item with a callback to a menu
  */
-static void add_action(GtkWidget *menu, const char *label,
-                        GCallback callback, gpointer data) {
+static GtkWidget* add_action(GtkWidget *menu, const char *label,
+                              GCallback callback, gpointer data) {
     GtkWidget *item = gtk_menu_item_new_with_label(label);
     g_signal_connect(item, "activate", callback, data);
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), item);
     gtk_widget_show(item);
+    return item;
 }
 
 /* ──────────────────────────────────────────────────────────────
@@ -427,59 +422,113 @@ static void add_action(GtkWidget *menu, const char *label,
  * ────────────────────────────────────────────────────────────── */
 
 /**
- * Rebuild a connection indicator's menu from scratch.
- * This is the core fix: calling app_indicator_set_menu() with a new menu
- * forces dbusmenu to re-serialize the entire tree, avoiding the property
- * propagation issues that plague visibility/sensitivity changes.
+ * Refresh the status label in place.
+ * Only a changed label is sent, so dbusmenu exports a single property
+ * update instead of a new layout.
  */
-static void connection_indicator_rebuild_menu(ConnectionIndicator *ci) {
-    GtkWidget *new_menu = gtk_menu_new();
-
-    /* Status label (disabled) */
+static void connection_indicator_update_status(ConnectionIndicator *ci) {
     char label[256];
     format_status_label(ci->config_name, ci->state, ci->connect_time,
                         label, sizeof(label));
-    GtkWidget *status = gtk_menu_item_new_with_label(label);
-    gtk_widget_set_sensitive(status, FALSE);
-    gtk_menu_shell_append(GTK_MENU_SHELL(new_menu), status);
-    gtk_widget_show(status);
 
-    /* Separator */
-    GtkWidget *sep = gtk_separator_menu_item_new();
-    gtk_menu_shell_append(GTK_MENU_SHELL(new_menu), sep);
-    gtk_widget_show(sep);
+    const char *current = gtk_menu_item_get_label(GTK_MENU_ITEM(ci->status_item));
+    if (g_strcmp0(current, label) != 0) {
+        gtk_menu_item_set_label(GTK_MENU_ITEM(ci->status_item), label);
+    }
+}
+
+/**
+ * Replace the state-dependent actions below the status label.
+ * Items are removed and appended rather than hidden, avoiding the
+ * visibility/sensitivity propagation issues of dbusmenu; the menu itself
+ * stays the one exported with app_indicator_set_menu().
+ */
+static void connection_indicator_build_actions(ConnectionIndicator *ci) {
+    for (GList *l = ci->action_items; l; l = l->next) {
+        gtk_widget_destroy(GTK_WIDGET(l->data));
+    }
+    g_list_free(ci->action_items);
+    ci->action_items = NULL;
+
+    GtkWidget *menu = ci->menu;
+    GList *items = NULL;
 
-    /* State-dependent actions */
     switch (ci->state) {
         case CONN_STATE_DISCONNECTED:
         case CONN_STATE_ERROR:
-            add_action(new_menu, "Connect", G_CALLBACK(on_connect), ci);
+            items = g_list_append(items, add_action(menu, "Connect", G_CALLBACK(on_connect), ci));
             break;
 
         case CONN_STATE_CONNECTING:
         case CONN_STATE_RECONNECTING:
-            add_action(new_menu, "Cancel", G_CALLBACK(on_cancel), ci);
+            items = g_list_append(items, add_action(menu, "Cancel", G_CALLBACK(on_cancel), ci));
             break;
 
         case CONN_STATE_CONNECTED:
-            add_action(new_menu, "Disconnect", G_CALLBACK(on_disconnect), ci);
-            add_action(new_menu, "Pause", G_CALLBACK(on_pause), ci);
+            items = g_list_append(items, add_action(menu, "Disconnect", G_CALLBACK(on_disconnect), ci));
+            items = g_list_append(items, add_action(menu, "Pause", G_CALLBACK(on_pause), ci));
             break;
 
         case CONN_STATE_PAUSED:
-            add_action(new_menu, "Resume", G_CALLBACK(on_resume), ci);
-            add_action(new_menu, "Disconnect", G_CALLBACK(on_disconnect), ci);
+            items = g_list_append(items, add_action(menu, "Resume", G_CALLBACK(on_resume), ci));
+            items = g_list_append(items, add_action(menu, "Disconnect", G_CALLBACK(on_disconnect), ci));
             break;
 
         case CONN_STATE_AUTH_REQUIRED:
-            add_action(new_menu, "Authenticate", G_CALLBACK(on_authenticate), ci);
-            add_action(new_menu, "Cancel", G_CALLBACK(on_cancel), ci);
+            items = g_list_append(items, add_action(menu, "Authenticate", G_CALLBACK(on_authenticate), ci));
+            items = g_list_append(items, add_action(menu, "Cancel", G_CALLBACK(on_cancel), ci));
             break;
     }
 
-    /* Swap menu — AppIndicator re-serializes on set_menu */
-    app_indicator_set_menu(ci->indicator, GTK_MENU(new_menu));
-    ci->menu = new_menu;
+    ci->action_items = items;
+    ci->menu_state = ci->state;
+}
+
+/**
+ * Build a connection indicator's menu once and export it
+ */
+static void connection_indicator_build_menu(ConnectionIndicator *ci) {
+    ci->menu = gtk_menu_new();
+    g_object_ref_sink(ci->menu);
+
+    /* Status label (disabled) */
+    ci->status_item = gtk_menu_item_new_with_label("");
+    gtk_widget_set_sensitive(ci->status_item, FALSE);
+    gtk_menu_shell_append(GTK_MENU_SHELL(ci->menu), ci->status_item);
+    gtk_widget_show(ci->status_item);
+    connection_indicator_update_status(ci);
+
+    /* Separator */
+    GtkWidget *sep = gtk_separator_menu_item_new();
+    gtk_menu_shell_append(GTK_MENU_SHELL(ci->menu), sep);
+    gtk_widget_show(sep);
+
+    /* State-dependent actions */
+    connection_indicator_build_actions(ci);
+
+    app_indicator_set_menu(ci->indicator, GTK_MENU(ci->menu));
+}
+
+/**
+ * Bring the menu up to date: actions change only with the FSM state,
+ * otherwise just the status label is refreshed
+ */
+static void connection_indicator_refresh_menu(ConnectionIndicator *ci) {
+    if (ci->state != ci->menu_state) {
+        connection_indicator_build_actions(ci);
+    }
+    connection_indicator_update_status(ci);
+}
+
+/**
+ * Feed a polled connection state to the connection's FSM
+ */
+static void sync_connection_fsm(ConnectionInfo *conn) {
+    ConnectionFsm *fsm = connection_fsm_get(conn->config_name);
+    if (conn->session_path) {
+        connection_fsm_bind_session(fsm, conn->session_path);
+    }
+    connection_fsm_observe(fsm, conn->state);
 }
 
 /**
@@ -515,8 +564,11 @@ static ConnectionIndicator* connection_indicator_create(sd_bus *bus, ConnectionI
     app_indicator_set_status(ci->indicator, APP_INDICATOR_STATUS_ACTIVE);
     app_indicator_set_title(ci->indicator, conn->config_name);
 
-    /* Build initial menu */
-    connection_indicator_rebuild_menu(ci);
+    /* Build the menu */
+    connection_indicator_build_menu(ci);
+
+    /* Sync the shared FSM with the state found at startup */
+    sync_connection_fsm(conn);
 
     logger_info("Created tray indicator for '%s' (state=%s)",
                 conn->config_name, connection_fsm_state_name(conn->state));
@@ -539,6 +591,12 @@ static void connection_indicator_free(ConnectionIndicator *ci) {
         g_object_unref(ci->indicator);
     }
 
+    if (ci->menu) {
+        gtk_widget_destroy(ci->menu);
+        g_object_unref(ci->menu);
+    }
+    g_list_free(ci->action_items);
+
     g_free(ci->config_path);
     g_free(ci->config_name);
     g_free(ci->session_path);
@@ -553,7 +611,8 @@ static void connection_indicator_update(ConnectionIndicator *ci, ConnectionInfo
         return;
     }
 
-    gboolean changed = FALSE;
+    /* Keep the shared FSM in step with what D-Bus reports */
+    sync_connection_fsm(conn);
 
     /* Check for state change */
     if (ci->state != conn->state) {
@@ -562,7 +621,6 @@ static void connection_indicator_update(ConnectionIndicator *ci, ConnectionInfo
                     connection_fsm_state_name(ci->state),
                     connection_fsm_state_name(conn->state));
         ci->state = conn->state;
-        changed = TRUE;
 
         /* Update icon */
         app_indicator_set_icon(ci->indicator, get_indicator_icon(ci->state));
@@ -575,13 +633,9 @@ static void connection_indicator_update(ConnectionIndicator *ci, ConnectionInfo
     if (g_strcmp0(ci->session_path, conn->session_path) != 0) {
         g_free(ci->session_path);
         ci->session_path = conn->session_path ? g_strdup(conn->session_path) : NULL;
-        changed = TRUE;
     }
 
-    /* Rebuild menu if anything changed */
-    if (changed) {
-        connection_indicator_rebuild_menu(ci);
-    }
+    connection_indicator_refresh_menu(ci);
 
     /* Auto-launch browser for authentication */
     if (conn->state == CONN_STATE_AUTH_REQUIRED && conn->session_path && ci->bus) {
@@ -612,6 +666,9 @@ static void on_connect(GtkMenuItem *item, gpointer data) {
 
     logger_info("Connecting: %s", ci->config_name);
 
+    /* A plain connect follows the profile's remote order, not an old pin */
+    config_clear_pin(ci->bus, ci->config_path);
+
     char *session_path = NULL;
     int r = session_start(ci->bus, ci->config_path, &session_path);
     if (r < 0) {
@@ -622,6 +679,35 @@ static void on_connect(GtkMenuItem *item, gpointer data) {
     }
 }
 
+/* Session captured for a confirmation; the indicator may go away meanwhile */
+typedef struct {
+    sd_bus *bus;
+    char *config_name;
+    char *session_path;
+} PendingDisconnect;
+
+static void pending_disconnect_free(gpointer data) {
+    PendingDisconnect *pd = (PendingDisconnect *)data;
+    g_free(pd->config_name);
+    g_free(pd->session_path);
+    g_free(pd);
+}
+
+/**
+ * Disconnect confirmed
+ */
+static void on_disconnect_confirmed(gpointer data) {
+    PendingDisconnect *pd = (PendingDisconnect *)data;
+
+    logger_info("Disconnecting: %s", pd->config_name);
+    int r = session_disconnect(pd->bus, pd->session_path);
+    if (r < 0) {
+        logger_error("Failed to disconnect session");
+    } else {
+        remove_session_timing(pd->session_path);
+    }
+}
+
 /**
  * Disconnect with confirmation dialog
  */
@@ -632,30 +718,16 @@ static void on_disconnect(GtkMenuItem *item, gpointer data) {
         return;
     }
 
-    /* Show confirmation dialog */
-    GtkWidget *dialog = gtk_message_dialog_new(
-        NULL,
-        GTK_DIALOG_MODAL,
-        GTK_MESSAGE_QUESTION,
-        GTK_BUTTONS_NONE,
-        "Disconnect from %s?",
-        ci->config_name
-    );
-    gtk_dialog_add_button(GTK_DIALOG(dialog), "Cancel", GTK_RESPONSE_CANCEL);
-    gtk_dialog_add_button(GTK_DIALOG(dialog), "Disconnect", GTK_RESPONSE_ACCEPT);
-
-    int response = gtk_dialog_run(GTK_DIALOG(dialog));
-    gtk_widget_destroy(dialog);
+    PendingDisconnect *pd = g_malloc0(sizeof(PendingDisconnect));
+    pd->bus = ci->bus;
+    pd->config_name = g_strdup(ci->config_name);
+    pd->session_path = g_strdup(ci->session_path);
 
-    if (response == GTK_RESPONSE_ACCEPT) {
-        logger_info("Disconnecting: %s", ci->config_name);
-        int r = session_disconnect(ci->bus, ci->session_path);
-        if (r < 0) {
-            logger_error("Failed to disconnect session");
-        } else {
-            remove_session_timing(ci->session_path);
-        }
-    }
+    /* Show confirmation dialog */
+    char *question = g_strdup_printf("Disconnect from %s?", ci->config_name);
+    dialog_confirm(GTK_MESSAGE_QUESTION, question, "Disconnect",
+                   on_disconnect_confirmed, pd, pending_disconnect_free);
+    g_free(question);
 }
 
 /**
@@ -762,116 +834,22 @@ static void show_dashboard_callback(GtkMenuItem *item, gpointer user_data) {
  */
 static void import_config_callback(GtkMenuItem *item, gpointer user_data) {
     (void)item;
-    sd_bus *bus = (sd_bus *)user_data;
-
-    if (!bus) {
-        logger_error("No D-Bus connection available");
-        dialog_show_error("Import Error", "No D-Bus connection available");
-        return;
-    }
-
-    /* Show file chooser */
-    char *file_path = file_chooser_select_ovpn("Import OpenVPN Configuration");
-    if (!file_path) {
-        return;  /* User cancelled */
-    }
-
-    logger_info("Selected file: %s", file_path);
-
-    /* Read file contents */
-    char *contents = NULL;
-    char *error = NULL;
-    int r = file_read_contents(file_path, &contents, &error);
-
-    if (r < 0) {
-        logger_error("Failed to read file: %s", error ? error : "Unknown error");
-        dialog_show_error("Import Error", error ? error : "Failed to read file");
-        g_free(error);
-        g_free(file_path);
-        return;
-    }
-
-    /* Extract default config name from filename */
-    char *basename = g_path_get_basename(file_path);
-    char *default_name = g_strdup(basename);
-
-    /* Remove .ovpn or .conf extension for default name */
-    char *dot = strrchr(default_name, '.');
-    if (dot && (strcmp(dot, ".ovpn") == 0 || strcmp(dot, ".conf") == 0)) {
-        *dot = '\0';
-    }
-
-    /* Prompt user for config name */
-    char *config_name = dialog_get_text_input(
-        "Import Configuration",
-        "Configuration name:",
-        default_name
-    );
-
-    g_free(default_name);
-    g_free(basename);
-
-    if (!config_name) {
-        logger_info("Import cancelled by user");
-        g_free(contents);
-        g_free(file_path);
-        return;
-    }
-
-    /* Import configuration with persistent=true */
-    char *config_path = NULL;
-    r = config_import(bus, config_name, contents, false, true, &config_path);
-
-    if (r < 0) {
-        logger_error("Failed to import configuration: %s", config_name);
-        char msg[256];
-        snprintf(msg, sizeof(msg),
-                 "Failed to import configuration '%s'.\n\n"
-                 "Check if the configuration already exists.", config_name);
-        dialog_show_error("Import Error", msg);
-    } else {
-        logger_info("Successfully imported persistent configuration: %s -> %s",
-                     config_name, config_path);
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Configuration '%s' imported successfully.",
-                 config_name);
-        dialog_show_info("Import Successful", msg);
-        g_free(config_path);
-    }
-
-    g_free(config_name);
-    g_free(contents);
-    g_free(file_path);
+    bulk_import_choose_file((sd_bus *)user_data, NULL, NULL);
 }
 
 /**
- * Force cleanup all VPN sessions via D-Bus (no sudo required)
+ * Import every configuration in a folder
  */
-static void on_force_cleanup(GtkMenuItem *item, gpointer data) {
+static void import_folder_callback(GtkMenuItem *item, gpointer user_data) {
     (void)item;
-    TrayIcon *tray = (TrayIcon *)data;
-    if (!tray || !tray->bus) {
-        return;
-    }
-
-    /* Confirmation dialog */
-    GtkWidget *dialog = gtk_message_dialog_new(
-        NULL,
-        GTK_DIALOG_MODAL,
-        GTK_MESSAGE_WARNING,
-        GTK_BUTTONS_NONE,
-        "Force cleanup all VPN sessions?\n\n"
-        "This will disconnect all active VPN connections."
-    );
-    gtk_dialog_add_button(GTK_DIALOG(dialog), "Cancel", GTK_RESPONSE_CANCEL);
-    gtk_dialog_add_button(GTK_DIALOG(dialog), "Cleanup", GTK_RESPONSE_ACCEPT);
-
-    int response = gtk_dialog_run(GTK_DIALOG(dialog));
-    gtk_widget_destroy(dialog);
+    bulk_import_choose_folder((sd_bus *)user_data, NULL, NULL);
+}
 
-    if (response != GTK_RESPONSE_ACCEPT) {
-        return;
-    }
+/**
+ * Force cleanup confirmed: disconnect all VPN sessions via D-Bus
+ */
+static void on_force_cleanup_confirmed(gpointer data) {
+    TrayIcon *tray = (TrayIcon *)data;
 
     logger_info("Force cleanup: disconnecting all sessions");
 
@@ -897,33 +875,27 @@ static void on_force_cleanup(GtkMenuItem *item, gpointer data) {
 }
 
 /**
- * Restart VPN backend service (requires sudo via pkexec)
+ * Force cleanup all VPN sessions via D-Bus (no sudo required)
  */
-static void on_restart_vpn_service(GtkMenuItem *item, gpointer data) {
+static void on_force_cleanup(GtkMenuItem *item, gpointer data) {
     (void)item;
-    (void)data;
-
-    /* Confirmation dialog */
-    GtkWidget *dialog = gtk_message_dialog_new(
-        NULL,
-        GTK_DIALOG_MODAL,
-        GTK_MESSAGE_WARNING,
-        GTK_BUTTONS_NONE,
-        "Restart VPN Service?\n\n"
-        "This will kill all VPN backend processes and\n"
-        "disconnect all active sessions.\n\n"
-        "Administrative privileges are required."
-    );
-    gtk_dialog_add_button(GTK_DIALOG(dialog), "Cancel", GTK_RESPONSE_CANCEL);
-    gtk_dialog_add_button(GTK_DIALOG(dialog), "Restart", GTK_RESPONSE_ACCEPT);
-
-    int response = gtk_dialog_run(GTK_DIALOG(dialog));
-    gtk_widget_destroy(dialog);
-
-    if (response != GTK_RESPONSE_ACCEPT) {
+    TrayIcon *tray = (TrayIcon *)data;
+    if (!tray || !tray->bus) {
         return;
     }
 
+    dialog_confirm(GTK_MESSAGE_WARNING,
+                   "Force cleanup all VPN sessions?\n\n"
+                   "This will disconnect all active VPN connections.",
+                   "Cleanup", on_force_cleanup_confirmed, tray, NULL);
+}
+
+/**
+ * Restart confirmed: restart VPN backend service (requires sudo via pkexec)
+ */
+static void on_restart_confirmed(gpointer data) {
+    (void)data;
+
     logger_info("Restarting VPN backend service via pkexec");
 
     GError *error = NULL;
@@ -954,6 +926,21 @@ static void on_restart_vpn_service(GtkMenuItem *item, gpointer data) {
     }
 }
 
+/**
+ * Restart VPN backend service after confirmation
+ */
+static void on_restart_vpn_service(GtkMenuItem *item, gpointer data) {
+    (void)item;
+    (void)data;
+
+    dialog_confirm(GTK_MESSAGE_WARNING,
+                   "Restart VPN Service?\n\n"
+                   "This will kill all VPN backend processes and\n"
+                   "disconnect all active sessions.\n\n"
+                   "Administrative privileges are required.",
+                   "Restart", on_restart_confirmed, NULL, NULL);
+}
+
 /* ──────────────────────────────────────────────────────────────
  * App menu building
  * ────────────────────────────────────────────────────────────── */
@@ -991,6 +978,12 @@ static void build_app_menu(TrayIcon *tray) {
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), import_item);
     gtk_widget_show(import_item);
 
+    /* Import Folder... */
+    GtkWidget *import_folder_item = gtk_menu_item_new_with_label("Import Folder...");
+    g_signal_connect(import_folder_item, "activate", G_CALLBACK(import_folder_callback), tray->bus);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), import_folder_item);
+    gtk_widget_show(import_folder_item);
+
     /* Settings (not implemented) */
     GtkWidget *settings = gtk_menu_item_new_with_label("Settings");
     gtk_widget_set_sensitive(settings, FALSE);
@@ -1101,21 +1094,6 @@ void tray_icon_set_tooltip(TrayIcon *tray, const char *tooltip) {
     app_indicator_set_title(tray->indicator, tooltip);
 }
 
-/**
- * Process pending GTK events (called by GLib timer)
- */
-int tray_icon_run(TrayIcon *tray) {
-    if (!tray) {
-        return -1;
-    }
-
-    while (gtk_events_pending()) {
-        gtk_main_iteration_do(FALSE);
-    }
-
-    return 0;
-}
-
 /**
  * Update tray with active VPN sessions.
  * Creates/updates/removes per-connection AppIndicators.
@@ -1234,7 +1212,8 @@ void tray_icon_update_sessions(TrayIcon *tray, sd_bus *bus) {
 
 /**
  * Update elapsed time labels for connected sessions.
- * Rebuilds menus for CONNECTED indicators to refresh the elapsed time.
+ * Only the status label of CONNECTED indicators changes; the menus
+ * themselves are left alone.
  */
 void tray_icon_update_timers(TrayIcon *tray, sd_bus *bus) {
     (void)bus;
@@ -1250,7 +1229,7 @@ void tray_icon_update_timers(TrayIcon *tray, sd_bus *bus) {
     while (g_hash_table_iter_next(&iter, &key, &value)) {
         ConnectionIndicator *ci = (ConnectionIndicator *)value;
         if (ci->state == CONN_STATE_CONNECTED) {
-            connection_indicator_rebuild_menu(ci);
+            connection_indicator_update_status(ci);
         }
     }
 }
@@ -15,6 +15,9 @@ typedef struct TrayIcon TrayIcon;
 /**
  * Initialize the system tray icon
  *
+ * Also initializes GTK, whose events are then dispatched by the
+ * application's main loop like every other source.
+ *
  * @param tooltip Initial tooltip text
  * @return Pointer to TrayIcon on success, NULL on failure
  */
@@ -28,14 +31,6 @@ TrayIcon* tray_icon_init(const char *tooltip);
  */
 void tray_icon_set_tooltip(TrayIcon *tray, const char *tooltip);
 
-/**
- * Run the tray icon event loop (blocking)
- *
- * @param tray TrayIcon instance
- * @return 0 on success, negative on error
- */
-int tray_icon_run(TrayIcon *tray);
-
 /**
  * Signal the tray to quit
  *
@@ -0,0 +1,901 @@
+#include "bulk_import.h"
+#include "../dbus/config_client.h"
+#include "../storage/profile_cache.h"
+#include "../utils/file_chooser.h"
+#define LOG_CATEGORY LOG_CAT_UI
+#include "../utils/logger.h"
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <errno.h>
+
+/* Threads reading and validating files */
+#define BULK_IMPORT_READERS         4
+
+/* Import calls outstanding at once */
+#define BULK_IMPORT_MAX_IN_FLIGHT   8
+
+/* How deep to look for profiles below the source directory */
+#define BULK_IMPORT_MAX_DEPTH       4
+
+/**
+ * Per-file state
+ */
+typedef enum {
+    ITEM_READING,
+    ITEM_QUEUED,
+    ITEM_IMPORTING,
+    ITEM_IMPORTED,
+    ITEM_DUPLICATE,
+    ITEM_INVALID,
+    ITEM_FAILED,
+    ITEM_CANCELLED
+} ItemState;
+
+/**
+ * Result list columns
+ */
+enum {
+    COL_FILE,
+    COL_RESULT,
+    COL_NUM_COLUMNS
+};
+
+typedef struct BulkImport BulkImport;
+
+/**
+ * One file being imported
+ */
+typedef struct {
+    BulkImport *job;
+    char *file_path;
+    char *name;                 /* Config name (file name without extension) */
+    char *contents;             /* Set by the reader, dropped once imported */
+    uint64_t hash;
+    ItemState state;
+    char *message;              /* Error detail */
+    GtkTreeIter iter;           /* Row in job->store */
+} ImportItem;
+
+/**
+ * A bulk import in progress
+ */
+struct BulkImport {
+    int ref_count;              /* Main thread only */
+    sd_bus *bus;
+    char *source;
+    char *extract_dir;          /* Temporary directory for archives */
+
+    GPtrArray *items;           /* ImportItem* */
+    GHashTable *known;          /* Content hashes already present or queued */
+    GThreadPool *readers;
+    GQueue ready;               /* ImportItem* waiting for an Import slot */
+    unsigned int in_flight;
+    unsigned int finished;
+    unsigned int imported;
+    unsigned int duplicates;
+    unsigned int failed;
+    gint cancelled;             /* Read by reader threads */
+    bool scanned;
+    bool done;
+
+    GtkWidget *window;
+    GtkWidget *status_label;
+    GtkWidget *progress;
+    GtkWidget *close_button;
+    GtkListStore *store;
+
+    BulkImportDoneCallback done_cb;
+    void *user_data;
+};
+
+/**
+ * Files found by the scan thread
+ */
+typedef struct {
+    BulkImport *job;
+    GPtrArray *paths;           /* char* */
+    GArray *existing;           /* guint64 content hashes of imported configs */
+    char *error;
+} ScanResult;
+
+static void pump_imports(BulkImport *job);
+
+/**
+ * Remove a directory tree
+ */
+static void remove_tree(const char *path) {
+    GDir *dir = g_dir_open(path, 0, NULL);
+    if (dir) {
+        const char *entry;
+        while ((entry = g_dir_read_name(dir)) != NULL) {
+            char *child = g_build_filename(path, entry, NULL);
+            if (g_file_test(child, G_FILE_TEST_IS_DIR) &&
+                !g_file_test(child, G_FILE_TEST_IS_SYMLINK)) {
+                remove_tree(child);
+            } else {
+                g_remove(child);
+            }
+            g_free(child);
+        }
+        g_dir_close(dir);
+    }
+    g_rmdir(path);
+}
+
+/**
+ * Free an item
+ */
+static void import_item_free(ImportItem *item) {
+    if (!item) return;
+
+    g_free(item->file_path);
+    g_free(item->name);
+    g_free(item->contents);
+    g_free(item->message);
+    g_free(item);
+}
+
+static BulkImport* job_ref(BulkImport *job) {
+    job->ref_count++;
+    return job;
+}
+
+static void job_unref(BulkImport *job) {
+    if (--job->ref_count > 0) {
+        return;
+    }
+
+    if (job->readers) {
+        g_thread_pool_free(job->readers, FALSE, TRUE);
+    }
+    if (job->extract_dir) {
+        remove_tree(job->extract_dir);
+        g_free(job->extract_dir);
+    }
+    g_queue_clear(&job->ready);
+    g_ptr_array_free(job->items, TRUE);
+    g_hash_table_destroy(job->known);
+    if (job->store) {
+        g_object_unref(job->store);
+    }
+    g_free(job->source);
+    g_free(job);
+}
+
+/**
+ * Check whether a path names a supported archive
+ */
+bool bulk_import_is_archive(const char *path) {
+    static const char *suffixes[] = { ".zip", ".tar", ".tar.gz", ".tgz", ".tar.xz", NULL };
+
+    if (!path) {
+        return false;
+    }
+
+    char *lower = g_ascii_strdown(path, -1);
+    bool match = false;
+    for (int i = 0; suffixes[i] && !match; i++) {
+        match = g_str_has_suffix(lower, suffixes[i]);
+    }
+    g_free(lower);
+    return match;
+}
+
+/**
+ * Whether a file name looks like a profile
+ */
+static bool has_profile_extension(const char *name) {
+    char *lower = g_ascii_strdown(name, -1);
+    bool match = g_str_has_suffix(lower, ".ovpn") || g_str_has_suffix(lower, ".conf");
+    g_free(lower);
+    return match;
+}
+
+/**
+ * Collect profile files below a directory
+ */
+static void collect_profiles(const char *dir_path, int depth, GPtrArray *paths) {
+    GDir *dir = g_dir_open(dir_path, 0, NULL);
+    if (!dir) {
+        return;
+    }
+
+    const char *entry;
+    while ((entry = g_dir_read_name(dir)) != NULL) {
+        if (entry[0] == '.') {
+            continue;
+        }
+
+        char *child = g_build_filename(dir_path, entry, NULL);
+        if (g_file_test(child, G_FILE_TEST_IS_DIR)) {
+            if (depth < BULK_IMPORT_MAX_DEPTH) {
+                collect_profiles(child, depth + 1, paths);
+            }
+            g_free(child);
+        } else if (has_profile_extension(entry)) {
+            g_ptr_array_add(paths, child);
+        } else {
+            g_free(child);
+        }
+    }
+    g_dir_close(dir);
+}
+
+/**
+ * Unpack an archive into a new temporary directory
+ *
+ * @return Directory path, or NULL with *error set
+ */
+static char* extract_archive(const char *archive, char **error) {
+    GError *gerror = NULL;
+    char *dir = g_dir_make_tmp("ovpn-import-XXXXXX", &gerror);
+    if (!dir) {
+        *error = g_strdup(gerror->message);
+        g_error_free(gerror);
+        return NULL;
+    }
+
+    char *lower = g_ascii_strdown(archive, -1);
+    bool zip = g_str_has_suffix(lower, ".zip");
+    g_free(lower);
+
+    const char *unzip_argv[] = { "unzip", "-qq", "-o", archive, "-d", dir, NULL };
+    const char *tar_argv[] = { "tar", "-xf", archive, "-C", dir, NULL };
+
+    gchar *standard_error = NULL;
+    gint exit_status = 0;
+    gboolean success = g_spawn_sync(
+        NULL,
+        (gchar **)(zip ? unzip_argv : tar_argv),
+        NULL,
+        G_SPAWN_SEARCH_PATH | G_SPAWN_STDOUT_TO_DEV_NULL,
+        NULL,
+        NULL,
+        NULL,
+        &standard_error,
+        &exit_status,
+        &gerror
+    );
+
+    if (!success || exit_status != 0) {
+        *error = g_strdup_printf("Failed to unpack archive: %s",
+                                 gerror ? gerror->message :
+                                 (standard_error && *standard_error) ? g_strstrip(standard_error) :
+                                 "unknown error");
+        if (gerror) g_error_free(gerror);
+        g_free(standard_error);
+        remove_tree(dir);
+        g_free(dir);
+        return NULL;
+    }
+
+    g_free(standard_error);
+    return dir;
+}
+
+static gint compare_paths(gconstpointer a, gconstpointer b) {
+    return g_strcmp0(*(const char * const *)a, *(const char * const *)b);
+}
+
+/**
+ * Update the summary line and progress bar
+ */
+static void update_status(BulkImport *job) {
+    if (!job->window) {
+        return;
+    }
+
+    guint total = job->items->len;
+    char text[192];
+
+    if (!job->scanned) {
+        snprintf(text, sizeof(text), "Looking for profiles in %s...", job->source);
+    } else {
+        snprintf(text, sizeof(text), "%s %u of %u profiles, %u already present, %u failed",
+                 job->done ? "Imported" : "Importing...", job->imported, total,
+                 job->duplicates, job->failed);
+    }
+    gtk_label_set_text(GTK_LABEL(job->status_label), text);
+
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(job->progress),
+                                  total > 0 ? (double)job->finished / total : (job->done ? 1.0 : 0.0));
+}
+
+/**
+ * Show an item's state in its row
+ */
+static void update_item_row(ImportItem *item) {
+    static const char *labels[] = {
+        [ITEM_READING] = "Reading...",
+        [ITEM_QUEUED] = "Waiting",
+        [ITEM_IMPORTING] = "Importing...",
+        [ITEM_IMPORTED] = "Imported",
+        [ITEM_DUPLICATE] = "Already imported",
+        [ITEM_INVALID] = "Invalid",
+        [ITEM_FAILED] = "Failed",
+        [ITEM_CANCELLED] = "Cancelled",
+    };
+
+    char *text = item->message ?
+        g_strdup_printf("%s: %s", labels[item->state], item->message) :
+        g_strdup(labels[item->state]);
+    gtk_list_store_set(item->job->store, &item->iter, COL_RESULT, text, -1);
+    g_free(text);
+}
+
+/**
+ * Finish the job once every file has a final result
+ */
+static void check_finished(BulkImport *job) {
+    if (job->done || !job->scanned || job->finished < job->items->len) {
+        update_status(job);
+        return;
+    }
+
+    job->done = true;
+    logger_info("Bulk import of %s: %u imported, %u already present, %u failed",
+                job->source, job->imported, job->duplicates, job->failed);
+
+    update_status(job);
+    if (job->window) {
+        gtk_button_set_label(GTK_BUTTON(job->close_button), "Close");
+        gtk_widget_set_sensitive(job->close_button, TRUE);
+    }
+
+    if (job->done_cb) {
+        job->done_cb(job->imported, job->user_data);
+    }
+}
+
+/**
+ * Move an item to a final state
+ */
+static void finish_item(ImportItem *item, ItemState state, const char *message) {
+    BulkImport *job = item->job;
+
+    item->state = state;
+    g_free(item->message);
+    item->message = g_strdup(message);
+    g_clear_pointer(&item->contents, g_free);
+
+    switch (state) {
+    case ITEM_IMPORTED:  job->imported++;   break;
+    case ITEM_DUPLICATE: job->duplicates++; break;
+    case ITEM_INVALID:
+    case ITEM_FAILED:    job->failed++;     break;
+    default: break;
+    }
+
+    job->finished++;
+    update_item_row(item);
+    check_finished(job);
+}
+
+/**
+ * Import call completed
+ */
+static void on_item_imported(const char *config_path, int result,
+                             const char *error_message, void *user_data) {
+    ImportItem *item = (ImportItem *)user_data;
+    BulkImport *job = item->job;
+    (void)config_path;
+
+    job->in_flight--;
+    if (result < 0) {
+        finish_item(item, ITEM_FAILED, error_message ? error_message : g_strerror(-result));
+    } else {
+        finish_item(item, ITEM_IMPORTED, NULL);
+    }
+
+    pump_imports(job);
+    job_unref(job);
+}
+
+/**
+ * Start Import calls until the concurrency window is full
+ */
+static void pump_imports(BulkImport *job) {
+    while (job->in_flight < BULK_IMPORT_MAX_IN_FLIGHT && !g_queue_is_empty(&job->ready)) {
+        ImportItem *item = g_queue_pop_head(&job->ready);
+
+        if (g_atomic_int_get(&job->cancelled)) {
+            finish_item(item, ITEM_CANCELLED, NULL);
+            continue;
+        }
+
+        int r = config_import_async(job->bus, item->name, item->contents, false, true,
+                                    on_item_imported, item);
+        if (r < 0) {
+            finish_item(item, ITEM_FAILED, g_strerror(-r));
+            continue;
+        }
+
+        job_ref(job);
+        job->in_flight++;
+        item->state = ITEM_IMPORTING;
+        update_item_row(item);
+    }
+}
+
+/**
+ * Main loop: a reader finished with an item
+ */
+static gboolean on_item_read(gpointer user_data) {
+    ImportItem *item = (ImportItem *)user_data;
+    BulkImport *job = item->job;
+
+    if (item->state == ITEM_INVALID) {
+        char *message = item->message;
+        item->message = NULL;
+        finish_item(item, ITEM_INVALID, message);
+        g_free(message);
+    } else if (g_atomic_int_get(&job->cancelled)) {
+        finish_item(item, ITEM_CANCELLED, NULL);
+    } else if (g_hash_table_contains(job->known, &item->hash)) {
+        finish_item(item, ITEM_DUPLICATE, NULL);
+    } else {
+        guint64 *key = g_new(guint64, 1);
+        *key = item->hash;
+        g_hash_table_add(job->known, key);
+
+        item->state = ITEM_QUEUED;
+        update_item_row(item);
+        g_queue_push_tail(&job->ready, item);
+        pump_imports(job);
+    }
+
+    job_unref(job);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Reader thread: read, validate and hash one file
+ */
+static void read_item(gpointer data, gpointer pool_data) {
+    ImportItem *item = (ImportItem *)data;
+    (void)pool_data;
+
+    if (!g_atomic_int_get(&item->job->cancelled)) {
+        char *error = NULL;
+        if (file_read_contents(item->file_path, &item->contents, &error) < 0) {
+            item->state = ITEM_INVALID;
+            item->message = error;
+        } else {
+            /* Same canonical hash as config_list gives; not added to the parse cache */
+            OvpnProfile *profile = profile_cache_parse(item->contents, strlen(item->contents),
+                                                       NULL, &item->hash);
+            if (profile->remote_count == 0) {
+                item->state = ITEM_INVALID;
+                item->message = g_strdup("No remote server in profile");
+            }
+            ovpn_profile_free(profile);
+        }
+    }
+
+    g_idle_add(on_item_read, item);
+}
+
+/**
+ * Main loop: scan finished, queue every file for reading
+ */
+static gboolean on_scan_done(gpointer user_data) {
+    ScanResult *res = (ScanResult *)user_data;
+    BulkImport *job = res->job;
+
+    job->scanned = true;
+
+    /* Content already imported is skipped */
+    for (guint i = 0; i < res->existing->len; i++) {
+        guint64 *key = g_new(guint64, 1);
+        *key = g_array_index(res->existing, guint64, i);
+        g_hash_table_add(job->known, key);
+    }
+    logger_info("Bulk import from %s (%u existing configs)", job->source, res->existing->len);
+
+    if (res->error) {
+        logger_error("Bulk import of %s: %s", job->source, res->error);
+        if (job->window) {
+            dialog_show_error("Import Error", res->error);
+        }
+    } else if (res->paths->len == 0 && job->window) {
+        dialog_show_info("Import", "No .ovpn or .conf files were found.");
+    }
+
+    for (guint i = 0; res->paths && i < res->paths->len; i++) {
+        ImportItem *item = g_malloc0(sizeof(ImportItem));
+        item->job = job;
+        item->file_path = g_strdup(g_ptr_array_index(res->paths, i));
+        item->state = ITEM_READING;
+
+        char *basename = g_path_get_basename(item->file_path);
+        char *dot = strrchr(basename, '.');
+        if (dot && dot != basename) {
+            *dot = '\0';
+        }
+        item->name = basename;
+
+        gtk_list_store_append(job->store, &item->iter);
+        gtk_list_store_set(job->store, &item->iter, COL_FILE, item->name, -1);
+        update_item_row(item);
+
+        g_ptr_array_add(job->items, item);
+        g_thread_pool_push(job->readers, item, NULL);
+        job_ref(job);
+    }
+
+    check_finished(job);
+
+    if (res->paths) {
+        g_ptr_array_free(res->paths, TRUE);
+    }
+    g_array_free(res->existing, TRUE);
+    g_free(res->error);
+    g_free(res);
+    job_unref(job);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Scan thread: hash the configs already imported
+ *
+ * Uses a connection of its own; the main one belongs to the main loop.
+ */
+static void collect_existing(GArray *existing) {
+    sd_bus *bus = NULL;
+    int r = sd_bus_open_system(&bus);
+    if (r < 0) {
+        logger_error("Bulk import: failed to connect to system bus: %s", strerror(-r));
+        return;
+    }
+
+    VpnConfig **configs = NULL;
+    unsigned int count = 0;
+    if (config_list(bus, &configs, &count) == 0) {
+        for (unsigned int i = 0; i < count; i++) {
+            if (configs[i]->profile) {
+                guint64 hash = configs[i]->content_hash;
+                g_array_append_val(existing, hash);
+            }
+        }
+        config_list_free(configs, count);
+    }
+
+    sd_bus_flush_close_unref(bus);
+}
+
+/**
+ * Scan thread: unpack archives and list profile files
+ */
+static gpointer scan_thread(gpointer data) {
+    ScanResult *res = (ScanResult *)data;
+    BulkImport *job = res->job;
+    const char *root = job->source;
+
+    res->existing = g_array_new(FALSE, FALSE, sizeof(guint64));
+    collect_existing(res->existing);
+
+    if (bulk_import_is_archive(job->source)) {
+        job->extract_dir = extract_archive(job->source, &res->error);
+        root = job->extract_dir;
+    }
+
+    res->paths = g_ptr_array_new_with_free_func(g_free);
+    if (root) {
+        collect_profiles(root, 0, res->paths);
+        g_ptr_array_sort(res->paths, compare_paths);
+    }
+
+    g_idle_add(on_scan_done, res);
+    return NULL;
+}
+
+/**
+ * Cancel / Close button
+ */
+static void on_close_clicked(GtkButton *button, gpointer data) {
+    (void)button;
+    BulkImport *job = (BulkImport *)data;
+
+    if (job->done) {
+        gtk_widget_destroy(job->window);
+        return;
+    }
+
+    /* Outstanding reads and imports settle, nothing new starts */
+    g_atomic_int_set(&job->cancelled, 1);
+    gtk_widget_set_sensitive(job->close_button, FALSE);
+    pump_imports(job);
+}
+
+/**
+ * Window destroyed - detach the UI; the job finishes in the background
+ */
+static void on_window_destroy(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    BulkImport *job = (BulkImport *)data;
+
+    g_atomic_int_set(&job->cancelled, 1);
+    job->window = NULL;
+    job->status_label = NULL;
+    job->progress = NULL;
+    job->close_button = NULL;
+    job_unref(job);
+}
+
+/**
+ * Build the progress window
+ */
+static void create_window(BulkImport *job) {
+    job->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_title(GTK_WINDOW(job->window), "Import Profiles");
+    gtk_window_set_default_size(GTK_WINDOW(job->window), 560, 420);
+    gtk_window_set_position(GTK_WINDOW(job->window), GTK_WIN_POS_CENTER);
+
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(box), 12);
+    gtk_container_add(GTK_CONTAINER(job->window), box);
+
+    job->status_label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(job->status_label), 0.0);
+    gtk_label_set_ellipsize(GTK_LABEL(job->status_label), PANGO_ELLIPSIZE_MIDDLE);
+    gtk_box_pack_start(GTK_BOX(box), job->status_label, FALSE, FALSE, 0);
+
+    job->progress = gtk_progress_bar_new();
+    gtk_box_pack_start(GTK_BOX(box), job->progress, FALSE, FALSE, 0);
+
+    /* Per-file results */
+    GtkWidget *scrolled = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),
+                                   GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_shadow_type(GTK_SCROLLED_WINDOW(scrolled), GTK_SHADOW_IN);
+
+    GtkWidget *tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(job->store));
+    GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+    g_object_set(renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes(
+        "Profile", renderer, "text", COL_FILE, NULL);
+    gtk_tree_view_column_set_expand(column, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(tree_view), column);
+
+    renderer = gtk_cell_renderer_text_new();
+    g_object_set(renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    column = gtk_tree_view_column_new_with_attributes(
+        "Result", renderer, "text", COL_RESULT, NULL);
+    gtk_tree_view_column_set_expand(column, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(tree_view), column);
+
+    gtk_container_add(GTK_CONTAINER(scrolled), tree_view);
+    gtk_box_pack_start(GTK_BOX(box), scrolled, TRUE, TRUE, 0);
+
+    /* Button bar */
+    GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_widget_set_margin_top(button_box, 4);
+    job->close_button = gtk_button_new_with_label("Cancel");
+    g_signal_connect(job->close_button, "clicked", G_CALLBACK(on_close_clicked), job);
+    gtk_box_pack_end(GTK_BOX(button_box), job->close_button, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(box), button_box, FALSE, FALSE, 0);
+
+    g_signal_connect(job->window, "destroy", G_CALLBACK(on_window_destroy), job_ref(job));
+
+    update_status(job);
+    gtk_widget_show_all(job->window);
+}
+
+/**
+ * Start importing a directory or archive and show the progress window
+ */
+int bulk_import_start(sd_bus *bus, const char *source,
+                      BulkImportDoneCallback done, void *user_data) {
+    if (!bus || !source) {
+        return -EINVAL;
+    }
+
+    GError *error = NULL;
+    BulkImport *job = g_malloc0(sizeof(BulkImport));
+    job->ref_count = 1;
+    job->bus = bus;
+    job->source = g_strdup(source);
+    job->items = g_ptr_array_new_with_free_func((GDestroyNotify)import_item_free);
+    job->known = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, NULL);
+    job->store = gtk_list_store_new(COL_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_STRING);
+    job->done_cb = done;
+    job->user_data = user_data;
+    g_queue_init(&job->ready);
+
+    job->readers = g_thread_pool_new(read_item, NULL, BULK_IMPORT_READERS, FALSE, &error);
+    if (!job->readers) {
+        logger_error("Bulk import: failed to start reader threads: %s",
+                     error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        job_unref(job);
+        return -ENOMEM;
+    }
+
+    create_window(job);
+
+    ScanResult *res = g_malloc0(sizeof(ScanResult));
+    res->job = job_ref(job);
+    g_thread_unref(g_thread_new("bulk-import-scan", scan_thread, res));
+
+    /* The window and outstanding work hold their own references */
+    job_unref(job);
+    return 0;
+}
+
+/* ──────────────────────────────────────────────────────────────
+ * Interactive import
+ * ────────────────────────────────────────────────────────────── */
+
+/* State of one interactive import, carried across its dialogs */
+typedef struct {
+    sd_bus *bus;
+    char *config_name;
+    char *contents;
+    BulkImportDoneCallback done;
+    void *user_data;
+} InteractiveImport;
+
+static InteractiveImport* interactive_import_new(sd_bus *bus, BulkImportDoneCallback done,
+                                                 void *user_data) {
+    InteractiveImport *imp = g_malloc0(sizeof(InteractiveImport));
+    imp->bus = bus;
+    imp->done = done;
+    imp->user_data = user_data;
+    return imp;
+}
+
+/**
+ * Report the outcome and free the import
+ */
+static void interactive_import_finish(InteractiveImport *imp, unsigned int imported) {
+    if (imp->done) {
+        imp->done(imported, imp->user_data);
+    }
+    g_free(imp->config_name);
+    g_free(imp->contents);
+    g_free(imp);
+}
+
+/**
+ * Import call for a single profile completed
+ */
+static void on_single_imported(const char *config_path, int result,
+                               const char *error_message, void *user_data) {
+    InteractiveImport *imp = (InteractiveImport *)user_data;
+    char msg[256];
+
+    if (result < 0) {
+        logger_error("Failed to import configuration %s: %s", imp->config_name,
+                     error_message ? error_message : g_strerror(-result));
+        snprintf(msg, sizeof(msg),
+                 "Failed to import configuration '%s'.\n\n"
+                 "Check if the configuration already exists.", imp->config_name);
+        dialog_show_error("Import Error", msg);
+        interactive_import_finish(imp, 0);
+        return;
+    }
+
+    logger_info("Successfully imported persistent configuration: %s -> %s",
+                imp->config_name, config_path);
+    snprintf(msg, sizeof(msg), "Configuration '%s' imported successfully.",
+             imp->config_name);
+    dialog_show_info("Import Successful", msg);
+    interactive_import_finish(imp, 1);
+}
+
+/**
+ * Name prompt closed
+ */
+static void on_import_name_entered(char *config_name, gpointer user_data) {
+    InteractiveImport *imp = (InteractiveImport *)user_data;
+
+    if (!config_name) {
+        logger_info("Import cancelled by user");
+        interactive_import_finish(imp, 0);
+        return;
+    }
+
+    imp->config_name = config_name;
+
+    /* Import configuration with persistent=true */
+    int r = config_import_async(imp->bus, imp->config_name, imp->contents, false, true,
+                                on_single_imported, imp);
+    if (r < 0) {
+        on_single_imported(NULL, r, NULL, imp);
+    }
+}
+
+/**
+ * File chooser closed
+ */
+static void on_import_file_chosen(char *file_path, gpointer user_data) {
+    InteractiveImport *imp = (InteractiveImport *)user_data;
+
+    if (!file_path) {
+        interactive_import_finish(imp, 0);  /* User cancelled */
+        return;
+    }
+
+    logger_info("Selected file: %s", file_path);
+
+    /* Archives go through the bulk importer */
+    if (bulk_import_is_archive(file_path)) {
+        bulk_import_start(imp->bus, file_path, imp->done, imp->user_data);
+        imp->done = NULL;
+        interactive_import_finish(imp, 0);
+        g_free(file_path);
+        return;
+    }
+
+    /* Read file contents */
+    char *error = NULL;
+    int r = file_read_contents(file_path, &imp->contents, &error);
+    if (r < 0) {
+        logger_error("Failed to read file: %s", error ? error : "Unknown error");
+        dialog_show_error("Import Error", error ? error : "Failed to read file");
+        g_free(error);
+        g_free(file_path);
+        interactive_import_finish(imp, 0);
+        return;
+    }
+
+    /* Extract default config name from filename */
+    char *default_name = g_path_get_basename(file_path);
+
+    /* Remove .ovpn or .conf extension for default name */
+    char *dot = strrchr(default_name, '.');
+    if (dot && (strcmp(dot, ".ovpn") == 0 || strcmp(dot, ".conf") == 0)) {
+        *dot = '\0';
+    }
+
+    /* Prompt user for config name */
+    dialog_get_text_input("Import Configuration", "Configuration name:", default_name,
+                          on_import_name_entered, imp);
+
+    g_free(default_name);
+    g_free(file_path);
+}
+
+/**
+ * Folder chooser closed
+ */
+static void on_import_folder_chosen(char *folder, gpointer user_data) {
+    InteractiveImport *imp = (InteractiveImport *)user_data;
+
+    if (folder) {
+        bulk_import_start(imp->bus, folder, imp->done, imp->user_data);
+        imp->done = NULL;
+        g_free(folder);
+    }
+    interactive_import_finish(imp, 0);
+}
+
+/**
+ * Ask for a profile or archive and import it
+ */
+void bulk_import_choose_file(sd_bus *bus, BulkImportDoneCallback done, void *user_data) {
+    if (!bus) {
+        logger_error("No D-Bus connection available");
+        dialog_show_error("Import Error", "No D-Bus connection available");
+        return;
+    }
+
+    file_chooser_select_ovpn("Import OpenVPN Configuration", on_import_file_chosen,
+                             interactive_import_new(bus, done, user_data));
+}
+
+/**
+ * Ask for a folder and bulk-import it
+ */
+void bulk_import_choose_folder(sd_bus *bus, BulkImportDoneCallback done, void *user_data) {
+    if (!bus) {
+        logger_error("No D-Bus connection available");
+        dialog_show_error("Import Error", "No D-Bus connection available");
+        return;
+    }
+
+    file_chooser_select_folder("Import Folder of OpenVPN Configurations",
+                               on_import_folder_chosen,
+                               interactive_import_new(bus, done, user_data));
+}
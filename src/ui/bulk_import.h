@@ -0,0 +1,67 @@
+#ifndef BULK_IMPORT_H
+#define BULK_IMPORT_H
+
+#include <stdbool.h>
+#include <systemd/sd-bus.h>
+
+/**
+ * Bulk Import
+ *
+ * Imports every .ovpn/.conf profile in a directory or archive (.zip,
+ * .tar, .tar.gz, .tgz, .tar.xz). Files are read, validated and hashed on
+ * worker threads, profiles already present (same content) are skipped,
+ * and Import calls are pipelined to the configuration service with
+ * bounded concurrency. A progress window lists the result of each file.
+ */
+
+/**
+ * Called on the main loop when a bulk import has finished
+ *
+ * @param imported Number of profiles imported
+ * @param user_data Data passed to bulk_import_start
+ */
+typedef void (*BulkImportDoneCallback)(unsigned int imported, void *user_data);
+
+/**
+ * Check whether a path names a supported archive
+ *
+ * @param path File path
+ * @return true for .zip/.tar/.tar.gz/.tgz/.tar.xz
+ */
+bool bulk_import_is_archive(const char *path);
+
+/**
+ * Start importing a directory or archive and show the progress window
+ *
+ * @param bus D-Bus connection
+ * @param source Directory or archive path
+ * @param done Completion callback (can be NULL)
+ * @param user_data Data passed to done
+ * @return 0 on success, negative errno on failure
+ */
+int bulk_import_start(sd_bus *bus, const char *source,
+                      BulkImportDoneCallback done, void *user_data);
+
+/**
+ * Ask for a profile or archive and import it
+ *
+ * A single profile is imported under a name the user confirms; an
+ * archive is handed to bulk_import_start. Returns immediately, the
+ * dialogs run from the main loop.
+ *
+ * @param bus D-Bus connection
+ * @param done Completion callback (can be NULL; called with 0 if cancelled)
+ * @param user_data Data passed to done
+ */
+void bulk_import_choose_file(sd_bus *bus, BulkImportDoneCallback done, void *user_data);
+
+/**
+ * Ask for a folder and bulk-import it
+ *
+ * @param bus D-Bus connection
+ * @param done Completion callback (can be NULL)
+ * @param user_data Data passed to done
+ */
+void bulk_import_choose_folder(sd_bus *bus, BulkImportDoneCallback done, void *user_data);
+
+#endif /* BULK_IMPORT_H */
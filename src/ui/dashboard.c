@@ -2,11 +2,15 @@
 #include "widgets.h"
 #include "icons.h"
 #include "servers_tab.h"
+#include "bulk_import.h"
+#include "graph_cache.h"
 #include "../dbus/session_client.h"
 #include "../dbus/config_client.h"
 #include "../monitoring/bandwidth_monitor.h"
+#define LOG_CATEGORY LOG_CAT_UI
 #include "../utils/logger.h"
-#include "../utils/file_chooser.h"
+#include "../utils/connection_fsm.h"
+#include "../utils/scheduler.h"
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -15,6 +19,24 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
+/* Refresh intervals while the window is on screen */
+#define DASHBOARD_REFRESH_FOCUSED_SEC    2
+#define DASHBOARD_REFRESH_UNFOCUSED_SEC  10
+
+/**
+ * Widgets of one Active Connections card, kept across updates
+ */
+typedef struct {
+    GtkWidget *frame;
+    GtkWidget *header_label;
+    GtkWidget *device_label;
+    GtkWidget *button_box;
+    char *device_name;         /* Device the address line was looked up for */
+    gboolean has_ip;           /* That lookup found an address */
+    SessionState state;        /* State the buttons were built for */
+    gboolean buttons_built;
+} SessionCard;
+
 /**
  * Dashboard structure
  */
@@ -41,6 +63,7 @@ struct Dashboard {
     double aggregate_ul_history[120];
     int aggregate_write_idx;
     int aggregate_sample_count;
+    guint64 aggregate_sample_seq;   /* Samples pushed so far (graph x position) */
     /* Status bar */
     GtkWidget *status_bar;
     GtkWidget *status_label;
@@ -48,6 +71,28 @@ struct Dashboard {
     GHashTable *bandwidth_monitors;
     /* Servers tab instance */
     ServersTab *servers_tab_instance;
+    unsigned int probe_concurrency;  /* Latency probes the Servers tab runs at once */
+    /* Notebook pages; Statistics and Servers are filled in on first switch */
+    GtkWidget *connections_page;
+    GtkWidget *statistics_page;
+    GtkWidget *servers_page;
+    /* Cards kept across updates, keyed by D-Bus object path */
+    GHashTable *session_cards;     /* session_path -> SessionCard */
+    GHashTable *config_rows;       /* config_path -> GtkListBoxRow */
+    GHashTable *stat_cards;        /* session_path -> stat card widget */
+    GtkWidget *no_sessions_label;
+    GtkWidget *no_configs_row;
+    /* Sessions from the last update, used to fill pages built in between */
+    VpnSession **sessions;
+    unsigned int session_count;
+    /* Refresh scheduling: only the visible page of an on-screen window is
+     * refreshed, at a slower rate while unfocused */
+    guint refresh_id;              /* Scheduler job */
+    guint refresh_interval;        /* Seconds; 0 while suspended */
+    gint64 last_refresh_us;
+    gboolean mapped;
+    gboolean iconified;
+    gboolean focused;
     sd_bus *bus;
 };
 
@@ -56,10 +101,12 @@ static gboolean on_window_delete(GtkWidget *widget, GdkEvent *event, gpointer da
 static void on_disconnect_clicked(GtkButton *button, gpointer data);
 static void on_connect_clicked(GtkButton *button, gpointer data);
 static void on_import_clicked(GtkButton *button, gpointer data);
-static void create_session_card(Dashboard *dashboard, VpnSession *session);
-static void create_config_card(Dashboard *dashboard, VpnConfig *config);
+static void on_import_folder_clicked(GtkButton *button, gpointer data);
+static SessionCard* create_session_card(Dashboard *dashboard, VpnSession *session);
+static GtkWidget* create_config_card(Dashboard *dashboard, VpnConfig *config);
 static void create_import_config_row(Dashboard *dashboard);
 static GtkWidget* create_vpn_stat_card(Dashboard *dashboard, VpnSession *session, BandwidthMonitor *monitor);
+static void dashboard_refresh(Dashboard *dashboard);
 
 /**
  * Format elapsed time
@@ -195,97 +242,99 @@ static int get_interface_gateway(const char *device_name, char *gw_buffer, size_
     return -1;
 }
 
+/**
+ * Set a label's markup, skipping the relayout when it has not changed
+ */
+static void set_label_markup(GtkWidget *label, const char *markup) {
+    const char *current = gtk_label_get_label(GTK_LABEL(label));
+    if (!current || strcmp(current, markup) != 0) {
+        gtk_label_set_markup(GTK_LABEL(label), markup);
+    }
+}
+
+/**
+ * Set a label's text, skipping the relayout when it has not changed
+ */
+static void set_label_text(GtkWidget *label, const char *text) {
+    const char *current = gtk_label_get_label(GTK_LABEL(label));
+    if (!current || strcmp(current, text) != 0) {
+        gtk_label_set_text(GTK_LABEL(label), text);
+    }
+}
+
+/* Download (green) and upload (blue) series */
+#define GRAPH_SERIES_COLORS { {0.2, 0.8, 0.4, 1.0}, {0.2, 0.5, 0.95, 1.0} }
+#define GRAPH_THEME_COLORS  { "success_green", "primary_blue" }
+
+/* Per-card sparkline: 60 seconds of samples */
+static const GraphStyle card_graph_style = {
+    .margin = 5,
+    .grid_alpha = 0.25,
+    .span = 60.0,
+    .series_count = 2,
+    .series_color = GRAPH_SERIES_COLORS,
+    .theme_color = GRAPH_THEME_COLORS,
+};
+
+/* Aggregate graph: the last 120 refreshes */
+static const GraphStyle aggregate_graph_style = {
+    .margin = 8,
+    .grid_alpha = 0.2,
+    .span = 120.0,
+    .series_count = 2,
+    .series_color = GRAPH_SERIES_COLORS,
+    .theme_color = GRAPH_THEME_COLORS,
+};
+
 /**
  * Draw sparkline graph for stat card (compact version without axes)
  */
 static gboolean on_card_graph_draw(GtkWidget *widget, cairo_t *cr, gpointer data) {
     BandwidthMonitor *monitor = (BandwidthMonitor *)data;
+    GraphCache *cache = graph_cache_get(widget);
     int width = gtk_widget_get_allocated_width(widget);
     int height = gtk_widget_get_allocated_height(widget);
     const int margin = 5;
 
-    /* Background */
-    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.02);
-    cairo_rectangle(cr, 0, 0, width, height);
-    cairo_fill(cr);
-
-    /* Horizontal grid lines at 25%, 50%, 75% */
-    {
-        GdkRGBA grid_clr;
-        GtkStyleContext *sc = gtk_widget_get_style_context(widget);
-        if (!gtk_style_context_lookup_color(sc, "text_tertiary", &grid_clr))
-            grid_clr = (GdkRGBA){0.5, 0.5, 0.5, 1.0};
-        grid_clr.alpha = 0.25;
-        cairo_set_source_rgba(cr, grid_clr.red, grid_clr.green, grid_clr.blue, grid_clr.alpha);
-        cairo_set_line_width(cr, 0.5);
-        double dashes[] = {4.0, 4.0};
-        cairo_set_dash(cr, dashes, 2, 0);
-        for (int i = 1; i <= 3; i++) {
-            double gy = margin + (height - 2 * margin) * (1.0 - i * 0.25);
-            cairo_move_to(cr, margin, gy);
-            cairo_line_to(cr, width - margin, gy);
-            cairo_stroke(cr);
-        }
-        cairo_set_dash(cr, NULL, 0, 0);
-    }
-
-    if (!monitor) {
-        return TRUE;
-    }
-
-    /* Get bandwidth samples (last 60 seconds for sparkline) */
+    /* Get bandwidth samples (last 60 seconds for sparkline), newest first */
     BandwidthSample samples[60];
     unsigned int sample_count = 0;
-    if (bandwidth_monitor_get_samples(monitor, samples, 60, &sample_count) < 0 || sample_count == 0) {
-        /* Draw a flat line at zero when no data */
-        cairo_set_source_rgba(cr, 0.2, 0.8, 0.4, 0.3);
-        cairo_move_to(cr, margin, margin + (height - 2 * margin) / 2);
-        cairo_line_to(cr, width - margin, margin + (height - 2 * margin) / 2);
-        cairo_stroke(cr);
-        return TRUE;
-    }
-
-    /* Filter out samples with timestamp=0 */
-    BandwidthSample valid_samples[60];
-    unsigned int valid_count = 0;
-    for (unsigned int i = 0; i < sample_count; i++) {
-        if (samples[i].timestamp > 0) {
-            valid_samples[valid_count++] = samples[i];
+    if (monitor && bandwidth_monitor_get_samples(monitor, samples, 60, &sample_count) >= 0) {
+        /* Filter out samples with timestamp=0 */
+        unsigned int valid_count = 0;
+        for (unsigned int i = 0; i < sample_count; i++) {
+            if (samples[i].timestamp > 0) {
+                samples[valid_count++] = samples[i];
+            }
         }
+        sample_count = valid_count;
     }
 
-    if (valid_count == 0) {
-        /* No valid samples */
-        cairo_set_source_rgba(cr, 0.2, 0.8, 0.4, 0.3);
-        cairo_move_to(cr, margin, margin + (height - 2 * margin) / 2);
-        cairo_line_to(cr, width - margin, margin + (height - 2 * margin) / 2);
-        cairo_stroke(cr);
-        return TRUE;
-    }
-
-    /* Copy valid samples back */
-    for (unsigned int i = 0; i < valid_count; i++) {
-        samples[i] = valid_samples[i];
-    }
-    sample_count = valid_count;
-
-    /* Find max rate for scaling */
+    /* Rates between consecutive samples, oldest first, placed at the
+     * newer sample's time */
+    GraphPoint points[60];
+    unsigned int point_count = 0;
     double max_rate = 0.0;
-    for (unsigned int i = 0; i < sample_count - 1; i++) {
+    for (unsigned int i = sample_count > 1 ? sample_count - 1 : 0; i-- > 0; ) {
         time_t time_diff = samples[i].timestamp - samples[i+1].timestamp;
         if (time_diff <= 0) {
             continue;  /* Skip invalid samples with same/backwards timestamps */
         }
 
-        double upload_rate = (double)(samples[i].bytes_out - samples[i+1].bytes_out) / (double)time_diff;
         double download_rate = (double)(samples[i].bytes_in - samples[i+1].bytes_in) / (double)time_diff;
+        double upload_rate = (double)(samples[i].bytes_out - samples[i+1].bytes_out) / (double)time_diff;
 
         /* Absolute values for scaling (handle negative rates from counter resets) */
-        if (upload_rate < 0) upload_rate = -upload_rate;
         if (download_rate < 0) download_rate = -download_rate;
+        if (upload_rate < 0) upload_rate = -upload_rate;
 
-        if (upload_rate > max_rate) max_rate = upload_rate;
         if (download_rate > max_rate) max_rate = download_rate;
+        if (upload_rate > max_rate) max_rate = upload_rate;
+
+        points[point_count].t = (double)samples[i].timestamp;
+        points[point_count].value[0] = download_rate;
+        points[point_count].value[1] = upload_rate;
+        point_count++;
     }
 
     /* Use adaptive minimum scale: if there's no traffic, use small scale; otherwise 1 KB/s */
@@ -295,11 +344,27 @@ static gboolean on_card_graph_draw(GtkWidget *widget, cairo_t *cr, gpointer data
         max_rate = 1024.0;  /* 1 KB/s scale for active connections */
     }
 
+    /* Background, grid and series from the offscreen layers */
+    graph_cache_draw(cache, cr, points, point_count, max_rate);
+
+    if (!monitor) {
+        return TRUE;
+    }
+
     int graph_width = width - 2 * margin;
     int graph_height = height - 2 * margin;
 
-    /* Special case: if only one sample, draw points instead of lines */
-    if (sample_count == 1) {
+    if (sample_count == 0) {
+        /* Draw a flat line at zero when no data */
+        cairo_set_source_rgba(cr, 0.2, 0.8, 0.4, 0.3);
+        cairo_move_to(cr, margin, margin + graph_height / 2);
+        cairo_line_to(cr, width - margin, margin + graph_height / 2);
+        cairo_stroke(cr);
+        return TRUE;
+    }
+
+    /* Special case: too few samples for a line, draw points instead */
+    if (point_count < 2) {
         double x = margin + graph_width;  /* Right edge */
         double y = margin + graph_height;  /* Bottom (zero rate) */
 
@@ -316,116 +381,6 @@ static gboolean on_card_graph_draw(GtkWidget *widget, cairo_t *cr, gpointer data
         return TRUE;
     }
 
-    /* Draw download line (green) with gradient fill */
-    cairo_set_line_width(cr, 2.0);
-    cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
-    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
-
-    gboolean first_point = TRUE;
-    double last_y = margin + graph_height;  /* Track last Y for extending to oldest sample */
-    for (unsigned int i = 0; i < sample_count - 1; i++) {
-        time_t time_diff = samples[i].timestamp - samples[i+1].timestamp;
-        if (time_diff <= 0) {
-            continue;  /* Skip invalid samples */
-        }
-
-        double rate = (samples[i].bytes_in - samples[i+1].bytes_in) / (double)time_diff;
-        /* Use time-based positioning: newer samples on right, older scroll left */
-        double time_offset = samples[0].timestamp - samples[i].timestamp;
-        double x = margin + graph_width - (time_offset * graph_width / 60.0);
-        double y = margin + graph_height - (rate / max_rate * graph_height);
-        last_y = y;
-
-        if (first_point) {
-            cairo_move_to(cr, x, y);
-            first_point = FALSE;
-        } else {
-            cairo_line_to(cr, x, y);
-        }
-    }
-
-    /* Extend line to the oldest sample's position to complete the graph */
-    double fill_left_x = margin;  /* Default: left margin */
-    if (!first_point && sample_count >= 2) {
-        double oldest_time_offset = samples[0].timestamp - samples[sample_count - 1].timestamp;
-        double oldest_x = margin + graph_width - (oldest_time_offset * graph_width / 60.0);
-        /* Clamp to visible area */
-        if (oldest_x < margin) oldest_x = margin;
-        cairo_line_to(cr, oldest_x, last_y);
-        fill_left_x = oldest_x;
-    }
-
-    /* Complete the path to create a filled area - go down then right along bottom */
-    cairo_line_to(cr, fill_left_x, margin + graph_height);  /* Down to bottom at current X */
-    cairo_line_to(cr, margin + graph_width, margin + graph_height);  /* Right along bottom */
-    cairo_close_path(cr);
-
-    /* Create gradient fill from opaque to transparent */
-    cairo_pattern_t *download_gradient = cairo_pattern_create_linear(0, margin, 0, margin + graph_height);
-    cairo_pattern_add_color_stop_rgba(download_gradient, 0.0, 0.2, 0.8, 0.4, 0.3);
-    cairo_pattern_add_color_stop_rgba(download_gradient, 1.0, 0.2, 0.8, 0.4, 0.0);
-    cairo_set_source(cr, download_gradient);
-    cairo_fill_preserve(cr);
-    cairo_pattern_destroy(download_gradient);
-
-    /* Stroke the line */
-    cairo_set_source_rgba(cr, 0.2, 0.8, 0.4, 0.8);
-    cairo_stroke(cr);
-
-    /* Draw upload line (blue) with gradient fill */
-    cairo_set_line_width(cr, 2.0);
-
-    first_point = TRUE;
-    last_y = margin + graph_height;  /* Reset for upload graph */
-    for (unsigned int i = 0; i < sample_count - 1; i++) {
-        time_t time_diff = samples[i].timestamp - samples[i+1].timestamp;
-        if (time_diff <= 0) {
-            continue;  /* Skip invalid samples */
-        }
-
-        double rate = (samples[i].bytes_out - samples[i+1].bytes_out) / (double)time_diff;
-        /* Use time-based positioning: newer samples on right, older scroll left */
-        double time_offset = samples[0].timestamp - samples[i].timestamp;
-        double x = margin + graph_width - (time_offset * graph_width / 60.0);
-        double y = margin + graph_height - (rate / max_rate * graph_height);
-        last_y = y;
-
-        if (first_point) {
-            cairo_move_to(cr, x, y);
-            first_point = FALSE;
-        } else {
-            cairo_line_to(cr, x, y);
-        }
-    }
-
-    /* Extend line to the oldest sample's position to complete the graph */
-    fill_left_x = margin;  /* Reset for upload graph */
-    if (!first_point && sample_count >= 2) {
-        double oldest_time_offset = samples[0].timestamp - samples[sample_count - 1].timestamp;
-        double oldest_x = margin + graph_width - (oldest_time_offset * graph_width / 60.0);
-        /* Clamp to visible area */
-        if (oldest_x < margin) oldest_x = margin;
-        cairo_line_to(cr, oldest_x, last_y);
-        fill_left_x = oldest_x;
-    }
-
-    /* Complete the path to create a filled area - go down then right along bottom */
-    cairo_line_to(cr, fill_left_x, margin + graph_height);  /* Down to bottom at current X */
-    cairo_line_to(cr, margin + graph_width, margin + graph_height);  /* Right along bottom */
-    cairo_close_path(cr);
-
-    /* Create gradient fill from opaque to transparent */
-    cairo_pattern_t *upload_gradient = cairo_pattern_create_linear(0, margin, 0, margin + graph_height);
-    cairo_pattern_add_color_stop_rgba(upload_gradient, 0.0, 0.2, 0.5, 0.95, 0.3);
-    cairo_pattern_add_color_stop_rgba(upload_gradient, 1.0, 0.2, 0.5, 0.95, 0.0);
-    cairo_set_source(cr, upload_gradient);
-    cairo_fill_preserve(cr);
-    cairo_pattern_destroy(upload_gradient);
-
-    /* Stroke the line */
-    cairo_set_source_rgba(cr, 0.2, 0.5, 0.95, 0.8);
-    cairo_stroke(cr);
-
     /* Overlay current rate text in graph corners */
     {
         BandwidthRate overlay_rate;
@@ -436,27 +391,22 @@ static gboolean on_card_graph_draw(GtkWidget *widget, cairo_t *cr, gpointer data
             snprintf(dl_f, sizeof(dl_f), "↓ %s/s", dl_t);
             snprintf(ul_f, sizeof(ul_f), "↑ %s/s", ul_t);
 
-            GtkStyleContext *sc = gtk_widget_get_style_context(widget);
             PangoLayout *layout = pango_cairo_create_layout(cr);
             PangoFontDescription *font = pango_font_description_from_string("Monospace Bold 8");
             pango_layout_set_font_description(layout, font);
 
             /* Download - top left (green) */
             GdkRGBA dl_clr;
-            if (!gtk_style_context_lookup_color(sc, "success_green", &dl_clr))
-                dl_clr = (GdkRGBA){0.2, 0.8, 0.4, 1.0};
-            dl_clr.alpha = 0.9;
-            cairo_set_source_rgba(cr, dl_clr.red, dl_clr.green, dl_clr.blue, dl_clr.alpha);
+            graph_cache_get_color(cache, 0, &dl_clr);
+            cairo_set_source_rgba(cr, dl_clr.red, dl_clr.green, dl_clr.blue, 0.9);
             pango_layout_set_text(layout, dl_f, -1);
             cairo_move_to(cr, margin + 4, margin + 2);
             pango_cairo_show_layout(cr, layout);
 
             /* Upload - top right (blue) */
             GdkRGBA ul_clr;
-            if (!gtk_style_context_lookup_color(sc, "primary_blue", &ul_clr))
-                ul_clr = (GdkRGBA){0.2, 0.5, 0.95, 1.0};
-            ul_clr.alpha = 0.9;
-            cairo_set_source_rgba(cr, ul_clr.red, ul_clr.green, ul_clr.blue, ul_clr.alpha);
+            graph_cache_get_color(cache, 1, &ul_clr);
+            cairo_set_source_rgba(cr, ul_clr.red, ul_clr.green, ul_clr.blue, 0.9);
             pango_layout_set_text(layout, ul_f, -1);
             PangoRectangle ink, logical;
             pango_layout_get_pixel_extents(layout, &ink, &logical);
@@ -476,139 +426,24 @@ static gboolean on_card_graph_draw(GtkWidget *widget, cairo_t *cr, gpointer data
  */
 static gboolean on_aggregate_graph_draw(GtkWidget *widget, cairo_t *cr, gpointer data) {
     Dashboard *dashboard = (Dashboard *)data;
-    int width = gtk_widget_get_allocated_width(widget);
-    int height = gtk_widget_get_allocated_height(widget);
-    const int margin = 8;
-
-    /* Background */
-    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.02);
-    cairo_rectangle(cr, 0, 0, width, height);
-    cairo_fill(cr);
-
-    /* Grid lines */
-    {
-        GdkRGBA grid_clr;
-        GtkStyleContext *sc = gtk_widget_get_style_context(widget);
-        if (!gtk_style_context_lookup_color(sc, "text_tertiary", &grid_clr))
-            grid_clr = (GdkRGBA){0.5, 0.5, 0.5, 1.0};
-        grid_clr.alpha = 0.2;
-        cairo_set_source_rgba(cr, grid_clr.red, grid_clr.green, grid_clr.blue, grid_clr.alpha);
-        cairo_set_line_width(cr, 0.5);
-        double dashes[] = {4.0, 4.0};
-        cairo_set_dash(cr, dashes, 2, 0);
-        for (int i = 1; i <= 3; i++) {
-            double gy = margin + (height - 2 * margin) * (1.0 - i * 0.25);
-            cairo_move_to(cr, margin, gy);
-            cairo_line_to(cr, width - margin, gy);
-            cairo_stroke(cr);
-        }
-        cairo_set_dash(cr, NULL, 0, 0);
-    }
-
     int count = dashboard->aggregate_sample_count;
-    if (count < 2) return TRUE;
 
-    /* Find max rate for scaling */
+    /* History ring as points, oldest first, numbered by sample */
+    GraphPoint points[120];
     double max_rate = 1024.0;
     for (int i = 0; i < count; i++) {
-        int idx = (dashboard->aggregate_write_idx - 1 - i + 120) % 120;
-        if (dashboard->aggregate_dl_history[idx] > max_rate)
-            max_rate = dashboard->aggregate_dl_history[idx];
-        if (dashboard->aggregate_ul_history[idx] > max_rate)
-            max_rate = dashboard->aggregate_ul_history[idx];
-    }
-
-    int gw = width - 2 * margin;
-    int gh = height - 2 * margin;
-
-    /* Draw download line (green) with gradient fill */
-    cairo_set_line_width(cr, 2.0);
-    cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
-    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
-
-    gboolean first_point = TRUE;
-    for (int i = 0; i < count; i++) {
-        int idx = (dashboard->aggregate_write_idx - 1 - i + 120) % 120;
-        double rate = dashboard->aggregate_dl_history[idx];
-        double x = margin + gw - (i * gw / 120.0);
-        double y = margin + gh - (rate / max_rate * gh);
-        if (x < margin) break;
-
-        if (first_point) {
-            cairo_move_to(cr, x, y);
-            first_point = FALSE;
-        } else {
-            cairo_line_to(cr, x, y);
-        }
-    }
-
-    if (!first_point) {
-        /* Save path for stroke, then fill */
-        cairo_path_t *dl_path = cairo_copy_path(cr);
-
-        /* Complete fill area */
-        double cur_x, cur_y;
-        cairo_get_current_point(cr, &cur_x, &cur_y);
-        cairo_line_to(cr, cur_x, margin + gh);
-        cairo_line_to(cr, margin + gw, margin + gh);
-        cairo_close_path(cr);
-
-        cairo_pattern_t *dl_grad = cairo_pattern_create_linear(0, margin, 0, margin + gh);
-        cairo_pattern_add_color_stop_rgba(dl_grad, 0.0, 0.2, 0.8, 0.4, 0.3);
-        cairo_pattern_add_color_stop_rgba(dl_grad, 1.0, 0.2, 0.8, 0.4, 0.0);
-        cairo_set_source(cr, dl_grad);
-        cairo_fill(cr);
-        cairo_pattern_destroy(dl_grad);
-
-        /* Stroke the line */
-        cairo_new_path(cr);
-        cairo_append_path(cr, dl_path);
-        cairo_set_source_rgba(cr, 0.2, 0.8, 0.4, 0.8);
-        cairo_stroke(cr);
-        cairo_path_destroy(dl_path);
-    }
-
-    /* Draw upload line (blue) with gradient fill */
-    cairo_set_line_width(cr, 2.0);
-    first_point = TRUE;
-    for (int i = 0; i < count; i++) {
-        int idx = (dashboard->aggregate_write_idx - 1 - i + 120) % 120;
-        double rate = dashboard->aggregate_ul_history[idx];
-        double x = margin + gw - (i * gw / 120.0);
-        double y = margin + gh - (rate / max_rate * gh);
-        if (x < margin) break;
-
-        if (first_point) {
-            cairo_move_to(cr, x, y);
-            first_point = FALSE;
-        } else {
-            cairo_line_to(cr, x, y);
-        }
-    }
+        int age = count - 1 - i;
+        int idx = (dashboard->aggregate_write_idx - 1 - age + 120) % 120;
+        points[i].t = (double)(dashboard->aggregate_sample_seq - 1 - age);
+        points[i].value[0] = dashboard->aggregate_dl_history[idx];
+        points[i].value[1] = dashboard->aggregate_ul_history[idx];
 
-    if (!first_point) {
-        cairo_path_t *ul_path = cairo_copy_path(cr);
-
-        double cur_x, cur_y;
-        cairo_get_current_point(cr, &cur_x, &cur_y);
-        cairo_line_to(cr, cur_x, margin + gh);
-        cairo_line_to(cr, margin + gw, margin + gh);
-        cairo_close_path(cr);
-
-        cairo_pattern_t *ul_grad = cairo_pattern_create_linear(0, margin, 0, margin + gh);
-        cairo_pattern_add_color_stop_rgba(ul_grad, 0.0, 0.2, 0.5, 0.95, 0.3);
-        cairo_pattern_add_color_stop_rgba(ul_grad, 1.0, 0.2, 0.5, 0.95, 0.0);
-        cairo_set_source(cr, ul_grad);
-        cairo_fill(cr);
-        cairo_pattern_destroy(ul_grad);
-
-        cairo_new_path(cr);
-        cairo_append_path(cr, ul_path);
-        cairo_set_source_rgba(cr, 0.2, 0.5, 0.95, 0.8);
-        cairo_stroke(cr);
-        cairo_path_destroy(ul_path);
+        /* Find max rate for scaling */
+        if (points[i].value[0] > max_rate) max_rate = points[i].value[0];
+        if (points[i].value[1] > max_rate) max_rate = points[i].value[1];
     }
 
+    graph_cache_draw(graph_cache_get(widget), cr, points, (unsigned int)count, max_rate);
     return TRUE;
 }
 
@@ -640,17 +475,10 @@ static GtkWidget* create_vpn_stat_card(Dashboard *dashboard, VpnSession *session
     GtkWidget *header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
     gtk_container_set_border_width(GTK_CONTAINER(header), 0);
 
-    /* Status indicator */
-    const char *status_icon = "●";
-    GtkWidget *status_label = gtk_label_new(status_icon);
-    if (session->state == SESSION_STATE_CONNECTED) {
-        gtk_label_set_markup(GTK_LABEL(status_label), "<span foreground='#34C759'>●</span>");
-    } else if (session->state == SESSION_STATE_CONNECTING) {
-        gtk_label_set_markup(GTK_LABEL(status_label), "<span foreground='#FF9500'>●</span>");
-    } else {
-        gtk_label_set_markup(GTK_LABEL(status_label), "<span foreground='#FF3B30'>●</span>");
-    }
+    /* Status indicator (colored by update_vpn_stat_card) */
+    GtkWidget *status_label = gtk_label_new("●");
     gtk_box_pack_start(GTK_BOX(header), status_label, FALSE, FALSE, 0);
+    g_object_set_data(G_OBJECT(card), "status-label", status_label);
 
     /* Session name and protocol */
     char header_text[256];
@@ -661,30 +489,12 @@ static GtkWidget* create_vpn_stat_card(Dashboard *dashboard, VpnSession *session
     gtk_label_set_xalign(GTK_LABEL(name_label), 0.0);
     gtk_box_pack_start(GTK_BOX(header), name_label, TRUE, TRUE, 0);
 
-    /* Quality badge based on error ratio */
-    {
-        BandwidthSample q_sample;
-        if (bandwidth_monitor_get_latest_sample(monitor, &q_sample) >= 0) {
-            uint64_t total_pkts = q_sample.packets_in + q_sample.packets_out;
-            uint64_t total_errs = q_sample.errors_in + q_sample.errors_out +
-                                  q_sample.dropped_in + q_sample.dropped_out;
-            const char *q_text = NULL, *q_class = NULL;
-            if (total_pkts > 100) {
-                double ratio = (double)total_errs / (double)total_pkts;
-                if (ratio < 0.001)      { q_text = "Excellent"; q_class = "quality-excellent"; }
-                else if (ratio < 0.01)  { q_text = "Good";      q_class = "quality-good"; }
-                else if (ratio < 0.05)  { q_text = "Fair";      q_class = "quality-fair"; }
-                else                    { q_text = "Poor";      q_class = "quality-poor"; }
-            }
-            if (q_text) {
-                GtkWidget *badge = gtk_label_new(q_text);
-                GtkStyleContext *qc = gtk_widget_get_style_context(badge);
-                gtk_style_context_add_class(qc, "quality-badge");
-                gtk_style_context_add_class(qc, q_class);
-                gtk_box_pack_end(GTK_BOX(header), badge, FALSE, FALSE, 0);
-            }
-        }
-    }
+    /* Quality badge (shown once there is enough traffic to judge) */
+    GtkWidget *badge = gtk_label_new(NULL);
+    gtk_style_context_add_class(gtk_widget_get_style_context(badge), "quality-badge");
+    gtk_widget_set_no_show_all(badge, TRUE);
+    gtk_box_pack_end(GTK_BOX(header), badge, FALSE, FALSE, 0);
+    g_object_set_data(G_OBJECT(card), "quality-badge", badge);
 
     gtk_box_pack_start(GTK_BOX(card), header, FALSE, FALSE, 0);
 
@@ -716,6 +526,7 @@ static GtkWidget* create_vpn_stat_card(Dashboard *dashboard, VpnSession *session
     GtkWidget *graph = gtk_drawing_area_new();
     gtk_widget_set_size_request(graph, -1, 140);
     gtk_style_context_add_class(gtk_widget_get_style_context(graph), "card-graph-area");
+    graph_cache_attach(graph, &card_graph_style);
     g_signal_connect(graph, "draw", G_CALLBACK(on_card_graph_draw), monitor);
     g_object_set_data(G_OBJECT(card), "graph-area", graph);
     gtk_box_pack_start(GTK_BOX(card), graph, FALSE, FALSE, 5);
@@ -786,6 +597,12 @@ static GtkWidget* create_vpn_stat_card(Dashboard *dashboard, VpnSession *session
     gtk_style_context_add_class(gtk_widget_get_style_context(cipher_label), "card-stats-label");
     gtk_grid_attach(GTK_GRID(detail_grid), cipher_label, 1, 3, 1, 1);
 
+    GtkWidget *setup_label = gtk_label_new("Setup:   -");
+    gtk_label_set_xalign(GTK_LABEL(setup_label), 0.0);
+    gtk_style_context_add_class(gtk_widget_get_style_context(setup_label), "card-stats-label");
+    gtk_grid_attach(GTK_GRID(detail_grid), setup_label, 1, 4, 1, 1);
+    g_object_set_data(G_OBJECT(card), "setup-label", setup_label);
+
     gtk_box_pack_start(GTK_BOX(card), detail_grid, FALSE, FALSE, 0);
 
     /* More Info Revealer Section */
@@ -946,6 +763,140 @@ static GtkWidget* create_vpn_stat_card(Dashboard *dashboard, VpnSession *session
     return card;
 }
 
+/**
+ * Show how long the last connect took, phases and history in the tooltip
+ */
+static void update_setup_label(GtkWidget *label, const char *config_name) {
+    const ConnectionLatencyStats *st = connection_fsm_get_stats(connection_fsm_lookup(config_name));
+    if (!label || !st || !st->has_last) {
+        return;
+    }
+
+    char text[64];
+    snprintf(text, sizeof(text), "Setup:   %.1f s", st->last.total_us / 1e6);
+    set_label_text(label, text);
+
+    GString *tip = g_string_new("Last connect:");
+    for (unsigned int p = 0; p < FSM_PHASE_COUNT; p++) {
+        if (st->last.phase_us[p] > 0) {
+            g_string_append_printf(tip, "\n  %-10s %6.2f s",
+                                   connection_fsm_phase_name((ConnectionPhase)p),
+                                   st->last.phase_us[p] / 1e6);
+        }
+    }
+    g_string_append_printf(tip, "\n%u connects, %u failed", st->connects, st->failures);
+    int64_t p50 = connection_fsm_histogram_quantile(st->connected_hist, 0.5);
+    int64_t p90 = connection_fsm_histogram_quantile(st->connected_hist, 0.9);
+    if (p50 >= 0) {
+        g_string_append_printf(tip, "\nTo connected: p50 ≤ %.1f s, p90 ≤ %.1f s",
+                               p50 / 1000.0, p90 / 1000.0);
+    }
+    int64_t auth50 = connection_fsm_histogram_quantile(st->auth_hist, 0.5);
+    if (auth50 >= 0) {
+        g_string_append_printf(tip, "\nTo auth: p50 ≤ %.1f s", auth50 / 1000.0);
+    }
+
+    char *old_tip = gtk_widget_get_tooltip_text(label);
+    if (g_strcmp0(old_tip, tip->str) != 0) {
+        gtk_widget_set_tooltip_text(label, tip->str);
+    }
+    g_free(old_tip);
+    g_string_free(tip, TRUE);
+}
+
+/**
+ * Refresh a VPN statistics card's live values in place
+ */
+static void update_vpn_stat_card(GtkWidget *card, VpnSession *session, BandwidthMonitor *monitor) {
+    GtkWidget *status_label = g_object_get_data(G_OBJECT(card), "status-label");
+    if (status_label) {
+        if (session->state == SESSION_STATE_CONNECTED) {
+            set_label_markup(status_label, "<span foreground='#34C759'>●</span>");
+        } else if (session->state == SESSION_STATE_CONNECTING) {
+            set_label_markup(status_label, "<span foreground='#FF9500'>●</span>");
+        } else {
+            set_label_markup(status_label, "<span foreground='#FF3B30'>●</span>");
+        }
+    }
+
+    /* Throughput labels */
+    BandwidthRate rate;
+    if (bandwidth_monitor_get_rate(monitor, &rate) >= 0) {
+        GtkWidget *download_label = g_object_get_data(G_OBJECT(card), "download-label");
+        GtkWidget *upload_label = g_object_get_data(G_OBJECT(card), "upload-label");
+
+        if (download_label && upload_label) {
+            char text[256];
+            format_bytes((uint64_t)rate.download_rate_bps, text, sizeof(text));
+            char label_text[256];
+            snprintf(label_text, sizeof(label_text), "↓ %s/s", text);
+            set_label_text(download_label, label_text);
+
+            format_bytes((uint64_t)rate.upload_rate_bps, text, sizeof(text));
+            snprintf(label_text, sizeof(label_text), "↑ %s/s", text);
+            set_label_text(upload_label, label_text);
+        }
+    }
+
+    /* Packet statistics and quality badge */
+    BandwidthSample sample;
+    if (bandwidth_monitor_get_latest_sample(monitor, &sample) >= 0) {
+        GtkWidget *sent_label = g_object_get_data(G_OBJECT(card), "sent-label");
+        GtkWidget *received_label = g_object_get_data(G_OBJECT(card), "received-label");
+        GtkWidget *errors_label = g_object_get_data(G_OBJECT(card), "errors-label");
+        char label_text[256];
+
+        if (sent_label) {
+            snprintf(label_text, sizeof(label_text), "Sent:     %lu", sample.packets_out);
+            set_label_text(sent_label, label_text);
+        }
+        if (received_label) {
+            snprintf(label_text, sizeof(label_text), "Received: %lu", sample.packets_in);
+            set_label_text(received_label, label_text);
+        }
+        if (errors_label) {
+            snprintf(label_text, sizeof(label_text), "Errors:   %lu",
+                    sample.errors_in + sample.errors_out);
+            set_label_text(errors_label, label_text);
+        }
+
+        /* Quality based on error ratio */
+        GtkWidget *badge = g_object_get_data(G_OBJECT(card), "quality-badge");
+        uint64_t total_pkts = sample.packets_in + sample.packets_out;
+        uint64_t total_errs = sample.errors_in + sample.errors_out +
+                              sample.dropped_in + sample.dropped_out;
+        const char *q_text = NULL, *q_class = NULL;
+        if (total_pkts > 100) {
+            double ratio = (double)total_errs / (double)total_pkts;
+            if (ratio < 0.001)      { q_text = "Excellent"; q_class = "quality-excellent"; }
+            else if (ratio < 0.01)  { q_text = "Good";      q_class = "quality-good"; }
+            else if (ratio < 0.05)  { q_text = "Fair";      q_class = "quality-fair"; }
+            else                    { q_text = "Poor";      q_class = "quality-poor"; }
+        }
+        if (badge) {
+            const char *old_class = g_object_get_data(G_OBJECT(badge), "quality-class");
+            if (old_class != q_class) {
+                GtkStyleContext *qc = gtk_widget_get_style_context(badge);
+                if (old_class) gtk_style_context_remove_class(qc, old_class);
+                if (q_class) gtk_style_context_add_class(qc, q_class);
+                g_object_set_data(G_OBJECT(badge), "quality-class", (gpointer)q_class);
+            }
+            if (q_text) {
+                set_label_text(badge, q_text);
+            }
+            gtk_widget_set_visible(badge, q_text != NULL);
+        }
+    }
+
+    update_setup_label(g_object_get_data(G_OBJECT(card), "setup-label"), session->config_name);
+
+    /* Queue redraw for sparkline graph */
+    GtkWidget *graph_area = g_object_get_data(G_OBJECT(card), "graph-area");
+    if (graph_area) {
+        gtk_widget_queue_draw(graph_area);
+    }
+}
+
 /**
  * Create a tab label with icon and text
  */
@@ -1006,6 +957,8 @@ static void on_connect_clicked(GtkButton *button, gpointer data) {
     }
 
     logger_info("Dashboard: Connecting to config %s", config_path);
+    config_clear_pin(dashboard->bus, config_path);
+
     char *session_path = NULL;
     int r = session_start(dashboard->bus, config_path, &session_path);
     if (r < 0) {
@@ -1019,108 +972,116 @@ static void on_connect_clicked(GtkButton *button, gpointer data) {
 }
 
 /**
- * Import button callback
+ * Bulk import finished - show the new configs
  */
-static void on_import_clicked(GtkButton *button, gpointer data) {
-    (void)button;
-    Dashboard *dashboard = (Dashboard *)data;
+static void on_bulk_import_done(unsigned int imported, void *user_data) {
+    Dashboard *dashboard = (Dashboard *)user_data;
 
-    if (!dashboard || !dashboard->bus) {
-        logger_error("No D-Bus connection available");
-        dialog_show_error("Import Error", "No D-Bus connection available");
-        return;
+    if (imported > 0) {
+        dashboard_update(dashboard, dashboard->bus);
     }
+}
 
-    /* Show file chooser */
-    char *file_path = file_chooser_select_ovpn("Import OpenVPN Configuration");
-    if (!file_path) {
-        return;
-    }
+/**
+ * Import Folder button callback
+ */
+static void on_import_folder_clicked(GtkButton *button, gpointer data) {
+    (void)button;
+    Dashboard *dashboard = (Dashboard *)data;
+
+    bulk_import_choose_folder(dashboard ? dashboard->bus : NULL, on_bulk_import_done, dashboard);
+}
 
-    logger_info("Selected file: %s", file_path);
+/**
+ * Import button callback
+ */
+static void on_import_clicked(GtkButton *button, gpointer data) {
+    (void)button;
+    Dashboard *dashboard = (Dashboard *)data;
 
-    /* Read file contents */
-    char *contents = NULL;
-    char *error = NULL;
-    int r = file_read_contents(file_path, &contents, &error);
+    bulk_import_choose_file(dashboard ? dashboard->bus : NULL, on_bulk_import_done, dashboard);
+}
 
-    if (r < 0) {
-        logger_error("Failed to read file: %s", error ? error : "Unknown error");
-        dialog_show_error("Import Error", error ? error : "Failed to read file");
-        g_free(error);
-        g_free(file_path);
+/**
+ * Free a session card record (the widgets belong to the container)
+ */
+static void session_card_free(SessionCard *card) {
+    if (!card) {
         return;
     }
+    g_free(card->device_name);
+    g_free(card);
+}
 
-    /* Extract default config name from filename */
-    char *basename = g_path_get_basename(file_path);
-    char *default_name = g_strdup(basename);
+/**
+ * Fill a session card's button row for the session's state
+ */
+static void fill_session_buttons(Dashboard *dashboard, GtkWidget *button_box, VpnSession *session) {
+    if (session->state == SESSION_STATE_AUTH_REQUIRED) {
+        /* Auth Required: [Authenticate] [Disconnect] */
+        GtkWidget *auth_btn = gtk_button_new_with_label("Authenticate");
+        g_object_set_data(G_OBJECT(auth_btn), "dashboard", dashboard);
+        /* TODO: Implement on_authenticate_clicked */
+        gtk_widget_set_sensitive(auth_btn, FALSE);
+        gtk_style_context_add_class(gtk_widget_get_style_context(auth_btn), "suggested-action");
+        gtk_box_pack_start(GTK_BOX(button_box), auth_btn, FALSE, FALSE, 0);
 
-    /* Remove .ovpn or .conf extension */
-    char *dot = strrchr(default_name, '.');
-    if (dot && (strcmp(dot, ".ovpn") == 0 || strcmp(dot, ".conf") == 0)) {
-        *dot = '\0';
-    }
+        GtkWidget *disconnect_btn = gtk_button_new_with_label("Disconnect");
+        g_object_set_data(G_OBJECT(disconnect_btn), "dashboard", dashboard);
+        g_signal_connect_data(disconnect_btn, "clicked",
+                             G_CALLBACK(on_disconnect_clicked),
+                             g_strdup(session->session_path),
+                             (GClosureNotify)g_free, 0);
+        gtk_style_context_add_class(gtk_widget_get_style_context(disconnect_btn), "destructive-action");
+        gtk_box_pack_start(GTK_BOX(button_box), disconnect_btn, FALSE, FALSE, 0);
 
-    /* Prompt user for config name */
-    char *config_name = dialog_get_text_input(
-        "Import Configuration",
-        "Configuration name:",
-        default_name
-    );
+    } else if (session->state == SESSION_STATE_CONNECTED) {
+        /* Connected: [Disconnect] [Statistics] [Pause] */
+        GtkWidget *disconnect_btn = gtk_button_new_with_label("Disconnect");
+        g_object_set_data(G_OBJECT(disconnect_btn), "dashboard", dashboard);
+        g_signal_connect_data(disconnect_btn, "clicked",
+                             G_CALLBACK(on_disconnect_clicked),
+                             g_strdup(session->session_path),
+                             (GClosureNotify)g_free, 0);
+        gtk_style_context_add_class(gtk_widget_get_style_context(disconnect_btn), "destructive-action");
+        gtk_box_pack_start(GTK_BOX(button_box), disconnect_btn, FALSE, FALSE, 0);
 
-    g_free(default_name);
-    g_free(basename);
+        GtkWidget *stats_btn = gtk_button_new_with_label("Statistics");
+        g_object_set_data(G_OBJECT(stats_btn), "dashboard", dashboard);
+        /* TODO: Implement on_statistics_clicked - switch to Statistics tab */
+        gtk_widget_set_sensitive(stats_btn, FALSE);
+        gtk_box_pack_start(GTK_BOX(button_box), stats_btn, FALSE, FALSE, 0);
 
-    if (!config_name) {
-        logger_info("Import cancelled by user");
-        g_free(contents);
-        g_free(file_path);
-        return;
-    }
+        GtkWidget *pause_btn = gtk_button_new_with_label("Pause");
+        g_object_set_data(G_OBJECT(pause_btn), "dashboard", dashboard);
+        /* TODO: Implement on_pause_clicked */
+        gtk_widget_set_sensitive(pause_btn, FALSE);
+        gtk_box_pack_start(GTK_BOX(button_box), pause_btn, FALSE, FALSE, 0);
 
-    /* Import configuration with persistent=true */
-    char *config_path = NULL;
-    r = config_import(dashboard->bus, config_name, contents, false, true, &config_path);
+    } else if (session->state == SESSION_STATE_PAUSED) {
+        /* Paused: [Disconnect] [Resume] */
+        GtkWidget *disconnect_btn = gtk_button_new_with_label("Disconnect");
+        g_object_set_data(G_OBJECT(disconnect_btn), "dashboard", dashboard);
+        g_signal_connect_data(disconnect_btn, "clicked",
+                             G_CALLBACK(on_disconnect_clicked),
+                             g_strdup(session->session_path),
+                             (GClosureNotify)g_free, 0);
+        gtk_style_context_add_class(gtk_widget_get_style_context(disconnect_btn), "destructive-action");
+        gtk_box_pack_start(GTK_BOX(button_box), disconnect_btn, FALSE, FALSE, 0);
 
-    if (r < 0) {
-        logger_error("Failed to import configuration: %s", config_name);
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Failed to import configuration '%s'.\n\nCheck if the configuration already exists.", config_name);
-        dialog_show_error("Import Error", msg);
-    } else {
-        logger_info("Successfully imported persistent configuration: %s -> %s", config_name, config_path);
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Configuration '%s' imported successfully.", config_name);
-        dialog_show_info("Import Successful", msg);
-        g_free(config_path);
-        /* Update dashboard to show new config */
-        dashboard_update(dashboard, dashboard->bus);
+        GtkWidget *resume_btn = gtk_button_new_with_label("Resume");
+        g_object_set_data(G_OBJECT(resume_btn), "dashboard", dashboard);
+        /* TODO: Implement on_resume_clicked */
+        gtk_widget_set_sensitive(resume_btn, FALSE);
+        gtk_style_context_add_class(gtk_widget_get_style_context(resume_btn), "suggested-action");
+        gtk_box_pack_start(GTK_BOX(button_box), resume_btn, FALSE, FALSE, 0);
     }
-
-    g_free(config_name);
-    g_free(contents);
-    g_free(file_path);
 }
 
 /**
- * Create a session card widget (Active Connection "Hero Row")
+ * Bring a session card up to date, touching only what changed
  */
-static void create_session_card(Dashboard *dashboard, VpnSession *session) {
-    if (!session) return;
-
-    /* Create card frame with visible border */
-    GtkWidget *card = gtk_frame_new(NULL);
-    gtk_frame_set_shadow_type(GTK_FRAME(card), GTK_SHADOW_ETCHED_OUT);
-
-    /* Add CSS class for distinct "hero row" styling */
-    GtkStyleContext *card_context = gtk_widget_get_style_context(card);
-    gtk_style_context_add_class(card_context, "active-connection-card");
-
-    /* Card content */
-    GtkWidget *card_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-    gtk_container_set_border_width(GTK_CONTAINER(card_box), 16);
-
+static void update_session_card(Dashboard *dashboard, SessionCard *card, VpnSession *session) {
     /* Get state emoji */
     const char *emoji = "🔵";  /* Default: blue circle */
     switch (session->state) {
@@ -1143,6 +1104,7 @@ static void create_session_card(Dashboard *dashboard, VpnSession *session) {
 
     /* Header line: emoji + name · state · duration */
     const char *state_text = widget_get_state_text(session->state);
+    char *name = g_markup_escape_text(session->config_name ? session->config_name : "Unknown", -1);
     char header_markup[512];
 
     if (session->state == SESSION_STATE_CONNECTED) {
@@ -1153,181 +1115,722 @@ static void create_session_card(Dashboard *dashboard, VpnSession *session) {
 
         snprintf(header_markup, sizeof(header_markup),
                 "%s <b>%s</b> · %s · %s",
-                emoji,
-                session->config_name ? session->config_name : "Unknown",
-                state_text,
-                elapsed_str);
+                emoji, name, state_text, elapsed_str);
     } else {
         snprintf(header_markup, sizeof(header_markup),
                 "%s <b>%s</b> · %s",
-                emoji,
-                session->config_name ? session->config_name : "Unknown",
-                state_text);
-    }
-
-    GtkWidget *header_label = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(header_label), header_markup);
-    gtk_label_set_xalign(GTK_LABEL(header_label), 0.0);
-    gtk_box_pack_start(GTK_BOX(card_box), header_label, FALSE, FALSE, 0);
-
-    /* Device info with IP */
-    if (session->device_name && session->device_name[0]) {
-        char ip_address[64];
-        char gateway[64];
-        char device_markup[256];
-
-        /* Get IP address and gateway from network interface */
-        int has_ip = get_interface_ip(session->device_name, ip_address, sizeof(ip_address)) == 0;
-        int has_gw = get_interface_gateway(session->device_name, gateway, sizeof(gateway)) == 0;
-
-        if (has_ip && has_gw) {
-            snprintf(device_markup, sizeof(device_markup),
-                    "<span size='small' foreground='#888888'>%s: %s (remote: %s)</span>",
-                    session->device_name, ip_address, gateway);
-        } else if (has_ip) {
-            snprintf(device_markup, sizeof(device_markup),
-                    "<span size='small' foreground='#888888'>%s: %s</span>",
-                    session->device_name, ip_address);
-        } else {
-            snprintf(device_markup, sizeof(device_markup),
-                    "<span size='small' foreground='#888888'>%s: No IP</span>",
-                    session->device_name);
+                emoji, name, state_text);
+    }
+    g_free(name);
+    set_label_markup(card->header_label, header_markup);
+
+    /* Device info with IP - looked up again only when the device changes
+     * or no address had been assigned yet */
+    const char *device = session->device_name && session->device_name[0] ? session->device_name : NULL;
+    if (g_strcmp0(device, card->device_name) != 0 || (device && !card->has_ip)) {
+        g_free(card->device_name);
+        card->device_name = g_strdup(device);
+        card->has_ip = FALSE;
+
+        if (device) {
+            char ip_address[64];
+            char gateway[64];
+            char device_markup[256];
+
+            /* Get IP address and gateway from network interface */
+            int has_ip = get_interface_ip(device, ip_address, sizeof(ip_address)) == 0;
+            int has_gw = get_interface_gateway(device, gateway, sizeof(gateway)) == 0;
+
+            if (has_ip && has_gw) {
+                snprintf(device_markup, sizeof(device_markup),
+                        "<span size='small' foreground='#888888'>%s: %s (remote: %s)</span>",
+                        device, ip_address, gateway);
+            } else if (has_ip) {
+                snprintf(device_markup, sizeof(device_markup),
+                        "<span size='small' foreground='#888888'>%s: %s</span>",
+                        device, ip_address);
+            } else {
+                snprintf(device_markup, sizeof(device_markup),
+                        "<span size='small' foreground='#888888'>%s: No IP</span>",
+                        device);
+            }
+
+            card->has_ip = has_ip;
+            set_label_markup(card->device_label, device_markup);
         }
+        gtk_widget_set_visible(card->device_label, device != NULL);
+    }
 
-        GtkWidget *device_label = gtk_label_new(NULL);
-        gtk_label_set_markup(GTK_LABEL(device_label), device_markup);
-        gtk_label_set_xalign(GTK_LABEL(device_label), 0.0);
-        gtk_box_pack_start(GTK_BOX(card_box), device_label, FALSE, FALSE, 0);
+    /* Action buttons depend only on the state */
+    if (!card->buttons_built || card->state != session->state) {
+        gtk_container_foreach(GTK_CONTAINER(card->button_box),
+                             (GtkCallback)gtk_widget_destroy, NULL);
+        fill_session_buttons(dashboard, card->button_box, session);
+        gtk_widget_show_all(card->button_box);
+        card->state = session->state;
+        card->buttons_built = TRUE;
     }
+}
+
+/**
+ * Create a session card widget (Active Connection "Hero Row")
+ */
+static SessionCard* create_session_card(Dashboard *dashboard, VpnSession *session) {
+    SessionCard *card = g_malloc0(sizeof(SessionCard));
+
+    /* Create card frame with visible border */
+    card->frame = gtk_frame_new(NULL);
+    gtk_frame_set_shadow_type(GTK_FRAME(card->frame), GTK_SHADOW_ETCHED_OUT);
+
+    /* Add CSS class for distinct "hero row" styling */
+    GtkStyleContext *card_context = gtk_widget_get_style_context(card->frame);
+    gtk_style_context_add_class(card_context, "active-connection-card");
+
+    /* Card content */
+    GtkWidget *card_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_container_set_border_width(GTK_CONTAINER(card_box), 16);
+
+    card->header_label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(card->header_label), 0.0);
+    gtk_box_pack_start(GTK_BOX(card_box), card->header_label, FALSE, FALSE, 0);
+
+    card->device_label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(card->device_label), 0.0);
+    gtk_widget_set_no_show_all(card->device_label, TRUE);
+    gtk_box_pack_start(GTK_BOX(card_box), card->device_label, FALSE, FALSE, 0);
 
     /* Action buttons */
-    GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
-    gtk_widget_set_margin_top(button_box, 8);
+    card->button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_widget_set_margin_top(card->button_box, 8);
+    gtk_box_pack_start(GTK_BOX(card_box), card->button_box, FALSE, FALSE, 0);
 
-    if (session->state == SESSION_STATE_AUTH_REQUIRED) {
-        /* Auth Required: [Authenticate] [Disconnect] */
-        GtkWidget *auth_btn = gtk_button_new_with_label("Authenticate");
-        g_object_set_data(G_OBJECT(auth_btn), "dashboard", dashboard);
-        /* TODO: Implement on_authenticate_clicked */
-        gtk_widget_set_sensitive(auth_btn, FALSE);
-        gtk_style_context_add_class(gtk_widget_get_style_context(auth_btn), "suggested-action");
-        gtk_box_pack_start(GTK_BOX(button_box), auth_btn, FALSE, FALSE, 0);
+    gtk_container_add(GTK_CONTAINER(card->frame), card_box);
+    gtk_box_pack_start(GTK_BOX(dashboard->sessions_container), card->frame, FALSE, FALSE, 0);
 
-        GtkWidget *disconnect_btn = gtk_button_new_with_label("Disconnect");
-        g_object_set_data(G_OBJECT(disconnect_btn), "dashboard", dashboard);
-        g_signal_connect(disconnect_btn, "clicked",
-                        G_CALLBACK(on_disconnect_clicked),
-                        g_strdup(session->session_path));
-        gtk_style_context_add_class(gtk_widget_get_style_context(disconnect_btn), "destructive-action");
-        gtk_box_pack_start(GTK_BOX(button_box), disconnect_btn, FALSE, FALSE, 0);
+    update_session_card(dashboard, card, session);
+    gtk_widget_show_all(card->frame);
 
-    } else if (session->state == SESSION_STATE_CONNECTED) {
-        /* Connected: [Disconnect] [Statistics] [Pause] */
-        GtkWidget *disconnect_btn = gtk_button_new_with_label("Disconnect");
-        g_object_set_data(G_OBJECT(disconnect_btn), "dashboard", dashboard);
-        g_signal_connect(disconnect_btn, "clicked",
-                        G_CALLBACK(on_disconnect_clicked),
-                        g_strdup(session->session_path));
-        gtk_style_context_add_class(gtk_widget_get_style_context(disconnect_btn), "destructive-action");
-        gtk_box_pack_start(GTK_BOX(button_box), disconnect_btn, FALSE, FALSE, 0);
+    return card;
+}
 
-        GtkWidget *stats_btn = gtk_button_new_with_label("Statistics");
-        g_object_set_data(G_OBJECT(stats_btn), "dashboard", dashboard);
-        /* TODO: Implement on_statistics_clicked - switch to Statistics tab */
-        gtk_widget_set_sensitive(stats_btn, FALSE);
-        gtk_box_pack_start(GTK_BOX(button_box), stats_btn, FALSE, FALSE, 0);
+/**
+ * Create a configuration list item widget (Action Row style)
+ *
+ * Rows are inserted just above the Import row.
+ */
+static GtkWidget* create_config_card(Dashboard *dashboard, VpnConfig *config) {
+    /* Create list box row */
+    GtkWidget *row = gtk_list_box_row_new();
+    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(row), FALSE);
 
-        GtkWidget *pause_btn = gtk_button_new_with_label("Pause");
-        g_object_set_data(G_OBJECT(pause_btn), "dashboard", dashboard);
-        /* TODO: Implement on_pause_clicked */
-        gtk_widget_set_sensitive(pause_btn, FALSE);
-        gtk_box_pack_start(GTK_BOX(button_box), pause_btn, FALSE, FALSE, 0);
+    /* Row content box */
+    GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_container_set_border_width(GTK_CONTAINER(row_box), 12);
 
-    } else if (session->state == SESSION_STATE_PAUSED) {
-        /* Paused: [Disconnect] [Resume] */
-        GtkWidget *disconnect_btn = gtk_button_new_with_label("Disconnect");
-        g_object_set_data(G_OBJECT(disconnect_btn), "dashboard", dashboard);
-        g_signal_connect(disconnect_btn, "clicked",
-                        G_CALLBACK(on_disconnect_clicked),
-                        g_strdup(session->session_path));
-        gtk_style_context_add_class(gtk_widget_get_style_context(disconnect_btn), "destructive-action");
-        gtk_box_pack_start(GTK_BOX(button_box), disconnect_btn, FALSE, FALSE, 0);
+    /* Name label */
+    GtkWidget *name_label = gtk_label_new(config->config_name ? config->config_name : "Unknown");
+    gtk_label_set_xalign(GTK_LABEL(name_label), 0.0);
+    gtk_box_pack_start(GTK_BOX(row_box), name_label, TRUE, TRUE, 0);
+    g_object_set_data(G_OBJECT(row), "name-label", name_label);
 
-        GtkWidget *resume_btn = gtk_button_new_with_label("Resume");
-        g_object_set_data(G_OBJECT(resume_btn), "dashboard", dashboard);
-        /* TODO: Implement on_resume_clicked */
-        gtk_widget_set_sensitive(resume_btn, FALSE);
-        gtk_style_context_add_class(gtk_widget_get_style_context(resume_btn), "suggested-action");
-        gtk_box_pack_start(GTK_BOX(button_box), resume_btn, FALSE, FALSE, 0);
+    /* Connect button */
+    GtkWidget *connect_btn = gtk_button_new_with_label("Connect");
+    g_object_set_data(G_OBJECT(connect_btn), "dashboard", dashboard);
+    g_signal_connect_data(connect_btn, "clicked",
+                         G_CALLBACK(on_connect_clicked),
+                         g_strdup(config->config_path),
+                         (GClosureNotify)g_free, 0);
+    gtk_style_context_add_class(gtk_widget_get_style_context(connect_btn), "suggested-action");
+    gtk_box_pack_start(GTK_BOX(row_box), connect_btn, FALSE, FALSE, 0);
+
+    gtk_container_add(GTK_CONTAINER(row), row_box);
+
+    /* Visibility is managed by the reconcile pass (rows of configs in use
+     * are hidden), so keep show_all on the window from overriding it */
+    gtk_widget_show_all(row);
+    gtk_widget_set_no_show_all(row, TRUE);
+
+    /* Placeholder row first, Import row last */
+    gtk_list_box_insert(GTK_LIST_BOX(dashboard->configs_container), row,
+                        (gint)g_hash_table_size(dashboard->config_rows) + 1);
+    return row;
+}
+
+/**
+ * Create a list box row holding a dimmed message, initially hidden
+ */
+static GtkWidget* create_placeholder_row(const char *message) {
+    GtkWidget *row = gtk_list_box_row_new();
+    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(row), FALSE);
+
+    char markup[256];
+    snprintf(markup, sizeof(markup), "<span foreground='#888888'>%s</span>", message);
+    GtkWidget *label = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(label), markup);
+    gtk_container_add(GTK_CONTAINER(row), label);
+
+    gtk_widget_show_all(row);
+    gtk_widget_hide(row);
+    gtk_widget_set_no_show_all(row, TRUE);
+    return row;
+}
+
+/**
+ * Create the "Import Config" row with button at the end of the list
+ */
+static void create_import_config_row(Dashboard *dashboard) {
+    /* Create list box row */
+    GtkWidget *row = gtk_list_box_row_new();
+    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(row), FALSE);
+
+    /* Row content box */
+    GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_container_set_border_width(GTK_CONTAINER(row_box), 12);
+
+    /* Import button */
+    GtkWidget *import_btn = gtk_button_new_with_label("+ Import");
+    g_signal_connect(import_btn, "clicked", G_CALLBACK(on_import_clicked), dashboard);
+    gtk_box_pack_start(GTK_BOX(row_box), import_btn, FALSE, FALSE, 0);
+
+    /* Import a whole folder of profiles */
+    GtkWidget *import_folder_btn = gtk_button_new_with_label("+ Import Folder");
+    g_signal_connect(import_folder_btn, "clicked", G_CALLBACK(on_import_folder_clicked), dashboard);
+    gtk_box_pack_start(GTK_BOX(row_box), import_folder_btn, FALSE, FALSE, 0);
+
+    gtk_container_add(GTK_CONTAINER(row), row_box);
+    gtk_container_add(GTK_CONTAINER(dashboard->configs_container), row);
+}
+
+/**
+ * Build the Statistics page into its placeholder
+ */
+static void build_statistics_page(Dashboard *dashboard) {
+    gint64 start = g_get_monotonic_time();
+
+    dashboard->stat_cards = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    GtkWidget *stats_scrolled = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(stats_scrolled),
+                                   GTK_POLICY_NEVER,
+                                   GTK_POLICY_AUTOMATIC);
+
+    /* Main container for statistics tab */
+    dashboard->statistics_tab = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+
+    /* Aggregate bandwidth section (fixed above scrolling cards) */
+    dashboard->aggregate_graph_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+    gtk_widget_set_margin_start(dashboard->aggregate_graph_box, 20);
+    gtk_widget_set_margin_end(dashboard->aggregate_graph_box, 20);
+    gtk_widget_set_margin_top(dashboard->aggregate_graph_box, 16);
+    gtk_widget_set_no_show_all(dashboard->aggregate_graph_box, TRUE);
+
+    GtkWidget *agg_header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    GtkWidget *agg_title = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(agg_title),
+        "<span size='large' weight='600'>Total Bandwidth</span>");
+    gtk_label_set_xalign(GTK_LABEL(agg_title), 0.0);
+    gtk_box_pack_start(GTK_BOX(agg_header), agg_title, TRUE, TRUE, 0);
+
+    dashboard->aggregate_dl_label = gtk_label_new("↓ 0 B/s");
+    gtk_style_context_add_class(gtk_widget_get_style_context(dashboard->aggregate_dl_label), "card-bandwidth-download");
+    gtk_box_pack_start(GTK_BOX(agg_header), dashboard->aggregate_dl_label, FALSE, FALSE, 0);
+
+    dashboard->aggregate_ul_label = gtk_label_new("↑ 0 B/s");
+    gtk_style_context_add_class(gtk_widget_get_style_context(dashboard->aggregate_ul_label), "card-bandwidth-upload");
+    gtk_box_pack_start(GTK_BOX(agg_header), dashboard->aggregate_ul_label, FALSE, FALSE, 0);
+
+    gtk_box_pack_start(GTK_BOX(dashboard->aggregate_graph_box), agg_header, FALSE, FALSE, 0);
+
+    dashboard->aggregate_graph = gtk_drawing_area_new();
+    gtk_widget_set_size_request(dashboard->aggregate_graph, -1, 180);
+    gtk_style_context_add_class(gtk_widget_get_style_context(dashboard->aggregate_graph), "card-graph-area");
+    graph_cache_attach(dashboard->aggregate_graph, &aggregate_graph_style);
+    g_signal_connect(dashboard->aggregate_graph, "draw", G_CALLBACK(on_aggregate_graph_draw), dashboard);
+    gtk_box_pack_start(GTK_BOX(dashboard->aggregate_graph_box), dashboard->aggregate_graph, FALSE, FALSE, 0);
+
+    gtk_box_pack_start(GTK_BOX(dashboard->statistics_tab), dashboard->aggregate_graph_box, FALSE, FALSE, 0);
+
+    /* FlowBox for stat cards - wraps automatically */
+    dashboard->stats_flowbox = gtk_flow_box_new();
+    gtk_flow_box_set_selection_mode(GTK_FLOW_BOX(dashboard->stats_flowbox), GTK_SELECTION_NONE);
+    gtk_flow_box_set_homogeneous(GTK_FLOW_BOX(dashboard->stats_flowbox), FALSE);
+    gtk_flow_box_set_max_children_per_line(GTK_FLOW_BOX(dashboard->stats_flowbox), 4);
+    gtk_flow_box_set_column_spacing(GTK_FLOW_BOX(dashboard->stats_flowbox), 10);
+    gtk_flow_box_set_row_spacing(GTK_FLOW_BOX(dashboard->stats_flowbox), 10);
+    gtk_widget_set_margin_start(dashboard->stats_flowbox, 20);
+    gtk_widget_set_margin_end(dashboard->stats_flowbox, 20);
+    gtk_widget_set_margin_top(dashboard->stats_flowbox, 20);
+    gtk_widget_set_margin_bottom(dashboard->stats_flowbox, 20);
+
+    gtk_container_add(GTK_CONTAINER(stats_scrolled), dashboard->stats_flowbox);
+    gtk_box_pack_start(GTK_BOX(dashboard->statistics_tab), stats_scrolled, TRUE, TRUE, 0);
+
+    /* Empty state (shown when no VPNs connected) */
+    dashboard->stats_empty_state = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
+    gtk_widget_set_valign(dashboard->stats_empty_state, GTK_ALIGN_CENTER);
+    gtk_widget_set_halign(dashboard->stats_empty_state, GTK_ALIGN_CENTER);
+    gtk_widget_set_vexpand(dashboard->stats_empty_state, TRUE);
+
+    GtkWidget *empty_icon = gtk_image_new_from_icon_name("network-offline-symbolic", GTK_ICON_SIZE_DIALOG);
+    gtk_image_set_pixel_size(GTK_IMAGE(empty_icon), 96);
+    gtk_widget_set_opacity(empty_icon, 0.3);
+    gtk_box_pack_start(GTK_BOX(dashboard->stats_empty_state), empty_icon, FALSE, FALSE, 0);
+
+    GtkWidget *empty_label = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(empty_label),
+                        "<span size='large' weight='600'>No active connections</span>\n"
+                        "<span foreground='#888888'>Connect to a VPN to see statistics</span>");
+    gtk_label_set_justify(GTK_LABEL(empty_label), GTK_JUSTIFY_CENTER);
+    gtk_box_pack_start(GTK_BOX(dashboard->stats_empty_state), empty_label, FALSE, FALSE, 0);
+
+    gtk_box_pack_start(GTK_BOX(dashboard->statistics_tab), dashboard->stats_empty_state, TRUE, TRUE, 0);
+    gtk_widget_set_no_show_all(dashboard->stats_empty_state, TRUE);
+
+    gtk_box_pack_start(GTK_BOX(dashboard->statistics_page), dashboard->statistics_tab, TRUE, TRUE, 0);
+    gtk_widget_show_all(dashboard->statistics_page);
+
+    logger_info("Dashboard: Statistics page built in %.1f ms",
+                (g_get_monotonic_time() - start) / 1000.0);
+}
+
+/**
+ * Build the Servers page into its placeholder
+ */
+static void build_servers_page(Dashboard *dashboard) {
+    gint64 start = g_get_monotonic_time();
+
+    dashboard->servers_tab_instance = servers_tab_create(dashboard->bus,
+                                                         dashboard->probe_concurrency);
+    dashboard->servers_tab = servers_tab_get_widget(dashboard->servers_tab_instance);
+    if (!dashboard->servers_tab) {
+        return;
+    }
+
+    gtk_box_pack_start(GTK_BOX(dashboard->servers_page), dashboard->servers_tab, TRUE, TRUE, 0);
+    gtk_widget_show_all(dashboard->servers_page);
+
+    logger_info("Dashboard: Servers page built in %.1f ms",
+                (g_get_monotonic_time() - start) / 1000.0);
+}
+
+/**
+ * Create bandwidth monitors for new sessions and take a sample from each
+ */
+static void sample_bandwidth(Dashboard *dashboard, sd_bus *bus) {
+    for (unsigned int i = 0; i < dashboard->session_count; i++) {
+        VpnSession *session = dashboard->sessions[i];
+
+        if (!session->device_name || !session->session_path) {
+            continue;  /* Skip sessions without device */
+        }
+
+        /* Get or create bandwidth monitor for this session */
+        BandwidthMonitor *monitor = g_hash_table_lookup(
+            dashboard->bandwidth_monitors,
+            session->session_path
+        );
+
+        if (!monitor) {
+            logger_debug("Dashboard: Creating bandwidth monitor for session %s (device: %s)",
+                   session->config_name ? session->config_name : "unknown",
+                   session->device_name);
+
+            monitor = bandwidth_monitor_create(
+                session->session_path,
+                session->device_name,
+                STATS_SOURCE_AUTO,
+                7200  /* 2-hour buffer (7200 seconds) */
+            );
+
+            if (!monitor) {
+                logger_debug("Dashboard: Failed to create bandwidth monitor");
+                continue;
+            }
+
+            g_hash_table_insert(
+                dashboard->bandwidth_monitors,
+                g_strdup(session->session_path),
+                monitor
+            );
+        }
+
+        bandwidth_monitor_update(monitor, bus);
+    }
+}
+
+/**
+ * Find a session in the cached list by object path
+ */
+static VpnSession* find_cached_session(Dashboard *dashboard, const char *session_path) {
+    for (unsigned int i = 0; i < dashboard->session_count; i++) {
+        if (g_strcmp0(dashboard->sessions[i]->session_path, session_path) == 0) {
+            return dashboard->sessions[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Drop bandwidth monitors of sessions that have ended, along with their
+ * stat cards (whose graphs draw from the monitor)
+ */
+static void prune_bandwidth_monitors(Dashboard *dashboard) {
+    GHashTableIter iter;
+    gpointer key;
+
+    g_hash_table_iter_init(&iter, dashboard->bandwidth_monitors);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (find_cached_session(dashboard, key)) {
+            continue;
+        }
+
+        GtkWidget *card = dashboard->stat_cards ?
+            g_hash_table_lookup(dashboard->stat_cards, key) : NULL;
+        if (card) {
+            /* The FlowBox wraps each card in a GtkFlowBoxChild */
+            gtk_widget_destroy(gtk_widget_get_parent(card));
+            g_hash_table_remove(dashboard->stat_cards, key);
+        }
+        g_hash_table_iter_remove(&iter);
+    }
+}
+
+/**
+ * Reconcile the stat cards with the cached session list
+ *
+ * Cards are created once per session and updated in place.
+ */
+static void update_statistics(Dashboard *dashboard) {
+    if (!dashboard->stats_flowbox) {
+        return;  /* Page not built yet */
+    }
+
+    /* Remove cards of sessions that have ended */
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, dashboard->stat_cards);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (!find_cached_session(dashboard, key) ||
+            !g_hash_table_contains(dashboard->bandwidth_monitors, key)) {
+            /* The FlowBox wraps each card in a GtkFlowBoxChild */
+            gtk_widget_destroy(gtk_widget_get_parent(GTK_WIDGET(value)));
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+
+    for (unsigned int i = 0; i < dashboard->session_count; i++) {
+        VpnSession *session = dashboard->sessions[i];
+
+        if (!session->session_path) {
+            continue;
+        }
+
+        BandwidthMonitor *monitor = g_hash_table_lookup(
+            dashboard->bandwidth_monitors,
+            session->session_path
+        );
+        if (!monitor) {
+            continue;  /* No device yet */
+        }
+
+        GtkWidget *card = g_hash_table_lookup(dashboard->stat_cards, session->session_path);
+        if (!card) {
+            card = create_vpn_stat_card(dashboard, session, monitor);
+            if (!card) {
+                continue;
+            }
+            gtk_container_add(GTK_CONTAINER(dashboard->stats_flowbox), card);
+            gtk_widget_show_all(gtk_widget_get_parent(card));
+            g_hash_table_insert(dashboard->stat_cards, g_strdup(session->session_path), card);
+        }
+
+        update_vpn_stat_card(card, session, monitor);
+    }
+
+    /* Empty state when disconnected, aggregate graph otherwise */
+    gboolean connected = dashboard->session_count > 0;
+    gtk_widget_set_visible(dashboard->stats_empty_state, !connected);
+    if (dashboard->aggregate_graph_box) {
+        if (connected && !gtk_widget_get_visible(dashboard->aggregate_graph_box)) {
+            gtk_widget_show_all(dashboard->aggregate_graph_box);
+        } else if (!connected) {
+            gtk_widget_hide(dashboard->aggregate_graph_box);
+        }
+    }
+}
+
+/**
+ * Check whether a session list contains an object path
+ */
+static gboolean session_list_has(VpnSession **sessions, unsigned int count, const char *session_path) {
+    for (unsigned int i = 0; i < count; i++) {
+        if (g_strcmp0(sessions[i]->session_path, session_path) == 0) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Reconcile the Active Connections cards with a session list
+ */
+static void reconcile_session_cards(Dashboard *dashboard, VpnSession **sessions, unsigned int count) {
+    /* Remove cards of sessions that have ended */
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, dashboard->session_cards);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (!session_list_has(sessions, count, key)) {
+            gtk_widget_destroy(((SessionCard *)value)->frame);
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        VpnSession *session = sessions[i];
+        if (!session->session_path) {
+            continue;
+        }
+
+        SessionCard *card = g_hash_table_lookup(dashboard->session_cards, session->session_path);
+        if (!card) {
+            card = create_session_card(dashboard, session);
+            g_hash_table_insert(dashboard->session_cards, g_strdup(session->session_path), card);
+        } else {
+            update_session_card(dashboard, card, session);
+        }
+
+        /* Keep the listing order (the placeholder label is child 0) */
+        gint position = 0;
+        gtk_container_child_get(GTK_CONTAINER(dashboard->sessions_container), card->frame,
+                                "position", &position, NULL);
+        if (position != (gint)i + 1) {
+            gtk_box_reorder_child(GTK_BOX(dashboard->sessions_container), card->frame, (gint)i + 1);
+        }
+    }
+
+    gtk_widget_set_visible(dashboard->no_sessions_label, count == 0);
+}
+
+/**
+ * Reconcile the Available Configurations rows with a config list
+ *
+ * Configs that are in use stay in the list but are hidden, since they
+ * appear under Active Connections.
+ */
+static void reconcile_config_rows(Dashboard *dashboard, VpnConfig **configs, unsigned int config_count,
+                                  VpnSession **sessions, unsigned int session_count) {
+    /* Remove rows of configs that no longer exist */
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, dashboard->config_rows);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        gboolean found = FALSE;
+        for (unsigned int i = 0; i < config_count && !found; i++) {
+            found = g_strcmp0(configs[i]->config_path, key) == 0;
+        }
+        if (!found) {
+            gtk_widget_destroy(GTK_WIDGET(value));
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+
+    for (unsigned int i = 0; i < config_count; i++) {
+        VpnConfig *config = configs[i];
+        if (!config->config_path) {
+            continue;
+        }
+
+        GtkWidget *row = g_hash_table_lookup(dashboard->config_rows, config->config_path);
+        if (!row) {
+            row = create_config_card(dashboard, config);
+            g_hash_table_insert(dashboard->config_rows, g_strdup(config->config_path), row);
+        } else {
+            GtkWidget *name_label = g_object_get_data(G_OBJECT(row), "name-label");
+            set_label_text(name_label, config->config_name ? config->config_name : "Unknown");
+        }
+
+        /* Check if config is in use */
+        gboolean in_use = FALSE;
+        for (unsigned int j = 0; j < session_count; j++) {
+            if (sessions[j]->config_name && config->config_name &&
+                strcmp(sessions[j]->config_name, config->config_name) == 0) {
+                in_use = TRUE;
+                break;
+            }
+        }
+        gtk_widget_set_visible(row, !in_use);
+    }
+
+    gtk_widget_set_visible(dashboard->no_configs_row, config_count == 0);
+}
+
+/**
+ * Whether the window is mapped and not minimized
+ */
+static gboolean is_on_screen(Dashboard *dashboard) {
+    return dashboard->window && dashboard->mapped && !dashboard->iconified;
+}
+
+/**
+ * Currently selected notebook page
+ */
+static GtkWidget* current_page(Dashboard *dashboard) {
+    GtkNotebook *notebook = GTK_NOTEBOOK(dashboard->notebook);
+    return gtk_notebook_get_nth_page(notebook, gtk_notebook_get_current_page(notebook));
+}
+
+/**
+ * Periodic refresh of the visible page
+ */
+static gboolean on_refresh_timer(gpointer data) {
+    dashboard_refresh((Dashboard *)data);
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Pick the refresh rate for the current visibility and focus, suspend
+ * work for hidden surfaces
+ */
+static void update_activity(Dashboard *dashboard) {
+    gboolean on_screen = is_on_screen(dashboard);
+
+    if (dashboard->servers_tab_instance) {
+        servers_tab_set_active(dashboard->servers_tab_instance,
+                               on_screen && current_page(dashboard) == dashboard->servers_page);
+    }
+
+    guint interval = 0;
+    if (on_screen) {
+        interval = dashboard->focused ? DASHBOARD_REFRESH_FOCUSED_SEC
+                                      : DASHBOARD_REFRESH_UNFOCUSED_SEC;
+    }
+    if (interval == dashboard->refresh_interval) {
+        return;
     }
 
-    gtk_box_pack_start(GTK_BOX(card_box), button_box, FALSE, FALSE, 0);
+    if (dashboard->refresh_id > 0) {
+        scheduler_remove(dashboard->refresh_id);
+        dashboard->refresh_id = 0;
+    }
+    dashboard->refresh_interval = interval;
+    if (interval > 0) {
+        SchedJobSpec spec = {
+            .name = "dashboard",
+            .period_ms = SCHED_PERIOD(interval * 1000),
+            .tolerance_ms = interval * 1000 / 4,
+            .priority = SCHED_PRIORITY_HIGH
+        };
+        dashboard->refresh_id = scheduler_add(&spec, on_refresh_timer, dashboard);
+    }
 
-    gtk_container_add(GTK_CONTAINER(card), card_box);
-    gtk_box_pack_start(GTK_BOX(dashboard->sessions_container), card, FALSE, FALSE, 0);
+    if (logger_verbose(2)) {
+        if (interval > 0) {
+            logger_info("Dashboard: refreshing every %us (%s)", interval,
+                        dashboard->focused ? "focused" : "unfocused");
+        } else {
+            logger_info("Dashboard: refresh suspended (hidden)");
+        }
+    }
 }
 
 /**
- * Create a configuration list item widget (Action Row style)
+ * Refresh right away if the window came back on screen with stale data
  */
-static void create_config_card(Dashboard *dashboard, VpnConfig *config) {
-    if (!config) return;
-
-    /* Create list box row */
-    GtkWidget *row = gtk_list_box_row_new();
-    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(row), FALSE);
+static void catch_up(Dashboard *dashboard) {
+    if (is_on_screen(dashboard) &&
+        g_get_monotonic_time() - dashboard->last_refresh_us >= G_USEC_PER_SEC) {
+        dashboard_refresh(dashboard);
+    }
+}
 
-    /* Row content box */
-    GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
-    gtk_container_set_border_width(GTK_CONTAINER(row_box), 12);
+/**
+ * Window mapped
+ */
+static gboolean on_window_map_event(GtkWidget *widget, GdkEvent *event, gpointer data) {
+    (void)widget;
+    (void)event;
+    Dashboard *dashboard = (Dashboard *)data;
 
-    /* Name label */
-    GtkWidget *name_label = gtk_label_new(config->config_name ? config->config_name : "Unknown");
-    gtk_label_set_xalign(GTK_LABEL(name_label), 0.0);
-    gtk_box_pack_start(GTK_BOX(row_box), name_label, TRUE, TRUE, 0);
+    dashboard->mapped = TRUE;
+    update_activity(dashboard);
+    catch_up(dashboard);
+    return FALSE;
+}
 
-    /* Connect button */
-    GtkWidget *connect_btn = gtk_button_new_with_label("Connect");
-    g_object_set_data(G_OBJECT(connect_btn), "dashboard", dashboard);
-    g_signal_connect(connect_btn, "clicked",
-                    G_CALLBACK(on_connect_clicked),
-                    g_strdup(config->config_path));
-    gtk_style_context_add_class(gtk_widget_get_style_context(connect_btn), "suggested-action");
-    gtk_box_pack_start(GTK_BOX(row_box), connect_btn, FALSE, FALSE, 0);
+/**
+ * Window unmapped (hidden or closed to the tray)
+ */
+static gboolean on_window_unmap_event(GtkWidget *widget, GdkEvent *event, gpointer data) {
+    (void)widget;
+    (void)event;
+    Dashboard *dashboard = (Dashboard *)data;
 
-    gtk_container_add(GTK_CONTAINER(row), row_box);
-    gtk_container_add(GTK_CONTAINER(dashboard->configs_container), row);
+    dashboard->mapped = FALSE;
+    update_activity(dashboard);
+    return FALSE;
 }
 
 /**
- * Create the "Import Config" row with button at the end of the list
+ * Window minimized or restored
  */
-static void create_import_config_row(Dashboard *dashboard) {
-    /* Create list box row */
-    GtkWidget *row = gtk_list_box_row_new();
-    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(row), FALSE);
+static gboolean on_window_state_event(GtkWidget *widget, GdkEventWindowState *event, gpointer data) {
+    (void)widget;
+    Dashboard *dashboard = (Dashboard *)data;
 
-    /* Row content box */
-    GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
-    gtk_container_set_border_width(GTK_CONTAINER(row_box), 12);
+    if (!(event->changed_mask & GDK_WINDOW_STATE_ICONIFIED)) {
+        return FALSE;
+    }
 
-    /* Import button */
-    GtkWidget *import_btn = gtk_button_new_with_label("+ Import");
-    g_signal_connect(import_btn, "clicked", G_CALLBACK(on_import_clicked), dashboard);
-    gtk_box_pack_start(GTK_BOX(row_box), import_btn, FALSE, FALSE, 0);
+    dashboard->iconified = (event->new_window_state & GDK_WINDOW_STATE_ICONIFIED) != 0;
+    update_activity(dashboard);
+    catch_up(dashboard);
+    return FALSE;
+}
 
-    gtk_container_add(GTK_CONTAINER(row), row_box);
-    gtk_container_add(GTK_CONTAINER(dashboard->configs_container), row);
+/**
+ * Window gained or lost focus
+ */
+static void on_window_active_changed(GObject *object, GParamSpec *pspec, gpointer data) {
+    (void)pspec;
+    Dashboard *dashboard = (Dashboard *)data;
+
+    dashboard->focused = gtk_window_is_active(GTK_WINDOW(object));
+    update_activity(dashboard);
+    if (dashboard->focused) {
+        catch_up(dashboard);
+    }
 }
 
 /**
- * Create dashboard window
+ * Notebook page switch (connected after the default handler, so the new
+ * page is current) - build pages the first time they are shown and bring
+ * the page up to date, since hidden pages are not refreshed
  */
-Dashboard* dashboard_create(void) {
-    Dashboard *dashboard = g_malloc0(sizeof(Dashboard));
-    if (!dashboard) {
-        return NULL;
+static void on_notebook_switch_page(GtkNotebook *notebook, GtkWidget *page,
+                                    guint page_num, gpointer data) {
+    (void)notebook;
+    (void)page_num;
+    Dashboard *dashboard = (Dashboard *)data;
+
+    if (page == dashboard->statistics_page && !dashboard->statistics_tab) {
+        build_statistics_page(dashboard);
+    } else if (page == dashboard->servers_page && !dashboard->servers_tab_instance) {
+        build_servers_page(dashboard);
+    }
+
+    update_activity(dashboard);
+    if (is_on_screen(dashboard)) {
+        dashboard_refresh(dashboard);
     }
+}
+
+/**
+ * Build the dashboard window (Connections page only; other pages are
+ * placeholders until first switched to)
+ */
+static void build_window(Dashboard *dashboard) {
+    gint64 start = g_get_monotonic_time();
 
     /* Create window */
     dashboard->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
@@ -1356,6 +1859,16 @@ Dashboard* dashboard_create(void) {
     g_signal_connect(dashboard->window, "delete-event",
                     G_CALLBACK(on_window_delete), dashboard);
 
+    /* Track visibility and focus to schedule refreshes */
+    g_signal_connect(dashboard->window, "map-event",
+                    G_CALLBACK(on_window_map_event), dashboard);
+    g_signal_connect(dashboard->window, "unmap-event",
+                    G_CALLBACK(on_window_unmap_event), dashboard);
+    g_signal_connect(dashboard->window, "window-state-event",
+                    G_CALLBACK(on_window_state_event), dashboard);
+    g_signal_connect(dashboard->window, "notify::is-active",
+                    G_CALLBACK(on_window_active_changed), dashboard);
+
     /* Create notebook for tabs */
     dashboard->notebook = gtk_notebook_new();
     gtk_notebook_set_tab_pos(GTK_NOTEBOOK(dashboard->notebook), GTK_POS_TOP);
@@ -1388,6 +1901,13 @@ Dashboard* dashboard_create(void) {
     gtk_widget_set_margin_top(dashboard->sessions_container, 0);
     gtk_box_pack_start(GTK_BOX(dashboard->connections_tab), dashboard->sessions_container, FALSE, FALSE, 0);
 
+    /* No active sessions (shown by reconcile_session_cards) */
+    dashboard->no_sessions_label = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(dashboard->no_sessions_label),
+                       "<span foreground='#888888'>No active VPN connections</span>");
+    gtk_widget_set_no_show_all(dashboard->no_sessions_label, TRUE);
+    gtk_box_pack_start(GTK_BOX(dashboard->sessions_container), dashboard->no_sessions_label, FALSE, FALSE, 0);
+
     /* Configurations section */
     GtkWidget *configs_header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_container_set_border_width(GTK_CONTAINER(configs_header), 20);
@@ -1417,105 +1937,34 @@ Dashboard* dashboard_create(void) {
     gtk_list_box_set_selection_mode(GTK_LIST_BOX(dashboard->configs_container), GTK_SELECTION_NONE);
 
     gtk_container_add(GTK_CONTAINER(configs_frame), dashboard->configs_container);
+
+    /* Placeholder first, config rows in between, Import row last */
+    dashboard->no_configs_row = create_placeholder_row("No configurations available");
+    gtk_container_add(GTK_CONTAINER(dashboard->configs_container), dashboard->no_configs_row);
+    create_import_config_row(dashboard);
+
+    /* Cards and rows are kept across updates, keyed by object path */
+    dashboard->session_cards = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                     (GDestroyNotify)session_card_free);
+    dashboard->config_rows = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
     gtk_box_pack_start(GTK_BOX(dashboard->connections_tab), configs_frame, FALSE, FALSE, 0);
 
     gtk_container_add(GTK_CONTAINER(connections_scrolled), dashboard->connections_tab);
     gtk_notebook_append_page(GTK_NOTEBOOK(dashboard->notebook), connections_scrolled,
                             create_tab_label("network-wired-symbolic", "Connections"));
+    dashboard->connections_page = connections_scrolled;
 
-    /* Tab 2: Statistics - Card-based view */
-    GtkWidget *stats_scrolled = gtk_scrolled_window_new(NULL, NULL);
-    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(stats_scrolled),
-                                   GTK_POLICY_NEVER,
-                                   GTK_POLICY_AUTOMATIC);
-
-    /* Main container for statistics tab */
-    dashboard->statistics_tab = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-
-    /* Aggregate bandwidth section (fixed above scrolling cards) */
-    dashboard->aggregate_graph_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
-    gtk_widget_set_margin_start(dashboard->aggregate_graph_box, 20);
-    gtk_widget_set_margin_end(dashboard->aggregate_graph_box, 20);
-    gtk_widget_set_margin_top(dashboard->aggregate_graph_box, 16);
-    gtk_widget_set_no_show_all(dashboard->aggregate_graph_box, TRUE);
-
-    GtkWidget *agg_header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
-    GtkWidget *agg_title = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(agg_title),
-        "<span size='large' weight='600'>Total Bandwidth</span>");
-    gtk_label_set_xalign(GTK_LABEL(agg_title), 0.0);
-    gtk_box_pack_start(GTK_BOX(agg_header), agg_title, TRUE, TRUE, 0);
-
-    dashboard->aggregate_dl_label = gtk_label_new("↓ 0 B/s");
-    gtk_style_context_add_class(gtk_widget_get_style_context(dashboard->aggregate_dl_label), "card-bandwidth-download");
-    gtk_box_pack_start(GTK_BOX(agg_header), dashboard->aggregate_dl_label, FALSE, FALSE, 0);
-
-    dashboard->aggregate_ul_label = gtk_label_new("↑ 0 B/s");
-    gtk_style_context_add_class(gtk_widget_get_style_context(dashboard->aggregate_ul_label), "card-bandwidth-upload");
-    gtk_box_pack_start(GTK_BOX(agg_header), dashboard->aggregate_ul_label, FALSE, FALSE, 0);
-
-    gtk_box_pack_start(GTK_BOX(dashboard->aggregate_graph_box), agg_header, FALSE, FALSE, 0);
-
-    dashboard->aggregate_graph = gtk_drawing_area_new();
-    gtk_widget_set_size_request(dashboard->aggregate_graph, -1, 180);
-    gtk_style_context_add_class(gtk_widget_get_style_context(dashboard->aggregate_graph), "card-graph-area");
-    g_signal_connect(dashboard->aggregate_graph, "draw", G_CALLBACK(on_aggregate_graph_draw), dashboard);
-    gtk_box_pack_start(GTK_BOX(dashboard->aggregate_graph_box), dashboard->aggregate_graph, FALSE, FALSE, 0);
-
-    gtk_box_pack_start(GTK_BOX(dashboard->statistics_tab), dashboard->aggregate_graph_box, FALSE, FALSE, 0);
-
-    /* FlowBox for stat cards - wraps automatically */
-    dashboard->stats_flowbox = gtk_flow_box_new();
-    gtk_flow_box_set_selection_mode(GTK_FLOW_BOX(dashboard->stats_flowbox), GTK_SELECTION_NONE);
-    gtk_flow_box_set_homogeneous(GTK_FLOW_BOX(dashboard->stats_flowbox), FALSE);
-    gtk_flow_box_set_max_children_per_line(GTK_FLOW_BOX(dashboard->stats_flowbox), 4);
-    gtk_flow_box_set_column_spacing(GTK_FLOW_BOX(dashboard->stats_flowbox), 10);
-    gtk_flow_box_set_row_spacing(GTK_FLOW_BOX(dashboard->stats_flowbox), 10);
-    gtk_widget_set_margin_start(dashboard->stats_flowbox, 20);
-    gtk_widget_set_margin_end(dashboard->stats_flowbox, 20);
-    gtk_widget_set_margin_top(dashboard->stats_flowbox, 20);
-    gtk_widget_set_margin_bottom(dashboard->stats_flowbox, 20);
-
-    gtk_container_add(GTK_CONTAINER(stats_scrolled), dashboard->stats_flowbox);
-    gtk_box_pack_start(GTK_BOX(dashboard->statistics_tab), stats_scrolled, TRUE, TRUE, 0);
-
-    /* Empty state (shown when no VPNs connected) */
-    dashboard->stats_empty_state = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
-    gtk_widget_set_valign(dashboard->stats_empty_state, GTK_ALIGN_CENTER);
-    gtk_widget_set_halign(dashboard->stats_empty_state, GTK_ALIGN_CENTER);
-    gtk_widget_set_vexpand(dashboard->stats_empty_state, TRUE);
-
-    GtkWidget *empty_icon = gtk_image_new_from_icon_name("network-offline-symbolic", GTK_ICON_SIZE_DIALOG);
-    gtk_image_set_pixel_size(GTK_IMAGE(empty_icon), 96);
-    gtk_widget_set_opacity(empty_icon, 0.3);
-    gtk_box_pack_start(GTK_BOX(dashboard->stats_empty_state), empty_icon, FALSE, FALSE, 0);
-
-    GtkWidget *empty_label = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(empty_label),
-                        "<span size='large' weight='600'>No active connections</span>\n"
-                        "<span foreground='#888888'>Connect to a VPN to see statistics</span>");
-    gtk_label_set_justify(GTK_LABEL(empty_label), GTK_JUSTIFY_CENTER);
-    gtk_box_pack_start(GTK_BOX(dashboard->stats_empty_state), empty_label, FALSE, FALSE, 0);
-
-    gtk_box_pack_start(GTK_BOX(dashboard->statistics_tab), dashboard->stats_empty_state, TRUE, TRUE, 0);
-    gtk_widget_set_no_show_all(dashboard->stats_empty_state, TRUE);
-
-    gtk_notebook_append_page(GTK_NOTEBOOK(dashboard->notebook), dashboard->statistics_tab,
+    /* Tabs 2 and 3: Statistics and Servers, built on first switch */
+    dashboard->statistics_page = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    gtk_notebook_append_page(GTK_NOTEBOOK(dashboard->notebook), dashboard->statistics_page,
                             create_tab_label("utilities-system-monitor-symbolic", "Statistics"));
 
-    /* Tab 3: Servers */
-    dashboard->servers_tab_instance = servers_tab_create(NULL);  /* bus will be set later */
-    dashboard->servers_tab = servers_tab_get_widget(dashboard->servers_tab_instance);
-    gtk_notebook_append_page(GTK_NOTEBOOK(dashboard->notebook), dashboard->servers_tab,
+    dashboard->servers_page = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    gtk_notebook_append_page(GTK_NOTEBOOK(dashboard->notebook), dashboard->servers_page,
                             create_tab_label("network-server-symbolic", "Servers"));
 
-    /* Initialize bandwidth monitors hash table */
-    dashboard->bandwidth_monitors = g_hash_table_new_full(
-        g_str_hash,
-        g_str_equal,
-        g_free,
-        (GDestroyNotify)bandwidth_monitor_free
-    );
+    g_signal_connect_after(dashboard->notebook, "switch-page",
+                          G_CALLBACK(on_notebook_switch_page), dashboard);
 
     /* Main container: notebook + status bar */
     GtkWidget *main_vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -1532,27 +1981,64 @@ Dashboard* dashboard_create(void) {
 
     gtk_container_add(GTK_CONTAINER(dashboard->window), main_vbox);
 
-    logger_info("Dashboard window created");
+    logger_info("Dashboard window built in %.1f ms",
+                (g_get_monotonic_time() - start) / 1000.0);
+}
+
+/**
+ * Create dashboard
+ *
+ * The window itself is built on first show, so this is cheap enough to
+ * call during startup.
+ */
+Dashboard* dashboard_create(void) {
+    Dashboard *dashboard = g_malloc0(sizeof(Dashboard));
+    if (!dashboard) {
+        return NULL;
+    }
+
+    /* Initialize bandwidth monitors hash table */
+    dashboard->bandwidth_monitors = g_hash_table_new_full(
+        g_str_hash,
+        g_str_equal,
+        g_free,
+        (GDestroyNotify)bandwidth_monitor_free
+    );
 
     return dashboard;
 }
 
+/**
+ * Set how many servers the Servers tab probes at once
+ */
+void dashboard_set_probe_concurrency(Dashboard *dashboard, unsigned int probe_concurrency) {
+    if (!dashboard) {
+        return;
+    }
+
+    dashboard->probe_concurrency = probe_concurrency;
+    if (dashboard->servers_tab_instance) {
+        servers_tab_set_probe_concurrency(dashboard->servers_tab_instance, probe_concurrency);
+    }
+}
+
 /**
  * Show dashboard
  */
 void dashboard_show(Dashboard *dashboard) {
-    if (!dashboard || !dashboard->window) {
+    if (!dashboard) {
         return;
     }
 
-    /* Ensure window is realized before showing */
-    if (!gtk_widget_get_realized(dashboard->window)) {
-        gtk_widget_realize(dashboard->window);
+    /* Build the window on first show */
+    if (!dashboard->window) {
+        build_window(dashboard);
+    }
 
-        /* Update dashboard with current data on first show */
-        if (dashboard->bus) {
-            dashboard_update(dashboard, dashboard->bus);
-        }
+    /* Fill it with current data before it appears (nothing is refreshed
+     * while hidden) */
+    if (!gtk_widget_get_visible(dashboard->window)) {
+        dashboard_refresh(dashboard);
     }
 
     gtk_widget_show_all(dashboard->window);
@@ -1574,11 +2060,11 @@ void dashboard_hide(Dashboard *dashboard) {
  * Toggle dashboard visibility
  */
 void dashboard_toggle(Dashboard *dashboard) {
-    if (!dashboard || !dashboard->window) {
+    if (!dashboard) {
         return;
     }
 
-    if (gtk_widget_get_visible(dashboard->window)) {
+    if (dashboard->window && gtk_widget_get_visible(dashboard->window)) {
         dashboard_hide(dashboard);
     } else {
         dashboard_show(dashboard);
@@ -1595,189 +2081,58 @@ void dashboard_update(Dashboard *dashboard, sd_bus *bus) {
 
     dashboard->bus = bus;
 
-    /* Clear existing content */
-    gtk_container_foreach(GTK_CONTAINER(dashboard->sessions_container),
-                         (GtkCallback)gtk_widget_destroy, NULL);
-    gtk_container_foreach(GTK_CONTAINER(dashboard->configs_container),
-                         (GtkCallback)gtk_widget_destroy, NULL);
+    /* Hidden surfaces catch up when they come back on screen */
+    if (is_on_screen(dashboard)) {
+        dashboard_refresh(dashboard);
+    }
+}
+
+/**
+ * Refresh the visible page and the window chrome (header, status bar)
+ */
+static void dashboard_refresh(Dashboard *dashboard) {
+    sd_bus *bus = dashboard->bus;
+    if (!dashboard->window || !bus) {
+        return;
+    }
+
+    GtkWidget *page = current_page(dashboard);
+    dashboard->last_refresh_us = g_get_monotonic_time();
 
     /* Get active sessions */
     VpnSession **sessions = NULL;
     unsigned int session_count = 0;
-    int r = session_list(bus, &sessions, &session_count);
-
-    if (r >= 0 && session_count > 0) {
-        for (unsigned int i = 0; i < session_count; i++) {
-            create_session_card(dashboard, sessions[i]);
-        }
-    } else {
-        /* No active sessions */
-        GtkWidget *no_sessions = gtk_label_new(NULL);
-        gtk_label_set_markup(GTK_LABEL(no_sessions),
-                           "<span foreground='#888888'>No active VPN connections</span>");
-        gtk_box_pack_start(GTK_BOX(dashboard->sessions_container), no_sessions, FALSE, FALSE, 0);
-    }
-
-    /* Get configurations */
-    VpnConfig **configs = NULL;
-    unsigned int config_count = 0;
-    r = config_list(bus, &configs, &config_count);
-
-    if (r >= 0 && config_count > 0) {
-        for (unsigned int i = 0; i < config_count; i++) {
-            /* Check if config is in use */
-            gboolean in_use = FALSE;
-            if (sessions && session_count > 0) {
-                for (unsigned int j = 0; j < session_count; j++) {
-                    if (sessions[j]->config_name && configs[i]->config_name &&
-                        strcmp(sessions[j]->config_name, configs[i]->config_name) == 0) {
-                        in_use = TRUE;
-                        break;
-                    }
-                }
-            }
-            /* Skip configs that are already in use (shown in Active Connections) */
-            if (in_use) {
-                continue;
-            }
-            create_config_card(dashboard, configs[i]);
-        }
-        config_list_free(configs, config_count);
-    } else {
-        /* No configurations */
-        GtkWidget *no_configs = gtk_label_new(NULL);
-        gtk_label_set_markup(GTK_LABEL(no_configs),
-                           "<span foreground='#888888'>No configurations available</span>");
-        gtk_box_pack_start(GTK_BOX(dashboard->configs_container), no_configs, FALSE, FALSE, 0);
+    if (session_list(bus, &sessions, &session_count) < 0) {
+        session_count = 0;
     }
 
-    /* Add Import Config row at the end of the list */
-    create_import_config_row(dashboard);
-
-    /* Update Statistics Tab - Card-based view for multiple sessions */
-    /* Clear existing stat cards */
-    gtk_container_foreach(GTK_CONTAINER(dashboard->stats_flowbox),
-                         (GtkCallback)gtk_widget_destroy, NULL);
-
-    if (session_count > 0 && sessions) {
-        /* Hide empty state */
-        gtk_widget_hide(dashboard->stats_empty_state);
-
-        /* Create/update stat cards for each session */
-        for (unsigned int i = 0; i < session_count; i++) {
-            VpnSession *session = sessions[i];
-
-            if (!session->device_name || !session->session_path) {
-                continue;  /* Skip sessions without device */
-            }
-
-            /* Get or create bandwidth monitor for this session */
-            BandwidthMonitor *monitor = g_hash_table_lookup(
-                dashboard->bandwidth_monitors,
-                session->session_path
-            );
-
-            if (!monitor) {
-                /* Create new monitor */
-                logger_debug("Dashboard: Creating bandwidth monitor for session %s (device: %s)",
-                       session->config_name ? session->config_name : "unknown",
-                       session->device_name);
-
-                monitor = bandwidth_monitor_create(
-                    session->session_path,
-                    session->device_name,
-                    STATS_SOURCE_AUTO,
-                    7200  /* 2-hour buffer (7200 seconds) */
-                );
-
-                if (monitor) {
-                    g_hash_table_insert(
-                        dashboard->bandwidth_monitors,
-                        g_strdup(session->session_path),
-                        monitor
-                    );
-                    logger_debug("Dashboard: Bandwidth monitor created successfully");
-                } else {
-                    logger_debug("Dashboard: Failed to create bandwidth monitor");
-                    continue;
-                }
-            }
-
-            /* Update the monitor */
-            bandwidth_monitor_update(monitor, bus);
-
-            /* Create stat card for this session */
-            GtkWidget *card = create_vpn_stat_card(dashboard, session, monitor);
-            if (card) {
-                gtk_container_add(GTK_CONTAINER(dashboard->stats_flowbox), card);
-
-                /* Update card with live data */
-                BandwidthRate rate;
-                if (bandwidth_monitor_get_rate(monitor, &rate) >= 0) {
-                    /* Update throughput labels */
-                    GtkWidget *download_label = g_object_get_data(G_OBJECT(card), "download-label");
-                    GtkWidget *upload_label = g_object_get_data(G_OBJECT(card), "upload-label");
-
-                    if (download_label && upload_label) {
-                        char text[256];
-                        format_bytes((uint64_t)rate.download_rate_bps, text, sizeof(text));
-                        char label_text[256];
-                        snprintf(label_text, sizeof(label_text), "↓ %s/s", text);
-                        gtk_label_set_text(GTK_LABEL(download_label), label_text);
-
-                        format_bytes((uint64_t)rate.upload_rate_bps, text, sizeof(text));
-                        snprintf(label_text, sizeof(label_text), "↑ %s/s", text);
-                        gtk_label_set_text(GTK_LABEL(upload_label), label_text);
-                    }
-                }
-
-                /* Update packet statistics */
-                BandwidthSample sample;
-                if (bandwidth_monitor_get_latest_sample(monitor, &sample) >= 0) {
-                    GtkWidget *sent_label = g_object_get_data(G_OBJECT(card), "sent-label");
-                    GtkWidget *received_label = g_object_get_data(G_OBJECT(card), "received-label");
-                    GtkWidget *errors_label = g_object_get_data(G_OBJECT(card), "errors-label");
-
-                    if (sent_label) {
-                        char label_text[256];
-                        snprintf(label_text, sizeof(label_text), "Sent:     %lu", sample.packets_out);
-                        gtk_label_set_text(GTK_LABEL(sent_label), label_text);
-                    }
-                    if (received_label) {
-                        char label_text[256];
-                        snprintf(label_text, sizeof(label_text), "Received: %lu", sample.packets_in);
-                        gtk_label_set_text(GTK_LABEL(received_label), label_text);
-                    }
-                    if (errors_label) {
-                        char label_text[256];
-                        snprintf(label_text, sizeof(label_text), "Errors:   %lu",
-                                sample.errors_in + sample.errors_out);
-                        gtk_label_set_text(GTK_LABEL(errors_label), label_text);
-                    }
-                }
+    if (page == dashboard->connections_page) {
+        reconcile_session_cards(dashboard, sessions, session_count);
 
-                /* Queue redraw for sparkline graph */
-                GtkWidget *graph_area = g_object_get_data(G_OBJECT(card), "graph-area");
-                if (graph_area) {
-                    gtk_widget_queue_draw(graph_area);
-                }
-            }
+        /* Get configurations */
+        VpnConfig **configs = NULL;
+        unsigned int config_count = 0;
+        if (config_list(bus, &configs, &config_count) < 0) {
+            config_count = 0;
         }
 
-        gtk_widget_show_all(dashboard->stats_flowbox);
-
-        /* Show aggregate graph */
-        if (dashboard->aggregate_graph_box) {
-            gtk_widget_show_all(dashboard->aggregate_graph_box);
+        reconcile_config_rows(dashboard, configs, config_count, sessions, session_count);
+        if (configs) {
+            config_list_free(configs, config_count);
         }
-    } else {
-        /* No active sessions - show empty state */
-        gtk_widget_show(dashboard->stats_empty_state);
+    }
 
-        /* Hide aggregate graph */
-        if (dashboard->aggregate_graph_box) {
-            gtk_widget_hide(dashboard->aggregate_graph_box);
-        }
+    /* Keep the session list for pages built before the next update */
+    if (dashboard->sessions) {
+        session_list_free(dashboard->sessions, dashboard->session_count);
+    }
+    dashboard->sessions = sessions;
+    dashboard->session_count = sessions ? session_count : 0;
+
+    sample_bandwidth(dashboard, bus);
+    prune_bandwidth_monitors(dashboard);
+    if (page == dashboard->statistics_page) {
+        update_statistics(dashboard);
     }
 
     /* Update header bar subtitle */
@@ -1817,17 +2172,18 @@ void dashboard_update(Dashboard *dashboard, sd_bus *bus) {
         dashboard->aggregate_ul_history[dashboard->aggregate_write_idx] = total_ul;
         dashboard->aggregate_write_idx = (dashboard->aggregate_write_idx + 1) % 120;
         if (dashboard->aggregate_sample_count < 120) dashboard->aggregate_sample_count++;
+        dashboard->aggregate_sample_seq++;
 
         /* Update aggregate graph labels */
         if (dashboard->aggregate_dl_label && dashboard->aggregate_ul_label) {
             char agg_text[64], agg_label[80];
             format_bytes((uint64_t)total_dl, agg_text, sizeof(agg_text));
             snprintf(agg_label, sizeof(agg_label), "↓ %s/s", agg_text);
-            gtk_label_set_text(GTK_LABEL(dashboard->aggregate_dl_label), agg_label);
+            set_label_text(dashboard->aggregate_dl_label, agg_label);
 
             format_bytes((uint64_t)total_ul, agg_text, sizeof(agg_text));
             snprintf(agg_label, sizeof(agg_label), "↑ %s/s", agg_text);
-            gtk_label_set_text(GTK_LABEL(dashboard->aggregate_ul_label), agg_label);
+            set_label_text(dashboard->aggregate_ul_label, agg_label);
         }
 
         /* Queue aggregate graph redraw */
@@ -1845,25 +2201,17 @@ void dashboard_update(Dashboard *dashboard, sd_bus *bus) {
                 snprintf(status_text, sizeof(status_text),
                         "↓ %s/s  ↑ %s/s  ·  %u connection%s  ·  Uptime: %s",
                         dl_s, ul_s, session_count, session_count > 1 ? "s" : "", ut_s);
-                gtk_label_set_text(GTK_LABEL(dashboard->status_label), status_text);
+                set_label_text(dashboard->status_label, status_text);
             } else {
-                gtk_label_set_text(GTK_LABEL(dashboard->status_label), "No active connections");
+                set_label_text(dashboard->status_label, "No active connections");
             }
         }
     }
 
-    /* Free sessions after we're done using them */
-    if (sessions) {
-        session_list_free(sessions, session_count);
-    }
-
     /* Update servers tab */
-    if (dashboard->servers_tab_instance) {
+    if (page == dashboard->servers_page && dashboard->servers_tab_instance) {
         servers_tab_refresh(dashboard->servers_tab_instance, bus);
     }
-
-    gtk_widget_show_all(dashboard->sessions_container);
-    gtk_widget_show_all(dashboard->configs_container);
 }
 
 /**
@@ -1874,12 +2222,35 @@ void dashboard_destroy(Dashboard *dashboard) {
         return;
     }
 
+    if (dashboard->refresh_id > 0) {
+        scheduler_remove(dashboard->refresh_id);
+    }
+    if (dashboard->window) {
+        g_signal_handlers_disconnect_by_data(dashboard->window, dashboard);
+        g_signal_handlers_disconnect_by_data(dashboard->notebook, dashboard);
+    }
+
     /* Clean up bandwidth monitors hash table */
     if (dashboard->bandwidth_monitors) {
         g_hash_table_destroy(dashboard->bandwidth_monitors);
         dashboard->bandwidth_monitors = NULL;
     }
 
+    if (dashboard->sessions) {
+        session_list_free(dashboard->sessions, dashboard->session_count);
+    }
+
+    /* Card indexes (the widgets go with the window) */
+    if (dashboard->session_cards) {
+        g_hash_table_destroy(dashboard->session_cards);
+    }
+    if (dashboard->config_rows) {
+        g_hash_table_destroy(dashboard->config_rows);
+    }
+    if (dashboard->stat_cards) {
+        g_hash_table_destroy(dashboard->stat_cards);
+    }
+
     /* Clean up servers tab */
     if (dashboard->servers_tab_instance) {
         servers_tab_free(dashboard->servers_tab_instance);
@@ -17,12 +17,26 @@
 typedef struct Dashboard Dashboard;
 
 /**
- * Create and initialize the dashboard window
+ * Create the dashboard
+ *
+ * The window and its notebook pages are built on first show, so this is
+ * cheap to call at startup.
  *
  * @return Dashboard* - The dashboard instance, or NULL on failure
  */
 Dashboard* dashboard_create(void);
 
+/**
+ * Set how many servers the Servers tab probes at once
+ *
+ * Call before the dashboard is first shown; a tab that is already built
+ * adopts the new value.
+ *
+ * @param dashboard The dashboard instance
+ * @param probe_concurrency Probes in flight at once (minimum 1)
+ */
+void dashboard_set_probe_concurrency(Dashboard *dashboard, unsigned int probe_concurrency);
+
 /**
  * Show the dashboard window
  * If already visible, brings it to front
@@ -48,6 +62,11 @@ void dashboard_toggle(Dashboard *dashboard);
 /**
  * Update dashboard with current VPN sessions and configurations
  *
+ * The dashboard refreshes itself while it is on screen (every 2 s when
+ * focused, every 10 s otherwise, and right away when it is shown again);
+ * call this after changes that should appear immediately. While the
+ * window is hidden this only records the bus.
+ *
  * @param dashboard The dashboard instance
  * @param bus D-Bus connection for fetching data
  */
@@ -0,0 +1,334 @@
+#include "graph_cache.h"
+#include <math.h>
+
+#define GRAPH_LINE_WIDTH 2.0
+#define GRAPH_LINE_ALPHA 0.8
+#define GRAPH_FILL_ALPHA 0.3
+
+struct GraphCache {
+    GtkWidget *widget;
+    GraphStyle style;
+
+    int width;
+    int height;
+    int scale;
+
+    /* Background and grid; NULL until (re)built */
+    cairo_surface_t *static_layer;
+    GdkRGBA colors[GRAPH_MAX_SERIES];
+
+    /* Series, kept as two layers so the lines can be drawn opaque
+     * segment by segment and composited with one alpha */
+    cairo_surface_t *fill_layer;
+    cairo_surface_t *line_layer;
+    cairo_surface_t *spare;           /* Scroll target, swapped with a layer */
+    gboolean series_valid;
+    double max_value;
+    double last_t;                    /* Newest point in the series layers */
+    double origin;                    /* Absolute pixel column of the left edge */
+};
+
+static void drop_surface(cairo_surface_t **surface) {
+    if (*surface) {
+        cairo_surface_destroy(*surface);
+        *surface = NULL;
+    }
+}
+
+static void drop_layers(GraphCache *cache) {
+    drop_surface(&cache->static_layer);
+    drop_surface(&cache->fill_layer);
+    drop_surface(&cache->line_layer);
+    drop_surface(&cache->spare);
+    cache->series_valid = FALSE;
+}
+
+static void graph_cache_free(gpointer data) {
+    GraphCache *cache = data;
+    drop_layers(cache);
+    g_free(cache);
+}
+
+/**
+ * Theme or CSS changed: rebuild the static layer and overlay colors
+ */
+static void on_style_updated(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    GraphCache *cache = data;
+    drop_surface(&cache->static_layer);
+}
+
+static cairo_surface_t* create_layer(GraphCache *cache) {
+    /* Matches the window's format and scale factor */
+    return gdk_window_create_similar_surface(gtk_widget_get_window(cache->widget),
+                                             CAIRO_CONTENT_COLOR_ALPHA,
+                                             cache->width, cache->height);
+}
+
+static void clear_layer(cairo_surface_t *layer) {
+    cairo_t *cr = cairo_create(layer);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+}
+
+/**
+ * Shift a layer left by a whole number of pixels
+ */
+static void scroll_layer(GraphCache *cache, cairo_surface_t **layer, double shift) {
+    cairo_t *cr = cairo_create(cache->spare);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cr, *layer, -shift, 0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    cairo_surface_t *scrolled = cache->spare;
+    cache->spare = *layer;
+    *layer = scrolled;
+}
+
+static void build_static_layer(GraphCache *cache) {
+    GtkStyleContext *sc = gtk_widget_get_style_context(cache->widget);
+    const int margin = cache->style.margin;
+
+    cache->static_layer = create_layer(cache);
+    cairo_t *cr = cairo_create(cache->static_layer);
+
+    /* Background */
+    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.02);
+    cairo_rectangle(cr, 0, 0, cache->width, cache->height);
+    cairo_fill(cr);
+
+    /* Horizontal grid lines at 25%, 50%, 75% */
+    GdkRGBA grid_clr;
+    if (!gtk_style_context_lookup_color(sc, "text_tertiary", &grid_clr))
+        grid_clr = (GdkRGBA){0.5, 0.5, 0.5, 1.0};
+    cairo_set_source_rgba(cr, grid_clr.red, grid_clr.green, grid_clr.blue, cache->style.grid_alpha);
+    cairo_set_line_width(cr, 0.5);
+    double dashes[] = {4.0, 4.0};
+    cairo_set_dash(cr, dashes, 2, 0);
+    for (int i = 1; i <= 3; i++) {
+        double gy = margin + (cache->height - 2 * margin) * (1.0 - i * 0.25);
+        cairo_move_to(cr, margin, gy);
+        cairo_line_to(cr, cache->width - margin, gy);
+        cairo_stroke(cr);
+    }
+
+    cairo_destroy(cr);
+
+    /* Overlay colors */
+    for (unsigned int s = 0; s < cache->style.series_count; s++) {
+        const char *name = cache->style.theme_color[s];
+        if (!name || !gtk_style_context_lookup_color(sc, name, &cache->colors[s]))
+            cache->colors[s] = cache->style.series_color[s];
+    }
+}
+
+/**
+ * Make sure all layers exist for the current allocation and scale
+ */
+static void ensure_layers(GraphCache *cache, int width, int height) {
+    int scale = gtk_widget_get_scale_factor(cache->widget);
+
+    if (width != cache->width || height != cache->height || scale != cache->scale) {
+        drop_layers(cache);
+        cache->width = width;
+        cache->height = height;
+        cache->scale = scale;
+    }
+
+    if (!cache->static_layer) {
+        build_static_layer(cache);
+    }
+
+    if (!cache->fill_layer) {
+        cache->fill_layer = create_layer(cache);
+        cache->line_layer = create_layer(cache);
+        cache->spare = create_layer(cache);
+        cache->series_valid = FALSE;
+    }
+}
+
+/**
+ * Draw the segments from points[first] to points[count - 1]
+ */
+static void draw_segments(GraphCache *cache, const GraphPoint *points,
+                          unsigned int first, unsigned int count) {
+    const int margin = cache->style.margin;
+    double gw = cache->width - 2 * margin;
+    double gh = cache->height - 2 * margin;
+    double px = gw / cache->style.span;
+    double bottom = margin + gh;
+
+    cairo_t *fill_cr = cairo_create(cache->fill_layer);
+    cairo_t *line_cr = cairo_create(cache->line_layer);
+
+    /* Segments are filled one after another across scrolls; without
+     * antialiasing neighbouring trapezoids tile exactly and leave no
+     * seams. The jagged top edge is covered by the line. */
+    cairo_set_antialias(fill_cr, CAIRO_ANTIALIAS_NONE);
+    cairo_set_line_width(line_cr, GRAPH_LINE_WIDTH);
+    cairo_set_line_cap(line_cr, CAIRO_LINE_CAP_ROUND);
+    cairo_set_line_join(line_cr, CAIRO_LINE_JOIN_ROUND);
+
+    for (unsigned int s = 0; s < cache->style.series_count; s++) {
+        const GdkRGBA *c = &cache->style.series_color[s];
+
+        for (unsigned int i = first; i < count; i++) {
+            double x = margin + (points[i].t * px - cache->origin);
+            double v = points[i].value[s];
+            if (v > cache->max_value) v = cache->max_value;
+            double y = bottom - (v / cache->max_value * gh);
+
+            if (i == first) {
+                cairo_move_to(line_cr, x, y);
+            } else {
+                double px0, py0;
+                cairo_get_current_point(line_cr, &px0, &py0);
+                cairo_move_to(fill_cr, px0, py0);
+                cairo_line_to(fill_cr, x, y);
+                cairo_line_to(fill_cr, x, bottom);
+                cairo_line_to(fill_cr, px0, bottom);
+                cairo_close_path(fill_cr);
+                cairo_line_to(line_cr, x, y);
+            }
+        }
+
+        cairo_pattern_t *gradient = cairo_pattern_create_linear(0, margin, 0, bottom);
+        cairo_pattern_add_color_stop_rgba(gradient, 0.0, c->red, c->green, c->blue, GRAPH_FILL_ALPHA);
+        cairo_pattern_add_color_stop_rgba(gradient, 1.0, c->red, c->green, c->blue, 0.0);
+        cairo_set_source(fill_cr, gradient);
+        cairo_fill(fill_cr);
+        cairo_pattern_destroy(gradient);
+
+        cairo_set_source_rgb(line_cr, c->red, c->green, c->blue);
+        cairo_stroke(line_cr);
+    }
+
+    cairo_destroy(fill_cr);
+    cairo_destroy(line_cr);
+}
+
+/**
+ * Bring the series layers up to date with the points
+ */
+static void update_series(GraphCache *cache, const GraphPoint *points,
+                          unsigned int count, double max_value) {
+    const int margin = cache->style.margin;
+    double gw = cache->width - 2 * margin;
+    double px = gw / cache->style.span;
+    double newest = points[count - 1].t;
+    /* Whole pixels, so scrolling never resamples the layers */
+    double origin = ceil(newest * px) - gw;
+    unsigned int first = 0;
+    gboolean incremental = FALSE;
+
+    if (cache->series_valid && cache->max_value == max_value &&
+        origin >= cache->origin && origin - cache->origin < gw) {
+        /* Continue from the newest point already drawn */
+        for (unsigned int i = count; i-- > 0; ) {
+            if (points[i].t == cache->last_t) {
+                first = i;
+                incremental = TRUE;
+                break;
+            }
+            if (points[i].t < cache->last_t) break;
+        }
+    }
+
+    if (incremental) {
+        if (first == count - 1) {
+            return;  /* Nothing new */
+        }
+        double shift = origin - cache->origin;
+        if (shift > 0) {
+            scroll_layer(cache, &cache->fill_layer, shift);
+            scroll_layer(cache, &cache->line_layer, shift);
+        }
+    } else {
+        clear_layer(cache->fill_layer);
+        clear_layer(cache->line_layer);
+    }
+
+    cache->origin = origin;
+    cache->max_value = max_value;
+    draw_segments(cache, points, first, count);
+    cache->last_t = newest;
+    cache->series_valid = TRUE;
+}
+
+GraphCache* graph_cache_attach(GtkWidget *area, const GraphStyle *style) {
+    if (!area || !style) {
+        return NULL;
+    }
+
+    GraphCache *cache = g_malloc0(sizeof(GraphCache));
+    cache->widget = area;
+    cache->style = *style;
+    if (cache->style.series_count > GRAPH_MAX_SERIES) {
+        cache->style.series_count = GRAPH_MAX_SERIES;
+    }
+    if (cache->style.span <= 0) {
+        cache->style.span = 1;
+    }
+
+    g_object_set_data_full(G_OBJECT(area), "graph-cache", cache, graph_cache_free);
+    g_signal_connect(area, "style-updated", G_CALLBACK(on_style_updated), cache);
+
+    return cache;
+}
+
+GraphCache* graph_cache_get(GtkWidget *area) {
+    return area ? g_object_get_data(G_OBJECT(area), "graph-cache") : NULL;
+}
+
+void graph_cache_draw(GraphCache *cache, cairo_t *cr,
+                      const GraphPoint *points, unsigned int count,
+                      double max_value) {
+    if (!cache || !cr) {
+        return;
+    }
+
+    int width = gtk_widget_get_allocated_width(cache->widget);
+    int height = gtk_widget_get_allocated_height(cache->widget);
+    int margin = cache->style.margin;
+    if (width <= 2 * margin || height <= 2 * margin) {
+        return;
+    }
+
+    ensure_layers(cache, width, height);
+
+    gboolean has_series = points && count >= 2 && max_value > 0;
+    if (has_series) {
+        update_series(cache, points, count, max_value);
+    } else {
+        cache->series_valid = FALSE;
+    }
+
+    cairo_save(cr);
+    cairo_set_source_surface(cr, cache->static_layer, 0, 0);
+    cairo_paint(cr);
+
+    if (has_series) {
+        /* Points older than the span scroll out under the left margin */
+        cairo_rectangle(cr, margin, 0, width - margin, height);
+        cairo_clip(cr);
+        cairo_set_source_surface(cr, cache->fill_layer, 0, 0);
+        cairo_paint(cr);
+        cairo_set_source_surface(cr, cache->line_layer, 0, 0);
+        cairo_paint_with_alpha(cr, GRAPH_LINE_ALPHA);
+    }
+    cairo_restore(cr);
+}
+
+void graph_cache_get_color(GraphCache *cache, unsigned int series, GdkRGBA *color) {
+    if (!cache || !color || series >= GRAPH_MAX_SERIES) {
+        return;
+    }
+
+    if (cache->static_layer) {
+        *color = cache->colors[series];
+    } else {
+        *color = cache->style.series_color[series];
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef GRAPH_CACHE_H
+#define GRAPH_CACHE_H
+
+#include <gtk/gtk.h>
+
+/**
+ * Graph Cache
+ *
+ * Offscreen rendering for the dashboard's scrolling bandwidth graphs.
+ * Each graph is composited from cached layers:
+ *  - a static layer (background and grid), rebuilt only when the widget
+ *    is resized, moves to a display with another scale, or the theme
+ *    changes
+ *  - series layers (gradient fills and lines); when new samples arrive
+ *    they are scrolled left by whole pixels and only the new segments
+ *    are drawn at the right edge
+ * The series layers are redrawn in full when the vertical scale changes.
+ */
+
+#define GRAPH_MAX_SERIES 2
+
+/* One sample of every series at a position on the horizontal axis */
+typedef struct {
+    double t;                        /* Position (seconds, sample number, ...) */
+    double value[GRAPH_MAX_SERIES];  /* Series values, >= 0 */
+} GraphPoint;
+
+/* Graph appearance */
+typedef struct {
+    int margin;                      /* Inner margin in pixels */
+    double grid_alpha;               /* Alpha of the dashed grid lines */
+    double span;                     /* Visible range of t */
+    unsigned int series_count;
+    GdkRGBA series_color[GRAPH_MAX_SERIES];
+    const char *theme_color[GRAPH_MAX_SERIES]; /* Named theme color per series (can be NULL) */
+} GraphStyle;
+
+typedef struct GraphCache GraphCache;
+
+/**
+ * Attach a cache to a drawing area
+ *
+ * The cache is owned by the widget and freed with it.
+ *
+ * @param area Drawing area
+ * @param style Graph appearance (copied; theme color names must be static)
+ * @return GraphCache* - The attached cache
+ */
+GraphCache* graph_cache_attach(GtkWidget *area, const GraphStyle *style);
+
+/**
+ * Get the cache attached to a drawing area
+ *
+ * @param area Drawing area
+ * @return GraphCache* or NULL if none is attached
+ */
+GraphCache* graph_cache_get(GtkWidget *area);
+
+/**
+ * Draw the graph from a draw handler
+ *
+ * Points must be ordered oldest first and only ever be appended to
+ * between calls; anything else is detected and causes a full redraw.
+ * With fewer than two points only the static layer is drawn.
+ *
+ * @param cache Graph cache
+ * @param cr Cairo context of the draw handler
+ * @param points Samples, oldest first
+ * @param count Number of points
+ * @param max_value Value drawn at the top of the graph
+ */
+void graph_cache_draw(GraphCache *cache, cairo_t *cr,
+                      const GraphPoint *points, unsigned int count,
+                      double max_value);
+
+/**
+ * Get the theme color of a series for overlays
+ *
+ * Resolved once per theme change; falls back to the series color.
+ *
+ * @param cache Graph cache
+ * @param series Series index
+ * @param color Output color
+ */
+void graph_cache_get_color(GraphCache *cache, unsigned int series, GdkRGBA *color);
+
+#endif /* GRAPH_CACHE_H */
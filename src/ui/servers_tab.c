@@ -1,10 +1,20 @@
 #include "servers_tab.h"
 #include "icons.h"
+#define LOG_CATEGORY LOG_CAT_UI
 #include "../utils/logger.h"
 #include "../monitoring/ping_util.h"
+#include "../monitoring/probe_scheduler.h"
+#include "../monitoring/dns_cache.h"
 #include "../dbus/session_client.h"
+#include <stdlib.h>
 #include <string.h>
 
+/* Background latency probing (concurrency comes from the settings) */
+#define SERVERS_PROBE_INTERVAL_SEC  60
+#define SERVERS_PROBE_TIMEOUT_MS    2000
+#define SERVERS_PROBE_BURST         5
+#define SERVERS_PROBE_SPACING_MS    200
+
 /**
  * TreeView column indices
  */
@@ -16,6 +26,13 @@ enum {
     COL_PORT,             /* Port number */
     COL_PROTOCOL,         /* Protocol (UDP/TCP) */
     COL_LATENCY,          /* Latency display string */
+    COL_DNS,              /* DNS resolution time display string */
+    COL_LOSS,             /* Packet loss display string */
+    COL_JITTER,           /* Jitter display string */
+    COL_LATENCY_VALUE,    /* Latency sort key (hidden) */
+    COL_LOSS_VALUE,       /* Loss sort key (hidden) */
+    COL_JITTER_VALUE,     /* Jitter sort key (hidden) */
+    COL_DNS_VALUE,        /* DNS resolution time sort key (hidden) */
     COL_NUM_COLUMNS
 };
 
@@ -27,26 +44,39 @@ struct ServersTab {
     GtkWidget *search_entry;     /* Search/filter entry */
     GtkWidget *tree_view;        /* Server list tree view */
     GtkListStore *list_store;    /* Data model */
+    GtkTreeModel *filter;        /* Search filter over list_store */
+    GtkTreeModel *sort;          /* Sorted view of filter, shown by tree_view */
+    char *filter_key;            /* Case-folded search text (NULL = show all) */
     GtkWidget *refresh_latency_button; /* Refresh latency button */
     GtkWidget *connect_button;   /* Connect button */
+    GtkWidget *connect_fastest_button; /* Connect to fastest remote button */
     GtkWidget *disconnect_button; /* Disconnect button */
     GtkWidget *refresh_button;   /* Refresh button */
 
     GPtrArray *servers;          /* Array of ServerInfo */
+    GHashTable *rows;            /* ServerInfo* -> GtkTreeRowReference* in list_store */
+    GHashTable *by_path;         /* config path -> ServerInfo* */
+    GHashTable *dirty;           /* ServerInfo* with row updates pending */
+    guint flush_id;              /* Pending row update flush */
     sd_bus *bus;                 /* D-Bus connection */
 
-    int ping_in_progress;        /* Number of pings in progress */
+    ProbeScheduler *probes;      /* Background latency prober */
+    ServerInfo *prioritized;     /* Selected server when priorities were last set */
 };
 
 /* Forward declarations */
 static void on_refresh_latency_clicked(GtkButton *button, gpointer data);
 static void on_connect_clicked(GtkButton *button, gpointer data);
+static void on_connect_fastest_clicked(GtkButton *button, gpointer data);
 static void on_disconnect_clicked(GtkButton *button, gpointer data);
 static void on_refresh_clicked(GtkButton *button, gpointer data);
 static void on_selection_changed(GtkTreeSelection *selection, gpointer data);
 static void on_search_changed(GtkSearchEntry *entry, gpointer data);
-static void ping_callback(const char *hostname, int latency_ms, void *user_data);
-static void test_all_servers_latency(ServersTab *tab);
+static void on_probe_result(const char *target_id, int latency_ms,
+                            const BurstStats *stats,
+                            const ProbeHistory *history, void *user_data);
+static void update_probe_priorities(ServersTab *tab);
+static void on_scroll_changed(GtkAdjustment *adjustment, gpointer data);
 
 /**
  * Cell data function for latency column - applies background color based on latency value
@@ -82,18 +112,70 @@ static void server_info_free(ServerInfo *info) {
     if (info->config) {
         config_free(info->config);
     }
+    g_free(info->remote_status);
+    g_free(info->search_key);
     g_free(info);
 }
 
+/**
+ * Build the text the search filter matches: name, hostname and every
+ * remote host, case-folded once so filtering is a plain substring test
+ */
+static char* make_search_key(const VpnConfig *config) {
+    GString *key = g_string_new(NULL);
+
+    if (config->config_name) {
+        g_string_append(key, config->config_name);
+    }
+    if (config->server_hostname) {
+        g_string_append_c(key, '\n');
+        g_string_append(key, config->server_hostname);
+    }
+    for (unsigned int i = 0; i < config->remote_count; i++) {
+        if (config->remotes[i].host) {
+            g_string_append_c(key, '\n');
+            g_string_append(key, config->remotes[i].host);
+        }
+    }
+
+    char *folded = g_utf8_casefold(key->str, -1);
+    g_string_free(key, TRUE);
+    return folded;
+}
+
+/**
+ * Search filter visibility function
+ */
+static gboolean server_visible(GtkTreeModel *model, GtkTreeIter *iter, gpointer data) {
+    ServersTab *tab = (ServersTab *)data;
+    ServerInfo *server = NULL;
+
+    if (!tab->filter_key) {
+        return TRUE;
+    }
+
+    gtk_tree_model_get(model, iter, COL_SERVER_INFO, &server, -1);
+    return server && server->search_key && strstr(server->search_key, tab->filter_key) != NULL;
+}
+
 /**
  * Create servers tab widget
  */
-ServersTab* servers_tab_create(sd_bus *bus) {
+ServersTab* servers_tab_create(sd_bus *bus, unsigned int probe_concurrency) {
     ServersTab *tab = g_malloc0(sizeof(ServersTab));
     if (!tab) return NULL;
 
     tab->bus = bus;
     tab->servers = g_ptr_array_new_with_free_func((GDestroyNotify)server_info_free);
+    tab->rows = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                      (GDestroyNotify)gtk_tree_row_reference_free);
+    tab->by_path = g_hash_table_new(g_str_hash, g_str_equal);
+    tab->dirty = g_hash_table_new(g_direct_hash, g_direct_equal);
+    tab->probes = probe_scheduler_create(probe_concurrency,
+                                         SERVERS_PROBE_INTERVAL_SEC,
+                                         SERVERS_PROBE_TIMEOUT_MS);
+    probe_scheduler_set_burst(tab->probes, SERVERS_PROBE_BURST, SERVERS_PROBE_SPACING_MS);
+    probe_scheduler_subscribe(tab->probes, on_probe_result, tab);
 
     /* Main container */
     tab->container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 12);
@@ -134,10 +216,23 @@ ServersTab* servers_tab_create(sd_bus *bus) {
                                          G_TYPE_STRING,    /* Server hostname/IP */
                                          G_TYPE_INT,       /* Port */
                                          G_TYPE_STRING,    /* Protocol */
-                                         G_TYPE_STRING);   /* Latency */
+                                         G_TYPE_STRING,    /* Latency */
+                                         G_TYPE_STRING,    /* DNS */
+                                         G_TYPE_STRING,    /* Loss */
+                                         G_TYPE_STRING,    /* Jitter */
+                                         G_TYPE_INT,       /* Latency sort key */
+                                         G_TYPE_DOUBLE,    /* Loss sort key */
+                                         G_TYPE_DOUBLE,    /* Jitter sort key */
+                                         G_TYPE_INT64);    /* DNS sort key */
+
+    /* Search filter and column sorting stacked on the store */
+    tab->filter = gtk_tree_model_filter_new(GTK_TREE_MODEL(tab->list_store), NULL);
+    gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(tab->filter),
+                                           server_visible, tab, NULL);
+    tab->sort = gtk_tree_model_sort_new_with_model(tab->filter);
 
     /* Create tree view */
-    tab->tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(tab->list_store));
+    tab->tree_view = gtk_tree_view_new_with_model(tab->sort);
     gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(tab->tree_view), TRUE);
     gtk_tree_view_set_enable_search(GTK_TREE_VIEW(tab->tree_view), TRUE);
     gtk_tree_view_set_search_column(GTK_TREE_VIEW(tab->tree_view), COL_CONFIG_NAME);
@@ -198,7 +293,34 @@ ServersTab* servers_tab_create(sd_bus *bus) {
     gtk_tree_view_column_pack_start(column, renderer, TRUE);
     gtk_tree_view_column_add_attribute(column, renderer, "text", COL_LATENCY);
     gtk_tree_view_column_set_cell_data_func(column, renderer, latency_cell_data_func, NULL, NULL);
-    gtk_tree_view_column_set_sort_column_id(column, COL_LATENCY);
+    gtk_tree_view_column_set_sort_column_id(column, COL_LATENCY_VALUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(tab->tree_view), column);
+
+    /* DNS column - resolution time, kept apart from network latency */
+    renderer = gtk_cell_renderer_text_new();
+    column = gtk_tree_view_column_new_with_attributes(
+        "DNS", renderer,
+        "text", COL_DNS,
+        NULL);
+    gtk_tree_view_column_set_sort_column_id(column, COL_DNS_VALUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(tab->tree_view), column);
+
+    /* Loss column - share of the last burst that went unanswered */
+    renderer = gtk_cell_renderer_text_new();
+    column = gtk_tree_view_column_new_with_attributes(
+        "Loss", renderer,
+        "text", COL_LOSS,
+        NULL);
+    gtk_tree_view_column_set_sort_column_id(column, COL_LOSS_VALUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(tab->tree_view), column);
+
+    /* Jitter column */
+    renderer = gtk_cell_renderer_text_new();
+    column = gtk_tree_view_column_new_with_attributes(
+        "Jitter", renderer,
+        "text", COL_JITTER,
+        NULL);
+    gtk_tree_view_column_set_sort_column_id(column, COL_JITTER_VALUE);
     gtk_tree_view_append_column(GTK_TREE_VIEW(tab->tree_view), column);
 
     /* Connect selection changed signal */
@@ -210,6 +332,10 @@ ServersTab* servers_tab_create(sd_bus *bus) {
     gtk_container_add(GTK_CONTAINER(scrolled), tab->tree_view);
     gtk_box_pack_start(GTK_BOX(tab->container), scrolled, TRUE, TRUE, 0);
 
+    /* Rows scrolled into view are probed first */
+    g_signal_connect(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scrolled)),
+                     "value-changed", G_CALLBACK(on_scroll_changed), tab);
+
     /* Button bar */
     GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
     gtk_widget_set_margin_top(button_box, 12);
@@ -237,6 +363,13 @@ ServersTab* servers_tab_create(sd_bus *bus) {
     gtk_style_context_add_class(ctx, "suggested-action");
     gtk_box_pack_start(GTK_BOX(button_box), tab->connect_button, FALSE, FALSE, 0);
 
+    /* Connect to fastest remote button (multi-remote profiles) */
+    tab->connect_fastest_button = gtk_button_new_with_label("Connect to Fastest");
+    gtk_widget_set_sensitive(tab->connect_fastest_button, FALSE);
+    g_signal_connect(tab->connect_fastest_button, "clicked",
+                    G_CALLBACK(on_connect_fastest_clicked), tab);
+    gtk_box_pack_start(GTK_BOX(button_box), tab->connect_fastest_button, FALSE, FALSE, 0);
+
     /* Disconnect button */
     tab->disconnect_button = gtk_button_new_with_label("Disconnect");
     gtk_widget_set_sensitive(tab->disconnect_button, FALSE);
@@ -259,9 +392,9 @@ GtkWidget* servers_tab_get_widget(ServersTab *tab) {
 }
 
 /**
- * Update tree view row for a server
+ * Write a server's columns into its list store row
  */
-static void update_server_row(ServersTab *tab, ServerInfo *server, GtkTreeIter *iter) {
+static void set_server_row(ServersTab *tab, ServerInfo *server, GtkTreeIter *iter) {
     const char *status_icon = NULL;
     if (server->connected) {
         status_icon = ICON_STATUS_ACTIVE;  /* Active connection indicator */
@@ -276,126 +409,297 @@ static void update_server_row(ServersTab *tab, ServerInfo *server, GtkTreeIter *
         snprintf(latency_text, sizeof(latency_text), "%d ms", server->latency_ms);
     }
 
+    /* Loss and jitter are only meaningful once a burst has completed */
+    gboolean measured = !server->testing &&
+                        (server->latency_ms >= 0 || server->loss_percent > 0.0);
+    char loss_text[16];
+    char jitter_text[16];
+    if (measured) {
+        snprintf(loss_text, sizeof(loss_text), "%.0f%%", server->loss_percent);
+    } else {
+        snprintf(loss_text, sizeof(loss_text), "--");
+    }
+    if (measured && server->latency_ms >= 0) {
+        snprintf(jitter_text, sizeof(jitter_text), "%.1f ms", server->jitter_ms);
+    } else {
+        snprintf(jitter_text, sizeof(jitter_text), "--");
+    }
+
+    /* Unmeasured and unreachable servers sort after every measured one */
+    int latency_key = server->latency_ms >= 0 ? server->latency_ms : G_MAXINT;
+    double loss_key = measured ? server->loss_percent : G_MAXDOUBLE;
+    double jitter_key = measured && server->latency_ms >= 0 ? server->jitter_ms : G_MAXDOUBLE;
+    gint64 dns_key = server->dns_ms >= 0 ? server->dns_ms : G_MAXINT64;
+
+    char dns_text[16];
+    if (server->dns_ms < 0) {
+        snprintf(dns_text, sizeof(dns_text), "--");
+    } else {
+        snprintf(dns_text, sizeof(dns_text), "%d ms", server->dns_ms);
+    }
+
+    /* Show the fastest remote once measured, otherwise the first */
+    const char *host = server->config->server_hostname;
+    const char *protocol = server->config->protocol;
+    int port = server->config->server_port;
+    if (server->best_remote >= 0) {
+        const VpnRemote *best = &server->config->remotes[server->best_remote];
+        host = best->host;
+        port = best->port;
+        protocol = best->protocol;
+    }
+
+    char server_text[256];
+    if (server->config->pinned_host) {
+        snprintf(server_text, sizeof(server_text), "%s (pinned)",
+                 server->config->pinned_host);
+    } else if (server->config->remote_count > 1) {
+        snprintf(server_text, sizeof(server_text), "%s (+%u)",
+                 host, server->config->remote_count - 1);
+    } else {
+        snprintf(server_text, sizeof(server_text), "%s", host ? host : "--");
+    }
+
     gtk_list_store_set(tab->list_store, iter,
                       COL_SERVER_INFO, server,
                       COL_STATUS_ICON, status_icon,
                       COL_CONFIG_NAME, server->config->config_name ? server->config->config_name : "Unknown",
-                      COL_SERVER, server->config->server_hostname ? server->config->server_hostname : "--",
-                      COL_PORT, server->config->server_port,
-                      COL_PROTOCOL, server->config->protocol ? server->config->protocol : "--",
+                      COL_SERVER, server_text,
+                      COL_PORT, port,
+                      COL_PROTOCOL, protocol ? protocol : "--",
                       COL_LATENCY, latency_text,
+                      COL_DNS, dns_text,
+                      COL_LOSS, loss_text,
+                      COL_JITTER, jitter_text,
+                      COL_LATENCY_VALUE, latency_key,
+                      COL_LOSS_VALUE, loss_key,
+                      COL_JITTER_VALUE, jitter_key,
+                      COL_DNS_VALUE, dns_key,
                       -1);
 }
 
 /**
- * Callback data for ping updates
+ * Add a row for a server and index it
+ */
+static void append_server_row(ServersTab *tab, ServerInfo *server) {
+    GtkTreeIter iter;
+    gtk_list_store_append(tab->list_store, &iter);
+    set_server_row(tab, server, &iter);
+
+    GtkTreePath *path = gtk_tree_model_get_path(GTK_TREE_MODEL(tab->list_store), &iter);
+    g_hash_table_replace(tab->rows, server,
+                         gtk_tree_row_reference_new(GTK_TREE_MODEL(tab->list_store), path));
+    gtk_tree_path_free(path);
+}
+
+/**
+ * Refresh the row showing a server now
  */
-typedef struct {
-    ServersTab *tab;
-    ServerInfo *server;
-    int latency_ms;
-} PingCallbackData;
+static void update_server_row(ServersTab *tab, ServerInfo *server) {
+    GtkTreeRowReference *ref = g_hash_table_lookup(tab->rows, server);
+    GtkTreePath *path = ref ? gtk_tree_row_reference_get_path(ref) : NULL;
+    if (!path) {
+        return;
+    }
+
+    GtkTreeIter iter;
+    if (gtk_tree_model_get_iter(GTK_TREE_MODEL(tab->list_store), &iter, path)) {
+        set_server_row(tab, server, &iter);
+    }
+    gtk_tree_path_free(path);
+    g_hash_table_remove(tab->dirty, server);
+}
 
 /**
- * Idle callback to update GUI with ping results
+ * Apply queued row updates, once per frame
  */
-static gboolean ping_update_idle(gpointer user_data) {
-    PingCallbackData *data = (PingCallbackData *)user_data;
-    ServersTab *tab = data->tab;
-    ServerInfo *server = data->server;
-    int latency_ms = data->latency_ms;
+static gboolean on_flush_updates(gpointer data) {
+    ServersTab *tab = (ServersTab *)data;
+    GHashTableIter it;
+    gpointer key;
 
-    /* Update server info */
-    server->testing = FALSE;
-    server->latency_ms = latency_ms;
+    tab->flush_id = 0;
 
-    /* Find the server in the list and update the row */
-    GtkTreeIter iter;
-    if (gtk_tree_model_get_iter_first(GTK_TREE_MODEL(tab->list_store), &iter)) {
-        do {
-            ServerInfo *row_server = NULL;
-            gtk_tree_model_get(GTK_TREE_MODEL(tab->list_store), &iter,
-                             COL_SERVER_INFO, &row_server, -1);
-            if (row_server == server) {
-                update_server_row(tab, server, &iter);
-                break;
-            }
-        } while (gtk_tree_model_iter_next(GTK_TREE_MODEL(tab->list_store), &iter));
+    GHashTable *dirty = tab->dirty;
+    tab->dirty = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    g_hash_table_iter_init(&it, dirty);
+    while (g_hash_table_iter_next(&it, &key, NULL)) {
+        update_server_row(tab, (ServerInfo *)key);
     }
+    g_hash_table_destroy(dirty);
 
-    /* Decrement ping counter */
-    if (tab->ping_in_progress > 0) {
-        tab->ping_in_progress--;
+    /* The fastest remote may have changed for the selected row */
+    GtkTreeSelection *selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(tab->tree_view));
+    on_selection_changed(selection, tab);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Queue a row update; results arriving within one frame are applied
+ * together just before it is drawn
+ */
+static void queue_server_update(ServersTab *tab, ServerInfo *server) {
+    g_hash_table_add(tab->dirty, server);
+
+    if (!tab->flush_id) {
+        tab->flush_id = g_idle_add_full(GDK_PRIORITY_REDRAW - 10, on_flush_updates, tab, NULL);
     }
+}
 
-    g_free(data);
-    return FALSE;  /* Don't call again */
+/**
+ * Probe target ID for one remote of a server: "<config path>#<index>"
+ */
+static char* remote_target_id(ServerInfo *server, unsigned int index) {
+    return g_strdup_printf("%s#%u", server->config->config_path, index);
 }
 
 /**
- * Ping callback - called when ping completes
+ * Pick the fastest measured remote and mirror it into the server's summary
  */
-static void ping_callback(const char *hostname, int latency_ms, void *user_data) {
-    PingCallbackData *data = (PingCallbackData *)user_data;
+static void update_best_remote(ServerInfo *server, unsigned int last_index) {
+    server->best_remote = -1;
+
+    for (unsigned int i = 0; i < server->config->remote_count; i++) {
+        int latency = server->remote_status[i].latency_ms;
+        if (latency >= 0 &&
+            (server->best_remote < 0 ||
+             latency < server->remote_status[server->best_remote].latency_ms)) {
+            server->best_remote = (int)i;
+        }
+    }
 
-    /* Update latency result */
-    data->latency_ms = latency_ms;
+    /* Nothing reachable: report the latest failure */
+    unsigned int shown = server->best_remote >= 0 ? (unsigned int)server->best_remote : last_index;
+    server->latency_ms = server->remote_status[shown].latency_ms;
+    server->loss_percent = server->remote_status[shown].loss_percent;
+    server->jitter_ms = server->remote_status[shown].jitter_ms;
 
-    /* Schedule GUI update on main thread */
-    g_idle_add(ping_update_idle, data);
+    gint64 dns_us = dns_cache_get_resolve_time_us(server->config->remotes[shown].host);
+    server->dns_ms = dns_us >= 0 ? (int)((dns_us + 500) / 1000) : -1;
 }
 
 /**
- * Test latency for a specific server
+ * Probe result from the scheduler
  */
-static void test_server_latency(ServersTab *tab, ServerInfo *server) {
-    if (!server->config->server_hostname) {
+static void on_probe_result(const char *target_id, int latency_ms,
+                            const BurstStats *stats,
+                            const ProbeHistory *history, void *user_data) {
+    ServersTab *tab = (ServersTab *)user_data;
+    (void)history;
+
+    const char *sep = strrchr(target_id, '#');
+    if (!sep) return;
+    unsigned int index = (unsigned int)strtoul(sep + 1, NULL, 10);
+
+    char *config_path = g_strndup(target_id, (gsize)(sep - target_id));
+    ServerInfo *server = g_hash_table_lookup(tab->by_path, config_path);
+    g_free(config_path);
+
+    if (!server || index >= server->config->remote_count) {
         return;
     }
 
-    server->testing = TRUE;
-    server->latency_ms = -1;
+    server->testing = FALSE;
+    server->remote_status[index].latency_ms = latency_ms;
+    server->remote_status[index].loss_percent = stats->loss_percent;
+    server->remote_status[index].jitter_ms = stats->jitter_ms;
+    server->remote_status[index].reordered = stats->reordered;
+    update_best_remote(server, index);
 
-    /* Update UI to show "Testing..." */
-    GtkTreeIter iter;
-    if (gtk_tree_model_get_iter_first(GTK_TREE_MODEL(tab->list_store), &iter)) {
-        do {
-            ServerInfo *row_server = NULL;
-            gtk_tree_model_get(GTK_TREE_MODEL(tab->list_store), &iter,
-                             COL_SERVER_INFO, &row_server, -1);
-            if (row_server == server) {
-                update_server_row(tab, server, &iter);
-                break;
-            }
-        } while (gtk_tree_model_iter_next(GTK_TREE_MODEL(tab->list_store), &iter));
+    queue_server_update(tab, server);
+}
+
+/**
+ * Register each of a server's remotes with the probe scheduler
+ */
+static void schedule_server_probe(ServersTab *tab, ServerInfo *server) {
+    if (!server->config->config_path || server->config->remote_count == 0) {
+        return;
+    }
+
+    if (!server->remote_status) {
+        server->remote_status = g_new(RemoteStatus, server->config->remote_count);
+        for (unsigned int i = 0; i < server->config->remote_count; i++) {
+            server->remote_status[i].latency_ms = -1;
+            server->remote_status[i].loss_percent = 0.0;
+            server->remote_status[i].jitter_ms = 0.0;
+            server->remote_status[i].reordered = 0;
+        }
     }
 
-    /* Create callback data */
-    PingCallbackData *callback_data = g_malloc0(sizeof(PingCallbackData));
-    callback_data->tab = tab;
-    callback_data->server = server;
-    callback_data->latency_ms = -1;  /* Will be updated by callback */
+    if (server->latency_ms < 0) {
+        server->testing = TRUE;
+    }
 
-    /* Start async ping */
-    tab->ping_in_progress++;
-    ping_host_async(server->config->server_hostname, 2000, ping_callback, callback_data);
+    for (unsigned int i = 0; i < server->config->remote_count; i++) {
+        const VpnRemote *remote = &server->config->remotes[i];
+        char *id = remote_target_id(server, i);
+        probe_scheduler_add_target(tab->probes, id, remote->host, remote->port, remote->protocol);
+        g_free(id);
+    }
 }
 
 /**
- * Test latency for all servers (rate-limited)
+ * Set probe priority for all remotes of a server
  */
-static void test_all_servers_latency(ServersTab *tab) {
-    /* Rate limiting: max 5 concurrent pings */
-    const int max_concurrent = 5;
-    int started = 0;
+static void set_server_priority(ServersTab *tab, ServerInfo *server) {
+    if (!server || !server->config->config_path) {
+        return;
+    }
 
-    for (guint i = 0; i < tab->servers->len && started < max_concurrent; i++) {
-        ServerInfo *server = g_ptr_array_index(tab->servers, i);
-        if (server->config->server_hostname) {
-            test_server_latency(tab, server);
-            started++;
+    for (unsigned int i = 0; i < server->config->remote_count; i++) {
+        char *id = remote_target_id(server, i);
+        probe_scheduler_set_priority(tab->probes, id, true);
+        g_free(id);
+    }
+}
+
+/**
+ * Give visible and selected rows priority in the probe queue
+ */
+static void update_probe_priorities(ServersTab *tab) {
+    GtkTreeModel *model = tab->sort;
+    GtkTreePath *start = NULL;
+    GtkTreePath *end = NULL;
+    GtkTreeIter iter;
+    ServerInfo *server = NULL;
+
+    probe_scheduler_clear_priorities(tab->probes);
+
+    if (gtk_tree_view_get_visible_range(GTK_TREE_VIEW(tab->tree_view), &start, &end)) {
+        if (gtk_tree_model_get_iter(model, &iter, start)) {
+            GtkTreePath *path = gtk_tree_path_copy(start);
+            do {
+                gtk_tree_model_get(model, &iter, COL_SERVER_INFO, &server, -1);
+                set_server_priority(tab, server);
+                if (gtk_tree_path_compare(path, end) >= 0) {
+                    break;
+                }
+                gtk_tree_path_next(path);
+            } while (gtk_tree_model_iter_next(model, &iter));
+            gtk_tree_path_free(path);
         }
+        gtk_tree_path_free(start);
+        gtk_tree_path_free(end);
     }
+
+    GtkTreeSelection *selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(tab->tree_view));
+    tab->prioritized = NULL;
+    if (gtk_tree_selection_get_selected(selection, NULL, &iter)) {
+        gtk_tree_model_get(model, &iter, COL_SERVER_INFO, &server, -1);
+        set_server_priority(tab, server);
+        tab->prioritized = server;
+    }
+}
+
+/**
+ * Tree view scrolled - reprioritize the rows now in view
+ */
+static void on_scroll_changed(GtkAdjustment *adjustment, gpointer data) {
+    (void)adjustment;
+    update_probe_priorities((ServersTab *)data);
 }
 
 /**
@@ -413,11 +717,20 @@ static void on_selection_changed(GtkTreeSelection *selection, gpointer data) {
         if (server) {
             /* Enable/disable buttons based on server state */
             gtk_widget_set_sensitive(tab->connect_button, !server->connected);
+            gtk_widget_set_sensitive(tab->connect_fastest_button,
+                                     !server->connected && server->best_remote >= 0 &&
+                                     server->config->remote_count > 1);
             gtk_widget_set_sensitive(tab->disconnect_button, server->connected);
         }
+
+        /* Also called after every row flush; only a new selection reorders the queue */
+        if (server != tab->prioritized) {
+            update_probe_priorities(tab);
+        }
     } else {
         /* No selection */
         gtk_widget_set_sensitive(tab->connect_button, FALSE);
+        gtk_widget_set_sensitive(tab->connect_fastest_button, FALSE);
         gtk_widget_set_sensitive(tab->disconnect_button, FALSE);
     }
 }
@@ -427,14 +740,17 @@ static void on_selection_changed(GtkTreeSelection *selection, gpointer data) {
  */
 static void on_refresh_latency_clicked(GtkButton *button, gpointer data) {
     ServersTab *tab = (ServersTab *)data;
-    test_all_servers_latency(tab);
+    probe_scheduler_probe_all_now(tab->probes);
 }
 
 /**
- * Connect button clicked
+ * Start a session for the selected server
+ *
+ * With fastest set, the config is first pinned to the lowest-latency
+ * remote; otherwise any pin on the config is removed so the profile's
+ * own remote order applies again.
  */
-static void on_connect_clicked(GtkButton *button, gpointer data) {
-    ServersTab *tab = (ServersTab *)data;
+static void connect_selected_server(ServersTab *tab, gboolean fastest) {
     GtkTreeSelection *selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(tab->tree_view));
     GtkTreeIter iter;
     GtkTreeModel *model;
@@ -444,9 +760,22 @@ static void on_connect_clicked(GtkButton *button, gpointer data) {
         gtk_tree_model_get(model, &iter, COL_SERVER_INFO, &server, -1);
 
         if (server && server->config->config_path) {
+            if (fastest && server->best_remote >= 0) {
+                const VpnRemote *best = &server->config->remotes[server->best_remote];
+                if (config_pin_remote(tab->bus, server->config->config_path, best) >= 0) {
+                    g_free(server->config->pinned_host);
+                    server->config->pinned_host = g_strdup(best->host);
+                }
+            } else if (config_clear_pin(tab->bus, server->config->config_path) >= 0) {
+                g_free(server->config->pinned_host);
+                server->config->pinned_host = NULL;
+            }
+
             logger_info("Connecting to server: %s (%s)",
                    server->config->config_name,
-                   server->config->server_address);
+                   server->config->pinned_host ?
+                       server->config->pinned_host :
+                       server->config->server_address);
 
             char *session_path = NULL;
             int r = session_start(tab->bus, server->config->config_path, &session_path);
@@ -458,13 +787,27 @@ static void on_connect_clicked(GtkButton *button, gpointer data) {
 
                 /* Update status */
                 server->connected = TRUE;
-                update_server_row(tab, server, &iter);
+                update_server_row(tab, server);
                 on_selection_changed(selection, tab);
             }
         }
     }
 }
 
+/**
+ * Connect button clicked
+ */
+static void on_connect_clicked(GtkButton *button, gpointer data) {
+    connect_selected_server((ServersTab *)data, FALSE);
+}
+
+/**
+ * Connect to Fastest button clicked
+ */
+static void on_connect_fastest_clicked(GtkButton *button, gpointer data) {
+    connect_selected_server((ServersTab *)data, TRUE);
+}
+
 /**
  * Disconnect button clicked
  */
@@ -496,7 +839,7 @@ static void on_disconnect_clicked(GtkButton *button, gpointer data) {
                             logger_error("Failed to disconnect session");
                         } else {
                             server->connected = FALSE;
-                            update_server_row(tab, server, &iter);
+                            update_server_row(tab, server);
                             on_selection_changed(selection, tab);
                         }
                         break;
@@ -523,33 +866,104 @@ static void on_search_changed(GtkSearchEntry *entry, gpointer data) {
     ServersTab *tab = (ServersTab *)data;
     const char *search_text = gtk_entry_get_text(GTK_ENTRY(entry));
 
-    /* Simple search implementation - rebuild list with filter */
-    gtk_list_store_clear(tab->list_store);
+    g_free(tab->filter_key);
+    tab->filter_key = search_text && *search_text ? g_utf8_casefold(search_text, -1) : NULL;
 
-    for (guint i = 0; i < tab->servers->len; i++) {
-        ServerInfo *server = g_ptr_array_index(tab->servers, i);
+    gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(tab->filter));
+    update_probe_priorities(tab);
+}
 
-        /* Filter by search text */
-        if (search_text && strlen(search_text) > 0) {
-            gboolean match = FALSE;
+/**
+ * Take the current pin from a freshly listed copy of the server's config
+ *
+ * Pins are also set and cleared from the tray, dashboard and control
+ * socket. Returns TRUE if the pin changed.
+ */
+static gboolean sync_pin(ServerInfo *server, VpnConfig **configs, unsigned int count) {
+    if (!server->config->config_path) {
+        return FALSE;
+    }
 
-            if (server->config->config_name &&
-                g_strstr_len(server->config->config_name, -1, search_text)) {
-                match = TRUE;
+    for (unsigned int i = 0; i < count; i++) {
+        if (configs[i]->config_path &&
+            strcmp(configs[i]->config_path, server->config->config_path) == 0) {
+            if (g_strcmp0(configs[i]->pinned_host, server->config->pinned_host) == 0) {
+                return FALSE;
             }
-            if (server->config->server_hostname &&
-                g_strstr_len(server->config->server_hostname, -1, search_text)) {
-                match = TRUE;
+            g_free(server->config->pinned_host);
+            server->config->pinned_host = g_strdup(configs[i]->pinned_host);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Whether a config path is still in the listed configurations
+ */
+static gboolean config_listed(const char *config_path, VpnConfig **configs, unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        if (configs[i]->config_path && strcmp(configs[i]->config_path, config_path) == 0) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Whether any server other than skip has a remote on host
+ */
+static gboolean host_in_use(ServersTab *tab, ServerInfo *skip, const char *host) {
+    for (guint i = 0; i < tab->servers->len; i++) {
+        ServerInfo *server = g_ptr_array_index(tab->servers, i);
+        if (server == skip) {
+            continue;
+        }
+        for (unsigned int j = 0; j < server->config->remote_count; j++) {
+            if (g_strcmp0(server->config->remotes[j].host, host) == 0) {
+                return TRUE;
             }
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Drop a server whose configuration was removed: its probes, its row,
+ * cached lookups no other server needs, and the server itself
+ */
+static void remove_server(ServersTab *tab, ServerInfo *server) {
+    logger_info("ServersTab: Removed server '%s'",
+                server->config->config_name ? server->config->config_name : "Unknown");
 
-            if (!match) continue;
+    for (unsigned int i = 0; i < server->config->remote_count; i++) {
+        char *target_id = remote_target_id(server, i);
+        probe_scheduler_remove_target(tab->probes, target_id);
+        g_free(target_id);
+
+        if (!host_in_use(tab, server, server->config->remotes[i].host)) {
+            dns_cache_forget(server->config->remotes[i].host);
         }
+    }
 
-        /* Add to list */
+    GtkTreeRowReference *ref = g_hash_table_lookup(tab->rows, server);
+    GtkTreePath *path = ref ? gtk_tree_row_reference_get_path(ref) : NULL;
+    if (path) {
         GtkTreeIter iter;
-        gtk_list_store_append(tab->list_store, &iter);
-        update_server_row(tab, server, &iter);
+        if (gtk_tree_model_get_iter(GTK_TREE_MODEL(tab->list_store), &iter, path)) {
+            gtk_list_store_remove(tab->list_store, &iter);
+        }
+        gtk_tree_path_free(path);
     }
+
+    if (tab->prioritized == server) {
+        tab->prioritized = NULL;
+    }
+    g_hash_table_remove(tab->rows, server);
+    g_hash_table_remove(tab->dirty, server);
+    g_hash_table_remove(tab->by_path, server->config->config_path);
+    g_ptr_array_remove(tab->servers, server);  /* Frees the server */
 }
 
 /**
@@ -581,10 +995,21 @@ void servers_tab_refresh(ServersTab *tab, sd_bus *bus) {
     if (tab->servers->len == 0) {
         logger_info("ServersTab: Initial load (found %u configs)", config_count);
 
+        /* Resolve every remote up front; probes then hit the cache */
+        for (unsigned int i = 0; i < config_count; i++) {
+            for (unsigned int j = 0; j < configs[i]->remote_count; j++) {
+                dns_cache_prefetch(configs[i]->remotes[j].host);
+            }
+        }
+
         for (unsigned int i = 0; i < config_count; i++) {
             ServerInfo *server = g_malloc0(sizeof(ServerInfo));
             server->config = configs[i];  /* Transfer ownership */
             server->latency_ms = -1;
+            server->loss_percent = 0.0;
+            server->jitter_ms = 0.0;
+            server->dns_ms = -1;
+            server->best_remote = -1;
             server->testing = FALSE;
             server->connected = FALSE;
 
@@ -600,27 +1025,37 @@ void servers_tab_refresh(ServersTab *tab, sd_bus *bus) {
                 }
             }
 
+            server->search_key = make_search_key(server->config);
+
             g_ptr_array_add(tab->servers, server);
+            if (server->config->config_path) {
+                g_hash_table_insert(tab->by_path, server->config->config_path, server);
+            }
+            schedule_server_probe(tab, server);
 
             logger_info("ServersTab: Added server '%s' (address=%s, connected=%d)",
                    server->config->config_name ? server->config->config_name : "Unknown",
                    server->config->server_address ? server->config->server_address : "N/A",
                    server->connected);
 
-            /* Add to tree view */
-            GtkTreeIter iter;
-            gtk_list_store_append(tab->list_store, &iter);
-            update_server_row(tab, server, &iter);
+            append_server_row(tab, server);
         }
         g_free(configs);  /* Free array but not configs themselves */
-
-        /* Automatically test latency on initial load */
-        test_all_servers_latency(tab);
     } else {
-        /* Update existing servers - only update connection status */
+        /* Drop servers whose configuration was removed */
+        for (guint i = tab->servers->len; i > 0; i--) {
+            ServerInfo *server = g_ptr_array_index(tab->servers, i - 1);
+            if (server->config->config_path &&
+                !config_listed(server->config->config_path, configs, config_count)) {
+                remove_server(tab, server);
+            }
+        }
+
+        /* Update existing servers - only connection status and pin */
         for (guint i = 0; i < tab->servers->len; i++) {
             ServerInfo *server = g_ptr_array_index(tab->servers, i);
             gboolean was_connected = server->connected;
+            gboolean pin_changed = sync_pin(server, configs, config_count);
             server->connected = FALSE;
 
             /* Check if this config is connected */
@@ -635,21 +1070,9 @@ void servers_tab_refresh(ServersTab *tab, sd_bus *bus) {
                 }
             }
 
-            /* Only update GUI if connection status changed */
-            if (was_connected != server->connected) {
-                /* Find and update this row in the tree view */
-                GtkTreeIter iter;
-                if (gtk_tree_model_get_iter_first(GTK_TREE_MODEL(tab->list_store), &iter)) {
-                    do {
-                        ServerInfo *row_server = NULL;
-                        gtk_tree_model_get(GTK_TREE_MODEL(tab->list_store), &iter,
-                                         COL_SERVER_INFO, &row_server, -1);
-                        if (row_server == server) {
-                            update_server_row(tab, server, &iter);
-                            break;
-                        }
-                    } while (gtk_tree_model_iter_next(GTK_TREE_MODEL(tab->list_store), &iter));
-                }
+            /* Only update GUI if connection status or pin changed */
+            if (was_connected != server->connected || pin_changed) {
+                queue_server_update(tab, server);
             }
         }
 
@@ -677,35 +1100,27 @@ void servers_tab_update_status(ServersTab *tab, sd_bus *bus) {
     if (r < 0) return;
 
     /* Update connection status for all servers */
-    GtkTreeIter iter;
-    if (gtk_tree_model_get_iter_first(GTK_TREE_MODEL(tab->list_store), &iter)) {
-        do {
-            ServerInfo *server = NULL;
-            gtk_tree_model_get(GTK_TREE_MODEL(tab->list_store), &iter,
-                             COL_SERVER_INFO, &server, -1);
-
-            if (server) {
-                gboolean was_connected = server->connected;
-                server->connected = FALSE;
-
-                /* Check if this config is connected */
-                if (sessions && session_count > 0) {
-                    for (unsigned int j = 0; j < session_count; j++) {
-                        if (sessions[j]->config_name &&
-                            server->config->config_name &&
-                            strcmp(sessions[j]->config_name, server->config->config_name) == 0) {
-                            server->connected = TRUE;
-                            break;
-                        }
-                    }
-                }
-
-                /* Update row if status changed */
-                if (was_connected != server->connected) {
-                    update_server_row(tab, server, &iter);
+    for (guint i = 0; i < tab->servers->len; i++) {
+        ServerInfo *server = g_ptr_array_index(tab->servers, i);
+        gboolean was_connected = server->connected;
+        server->connected = FALSE;
+
+        /* Check if this config is connected */
+        if (sessions && session_count > 0) {
+            for (unsigned int j = 0; j < session_count; j++) {
+                if (sessions[j]->config_name &&
+                    server->config->config_name &&
+                    strcmp(sessions[j]->config_name, server->config->config_name) == 0) {
+                    server->connected = TRUE;
+                    break;
                 }
             }
-        } while (gtk_tree_model_iter_next(GTK_TREE_MODEL(tab->list_store), &iter));
+        }
+
+        /* Update row if status changed */
+        if (was_connected != server->connected) {
+            update_server_row(tab, server);
+        }
     }
 
     if (sessions) {
@@ -717,19 +1132,54 @@ void servers_tab_update_status(ServersTab *tab, sd_bus *bus) {
     on_selection_changed(selection, tab);
 }
 
+/**
+ * Pause or resume background probing with the tab's visibility
+ */
+void servers_tab_set_active(ServersTab *tab, gboolean active) {
+    if (!tab) return;
+
+    probe_scheduler_set_paused(tab->probes, !active);
+}
+
+/**
+ * Change how many servers are probed at once
+ */
+void servers_tab_set_probe_concurrency(ServersTab *tab, unsigned int probe_concurrency) {
+    if (!tab) return;
+
+    probe_scheduler_set_concurrency(tab->probes, probe_concurrency);
+}
+
 /**
  * Free servers tab
  */
 void servers_tab_free(ServersTab *tab) {
     if (!tab) return;
 
+    /* Stop probing before the servers it reports on go away */
+    probe_scheduler_free(tab->probes);
+
+    if (tab->flush_id) {
+        g_source_remove(tab->flush_id);
+    }
+    g_hash_table_destroy(tab->dirty);
+    g_hash_table_destroy(tab->rows);
+    g_hash_table_destroy(tab->by_path);
+
     if (tab->servers) {
         g_ptr_array_free(tab->servers, TRUE);
     }
 
+    if (tab->sort) {
+        g_object_unref(tab->sort);
+    }
+    if (tab->filter) {
+        g_object_unref(tab->filter);
+    }
     if (tab->list_store) {
         g_object_unref(tab->list_store);
     }
+    g_free(tab->filter_key);
 
     g_free(tab);
 }
@@ -11,12 +11,26 @@
  * Displays available VPN configurations with server information and latency
  */
 
+/* Probe state of one remote endpoint */
+typedef struct {
+    int latency_ms;          /* Mean burst latency in ms (-1 = not tested, negative = failed) */
+    double loss_percent;     /* Probe loss within the last burst */
+    double jitter_ms;        /* Jitter within the last burst */
+    unsigned int reordered;  /* Reordered replies within the last burst */
+} RemoteStatus;
+
 /* Server information structure */
 typedef struct {
     VpnConfig *config;       /* Configuration details */
     int latency_ms;          /* Ping latency in milliseconds (-1 = not tested) */
+    double loss_percent;     /* Probe loss within the last burst */
+    double jitter_ms;        /* Jitter within the last burst */
+    int dns_ms;              /* Last hostname resolution time (-1 = unknown) */
+    RemoteStatus *remote_status; /* One per config->remotes entry */
+    int best_remote;         /* Index of fastest remote (-1 = none measured) */
     gboolean testing;        /* Currently testing latency */
     gboolean connected;      /* Currently connected */
+    char *search_key;        /* Case-folded name and hosts, matched by the search filter */
 } ServerInfo;
 
 /* Servers tab structure */
@@ -26,9 +40,10 @@ typedef struct ServersTab ServersTab;
  * Create servers tab widget
  *
  * @param bus D-Bus connection
+ * @param probe_concurrency Latency probes run at once (minimum 1)
  * @return ServersTab instance or NULL on error
  */
-ServersTab* servers_tab_create(sd_bus *bus);
+ServersTab* servers_tab_create(sd_bus *bus, unsigned int probe_concurrency);
 
 /**
  * Get the tab widget
@@ -54,6 +69,25 @@ void servers_tab_refresh(ServersTab *tab, sd_bus *bus);
  */
 void servers_tab_update_status(ServersTab *tab, sd_bus *bus);
 
+/**
+ * Tell the tab whether it is on screen
+ *
+ * Periodic latency probing is paused while the tab is not visible and
+ * catches up when it is shown again.
+ *
+ * @param tab ServersTab instance
+ * @param active TRUE when the tab is visible
+ */
+void servers_tab_set_active(ServersTab *tab, gboolean active);
+
+/**
+ * Change how many latency probes run at once
+ *
+ * @param tab ServersTab instance
+ * @param probe_concurrency Probes in flight at once (minimum 1)
+ */
+void servers_tab_set_probe_concurrency(ServersTab *tab, unsigned int probe_concurrency);
+
 /**
  * Free servers tab
  *
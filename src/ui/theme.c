@@ -1,4 +1,5 @@
 #include "theme.h"
+#define LOG_CATEGORY LOG_CAT_UI
 #include "../utils/logger.h"
 #include <stdio.h>
 #include <string.h>
@@ -1,5 +1,6 @@
 #include "widgets.h"
 #include "icons.h"
+#define LOG_CATEGORY LOG_CAT_UI
 #include "../utils/logger.h"
 #include <string.h>
 #include <time.h>
@@ -75,7 +76,7 @@ const char* widget_get_state_text(SessionState state) {
 GtkWidget* widget_create_menu_item(const char *label,
                                     const char *icon_name,
                                     const char *css_class) {
-    if (logger_get_verbosity() >= 2) {
+    if (logger_verbose(2)) {
         logger_debug("Creating menu item: label='%s', icon='%s', css='%s'",
                label ? label : "NULL",
                icon_name ? icon_name : "NULL",
@@ -90,7 +91,7 @@ GtkWidget* widget_create_menu_item(const char *label,
         menu_item = gtk_image_menu_item_new_with_label(label);
         gtk_image_menu_item_set_image(GTK_IMAGE_MENU_ITEM(menu_item), icon);
         gtk_image_menu_item_set_always_show_image(GTK_IMAGE_MENU_ITEM(menu_item), TRUE);
-        if (logger_get_verbosity() >= 2) {
+        if (logger_verbose(2)) {
             logger_debug("  -> Created ImageMenuItem with icon '%s'", icon_name);
         }
     } else {
@@ -101,7 +102,7 @@ GtkWidget* widget_create_menu_item(const char *label,
     if (css_class) {
         GtkStyleContext *context = gtk_widget_get_style_context(menu_item);
         gtk_style_context_add_class(context, css_class);
-        if (logger_get_verbosity() >= 2) {
+        if (logger_verbose(2)) {
             logger_debug("  -> Applied CSS class '%s'", css_class);
         }
     }
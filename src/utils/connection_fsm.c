@@ -1,7 +1,10 @@
 #include "connection_fsm.h"
+#define LOG_CATEGORY LOG_CAT_FSM
 #include "logger.h"
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <glib.h>
 
 /**
  * FSM instance structure
@@ -9,8 +12,41 @@
 struct ConnectionFsm {
     char *connection_name;       /* Connection name for logging */
     ConnectionState current_state;
+    char *session_path;          /* Session bound in the registry, or NULL */
+    unsigned int last_status;    /* Last StatusChange minor code */
+    bool user_disconnect;        /* Last disconnect was DISCONNECT_REQUESTED */
+
+    /* Transition journal (ring, journal_count entries recorded in total) */
+    ConnectionFsmJournalEntry journal[FSM_JOURNAL_SIZE];
+    size_t journal_count;
+
+    /* Connection attempt in progress */
+    bool attempt_active;
+    int64_t attempt_start_us;
+    ConnectionPhase phase;
+    int64_t phase_start_us;
+    ConnectionTiming attempt;
+
+    ConnectionLatencyStats stats;
+};
+
+const int64_t connection_fsm_histogram_bounds_ms[FSM_HISTOGRAM_BUCKETS - 1] = {
+    250, 500, 1000, 2000, 3000, 5000, 10000, 20000, 60000
 };
 
+/* Registry (main thread only) */
+static GHashTable *fsm_by_name = NULL;       /* config_name -> ConnectionFsm* (owned) */
+static GHashTable *fsm_by_session = NULL;    /* session_path -> ConnectionFsm* */
+
+/* Pending write of the default metrics file */
+static guint metrics_write_id = 0;
+
+/* State change listeners */
+static struct {
+    ConnectionFsmListener func;
+    void *user_data;
+} fsm_listeners[FSM_MAX_LISTENERS];
+
 /**
  * State transition rule
  */
@@ -56,6 +92,8 @@ static const StateTransition transition_table[] = {
     {CONN_STATE_PAUSED, FSM_EVENT_DISCONNECT_REQUESTED,        CONN_STATE_DISCONNECTED},
     {CONN_STATE_PAUSED, FSM_EVENT_SESSION_ERROR,               CONN_STATE_ERROR},
     {CONN_STATE_PAUSED, FSM_EVENT_SESSION_PAUSED,              CONN_STATE_PAUSED},        /* self (poll no-op) */
+    {CONN_STATE_PAUSED, FSM_EVENT_SESSION_CONNECTING,          CONN_STATE_CONNECTING},    /* resumed, reconnecting */
+    {CONN_STATE_PAUSED, FSM_EVENT_SESSION_RECONNECTING,        CONN_STATE_RECONNECTING},  /* resumed, reconnecting */
 
     /* From AUTH_REQUIRED */
     {CONN_STATE_AUTH_REQUIRED, FSM_EVENT_SESSION_CONNECTED,    CONN_STATE_CONNECTED},
@@ -181,11 +219,26 @@ const char* connection_fsm_event_name(ConnectionFsmEvent event) {
     }
 }
 
+/**
+ * Get phase name as string
+ */
+const char* connection_fsm_phase_name(ConnectionPhase phase) {
+    switch (phase) {
+        case FSM_PHASE_START:       return "start";
+        case FSM_PHASE_RESOLVE:     return "resolve";
+        case FSM_PHASE_WAIT:        return "wait";
+        case FSM_PHASE_AUTH:        return "auth";
+        case FSM_PHASE_GET_CONFIG:  return "get_config";
+        case FSM_PHASE_ASSIGN_IP:   return "assign_ip";
+        default:                    return "unknown";
+    }
+}
+
 /**
  * Create a new FSM instance
  */
 ConnectionFsm* connection_fsm_create(const char *connection_name) {
-    ConnectionFsm *fsm = malloc(sizeof(ConnectionFsm));
+    ConnectionFsm *fsm = calloc(1, sizeof(ConnectionFsm));
     if (!fsm) {
         logger_error("Failed to allocate FSM for connection '%s'",
                      connection_name ? connection_name : "unknown");
@@ -213,6 +266,7 @@ void connection_fsm_destroy(ConnectionFsm *fsm) {
     if (fsm->connection_name) {
         free(fsm->connection_name);
     }
+    g_free(fsm->session_path);
 
     free(fsm);
 }
@@ -230,15 +284,159 @@ static const StateTransition* find_transition(ConnectionState from_state, Connec
     return NULL;
 }
 
+/* ──────────────────────────────────────────────────────────────
+ * Connection attempt timing
+ * ────────────────────────────────────────────────────────────── */
+
+static unsigned int histogram_bucket(int64_t us) {
+    int64_t ms = us / 1000;
+    for (unsigned int i = 0; i < FSM_HISTOGRAM_BUCKETS - 1; i++) {
+        if (ms <= connection_fsm_histogram_bounds_ms[i]) {
+            return i;
+        }
+    }
+    return FSM_HISTOGRAM_BUCKETS - 1;
+}
+
 /**
- * Process an event and transition to new state
+ * Timer: write the metrics of the connects since it was scheduled
  */
-ConnectionState connection_fsm_process_event(ConnectionFsm *fsm, ConnectionFsmEvent event) {
-    if (!fsm) {
-        logger_error("NULL FSM in process_event");
-        return CONN_STATE_DISCONNECTED;
+static gboolean on_metrics_write(gpointer user_data) {
+    (void)user_data;
+
+    metrics_write_id = 0;
+    connection_fsm_write_metrics_file(NULL);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Write the default metrics file shortly, once for a burst of connects
+ */
+static void schedule_metrics_write(void) {
+    if (metrics_write_id == 0) {
+        metrics_write_id = g_timeout_add_seconds(FSM_METRICS_WRITE_DELAY_SEC,
+                                                 on_metrics_write, NULL);
+    }
+}
+
+static void attempt_begin(ConnectionFsm *fsm, int64_t now) {
+    memset(&fsm->attempt, 0, sizeof(fsm->attempt));
+    fsm->attempt_active = true;
+    fsm->attempt_start_us = now;
+    fsm->phase = FSM_PHASE_START;
+    fsm->phase_start_us = now;
+}
+
+static void attempt_set_phase(ConnectionFsm *fsm, ConnectionPhase phase, int64_t now) {
+    if (!fsm->attempt_active || phase == fsm->phase) {
+        return;
     }
 
+    fsm->attempt.phase_us[fsm->phase] += now - fsm->phase_start_us;
+    if (phase == FSM_PHASE_AUTH && fsm->attempt.to_auth_us == 0) {
+        fsm->attempt.to_auth_us = MAX(now - fsm->attempt_start_us, 1);
+    }
+    fsm->phase = phase;
+    fsm->phase_start_us = now;
+}
+
+static void attempt_finish(ConnectionFsm *fsm, int64_t now) {
+    ConnectionTiming *t = &fsm->attempt;
+    ConnectionLatencyStats *st = &fsm->stats;
+
+    t->phase_us[fsm->phase] += now - fsm->phase_start_us;
+    t->total_us = now - fsm->attempt_start_us;
+    fsm->attempt_active = false;
+
+    st->connects++;
+    st->connected_hist[histogram_bucket(t->total_us)]++;
+    st->connected_sum_us += t->total_us;
+    if (t->to_auth_us > 0) {
+        st->auth_hist[histogram_bucket(t->to_auth_us)]++;
+        st->auth_sum_us += t->to_auth_us;
+    }
+    st->last = *t;
+    st->has_last = true;
+
+    logger_log_fields(LOG_LEVEL_INFO,
+                      LOG_FIELDS(.config_name = fsm->connection_name,
+                                 .session_path = fsm->session_path,
+                                 .fsm_state = "CONNECTED",
+                                 .latency_us = t->total_us),
+                      "FSM '%s': connected in %.2f s (start %.2f, resolve %.2f, wait %.2f, "
+                      "auth %.2f, config %.2f, ip %.2f)",
+                      fsm->connection_name ? fsm->connection_name : "unknown",
+                      t->total_us / 1e6,
+                      t->phase_us[FSM_PHASE_START] / 1e6,
+                      t->phase_us[FSM_PHASE_RESOLVE] / 1e6,
+                      t->phase_us[FSM_PHASE_WAIT] / 1e6,
+                      t->phase_us[FSM_PHASE_AUTH] / 1e6,
+                      t->phase_us[FSM_PHASE_GET_CONFIG] / 1e6,
+                      t->phase_us[FSM_PHASE_ASSIGN_IP] / 1e6);
+
+    schedule_metrics_write();
+}
+
+/**
+ * Advance or end the attempt on a state change
+ *
+ * Attempts only begin on a connect request (see process_event_at), so
+ * resuming a paused session or the service reconnecting on its own is
+ * not timed as a connect.
+ */
+static void attempt_track(ConnectionFsm *fsm, ConnectionState old_state, int64_t now) {
+    if (old_state == fsm->current_state) {
+        return;
+    }
+
+    switch (fsm->current_state) {
+        case CONN_STATE_CONNECTING:
+        case CONN_STATE_RECONNECTING:
+            break;
+        case CONN_STATE_AUTH_REQUIRED:
+            attempt_set_phase(fsm, FSM_PHASE_AUTH, now);
+            break;
+        case CONN_STATE_CONNECTED:
+            if (fsm->attempt_active) {
+                attempt_finish(fsm, now);
+            }
+            break;
+        default:
+            /* DISCONNECTED, ERROR, PAUSED: the attempt did not make it */
+            if (fsm->attempt_active) {
+                fsm->attempt_active = false;
+                fsm->stats.failures++;
+            }
+            break;
+    }
+}
+
+static void journal_record(ConnectionFsm *fsm, int64_t now, ConnectionFsmEvent event,
+                           ConnectionState from, ConnectionState to, bool valid) {
+    ConnectionFsmJournalEntry *e = &fsm->journal[fsm->journal_count % FSM_JOURNAL_SIZE];
+    e->time_us = now;
+    e->event = event;
+    e->from_state = from;
+    e->to_state = to;
+    e->valid = valid;
+    fsm->journal_count++;
+}
+
+/**
+ * Tell every listener about a state change
+ */
+static void notify_listeners(ConnectionFsm *fsm, ConnectionState old_state) {
+    for (int i = 0; i < FSM_MAX_LISTENERS; i++) {
+        if (fsm_listeners[i].func) {
+            fsm_listeners[i].func(fsm, old_state, fsm_listeners[i].user_data);
+        }
+    }
+}
+
+/**
+ * Process an event that happened at a given monotonic time
+ */
+static ConnectionState process_event_at(ConnectionFsm *fsm, ConnectionFsmEvent event, int64_t now) {
     ConnectionState old_state = fsm->current_state;
     const StateTransition *transition = find_transition(old_state, event);
 
@@ -247,7 +445,10 @@ ConnectionState connection_fsm_process_event(ConnectionFsm *fsm, ConnectionFsmEv
         fsm->current_state = transition->to_state;
 
         if (old_state != fsm->current_state) {
-            logger_info("FSM '%s': %s + %s -> %s",
+            logger_log_fields(LOG_LEVEL_INFO,
+                       LOG_FIELDS(.config_name = fsm->connection_name,
+                                  .fsm_state = connection_fsm_state_name(fsm->current_state)),
+                       "FSM '%s': %s + %s -> %s",
                        fsm->connection_name ? fsm->connection_name : "unknown",
                        connection_fsm_state_name(old_state),
                        connection_fsm_event_name(event),
@@ -261,15 +462,46 @@ ConnectionState connection_fsm_process_event(ConnectionFsm *fsm, ConnectionFsmEv
         }
     } else {
         /* Invalid transition - log warning and stay in current state */
-        logger_warn("FSM '%s': Invalid transition from %s with event %s (ignored)",
+        logger_log_fields(LOG_LEVEL_WARN,
+                   LOG_FIELDS(.config_name = fsm->connection_name,
+                              .fsm_state = connection_fsm_state_name(old_state)),
+                   "FSM '%s': Invalid transition from %s with event %s (ignored)",
                    fsm->connection_name ? fsm->connection_name : "unknown",
                    connection_fsm_state_name(old_state),
                    connection_fsm_event_name(event));
     }
 
+    if (transition && event == FSM_EVENT_DISCONNECT_REQUESTED) {
+        fsm->user_disconnect = true;
+    } else if (transition && event == FSM_EVENT_CONNECT_REQUESTED) {
+        fsm->user_disconnect = false;
+        if (old_state == CONN_STATE_DISCONNECTED || old_state == CONN_STATE_ERROR) {
+            attempt_begin(fsm, now);
+        }
+    }
+
+    journal_record(fsm, now, event, old_state, fsm->current_state, transition != NULL);
+    attempt_track(fsm, old_state, now);
+
+    if (old_state != fsm->current_state) {
+        notify_listeners(fsm, old_state);
+    }
+
     return fsm->current_state;
 }
 
+/**
+ * Process an event and transition to new state
+ */
+ConnectionState connection_fsm_process_event(ConnectionFsm *fsm, ConnectionFsmEvent event) {
+    if (!fsm) {
+        logger_error("NULL FSM in process_event");
+        return CONN_STATE_DISCONNECTED;
+    }
+
+    return process_event_at(fsm, event, g_get_monotonic_time());
+}
+
 /**
  * Force FSM to a specific state (bypassing transition rules)
  */
@@ -282,10 +514,19 @@ void connection_fsm_force_state(ConnectionFsm *fsm, ConnectionState state) {
     ConnectionState old_state = fsm->current_state;
     fsm->current_state = state;
 
-    logger_warn("FSM '%s': Force-syncing state %s -> %s (D-Bus reality override)",
+    logger_log_fields(LOG_LEVEL_WARN,
+                LOG_FIELDS(.config_name = fsm->connection_name,
+                           .fsm_state = connection_fsm_state_name(state)),
+                "FSM '%s': Force-syncing state %s -> %s (D-Bus reality override)",
                 fsm->connection_name ? fsm->connection_name : "unknown",
                 connection_fsm_state_name(old_state),
                 connection_fsm_state_name(state));
+
+    attempt_track(fsm, old_state, g_get_monotonic_time());
+
+    if (old_state != state) {
+        notify_listeners(fsm, old_state);
+    }
 }
 
 /**
@@ -299,6 +540,34 @@ ConnectionState connection_fsm_get_state(const ConnectionFsm *fsm) {
     return fsm->current_state;
 }
 
+/**
+ * Get the connection name
+ */
+const char* connection_fsm_get_name(const ConnectionFsm *fsm) {
+    return fsm ? fsm->connection_name : NULL;
+}
+
+/**
+ * Get the bound session
+ */
+const char* connection_fsm_get_session(const ConnectionFsm *fsm) {
+    return fsm ? fsm->session_path : NULL;
+}
+
+/**
+ * Get the last StatusChange minor code
+ */
+unsigned int connection_fsm_get_last_status(const ConnectionFsm *fsm) {
+    return fsm ? fsm->last_status : 0;
+}
+
+/**
+ * Check whether the last disconnect was user-requested
+ */
+bool connection_fsm_user_disconnected(const ConnectionFsm *fsm) {
+    return fsm && fsm->user_disconnect;
+}
+
 /**
  * Get button states for current state
  */
@@ -330,3 +599,449 @@ ConnectionButtonStates connection_fsm_get_button_states(const ConnectionFsm *fsm
 
     return default_states;
 }
+
+/**
+ * Get the transition journal, oldest first
+ */
+size_t connection_fsm_get_journal(const ConnectionFsm *fsm,
+                                  ConnectionFsmJournalEntry *entries, size_t max) {
+    if (!fsm || !entries) {
+        return 0;
+    }
+
+    size_t count = MIN(fsm->journal_count, (size_t)FSM_JOURNAL_SIZE);
+    size_t first = fsm->journal_count - count;
+    if (count > max) {
+        first += count - max;
+        count = max;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        entries[i] = fsm->journal[(first + i) % FSM_JOURNAL_SIZE];
+    }
+    return count;
+}
+
+/**
+ * Get latency statistics
+ */
+const ConnectionLatencyStats* connection_fsm_get_stats(const ConnectionFsm *fsm) {
+    return fsm ? &fsm->stats : NULL;
+}
+
+/**
+ * Estimate a quantile from a histogram
+ */
+int64_t connection_fsm_histogram_quantile(const unsigned int *hist, double q) {
+    unsigned int total = 0;
+    for (unsigned int i = 0; i < FSM_HISTOGRAM_BUCKETS; i++) {
+        total += hist[i];
+    }
+    if (total == 0) {
+        return -1;
+    }
+
+    unsigned int target = (unsigned int)(q * total + 0.999999);
+    if (target == 0) target = 1;
+
+    unsigned int cumulative = 0;
+    for (unsigned int i = 0; i < FSM_HISTOGRAM_BUCKETS - 1; i++) {
+        cumulative += hist[i];
+        if (cumulative >= target) {
+            return connection_fsm_histogram_bounds_ms[i];
+        }
+    }
+    return connection_fsm_histogram_bounds_ms[FSM_HISTOGRAM_BUCKETS - 2];
+}
+
+/* ──────────────────────────────────────────────────────────────
+ * Registry
+ * ────────────────────────────────────────────────────────────── */
+
+static void registry_free_fsm(gpointer data) {
+    connection_fsm_destroy((ConnectionFsm *)data);
+}
+
+/**
+ * Get the FSM of a config, creating it on first use
+ */
+ConnectionFsm* connection_fsm_get(const char *config_name) {
+    if (!config_name) {
+        return NULL;
+    }
+
+    if (!fsm_by_name) {
+        fsm_by_name = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, registry_free_fsm);
+        fsm_by_session = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+
+    ConnectionFsm *fsm = g_hash_table_lookup(fsm_by_name, config_name);
+    if (!fsm) {
+        fsm = connection_fsm_create(config_name);
+        if (fsm) {
+            g_hash_table_insert(fsm_by_name, g_strdup(config_name), fsm);
+        }
+    }
+    return fsm;
+}
+
+/**
+ * Get the FSM of a config if one exists
+ */
+ConnectionFsm* connection_fsm_lookup(const char *config_name) {
+    if (!fsm_by_name || !config_name) {
+        return NULL;
+    }
+    return g_hash_table_lookup(fsm_by_name, config_name);
+}
+
+/**
+ * Find the FSM a session belongs to
+ */
+ConnectionFsm* connection_fsm_find_session(const char *session_path) {
+    if (!fsm_by_session || !session_path) {
+        return NULL;
+    }
+    return g_hash_table_lookup(fsm_by_session, session_path);
+}
+
+/**
+ * Associate a session with an FSM
+ */
+void connection_fsm_bind_session(ConnectionFsm *fsm, const char *session_path) {
+    if (!fsm || !fsm_by_session || g_strcmp0(fsm->session_path, session_path) == 0) {
+        return;
+    }
+
+    if (fsm->session_path) {
+        g_hash_table_remove(fsm_by_session, fsm->session_path);
+        g_free(fsm->session_path);
+    }
+    fsm->session_path = g_strdup(session_path);
+    if (session_path) {
+        g_hash_table_insert(fsm_by_session, g_strdup(session_path), fsm);
+    }
+}
+
+/**
+ * Record a connect request
+ */
+void connection_fsm_connect_requested(ConnectionFsm *fsm, const char *session_path,
+                                      int64_t started_us) {
+    if (!fsm) {
+        return;
+    }
+
+    connection_fsm_bind_session(fsm, session_path);
+    fsm->last_status = 0;
+
+    process_event_at(fsm, FSM_EVENT_CONNECT_REQUESTED, started_us);
+    if (!fsm->attempt_active) {
+        /* Stale state (e.g. the old session's end was not seen yet) */
+        connection_fsm_force_state(fsm, CONN_STATE_CONNECTING);
+        attempt_begin(fsm, started_us);
+    }
+}
+
+/**
+ * Phase implied by a status change, or -1
+ *
+ * openvpn3 StatusMinor: 4 CFG_REQUIRE_USER, 20 SESS_AUTH_USERPASS,
+ * 21 SESS_AUTH_CHALLENGE, 22 SESS_AUTH_URL. While connecting, the
+ * message carries the core client event (RESOLVE, WAIT, AUTH_PENDING,
+ * GET_CONFIG, ASSIGN_IP, ADD_ROUTES ...).
+ */
+static int phase_for_status(unsigned int minor, const char *message) {
+    if (minor == 4 || minor == 20 || minor == 21 || minor == 22) {
+        return FSM_PHASE_AUTH;
+    }
+    if (!message) {
+        return -1;
+    }
+
+    char *lower = g_ascii_strdown(message, -1);
+    int phase = -1;
+    if (strstr(lower, "resolv")) {
+        phase = FSM_PHASE_RESOLVE;
+    } else if (strstr(lower, "wait")) {
+        phase = FSM_PHASE_WAIT;
+    } else if (strstr(lower, "auth")) {
+        phase = FSM_PHASE_AUTH;
+    } else if (strstr(lower, "get_config") || strstr(lower, "get config")) {
+        phase = FSM_PHASE_GET_CONFIG;
+    } else if (strstr(lower, "assign_ip") || strstr(lower, "assign ip") ||
+               strstr(lower, "add_routes")) {
+        phase = FSM_PHASE_ASSIGN_IP;
+    }
+    g_free(lower);
+    return phase;
+}
+
+/**
+ * Event implied by a status minor code, or -1
+ */
+static int event_for_status(unsigned int minor) {
+    switch (minor) {
+        case 5:  /* CONN_INIT */
+        case 6:  /* CONN_CONNECTING */
+            return FSM_EVENT_SESSION_CONNECTING;
+        case 7:  /* CONN_CONNECTED */
+            return FSM_EVENT_SESSION_CONNECTED;
+        case 4: case 20: case 21: case 22:
+            return FSM_EVENT_SESSION_AUTH_REQUIRED;
+        case 1:  /* CFG_ERROR */
+        case 10: /* CONN_FAILED */
+        case 11: /* CONN_AUTH_FAILED */
+            return FSM_EVENT_SESSION_ERROR;
+        case 12: /* CONN_RECONNECTING */
+            return FSM_EVENT_SESSION_RECONNECTING;
+        case 14: /* CONN_PAUSED */
+            return FSM_EVENT_SESSION_PAUSED;
+        case 9:  /* CONN_DISCONNECTED */
+        case 16: /* CONN_DONE */
+        case 19: /* SESS_REMOVED */
+            return FSM_EVENT_SESSION_DISCONNECTED;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * Feed a session status change
+ */
+void connection_fsm_note_status(ConnectionFsm *fsm, unsigned int major,
+                                unsigned int minor, const char *message) {
+    (void)major;
+    if (!fsm) {
+        return;
+    }
+
+    int64_t now = g_get_monotonic_time();
+    fsm->last_status = minor;
+
+    int phase = phase_for_status(minor, message);
+    if (phase >= 0) {
+        attempt_set_phase(fsm, (ConnectionPhase)phase, now);
+    }
+
+    int event = event_for_status(minor);
+    if (event >= 0) {
+        process_event_at(fsm, (ConnectionFsmEvent)event, now);
+    }
+}
+
+/**
+ * Feed a state observed by polling
+ */
+void connection_fsm_observe(ConnectionFsm *fsm, ConnectionState state) {
+    static const ConnectionFsmEvent state_events[] = {
+        [CONN_STATE_DISCONNECTED]  = FSM_EVENT_SESSION_DISCONNECTED,
+        [CONN_STATE_CONNECTING]    = FSM_EVENT_SESSION_CONNECTING,
+        [CONN_STATE_CONNECTED]     = FSM_EVENT_SESSION_CONNECTED,
+        [CONN_STATE_PAUSED]        = FSM_EVENT_SESSION_PAUSED,
+        [CONN_STATE_AUTH_REQUIRED] = FSM_EVENT_SESSION_AUTH_REQUIRED,
+        [CONN_STATE_ERROR]         = FSM_EVENT_SESSION_ERROR,
+        [CONN_STATE_RECONNECTING]  = FSM_EVENT_SESSION_RECONNECTING,
+    };
+
+    /* Unchanged polls are not journaled */
+    if (!fsm || fsm->current_state == state || (unsigned int)state >= G_N_ELEMENTS(state_events)) {
+        return;
+    }
+
+    if (process_event_at(fsm, state_events[state], g_get_monotonic_time()) != state) {
+        connection_fsm_force_state(fsm, state);
+    }
+}
+
+/**
+ * Call a function for every FSM in the registry
+ */
+void connection_fsm_foreach(ConnectionFsmFunc func, void *user_data) {
+    if (!fsm_by_name || !func) {
+        return;
+    }
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, fsm_by_name);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        func((ConnectionFsm *)value, user_data);
+    }
+}
+
+/**
+ * Add a state change listener
+ */
+int connection_fsm_add_listener(ConnectionFsmListener listener, void *user_data) {
+    if (!listener) {
+        return -EINVAL;
+    }
+
+    for (int i = 0; i < FSM_MAX_LISTENERS; i++) {
+        if (!fsm_listeners[i].func) {
+            fsm_listeners[i].func = listener;
+            fsm_listeners[i].user_data = user_data;
+            return 0;
+        }
+    }
+    return -ENOSPC;
+}
+
+/**
+ * Remove a state change listener
+ */
+void connection_fsm_remove_listener(ConnectionFsmListener listener, void *user_data) {
+    for (int i = 0; i < FSM_MAX_LISTENERS; i++) {
+        if (fsm_listeners[i].func == listener && fsm_listeners[i].user_data == user_data) {
+            fsm_listeners[i].func = NULL;
+            fsm_listeners[i].user_data = NULL;
+        }
+    }
+}
+
+/**
+ * Append a label value with Prometheus escaping
+ */
+static void append_label(GString *out, const char *value) {
+    for (const char *p = value; *p; p++) {
+        if (*p == '\\' || *p == '"') {
+            g_string_append_c(out, '\\');
+            g_string_append_c(out, *p);
+        } else if (*p == '\n') {
+            g_string_append(out, "\\n");
+        } else {
+            g_string_append_c(out, *p);
+        }
+    }
+}
+
+static void append_histogram(GString *out, const char *metric, const char *config,
+                             const unsigned int *hist, int64_t sum_us) {
+    unsigned int cumulative = 0;
+
+    for (unsigned int i = 0; i < FSM_HISTOGRAM_BUCKETS; i++) {
+        cumulative += hist[i];
+        g_string_append_printf(out, "%s_bucket{config=\"", metric);
+        append_label(out, config);
+        if (i < FSM_HISTOGRAM_BUCKETS - 1) {
+            g_string_append_printf(out, "\",le=\"%g\"} %u\n",
+                                   connection_fsm_histogram_bounds_ms[i] / 1000.0, cumulative);
+        } else {
+            g_string_append_printf(out, "\",le=\"+Inf\"} %u\n", cumulative);
+        }
+    }
+    g_string_append_printf(out, "%s_sum{config=\"", metric);
+    append_label(out, config);
+    g_string_append_printf(out, "\"} %.6f\n", sum_us / 1e6);
+    g_string_append_printf(out, "%s_count{config=\"", metric);
+    append_label(out, config);
+    g_string_append_printf(out, "\"} %u\n", cumulative);
+}
+
+/**
+ * Format latency metrics of all configs
+ */
+char* connection_fsm_export_metrics(void) {
+    GString *out = g_string_new(NULL);
+    if (!fsm_by_name) {
+        return g_string_free(out, FALSE);
+    }
+
+    GList *names = g_list_sort(g_hash_table_get_keys(fsm_by_name), (GCompareFunc)g_strcmp0);
+
+    g_string_append(out,
+        "# HELP ovpn_manager_connect_seconds Time from connect request to connected\n"
+        "# TYPE ovpn_manager_connect_seconds histogram\n");
+    for (GList *l = names; l; l = l->next) {
+        const ConnectionFsm *fsm = g_hash_table_lookup(fsm_by_name, l->data);
+        append_histogram(out, "ovpn_manager_connect_seconds", l->data,
+                         fsm->stats.connected_hist, fsm->stats.connected_sum_us);
+    }
+
+    g_string_append(out,
+        "# HELP ovpn_manager_auth_seconds Time from connect request to authentication\n"
+        "# TYPE ovpn_manager_auth_seconds histogram\n");
+    for (GList *l = names; l; l = l->next) {
+        const ConnectionFsm *fsm = g_hash_table_lookup(fsm_by_name, l->data);
+        append_histogram(out, "ovpn_manager_auth_seconds", l->data,
+                         fsm->stats.auth_hist, fsm->stats.auth_sum_us);
+    }
+
+    g_string_append(out,
+        "# HELP ovpn_manager_connect_failures_total Connection attempts that did not connect\n"
+        "# TYPE ovpn_manager_connect_failures_total counter\n");
+    for (GList *l = names; l; l = l->next) {
+        const ConnectionFsm *fsm = g_hash_table_lookup(fsm_by_name, l->data);
+        g_string_append(out, "ovpn_manager_connect_failures_total{config=\"");
+        append_label(out, l->data);
+        g_string_append_printf(out, "\"} %u\n", fsm->stats.failures);
+    }
+
+    g_string_append(out,
+        "# HELP ovpn_manager_connect_phase_seconds Phase durations of the last connect\n"
+        "# TYPE ovpn_manager_connect_phase_seconds gauge\n");
+    for (GList *l = names; l; l = l->next) {
+        const ConnectionFsm *fsm = g_hash_table_lookup(fsm_by_name, l->data);
+        if (!fsm->stats.has_last) {
+            continue;
+        }
+        for (unsigned int p = 0; p < FSM_PHASE_COUNT; p++) {
+            g_string_append(out, "ovpn_manager_connect_phase_seconds{config=\"");
+            append_label(out, l->data);
+            g_string_append_printf(out, "\",phase=\"%s\"} %.6f\n",
+                                   connection_fsm_phase_name((ConnectionPhase)p),
+                                   fsm->stats.last.phase_us[p] / 1e6);
+        }
+    }
+
+    g_list_free(names);
+    return g_string_free(out, FALSE);
+}
+
+/**
+ * Write the metrics file
+ */
+int connection_fsm_write_metrics_file(const char *path) {
+    char *default_path = NULL;
+    if (!path) {
+        default_path = g_build_filename(g_get_user_data_dir(), "ovpn-manager", "metrics.prom", NULL);
+        path = default_path;
+    }
+
+    char *dir = g_path_get_dirname(path);
+    g_mkdir_with_parents(dir, 0755);
+    g_free(dir);
+
+    char *text = connection_fsm_export_metrics();
+    GError *error = NULL;
+    int ret = 0;
+    if (!g_file_set_contents(path, text, -1, &error)) {
+        logger_warn("Failed to write metrics to %s: %s", path, error->message);
+        g_error_free(error);
+        ret = -EIO;
+    }
+
+    g_free(text);
+    g_free(default_path);
+    return ret;
+}
+
+/**
+ * Free all FSMs in the registry
+ */
+void connection_fsm_registry_cleanup(void) {
+    if (metrics_write_id > 0) {
+        g_source_remove(metrics_write_id);
+        metrics_write_id = 0;
+        connection_fsm_write_metrics_file(NULL);
+    }
+    if (fsm_by_session) {
+        g_hash_table_destroy(fsm_by_session);
+        fsm_by_session = NULL;
+    }
+    if (fsm_by_name) {
+        g_hash_table_destroy(fsm_by_name);
+        fsm_by_name = NULL;
+    }
+}
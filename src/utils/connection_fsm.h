@@ -2,6 +2,8 @@
 #define CONNECTION_FSM_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * Connection states (shared with tray.c)
@@ -43,11 +45,89 @@ typedef struct {
     bool auth_enabled;
 } ConnectionButtonStates;
 
+/**
+ * Phases of connection establishment
+ *
+ * Correlated from the session's StatusChange minor codes and messages
+ * (openvpn3 core events RESOLVE, WAIT, AUTH, GET_CONFIG, ASSIGN_IP).
+ */
+typedef enum {
+    FSM_PHASE_START,         /* Request until the first status */
+    FSM_PHASE_RESOLVE,       /* Resolving the remote */
+    FSM_PHASE_WAIT,          /* Waiting for the server */
+    FSM_PHASE_AUTH,          /* Authenticating (includes user/web auth) */
+    FSM_PHASE_GET_CONFIG,    /* Pulling the configuration */
+    FSM_PHASE_ASSIGN_IP,     /* Assigning addresses and routes */
+    FSM_PHASE_COUNT
+} ConnectionPhase;
+
+/* Histogram upper bounds in ms; the last bucket is unbounded */
+#define FSM_HISTOGRAM_BUCKETS 10
+extern const int64_t connection_fsm_histogram_bounds_ms[FSM_HISTOGRAM_BUCKETS - 1];
+
+/**
+ * Timing of one connection attempt (microseconds)
+ */
+typedef struct {
+    int64_t total_us;                      /* Request to connected */
+    int64_t to_auth_us;                    /* Request to auth phase, 0 = no auth */
+    int64_t phase_us[FSM_PHASE_COUNT];     /* Time spent in each phase */
+} ConnectionTiming;
+
+/**
+ * Connection latency statistics of one config
+ */
+typedef struct {
+    unsigned int connects;                 /* Attempts that reached CONNECTED */
+    unsigned int failures;                 /* Attempts that ended otherwise */
+    unsigned int connected_hist[FSM_HISTOGRAM_BUCKETS];  /* Time to connected */
+    unsigned int auth_hist[FSM_HISTOGRAM_BUCKETS];       /* Time to auth */
+    int64_t connected_sum_us;
+    int64_t auth_sum_us;
+    bool has_last;
+    ConnectionTiming last;                 /* Most recent successful attempt */
+} ConnectionLatencyStats;
+
+/**
+ * One recorded process_event call
+ */
+typedef struct {
+    int64_t time_us;                       /* Monotonic */
+    ConnectionFsmEvent event;
+    ConnectionState from_state;
+    ConnectionState to_state;
+    bool valid;                            /* False if the event was ignored */
+} ConnectionFsmJournalEntry;
+
+/* Transitions kept per FSM */
+#define FSM_JOURNAL_SIZE 32
+
+/* State change listeners the registry can hold */
+#define FSM_MAX_LISTENERS 4
+
+/* Connects within this window share one write of the metrics file */
+#define FSM_METRICS_WRITE_DELAY_SEC 5
+
 /**
  * Opaque FSM instance (one per connection)
  */
 typedef struct ConnectionFsm ConnectionFsm;
 
+/**
+ * Called for each FSM by connection_fsm_foreach
+ */
+typedef void (*ConnectionFsmFunc)(ConnectionFsm *fsm, void *user_data);
+
+/**
+ * Called after an FSM changed state
+ *
+ * @param fsm FSM instance (its new state is current)
+ * @param old_state State before the change
+ * @param user_data Data passed to connection_fsm_add_listener
+ */
+typedef void (*ConnectionFsmListener)(ConnectionFsm *fsm, ConnectionState old_state,
+                                      void *user_data);
+
 /**
  * Create a new FSM instance for a connection
  * @param connection_name Name for logging/debugging
@@ -76,6 +156,36 @@ ConnectionState connection_fsm_process_event(ConnectionFsm *fsm, ConnectionFsmEv
  */
 ConnectionState connection_fsm_get_state(const ConnectionFsm *fsm);
 
+/**
+ * Get the connection name
+ * @param fsm FSM instance
+ * @return Name (owned by the FSM), or NULL
+ */
+const char* connection_fsm_get_name(const ConnectionFsm *fsm);
+
+/**
+ * Get the bound session
+ * @param fsm FSM instance
+ * @return Session object path (owned by the FSM), or NULL
+ */
+const char* connection_fsm_get_session(const ConnectionFsm *fsm);
+
+/**
+ * Get the last StatusChange minor code seen
+ * @param fsm FSM instance
+ * @return openvpn3 StatusMinor, 0 if none
+ */
+unsigned int connection_fsm_get_last_status(const ConnectionFsm *fsm);
+
+/**
+ * Check whether the last disconnect was requested by the user
+ *
+ * Set by DISCONNECT_REQUESTED, cleared by the next CONNECT_REQUESTED.
+ * @param fsm FSM instance
+ * @return true if the user disconnected
+ */
+bool connection_fsm_user_disconnected(const ConnectionFsm *fsm);
+
 /**
  * Get button states for current FSM state
  * @param fsm FSM instance
@@ -106,4 +216,153 @@ const char* connection_fsm_event_name(ConnectionFsmEvent event);
  */
 void connection_fsm_force_state(ConnectionFsm *fsm, ConnectionState state);
 
+/**
+ * Get the transition journal, oldest first
+ * @param fsm FSM instance
+ * @param entries Output array
+ * @param max Capacity of entries
+ * @return Number of entries written
+ */
+size_t connection_fsm_get_journal(const ConnectionFsm *fsm,
+                                  ConnectionFsmJournalEntry *entries, size_t max);
+
+/**
+ * Get the latency statistics of the FSM's connection
+ * @param fsm FSM instance
+ * @return Statistics (owned by the FSM)
+ */
+const ConnectionLatencyStats* connection_fsm_get_stats(const ConnectionFsm *fsm);
+
+/**
+ * Estimate a quantile from a latency histogram
+ * @param hist Histogram with FSM_HISTOGRAM_BUCKETS buckets
+ * @param q Quantile (0..1)
+ * @return Upper bound of the bucket holding the quantile in ms, -1 if empty
+ *         (the last bucket reports its lower bound)
+ */
+int64_t connection_fsm_histogram_quantile(const unsigned int *hist, double q);
+
+/**
+ * Get a phase name (for display)
+ * @param phase Phase
+ * @return Human-readable phase name
+ */
+const char* connection_fsm_phase_name(ConnectionPhase phase);
+
+/* ──────────────────────────────────────────────────────────────
+ * Registry: one FSM per config, shared by the tray, the dashboard
+ * and the D-Bus signal handlers (main thread only)
+ * ────────────────────────────────────────────────────────────── */
+
+/**
+ * Get the FSM of a config, creating it on first use
+ * @param config_name Config name
+ * @return FSM owned by the registry, NULL if config_name is NULL
+ */
+ConnectionFsm* connection_fsm_get(const char *config_name);
+
+/**
+ * Get the FSM of a config if one exists
+ * @param config_name Config name
+ * @return FSM owned by the registry or NULL
+ */
+ConnectionFsm* connection_fsm_lookup(const char *config_name);
+
+/**
+ * Find the FSM a session belongs to
+ * @param session_path Session object path
+ * @return FSM owned by the registry or NULL
+ */
+ConnectionFsm* connection_fsm_find_session(const char *session_path);
+
+/**
+ * Associate a session with an FSM
+ * @param fsm FSM instance
+ * @param session_path Session object path (NULL to clear)
+ */
+void connection_fsm_bind_session(ConnectionFsm *fsm, const char *session_path);
+
+/**
+ * Record a connect request made at a given time
+ *
+ * Starts a new attempt whose timing runs from started_us.
+ * @param fsm FSM instance
+ * @param session_path New session's object path
+ * @param started_us Monotonic time of the request
+ */
+void connection_fsm_connect_requested(ConnectionFsm *fsm, const char *session_path,
+                                      int64_t started_us);
+
+/**
+ * Feed a session status change (StatusChange signal)
+ *
+ * Advances the phase of a running attempt and processes the event the
+ * status implies.
+ * @param fsm FSM instance
+ * @param major Status major code
+ * @param minor Status minor code
+ * @param message Status message (can be NULL)
+ */
+void connection_fsm_note_status(ConnectionFsm *fsm, unsigned int major,
+                                unsigned int minor, const char *message);
+
+/**
+ * Feed a state observed by polling
+ *
+ * Processes the matching event and force-syncs if the FSM cannot get
+ * there by a valid transition.
+ * @param fsm FSM instance
+ * @param state Observed state
+ */
+void connection_fsm_observe(ConnectionFsm *fsm, ConnectionState state);
+
+/**
+ * Call a function for every FSM in the registry
+ *
+ * The function must not add or remove FSMs.
+ * @param func Function to call
+ * @param user_data Data passed to func
+ */
+void connection_fsm_foreach(ConnectionFsmFunc func, void *user_data);
+
+/**
+ * Add a listener notified of every state change
+ *
+ * Called for transitions and force-syncs of all FSMs in the registry,
+ * in the order the listeners were added.
+ * @param listener Listener
+ * @param user_data Data passed to listener
+ * @return 0 on success, -ENOSPC if FSM_MAX_LISTENERS are registered
+ */
+int connection_fsm_add_listener(ConnectionFsmListener listener, void *user_data);
+
+/**
+ * Remove a listener added with the same listener and user_data
+ * @param listener Listener
+ * @param user_data Data passed to connection_fsm_add_listener
+ */
+void connection_fsm_remove_listener(ConnectionFsmListener listener, void *user_data);
+
+/**
+ * Format latency metrics of all configs in Prometheus text format
+ * @return Newly allocated text (free with g_free)
+ */
+char* connection_fsm_export_metrics(void);
+
+/**
+ * Write the metrics to a file for a node_exporter textfile collector
+ *
+ * Replaces the file atomically.
+ * @param path File path (NULL for ~/.local/share/ovpn-manager/metrics.prom)
+ * @return 0 on success, negative on error
+ */
+int connection_fsm_write_metrics_file(const char *path);
+
+/**
+ * Free all FSMs in the registry
+ *
+ * A metrics file write still pending from a recent connect is done first.
+ */
+void connection_fsm_registry_cleanup(void);
+
 #endif /* CONNECTION_FSM_H */
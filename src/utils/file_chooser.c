@@ -5,14 +5,55 @@
 #include <string.h>
 #include <errno.h>
 
+/* Pending result dialog */
+typedef struct {
+    DialogResultCallback callback;
+    gpointer user_data;
+    GtkWidget *entry;           /* Text input dialogs only */
+} DialogRequest;
+
+static DialogRequest* dialog_request_new(DialogResultCallback callback, gpointer user_data) {
+    DialogRequest *req = g_malloc0(sizeof(DialogRequest));
+    req->callback = callback;
+    req->user_data = user_data;
+    return req;
+}
+
+/**
+ * Deliver a result and free the request
+ */
+static void dialog_request_finish(DialogRequest *req, char *result) {
+    if (req->callback) {
+        req->callback(result, req->user_data);
+    } else {
+        g_free(result);
+    }
+    g_free(req);
+}
+
+/**
+ * File chooser closed (also emitted when closed by the window manager)
+ */
+static void on_chooser_response(GtkDialog *dialog, gint response, gpointer data) {
+    DialogRequest *req = (DialogRequest *)data;
+    char *filename = NULL;
+
+    if (response == GTK_RESPONSE_ACCEPT) {
+        filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+    }
+
+    gtk_widget_destroy(GTK_WIDGET(dialog));
+    dialog_request_finish(req, filename);
+}
+
 /**
  * Show a file chooser dialog for selecting an OVPN file
  */
-char* file_chooser_select_ovpn(const char *title) {
+void file_chooser_select_ovpn(const char *title, DialogResultCallback callback,
+                              gpointer user_data) {
     GtkWidget *dialog;
     GtkFileChooser *chooser;
     GtkFileFilter *filter;
-    char *filename = NULL;
 
     /* Create file chooser dialog */
     dialog = gtk_file_chooser_dialog_new(
@@ -33,27 +74,45 @@ char* file_chooser_select_ovpn(const char *title) {
     gtk_file_filter_add_pattern(filter, "*.conf");
     gtk_file_chooser_add_filter(chooser, filter);
 
+    /* Archives of profiles are bulk-imported */
+    filter = gtk_file_filter_new();
+    gtk_file_filter_set_name(filter, "Profile Archives");
+    gtk_file_filter_add_pattern(filter, "*.zip");
+    gtk_file_filter_add_pattern(filter, "*.tar");
+    gtk_file_filter_add_pattern(filter, "*.tar.gz");
+    gtk_file_filter_add_pattern(filter, "*.tgz");
+    gtk_file_filter_add_pattern(filter, "*.tar.xz");
+    gtk_file_chooser_add_filter(chooser, filter);
+
     /* Add "All Files" filter */
     filter = gtk_file_filter_new();
     gtk_file_filter_set_name(filter, "All Files");
     gtk_file_filter_add_pattern(filter, "*");
     gtk_file_chooser_add_filter(chooser, filter);
 
-    /* Show dialog and get response */
-    gint response = gtk_dialog_run(GTK_DIALOG(dialog));
-
-    if (response == GTK_RESPONSE_ACCEPT) {
-        filename = gtk_file_chooser_get_filename(chooser);
-    }
-
-    gtk_widget_destroy(dialog);
+    /* Show dialog; the result arrives with the response */
+    g_signal_connect(dialog, "response", G_CALLBACK(on_chooser_response),
+                     dialog_request_new(callback, user_data));
+    gtk_window_present(GTK_WINDOW(dialog));
+}
 
-    /* Process pending events to clean up dialog */
-    while (gtk_events_pending()) {
-        gtk_main_iteration();
-    }
+/**
+ * Show a folder chooser dialog for bulk import
+ */
+void file_chooser_select_folder(const char *title, DialogResultCallback callback,
+                                gpointer user_data) {
+    GtkWidget *dialog = gtk_file_chooser_dialog_new(
+        title ? title : "Select Folder of OpenVPN Configurations",
+        NULL,
+        GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER,
+        "_Cancel", GTK_RESPONSE_CANCEL,
+        "_Select", GTK_RESPONSE_ACCEPT,
+        NULL
+    );
 
-    return filename;
+    g_signal_connect(dialog, "response", G_CALLBACK(on_chooser_response),
+                     dialog_request_new(callback, user_data));
+    gtk_window_present(GTK_WINDOW(dialog));
 }
 
 /**
@@ -107,16 +166,34 @@ int file_read_contents(const char *file_path, char **contents, char **error) {
     return 0;
 }
 
+/**
+ * Text input dialog closed
+ */
+static void on_text_input_response(GtkDialog *dialog, gint response, gpointer data) {
+    DialogRequest *req = (DialogRequest *)data;
+    char *result = NULL;
+
+    if (response == GTK_RESPONSE_ACCEPT) {
+        const char *text = gtk_entry_get_text(GTK_ENTRY(req->entry));
+        if (text && strlen(text) > 0) {
+            result = g_strdup(text);
+        }
+    }
+
+    gtk_widget_destroy(GTK_WIDGET(dialog));
+    dialog_request_finish(req, result);
+}
+
 /**
  * Show a dialog to get text input from user
  */
-char* dialog_get_text_input(const char *title, const char *prompt, const char *default_value) {
+void dialog_get_text_input(const char *title, const char *prompt, const char *default_value,
+                           DialogResultCallback callback, gpointer user_data) {
     GtkWidget *dialog;
     GtkWidget *content_area;
     GtkWidget *entry;
     GtkWidget *label;
     GtkWidget *hbox;
-    char *result = NULL;
 
     /* Create dialog */
     dialog = gtk_dialog_new_with_buttons(
@@ -149,70 +226,94 @@ char* dialog_get_text_input(const char *title, const char *prompt, const char *d
     }
     gtk_box_pack_start(GTK_BOX(hbox), entry, TRUE, TRUE, 0);
 
+    DialogRequest *req = dialog_request_new(callback, user_data);
+    req->entry = entry;
+    g_signal_connect(dialog, "response", G_CALLBACK(on_text_input_response), req);
+
     gtk_widget_show_all(dialog);
+}
 
-    /* Run dialog */
-    gint response = gtk_dialog_run(GTK_DIALOG(dialog));
+/* Pending confirmation */
+typedef struct {
+    DialogConfirmCallback on_accept;
+    gpointer user_data;
+    GDestroyNotify destroy_data;
+} ConfirmRequest;
 
-    if (response == GTK_RESPONSE_ACCEPT) {
-        const char *text = gtk_entry_get_text(GTK_ENTRY(entry));
-        if (text && strlen(text) > 0) {
-            result = g_strdup(text);
-        }
-    }
+/**
+ * Confirmation dialog closed
+ */
+static void on_confirm_response(GtkDialog *dialog, gint response, gpointer data) {
+    ConfirmRequest *req = (ConfirmRequest *)data;
 
-    gtk_widget_destroy(dialog);
+    gtk_widget_destroy(GTK_WIDGET(dialog));
 
-    /* Process pending events */
-    while (gtk_events_pending()) {
-        gtk_main_iteration();
+    if (response == GTK_RESPONSE_ACCEPT && req->on_accept) {
+        req->on_accept(req->user_data);
     }
-
-    return result;
+    if (req->destroy_data) {
+        req->destroy_data(req->user_data);
+    }
+    g_free(req);
 }
 
 /**
- * Show an error message dialog
+ * Ask the user to confirm an action
  */
-void dialog_show_error(const char *title, const char *message) {
+void dialog_confirm(GtkMessageType type, const char *message, const char *accept_label,
+                    DialogConfirmCallback on_accept, gpointer user_data,
+                    GDestroyNotify destroy_data) {
     GtkWidget *dialog = gtk_message_dialog_new(
         NULL,
-        GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
-        GTK_MESSAGE_ERROR,
-        GTK_BUTTONS_OK,
+        GTK_DIALOG_MODAL,
+        type,
+        GTK_BUTTONS_NONE,
         "%s",
-        message ? message : "An error occurred"
+        message ? message : ""
     );
+    gtk_dialog_add_button(GTK_DIALOG(dialog), "Cancel", GTK_RESPONSE_CANCEL);
+    gtk_dialog_add_button(GTK_DIALOG(dialog), accept_label ? accept_label : "OK",
+                          GTK_RESPONSE_ACCEPT);
 
-    gtk_window_set_title(GTK_WINDOW(dialog), title ? title : "Error");
-    gtk_dialog_run(GTK_DIALOG(dialog));
-    gtk_widget_destroy(dialog);
+    ConfirmRequest *req = g_malloc0(sizeof(ConfirmRequest));
+    req->on_accept = on_accept;
+    req->user_data = user_data;
+    req->destroy_data = destroy_data;
+    g_signal_connect(dialog, "response", G_CALLBACK(on_confirm_response), req);
 
-    /* Process pending events */
-    while (gtk_events_pending()) {
-        gtk_main_iteration();
-    }
+    gtk_window_present(GTK_WINDOW(dialog));
 }
 
 /**
- * Show an info message dialog
+ * Show a message dialog that closes itself
  */
-void dialog_show_info(const char *title, const char *message) {
+static void show_message(GtkMessageType type, const char *title, const char *message) {
     GtkWidget *dialog = gtk_message_dialog_new(
         NULL,
         GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
-        GTK_MESSAGE_INFO,
+        type,
         GTK_BUTTONS_OK,
         "%s",
-        message ? message : "Operation completed"
+        message
     );
 
-    gtk_window_set_title(GTK_WINDOW(dialog), title ? title : "Information");
-    gtk_dialog_run(GTK_DIALOG(dialog));
-    gtk_widget_destroy(dialog);
+    gtk_window_set_title(GTK_WINDOW(dialog), title);
+    g_signal_connect_swapped(dialog, "response", G_CALLBACK(gtk_widget_destroy), dialog);
+    gtk_window_present(GTK_WINDOW(dialog));
+}
 
-    /* Process pending events */
-    while (gtk_events_pending()) {
-        gtk_main_iteration();
-    }
+/**
+ * Show an error message dialog
+ */
+void dialog_show_error(const char *title, const char *message) {
+    show_message(GTK_MESSAGE_ERROR, title ? title : "Error",
+                 message ? message : "An error occurred");
+}
+
+/**
+ * Show an info message dialog
+ */
+void dialog_show_info(const char *title, const char *message) {
+    show_message(GTK_MESSAGE_INFO, title ? title : "Information",
+                 message ? message : "Operation completed");
 }
@@ -1,19 +1,55 @@
 #ifndef FILE_CHOOSER_H
 #define FILE_CHOOSER_H
 
+#include <gtk/gtk.h>
+
 /**
  * File Chooser Utilities
  *
- * GTK-based file selection dialogs
+ * GTK-based file selection and message dialogs. All dialogs are
+ * non-blocking: they are shown and report back through callbacks from
+ * the main loop, never by running a nested loop.
+ */
+
+/**
+ * Called when a chooser or input dialog closes
+ *
+ * @param result Selected path or entered text (caller of the callback
+ *               passes ownership; free with g_free), or NULL if cancelled
+ * @param user_data Data passed when the dialog was shown
+ */
+typedef void (*DialogResultCallback)(char *result, gpointer user_data);
+
+/**
+ * Called when a confirmation dialog is accepted
+ *
+ * @param user_data Data passed to dialog_confirm
+ */
+typedef void (*DialogConfirmCallback)(gpointer user_data);
+
+/**
+ * Show a file chooser dialog for selecting an OVPN file or profile archive
+ *
+ * Returns immediately; the callback runs from the main loop.
+ *
+ * @param title Dialog title
+ * @param callback Receives the selected path, or NULL if cancelled
+ * @param user_data Data passed to callback
  */
+void file_chooser_select_ovpn(const char *title, DialogResultCallback callback,
+                              gpointer user_data);
 
 /**
- * Show a file chooser dialog for selecting an OVPN file
+ * Show a folder chooser dialog for bulk import
+ *
+ * Returns immediately; the callback runs from the main loop.
  *
  * @param title Dialog title
- * @return Selected file path (must be freed with g_free), or NULL if cancelled
+ * @param callback Receives the selected directory, or NULL if cancelled
+ * @param user_data Data passed to callback
  */
-char* file_chooser_select_ovpn(const char *title);
+void file_chooser_select_folder(const char *title, DialogResultCallback callback,
+                                gpointer user_data);
 
 /**
  * Read entire file contents into a string
@@ -28,12 +64,33 @@ int file_read_contents(const char *file_path, char **contents, char **error);
 /**
  * Show a dialog to get text input from user
  *
+ * Returns immediately; the callback runs from the main loop.
+ *
  * @param title Dialog title
  * @param prompt Label text for the entry
  * @param default_value Initial value for the entry (can be NULL)
- * @return User-entered text (must be freed with g_free), or NULL if cancelled
+ * @param callback Receives the entered text, or NULL if cancelled or empty
+ * @param user_data Data passed to callback
+ */
+void dialog_get_text_input(const char *title, const char *prompt, const char *default_value,
+                           DialogResultCallback callback, gpointer user_data);
+
+/**
+ * Ask the user to confirm an action
+ *
+ * Returns immediately; on_accept runs from the main loop only if the
+ * user accepts. destroy_data is called on user_data either way.
+ *
+ * @param type Message type (question, warning, ...)
+ * @param message Question to display
+ * @param accept_label Label of the accept button
+ * @param on_accept Called when accepted
+ * @param user_data Data passed to on_accept
+ * @param destroy_data Frees user_data when the dialog closes (can be NULL)
  */
-char* dialog_get_text_input(const char *title, const char *prompt, const char *default_value);
+void dialog_confirm(GtkMessageType type, const char *message, const char *accept_label,
+                    DialogConfirmCallback on_accept, gpointer user_data,
+                    GDestroyNotify destroy_data);
 
 /**
  * Show an error message dialog
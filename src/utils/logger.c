@@ -3,28 +3,101 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <errno.h>
+#include <limits.h>
 #include <syslog.h>
 #include <glib.h>
+#include <systemd/sd-journal.h>
+
+/* Ring buffer capacity (power of two) */
+#define LOGGER_RING_SLOTS   512
+
+/* Longest message kept; longer ones are truncated */
+#define LOGGER_LINE_MAX     1024
+
+/* Space for structured fields per message */
+#define LOGGER_FIELDS_MAX   512
+
+/* Messages written per writev() */
+#define LOGGER_BATCH        64
+
+/* Slot text starts with this so it can be handed to the journal as is */
+#define JOURNAL_MESSAGE     "MESSAGE="
+#define JOURNAL_MESSAGE_LEN (sizeof(JOURNAL_MESSAGE) - 1)
+
+/* Default log file rotation */
+#define LOGGER_ROTATE_SIZE  (10 * 1024 * 1024)
+#define LOGGER_ROTATE_KEEP  3
+
+/**
+ * One queued message
+ *
+ * seq follows the bounded MPMC queue scheme: a slot is free for the
+ * producer claiming position p when seq == p, and ready for the writer
+ * when seq == p + 1. The writer hands it back with seq = p + slots.
+ */
+typedef struct {
+    guint seq;
+    LogLevel level;
+    LogCategory category;
+    gint64 time;                    /* Wall-clock seconds */
+    int len;                        /* Message length, without the prefix */
+    int fields_len;
+    char fields[LOGGER_FIELDS_MAX]; /* "KEY=value" entries, NUL-separated */
+    char text[JOURNAL_MESSAGE_LEN + LOGGER_LINE_MAX]; /* "MESSAGE=..." */
+} LogSlot;
 
 /* Logger state */
 static struct {
     bool initialized;
-    bool log_to_file;
-    bool use_syslog;
-    FILE *log_file;
-    LogLevel min_level;
-    int verbosity;  /* 0=quiet, 1=changes only, 2=detailed, 3=debug */
-    GMutex mutex;  /* For thread safety */
+    bool use_journal;
+    bool journal_failed;            /* Fall back to syslog */
+    bool skip_stderr;               /* stderr already goes to the journal */
+    int file_fd;                    /* -1 = no log file */
+    char *file_path;
+    off_t file_size;
+    off_t rotate_size;              /* 0 = never rotate */
+    unsigned int rotate_keep;
+
+    LogSlot *ring;
+    guint enqueue_pos;              /* Next position to claim (producers) */
+    guint dequeue_pos;              /* Next position to write (writer only) */
+    guint written_pos;              /* Everything before this is on disk */
+    guint dropped;                  /* Messages lost to a full ring */
+
+    GThread *writer;
+    GMutex mutex;                   /* Only for sleeping and flush waits */
+    GCond wake;                     /* Writer: work available */
+    GCond flushed;                  /* Producers: written_pos advanced */
+    gint writer_sleeping;
+    gint flush_waiters;
+    gint stopping;
 } logger_state = {
     .initialized = false,
-    .log_to_file = false,
-    .use_syslog = false,
-    .log_file = NULL,
-    .min_level = LOG_LEVEL_INFO,
-    .verbosity = 0,
+    .use_journal = false,
+    .file_fd = -1,
+    .rotate_size = LOGGER_ROTATE_SIZE,
+    .rotate_keep = LOGGER_ROTATE_KEEP,
+};
+
+/* Read lock-free by the macros in logger.h */
+int logger_current_level = LOG_LEVEL_INFO;
+int logger_current_verbosity = 0;   /* 0=quiet, 1=changes only, 2=detailed, 3=debug */
+unsigned int logger_category_mask = (1u << LOG_CAT_COUNT) - 1;
+
+/* Category names, indexed by LogCategory */
+static const char *log_category_names[] = {
+    "general",
+    "dbus",
+    "fsm",
+    "bw",
+    "ui",
+    "ping"
 };
 
 /* Log level names */
@@ -45,14 +118,13 @@ static const char *log_level_colors[] = {
 
 #define COLOR_RESET "\033[0m"
 
-/**
- * Get current timestamp as string
- */
-static void get_timestamp(char *buffer, size_t buffer_size) {
-    time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
-    strftime(buffer, buffer_size, "%Y-%m-%d %H:%M:%S", tm_info);
-}
+/* Journal priorities, indexed by LogLevel */
+static const int log_level_priorities[] = {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERR
+};
 
 /**
  * Ensure log directory exists
@@ -72,10 +144,445 @@ static int ensure_log_directory(const char *log_path) {
     return ret;
 }
 
+/* ──────────────────────────────────────────────────────────────
+ * Writer thread
+ * ────────────────────────────────────────────────────────────── */
+
+/**
+ * Write a whole iovec array, continuing after short writes
+ */
+static void write_all(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count > IOV_MAX ? IOV_MAX : count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;  /* Nowhere left to report it */
+        }
+
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+}
+
+/**
+ * Total length of an iovec array
+ */
+static off_t iov_length(const struct iovec *iov, int count) {
+    off_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += (off_t)iov[i].iov_len;
+    }
+    return total;
+}
+
+/**
+ * Rotate the log file: app.log -> app.log.1 -> ... -> app.log.<keep>
+ */
+static void rotate_file(void) {
+    const char *path = logger_state.file_path;
+
+    close(logger_state.file_fd);
+    logger_state.file_fd = -1;
+
+    if (logger_state.rotate_keep == 0) {
+        unlink(path);
+    }
+    for (unsigned int k = logger_state.rotate_keep; k >= 1; k--) {
+        char *src = k == 1 ? g_strdup(path) : g_strdup_printf("%s.%u", path, k - 1);
+        char *dst = g_strdup_printf("%s.%u", path, k);
+        rename(src, dst);  /* Missing generations are fine */
+        g_free(src);
+        g_free(dst);
+    }
+
+    logger_state.file_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    logger_state.file_size = 0;
+}
+
+/**
+ * Write to the log file, rotating once it reaches the size limit
+ */
+static void write_file(struct iovec *iov, int count) {
+    if (logger_state.file_fd < 0) {
+        return;
+    }
+
+    off_t len = iov_length(iov, count);
+    write_all(logger_state.file_fd, iov, count);
+    logger_state.file_size += len;
+
+    if (logger_state.rotate_size > 0 && logger_state.file_size >= logger_state.rotate_size) {
+        rotate_file();
+    }
+}
+
+/**
+ * Send one message to the journal with its structured fields
+ */
+static void send_journal(const LogSlot *slot) {
+    /* MESSAGE, PRIORITY, SYSLOG_IDENTIFIER, OVPN_CATEGORY + fields */
+    struct iovec iov[4 + LOGGER_FIELDS_MAX / 4];
+    char priority[16];
+    char category[32];
+    int n = 0;
+
+    iov[n++] = (struct iovec){ (char *)slot->text, JOURNAL_MESSAGE_LEN + (size_t)slot->len };
+    snprintf(priority, sizeof(priority), "PRIORITY=%d", log_level_priorities[slot->level]);
+    iov[n++] = (struct iovec){ priority, strlen(priority) };
+    iov[n++] = (struct iovec){ "SYSLOG_IDENTIFIER=ovpn-manager", 30 };
+    snprintf(category, sizeof(category), "OVPN_CATEGORY=%s", log_category_names[slot->category]);
+    iov[n++] = (struct iovec){ category, strlen(category) };
+
+    for (int off = 0; off < slot->fields_len && n < (int)G_N_ELEMENTS(iov); ) {
+        size_t len = strlen(slot->fields + off);
+        iov[n++] = (struct iovec){ (char *)slot->fields + off, len };
+        off += (int)len + 1;
+    }
+
+    if (sd_journal_sendv(iov, n) < 0) {
+        /* No journal (e.g. not running under systemd) */
+        logger_state.journal_failed = true;
+        logger_state.skip_stderr = false;
+    }
+}
+
+/**
+ * Format a timestamp, reusing the previous one within the same second
+ */
+static const char* format_timestamp(gint64 seconds) {
+    static char cached[32];
+    static gint64 cached_seconds = -1;
+
+    if (seconds != cached_seconds) {
+        time_t t = (time_t)seconds;
+        struct tm tm_info;
+        localtime_r(&t, &tm_info);
+        strftime(cached, sizeof(cached), "%Y-%m-%d %H:%M:%S", &tm_info);
+        cached_seconds = seconds;
+    }
+    return cached;
+}
+
+/**
+ * Write up to LOGGER_BATCH ready messages
+ *
+ * @return Number of messages written
+ */
+static unsigned int drain_batch(void) {
+    /* Per message: timestamp, prefix, text, newline */
+    struct iovec err_iov[LOGGER_BATCH * 4];
+    struct iovec file_iov[LOGGER_BATCH * 4];
+    char stamps[LOGGER_BATCH][32];
+    char err_prefix[LOGGER_BATCH][48];
+    char file_prefix[LOGGER_BATCH][32];
+    LogSlot *slots[LOGGER_BATCH];
+    unsigned int count = 0;
+    int ne = 0, nf = 0;
+
+    guint pos = logger_state.dequeue_pos;
+    while (count < LOGGER_BATCH) {
+        LogSlot *slot = &logger_state.ring[pos & (LOGGER_RING_SLOTS - 1)];
+        if (g_atomic_int_get(&slot->seq) != pos + 1) {
+            break;  /* Not published yet */
+        }
+
+        LogLevel level = slot->level;
+        g_strlcpy(stamps[count], format_timestamp(slot->time), sizeof(stamps[count]));
+        snprintf(err_prefix[count], sizeof(err_prefix[count]), "[ovpn-manager] [%s%s%s] ",
+                 log_level_colors[level], log_level_names[level], COLOR_RESET);
+        snprintf(file_prefix[count], sizeof(file_prefix[count]), " [ovpn-manager] [%s] ",
+                 log_level_names[level]);
+
+        char *text = slot->text + JOURNAL_MESSAGE_LEN;
+
+        if (!logger_state.skip_stderr) {
+            err_iov[ne++] = (struct iovec){ stamps[count], strlen(stamps[count]) };
+            err_iov[ne++] = (struct iovec){ err_prefix[count], strlen(err_prefix[count]) };
+            err_iov[ne++] = (struct iovec){ text, (size_t)slot->len };
+            err_iov[ne++] = (struct iovec){ "\n", 1 };
+        }
+
+        if (logger_state.file_fd >= 0) {
+            file_iov[nf++] = (struct iovec){ stamps[count], strlen(stamps[count]) };
+            file_iov[nf++] = (struct iovec){ file_prefix[count], strlen(file_prefix[count]) };
+            file_iov[nf++] = (struct iovec){ text, (size_t)slot->len };
+            file_iov[nf++] = (struct iovec){ "\n", 1 };
+        }
+
+        slots[count++] = slot;
+        pos++;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    if (ne > 0) {
+        write_all(STDERR_FILENO, err_iov, ne);
+    }
+    if (nf > 0) {
+        write_file(file_iov, nf);
+    }
+
+    /* Journal gets every message with its fields; the syslog fallback
+     * only WARN and ERROR as before */
+    for (unsigned int i = 0; i < count && logger_state.use_journal; i++) {
+        if (!logger_state.journal_failed) {
+            send_journal(slots[i]);
+        }
+        if (logger_state.journal_failed && slots[i]->level >= LOG_LEVEL_WARN) {
+            syslog(log_level_priorities[slots[i]->level], "%s",
+                   slots[i]->text + JOURNAL_MESSAGE_LEN);
+        }
+    }
+
+    /* Hand the slots back to producers */
+    for (unsigned int i = 0; i < count; i++) {
+        guint slot_pos = logger_state.dequeue_pos + i;
+        g_atomic_int_set(&slots[i]->seq, slot_pos + LOGGER_RING_SLOTS);
+    }
+    logger_state.dequeue_pos = pos;
+
+    return count;
+}
+
+/**
+ * Report messages dropped while the ring was full
+ */
+static void report_dropped(void) {
+    guint dropped = (guint)g_atomic_int_and(&logger_state.dropped, 0);
+    if (dropped == 0) {
+        return;
+    }
+
+    char line[96];
+    int len = snprintf(line, sizeof(line),
+                       "%s [ovpn-manager] [WARN] %u log messages dropped (buffer full)\n",
+                       format_timestamp(g_get_real_time() / G_USEC_PER_SEC), dropped);
+    struct iovec iov = { line, (size_t)len };
+    write_all(STDERR_FILENO, &iov, 1);
+    iov = (struct iovec){ line, (size_t)len };
+    write_file(&iov, 1);
+}
+
+/**
+ * Anything published that the writer has not taken yet?
+ */
+static bool ring_has_work(void) {
+    guint pos = logger_state.dequeue_pos;
+    LogSlot *slot = &logger_state.ring[pos & (LOGGER_RING_SLOTS - 1)];
+    return g_atomic_int_get(&slot->seq) == pos + 1;
+}
+
+static gpointer writer_main(gpointer data) {
+    (void)data;
+
+    for (;;) {
+        unsigned int written = 0;
+        unsigned int n;
+        while ((n = drain_batch()) > 0) {
+            written += n;
+        }
+        report_dropped();
+
+        if (written > 0) {
+            g_atomic_int_set(&logger_state.written_pos, logger_state.dequeue_pos);
+            if (g_atomic_int_get(&logger_state.flush_waiters) > 0) {
+                g_mutex_lock(&logger_state.mutex);
+                g_cond_broadcast(&logger_state.flushed);
+                g_mutex_unlock(&logger_state.mutex);
+            }
+        }
+
+        /* Sleep until a producer publishes; re-check under the mutex so
+         * a publish racing with falling asleep is not missed */
+        g_mutex_lock(&logger_state.mutex);
+        g_atomic_int_set(&logger_state.writer_sleeping, 1);
+        while (!ring_has_work() && !g_atomic_int_get(&logger_state.stopping)) {
+            g_cond_wait(&logger_state.wake, &logger_state.mutex);
+        }
+        g_atomic_int_set(&logger_state.writer_sleeping, 0);
+        bool stop = g_atomic_int_get(&logger_state.stopping) && !ring_has_work();
+        g_mutex_unlock(&logger_state.mutex);
+
+        if (stop) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Wake the writer if it is asleep
+ */
+static void wake_writer(void) {
+    if (g_atomic_int_get(&logger_state.writer_sleeping)) {
+        g_mutex_lock(&logger_state.mutex);
+        g_cond_signal(&logger_state.wake);
+        g_mutex_unlock(&logger_state.mutex);
+    }
+}
+
+/* ──────────────────────────────────────────────────────────────
+ * Producers
+ * ────────────────────────────────────────────────────────────── */
+
+/**
+ * Claim a ring slot
+ *
+ * @return Slot, or NULL if the ring is full
+ */
+static LogSlot* claim_slot(guint *out_pos) {
+    guint pos = (guint)g_atomic_int_get(&logger_state.enqueue_pos);
+
+    for (;;) {
+        LogSlot *slot = &logger_state.ring[pos & (LOGGER_RING_SLOTS - 1)];
+        gint diff = (gint)((guint)g_atomic_int_get(&slot->seq) - pos);
+
+        if (diff == 0) {
+            if (g_atomic_int_compare_and_exchange(&logger_state.enqueue_pos, pos, pos + 1)) {
+                *out_pos = pos;
+                return slot;
+            }
+        } else if (diff < 0) {
+            return NULL;
+        }
+        pos = (guint)g_atomic_int_get(&logger_state.enqueue_pos);
+    }
+}
+
+/**
+ * Block until everything logged so far has been written
+ */
+static void logger_flush(void) {
+    if (!logger_state.writer) {
+        return;
+    }
+
+    guint target = (guint)g_atomic_int_get(&logger_state.enqueue_pos);
+
+    g_atomic_int_inc(&logger_state.flush_waiters);
+    g_mutex_lock(&logger_state.mutex);
+    g_cond_signal(&logger_state.wake);
+    while ((gint)(target - (guint)g_atomic_int_get(&logger_state.written_pos)) > 0 &&
+           logger_state.writer) {
+        g_cond_wait(&logger_state.flushed, &logger_state.mutex);
+    }
+    g_mutex_unlock(&logger_state.mutex);
+    g_atomic_int_add(&logger_state.flush_waiters, -1);
+}
+
+/**
+ * Append "KEY=value" to a slot's fields
+ */
+static void pack_field(LogSlot *slot, const char *key, const char *value) {
+    if (!value) {
+        return;
+    }
+
+    int room = LOGGER_FIELDS_MAX - slot->fields_len;
+    int len = snprintf(slot->fields + slot->fields_len, room, "%s=%s", key, value);
+    if (len < 0 || len >= room) {
+        slot->fields[slot->fields_len] = '\0';  /* Does not fit: leave it out */
+        return;
+    }
+    slot->fields_len += len + 1;
+}
+
+static void pack_fields(LogSlot *slot, const LogFields *fields) {
+    slot->fields_len = 0;
+    if (!fields) {
+        return;
+    }
+
+    pack_field(slot, "SESSION_PATH", fields->session_path);
+    pack_field(slot, "CONFIG_NAME", fields->config_name);
+    pack_field(slot, "FSM_STATE", fields->fsm_state);
+    pack_field(slot, "DBUS_METHOD", fields->dbus_method);
+    if (fields->latency_us > 0) {
+        char latency[24];
+        snprintf(latency, sizeof(latency), "%lld", fields->latency_us);
+        pack_field(slot, "LATENCY_US", latency);
+    }
+}
+
+/**
+ * Format a message straight into a ring slot and publish it
+ */
+static void logger_logv(LogLevel level, LogCategory category, const LogFields *fields,
+                        const char *format, va_list args) {
+    if (!logger_state.initialized) {
+        return;
+    }
+
+    /* Check log level */
+    if ((gint)level < g_atomic_int_get(&logger_current_level)) {
+        return;
+    }
+
+    guint pos;
+    LogSlot *slot = claim_slot(&pos);
+    if (!slot && level == LOG_LEVEL_ERROR) {
+        /* Errors are not dropped: wait for the writer to make room */
+        logger_flush();
+        slot = claim_slot(&pos);
+    }
+    if (!slot) {
+        g_atomic_int_inc(&logger_state.dropped);
+    } else {
+        const int room = LOGGER_LINE_MAX;
+        slot->level = level;
+        slot->category = (unsigned int)category < LOG_CAT_COUNT ? category : LOG_CAT_GENERAL;
+        slot->time = g_get_real_time() / G_USEC_PER_SEC;
+        memcpy(slot->text, JOURNAL_MESSAGE, JOURNAL_MESSAGE_LEN);
+        int len = vsnprintf(slot->text + JOURNAL_MESSAGE_LEN, room, format, args);
+        if (len < 0) len = 0;
+        if (len >= room) len = room - 1;
+        slot->len = len;
+        pack_fields(slot, fields);
+
+        g_atomic_int_set(&slot->seq, pos + 1);
+        wake_writer();
+    }
+
+    /* Errors are on disk before the caller carries on */
+    if (level == LOG_LEVEL_ERROR) {
+        logger_flush();
+    }
+}
+
+/**
+ * Is stderr connected to the journal already (systemd service)?
+ *
+ * systemd sets JOURNAL_STREAM to "<dev>:<inode>" of the stream it
+ * connected; writing there as well would log every message twice.
+ */
+static bool stderr_is_journal(void) {
+    const char *stream = g_getenv("JOURNAL_STREAM");
+    unsigned long long dev, ino;
+    struct stat st;
+
+    if (!stream || sscanf(stream, "%llu:%llu", &dev, &ino) != 2) {
+        return false;
+    }
+    if (fstat(STDERR_FILENO, &st) != 0) {
+        return false;
+    }
+    return (unsigned long long)st.st_dev == dev && (unsigned long long)st.st_ino == ino;
+}
+
 /**
  * Initialize the logger
  */
-int logger_init(bool log_to_file, const char *log_file_path, LogLevel min_level, bool use_syslog) {
+int logger_init(bool log_to_file, const char *log_file_path, LogLevel min_level, bool use_journal) {
     char *default_log_path = NULL;
 
     if (logger_state.initialized) {
@@ -83,15 +590,14 @@ int logger_init(bool log_to_file, const char *log_file_path, LogLevel min_level,
         return -1;
     }
 
-    /* Initialize mutex */
-    g_mutex_init(&logger_state.mutex);
-
-    logger_state.min_level = min_level;
-    logger_state.log_to_file = log_to_file;
-    logger_state.use_syslog = use_syslog;
+    g_atomic_int_set(&logger_current_level, min_level);
+    logger_state.use_journal = use_journal;
+    logger_state.journal_failed = false;
+    logger_state.skip_stderr = use_journal && stderr_is_journal();
+    logger_state.file_fd = -1;
 
-    /* Initialize syslog if requested */
-    if (use_syslog) {
+    /* Syslog is the fallback when there is no journal */
+    if (use_journal) {
         openlog("ovpn-manager", LOG_PID | LOG_CONS, LOG_USER);
     }
 
@@ -110,24 +616,41 @@ int logger_init(bool log_to_file, const char *log_file_path, LogLevel min_level,
         /* Ensure directory exists */
         if (ensure_log_directory(default_log_path) != 0) {
             g_free(default_log_path);
-            g_mutex_clear(&logger_state.mutex);
             return -1;
         }
 
         /* Open log file */
-        logger_state.log_file = fopen(default_log_path, "a");
-        if (!logger_state.log_file) {
+        logger_state.file_fd = open(default_log_path,
+                                    O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (logger_state.file_fd < 0) {
             fprintf(stderr, "Failed to open log file %s: %s\n",
                     default_log_path, strerror(errno));
             g_free(default_log_path);
-            g_mutex_clear(&logger_state.mutex);
             return -1;
         }
 
+        struct stat st;
+        logger_state.file_size = fstat(logger_state.file_fd, &st) == 0 ? st.st_size : 0;
+        logger_state.file_path = default_log_path;
         fprintf(stderr, "Logging to file: %s\n", default_log_path);
-        g_free(default_log_path);
     }
 
+    /* Every slot starts free for the position that maps to it */
+    logger_state.ring = g_new(LogSlot, LOGGER_RING_SLOTS);
+    for (guint i = 0; i < LOGGER_RING_SLOTS; i++) {
+        logger_state.ring[i].seq = i;
+    }
+    logger_state.enqueue_pos = 0;
+    logger_state.dequeue_pos = 0;
+    logger_state.written_pos = 0;
+    logger_state.dropped = 0;
+    logger_state.stopping = 0;
+
+    g_mutex_init(&logger_state.mutex);
+    g_cond_init(&logger_state.wake);
+    g_cond_init(&logger_state.flushed);
+    logger_state.writer = g_thread_new("logger", writer_main, NULL);
+
     logger_state.initialized = true;
 
     logger_info("Logger initialized (min_level=%s, log_to_file=%s)",
@@ -141,165 +664,111 @@ int logger_init(bool log_to_file, const char *log_file_path, LogLevel min_level,
  * Set the minimum log level
  */
 void logger_set_level(LogLevel level) {
-    g_mutex_lock(&logger_state.mutex);
-    logger_state.min_level = level;
-    g_mutex_unlock(&logger_state.mutex);
+    g_atomic_int_set(&logger_current_level, level);
 }
 
 /**
  * Set verbosity level
  */
 void logger_set_verbosity(int level) {
-    g_mutex_lock(&logger_state.mutex);
-    logger_state.verbosity = level;
-    g_mutex_unlock(&logger_state.mutex);
+    g_atomic_int_set(&logger_current_verbosity, level);
 }
 
 /**
- * Get current verbosity level
+ * Enable or disable a log category
  */
-int logger_get_verbosity(void) {
-    int level;
-    g_mutex_lock(&logger_state.mutex);
-    level = logger_state.verbosity;
-    g_mutex_unlock(&logger_state.mutex);
-    return level;
+void logger_set_category(LogCategory category, bool enabled) {
+    if ((unsigned int)category >= LOG_CAT_COUNT) {
+        return;
+    }
+
+    if (enabled) {
+        g_atomic_int_or(&logger_category_mask, 1u << category);
+    } else {
+        g_atomic_int_and(&logger_category_mask, ~(1u << category));
+    }
 }
 
 /**
- * Log a message (generic)
+ * Apply a category list
  */
-void logger_log(LogLevel level, const char *format, ...) {
-    va_list args;
-    char timestamp[32];
-    bool use_color = true;
-
-    if (!logger_state.initialized) {
-        return;
+int logger_set_categories(const char *spec) {
+    if (!spec) {
+        return -EINVAL;
     }
 
-    /* Check log level */
-    if (level < logger_state.min_level) {
-        return;
-    }
-
-    g_mutex_lock(&logger_state.mutex);
+    gchar **names = g_strsplit(spec, ",", -1);
+    unsigned int mask = g_atomic_int_get(&logger_category_mask);
+    int ret = 0;
 
-    /* Get timestamp */
-    get_timestamp(timestamp, sizeof(timestamp));
-
-    /* Log to stderr (with color) */
-    if (use_color) {
-        fprintf(stderr, "%s[%s] [%s%s%s] ",
-                timestamp,
-                "ovpn-manager",
-                log_level_colors[level],
-                log_level_names[level],
-                COLOR_RESET);
-    } else {
-        fprintf(stderr, "%s [%s] [%s] ",
-                timestamp,
-                "ovpn-manager",
-                log_level_names[level]);
-    }
+    for (int i = 0; names[i]; i++) {
+        char *name = g_strstrip(names[i]);
+        bool enable = true;
 
-    va_start(args, format);
-    vfprintf(stderr, format, args);
-    va_end(args);
+        if (*name == '-') {
+            enable = false;
+            name++;
+        } else if (i == 0) {
+            mask = 0;  /* "dbus,fsm" means only those */
+        }
+        if (*name == '\0') {
+            continue;
+        }
 
-    fprintf(stderr, "\n");
-
-    /* Log to file (without color) */
-    if (logger_state.log_to_file && logger_state.log_file) {
-        fprintf(logger_state.log_file, "%s [%s] [%s] ",
-                timestamp,
-                "ovpn-manager",
-                log_level_names[level]);
-
-        va_start(args, format);
-        vfprintf(logger_state.log_file, format, args);
-        va_end(args);
-
-        fprintf(logger_state.log_file, "\n");
-        fflush(logger_state.log_file);
-    }
-
-    /* Log to syslog for WARN and ERROR levels */
-    if (logger_state.use_syslog && level >= LOG_LEVEL_WARN) {
-        int syslog_priority;
-        switch (level) {
-            case LOG_LEVEL_WARN:
-                syslog_priority = LOG_WARNING;
-                break;
-            case LOG_LEVEL_ERROR:
-                syslog_priority = LOG_ERR;
-                break;
-            default:
-                syslog_priority = LOG_INFO;
-                break;
+        unsigned int bits = 0;
+        if (g_ascii_strcasecmp(name, "all") == 0) {
+            bits = (1u << LOG_CAT_COUNT) - 1;
+        } else {
+            for (unsigned int c = 0; c < LOG_CAT_COUNT; c++) {
+                if (g_ascii_strcasecmp(name, log_category_names[c]) == 0) {
+                    bits = 1u << c;
+                    break;
+                }
+            }
         }
 
-        va_start(args, format);
-        vsyslog(syslog_priority, format, args);
-        va_end(args);
+        if (bits == 0) {
+            fprintf(stderr, "Unknown log category '%s'\n", name);
+            ret = -EINVAL;
+            continue;
+        }
+        mask = enable ? (mask | bits) : (mask & ~bits);
     }
 
-    g_mutex_unlock(&logger_state.mutex);
-}
-
-/**
- * Log a debug message
- */
-void logger_debug(const char *format, ...) {
-    va_list args;
-    va_start(args, format);
-
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    logger_log(LOG_LEVEL_DEBUG, "%s", buffer);
-
-    va_end(args);
+    g_strfreev(names);
+    g_atomic_int_set(&logger_category_mask, mask);
+    return ret;
 }
 
 /**
- * Log an info message
+ * Set log file rotation
  */
-void logger_info(const char *format, ...) {
-    va_list args;
-    va_start(args, format);
-
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    logger_log(LOG_LEVEL_INFO, "%s", buffer);
-
-    va_end(args);
+void logger_set_rotation(long long max_bytes, unsigned int keep) {
+    if (logger_state.initialized) {
+        return;  /* The writer owns these once running */
+    }
+    logger_state.rotate_size = max_bytes > 0 ? (off_t)max_bytes : 0;
+    logger_state.rotate_keep = keep;
 }
 
 /**
- * Log a warning message
+ * Write a message (level and category already checked by the caller)
  */
-void logger_warn(const char *format, ...) {
+void logger_write(LogLevel level, LogCategory category, const char *format, ...) {
     va_list args;
     va_start(args, format);
-
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    logger_log(LOG_LEVEL_WARN, "%s", buffer);
-
+    logger_logv(level, category, NULL, format, args);
     va_end(args);
 }
 
 /**
- * Log an error message
+ * Write a message with structured fields
  */
-void logger_error(const char *format, ...) {
+void logger_write_fields(LogLevel level, LogCategory category, const LogFields *fields,
+                         const char *format, ...) {
     va_list args;
     va_start(args, format);
-
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    logger_log(LOG_LEVEL_ERROR, "%s", buffer);
-
+    logger_logv(level, category, fields, format, args);
     va_end(args);
 }
 
@@ -311,26 +780,38 @@ void logger_cleanup(void) {
         return;
     }
 
-    /* Log shutdown message BEFORE acquiring mutex to avoid deadlock */
     logger_info("Logger shutting down");
 
+    /* Write out everything queued, then stop the writer */
+    logger_flush();
+    logger_state.initialized = false;
+
     g_mutex_lock(&logger_state.mutex);
+    g_atomic_int_set(&logger_state.stopping, 1);
+    g_cond_signal(&logger_state.wake);
+    g_mutex_unlock(&logger_state.mutex);
+    g_thread_join(logger_state.writer);
+    logger_state.writer = NULL;
 
     /* Close log file */
-    if (logger_state.log_file) {
-        fclose(logger_state.log_file);
-        logger_state.log_file = NULL;
+    if (logger_state.file_fd >= 0) {
+        close(logger_state.file_fd);
+        logger_state.file_fd = -1;
     }
 
+    g_free(logger_state.file_path);
+    logger_state.file_path = NULL;
+
     /* Close syslog */
-    if (logger_state.use_syslog) {
+    if (logger_state.use_journal) {
         closelog();
-        logger_state.use_syslog = false;
+        logger_state.use_journal = false;
     }
 
-    logger_state.initialized = false;
-    logger_state.log_to_file = false;
+    g_free(logger_state.ring);
+    logger_state.ring = NULL;
 
-    g_mutex_unlock(&logger_state.mutex);
+    g_cond_clear(&logger_state.wake);
+    g_cond_clear(&logger_state.flushed);
     g_mutex_clear(&logger_state.mutex);
 }
@@ -7,7 +7,12 @@
 /**
  * Logger Utility
  *
- * Simple logging system with multiple log levels and optional file output
+ * Simple logging system with multiple log levels and optional file output.
+ * Callers format into a fixed-size ring buffer and return; a background
+ * thread writes batches to stderr, the log file (rotated by size) and the
+ * systemd journal, where messages carry structured fields. If the ring is
+ * full messages are dropped and counted. ERROR messages and
+ * logger_cleanup() wait until everything queued has been written.
  */
 
 typedef enum {
@@ -17,16 +22,77 @@ typedef enum {
     LOG_LEVEL_ERROR = 3
 } LogLevel;
 
+/**
+ * Log categories
+ *
+ * A source file picks its category by defining LOG_CATEGORY before
+ * including this header. DEBUG and INFO messages (and logger_verbose()
+ * guards) of a disabled category are skipped; WARN and ERROR always pass.
+ */
+typedef enum {
+    LOG_CAT_GENERAL = 0,
+    LOG_CAT_DBUS,
+    LOG_CAT_FSM,
+    LOG_CAT_BW,
+    LOG_CAT_UI,
+    LOG_CAT_PING,
+    LOG_CAT_COUNT
+} LogCategory;
+
+#ifndef LOG_CATEGORY
+#define LOG_CATEGORY LOG_CAT_GENERAL
+#endif
+
+/* Lowest level compiled in; set to 1 by the build to drop DEBUG */
+#ifndef LOGGER_COMPILED_MIN_LEVEL
+#define LOGGER_COMPILED_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * Structured fields attached to a message
+ *
+ * Sent to the journal as SESSION_PATH, CONFIG_NAME, FSM_STATE,
+ * DBUS_METHOD and LATENCY_US; unset (NULL / 0) fields are omitted.
+ * Build one in place with LOG_FIELDS(.session_path = path, ...).
+ */
+typedef struct {
+    const char *session_path;
+    const char *config_name;
+    const char *fsm_state;
+    const char *dbus_method;
+    long long latency_us;
+} LogFields;
+
+#define LOG_FIELDS(...) (&(LogFields){ __VA_ARGS__ })
+
+/* Current settings, read by the macros below without locking.
+ * Use the setters to change them. */
+extern int logger_current_level;
+extern int logger_current_verbosity;
+extern unsigned int logger_category_mask;
+
 /**
  * Initialize the logger
  *
  * @param log_to_file If true, also log to file
  * @param log_file_path Path to log file (NULL for default: ~/.local/share/ovpn-manager/app.log)
  * @param min_level Minimum log level to output
- * @param use_syslog If true, send WARN and ERROR messages to syslog
+ * @param use_journal If true, send messages to the systemd journal (WARN and
+ *                    ERROR to syslog if there is no journal)
  * @return 0 on success, negative on error
  */
-int logger_init(bool log_to_file, const char *log_file_path, LogLevel min_level, bool use_syslog);
+int logger_init(bool log_to_file, const char *log_file_path, LogLevel min_level, bool use_journal);
+
+/**
+ * Set log file rotation (call before logger_init)
+ *
+ * Once the file reaches max_bytes it is renamed to .1 (older ones move
+ * up to .<keep>) and a new file is started. Default: 10 MiB, keep 3.
+ *
+ * @param max_bytes Size limit (0 = never rotate)
+ * @param keep Number of old files kept
+ */
+void logger_set_rotation(long long max_bytes, unsigned int keep);
 
 /**
  * Set the minimum log level
@@ -47,36 +113,93 @@ void logger_set_verbosity(int level);
  *
  * @return Current verbosity level
  */
-int logger_get_verbosity(void);
+static inline int logger_get_verbosity(void) {
+    return __atomic_load_n(&logger_current_verbosity, __ATOMIC_RELAXED);
+}
 
 /**
- * Log a message (generic)
+ * Enable or disable a log category
  *
- * @param level Log level
- * @param format Printf-style format string
- * @param ... Format arguments
+ * @param category Category
+ * @param enabled Whether its DEBUG/INFO messages are written
  */
-void logger_log(LogLevel level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+void logger_set_category(LogCategory category, bool enabled);
 
 /**
- * Log a debug message
+ * Apply a category list such as "dbus,fsm" or "all,-ping"
+ *
+ * Names are general, dbus, fsm, bw, ui, ping and all; a leading '-'
+ * disables. A list starting with a plain name first disables everything
+ * else.
+ *
+ * @param spec Comma-separated list
+ * @return 0 on success, -EINVAL on an unknown name (the rest is applied)
  */
-void logger_debug(const char *format, ...) __attribute__((format(printf, 1, 2)));
+int logger_set_categories(const char *spec);
 
 /**
- * Log an info message
+ * Would a message at this level and category be written?
+ */
+static inline bool logger_enabled(LogLevel level, LogCategory category) {
+    if ((int)level < LOGGER_COMPILED_MIN_LEVEL ||
+        (int)level < __atomic_load_n(&logger_current_level, __ATOMIC_RELAXED)) {
+        return false;
+    }
+    return level >= LOG_LEVEL_WARN ||
+           (__atomic_load_n(&logger_category_mask, __ATOMIC_RELAXED) & (1u << category));
+}
+
+/**
+ * Verbosity guard for the current file's category
+ *
+ * Use as: if (logger_verbose(2)) { ... }
  */
-void logger_info(const char *format, ...) __attribute__((format(printf, 1, 2)));
+#define logger_verbose(n) \
+    (logger_get_verbosity() >= (n) && \
+     (__atomic_load_n(&logger_category_mask, __ATOMIC_RELAXED) & (1u << (LOG_CATEGORY))))
 
 /**
- * Log a warning message
+ * Write a message unconditionally (use the macros below)
+ *
+ * @param level Log level
+ * @param category Log category
+ * @param format Printf-style format string
+ * @param ... Format arguments
  */
-void logger_warn(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void logger_write(LogLevel level, LogCategory category, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
 
 /**
- * Log an error message
+ * Write a message with structured fields unconditionally (use logger_log_fields)
  */
-void logger_error(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void logger_write_fields(LogLevel level, LogCategory category, const LogFields *fields,
+                         const char *format, ...) __attribute__((format(printf, 4, 5)));
+
+/*
+ * Logging macros
+ *
+ * The level and category are checked before the arguments are evaluated,
+ * so disabled messages cost one relaxed load. Below
+ * LOGGER_COMPILED_MIN_LEVEL the check is constant and the call is
+ * removed by the compiler (the format is still type-checked).
+ */
+#define logger_log(level, ...) \
+    do { \
+        if (logger_enabled((level), LOG_CATEGORY)) \
+            logger_write((level), LOG_CATEGORY, __VA_ARGS__); \
+    } while (0)
+
+/* Use as: logger_log_fields(LOG_LEVEL_INFO, LOG_FIELDS(.session_path = p), "...", ...) */
+#define logger_log_fields(level, fields, ...) \
+    do { \
+        if (logger_enabled((level), LOG_CATEGORY)) \
+            logger_write_fields((level), LOG_CATEGORY, (fields), __VA_ARGS__); \
+    } while (0)
+
+#define logger_debug(...) logger_log(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define logger_info(...)  logger_log(LOG_LEVEL_INFO, __VA_ARGS__)
+#define logger_warn(...)  logger_log(LOG_LEVEL_WARN, __VA_ARGS__)
+#define logger_error(...) logger_log(LOG_LEVEL_ERROR, __VA_ARGS__)
 
 /**
  * Clean up logger and close log file
@@ -0,0 +1,385 @@
+#include "ovpn_profile.h"
+#include <glib.h>
+#include <string.h>
+
+/**
+ * Whitespace within a line
+ */
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/**
+ * Move to the start of the line after the one ending at eol
+ */
+static void advance_past(OvpnTokenizer *tok, const char *eol) {
+    if (eol < tok->end) {
+        tok->pos = eol + 1;
+        tok->line++;
+    } else {
+        tok->pos = tok->end;
+    }
+}
+
+/**
+ * End of the line starting at p (the '\n', or the buffer end)
+ */
+static const char* line_end(const OvpnTokenizer *tok, const char *p) {
+    const char *eol = memchr(p, '\n', (size_t)(tok->end - p));
+    return eol ? eol : tok->end;
+}
+
+/**
+ * Split [p, eol) into a directive name and arguments
+ */
+static void read_directive(OvpnToken *token, const char *p, const char *eol) {
+    bool have_name = false;
+
+    while (p < eol) {
+        while (p < eol && is_blank(*p)) p++;
+        if (p == eol || *p == '#' || *p == ';') {
+            break;
+        }
+
+        OvpnSpan span;
+        if (*p == '"' || *p == '\'') {
+            char quote = *p++;
+            span.start = p;
+            while (p < eol && *p != quote) {
+                if (quote == '"' && *p == '\\' && p + 1 < eol) {
+                    p++;
+                }
+                p++;
+            }
+            span.len = (size_t)(p - span.start);
+            if (p < eol) p++;  /* Closing quote */
+        } else {
+            span.start = p;
+            while (p < eol && !is_blank(*p)) p++;
+            span.len = (size_t)(p - span.start);
+        }
+
+        if (!have_name) {
+            token->name = span;
+            have_name = true;
+        } else if (token->argc < OVPN_TOKEN_MAX_ARGS) {
+            token->args[token->argc++] = span;
+        }
+    }
+}
+
+/**
+ * Find "</name>" at or after p
+ */
+static const char* find_close_tag(const OvpnTokenizer *tok, const char *p, OvpnSpan name) {
+    while (p < tok->end) {
+        const char *lt = memmem(p, (size_t)(tok->end - p), "</", 2);
+        if (!lt) {
+            return NULL;
+        }
+
+        const char *n = lt + 2;
+        if ((size_t)(tok->end - n) > name.len &&
+            memcmp(n, name.start, name.len) == 0 && n[name.len] == '>') {
+            return lt;
+        }
+        p = n;
+    }
+    return NULL;
+}
+
+/**
+ * Read a "<tag>" line at p; inline blocks are consumed up to their close tag
+ *
+ * @return true if a token was produced
+ */
+static bool read_tag(OvpnTokenizer *tok, OvpnToken *token, const char *p, const char *eol) {
+    const char *gt = memchr(p, '>', (size_t)(eol - p));
+    if (!gt) {
+        advance_past(tok, eol);
+        return false;
+    }
+
+    bool closing = p[1] == '/';
+    token->name.start = p + (closing ? 2 : 1);
+    token->name.len = (size_t)(gt - token->name.start);
+
+    if (closing) {
+        advance_past(tok, eol);
+        if (!ovpn_span_equals(token->name, "connection")) {
+            return false;   /* Stray close tag */
+        }
+        token->kind = OVPN_TOKEN_BLOCK_END;
+        return true;
+    }
+
+    if (ovpn_span_equals(token->name, "connection")) {
+        token->kind = OVPN_TOKEN_BLOCK_START;
+        advance_past(tok, eol);
+        return true;
+    }
+
+    /* Inline file: the body runs from the next line to the close tag */
+    token->kind = OVPN_TOKEN_INLINE;
+    advance_past(tok, eol);
+
+    const char *body = tok->pos;
+    const char *close = find_close_tag(tok, body, token->name);
+    const char *body_end = close ? close : tok->end;
+
+    token->body.start = body;
+    token->body.len = (size_t)(body_end - body);
+
+    for (const char *nl = body; (nl = memchr(nl, '\n', (size_t)(body_end - nl))); nl++) {
+        tok->line++;
+    }
+
+    if (close) {
+        advance_past(tok, line_end(tok, close));
+    } else {
+        tok->pos = tok->end;
+    }
+    return true;
+}
+
+/**
+ * Start tokenizing a buffer
+ */
+void ovpn_tokenizer_init(OvpnTokenizer *tok, const char *buf, size_t len) {
+    tok->pos = buf;
+    tok->end = buf ? buf + len : NULL;
+    tok->line = 1;
+}
+
+/**
+ * Get the next token
+ */
+bool ovpn_tokenizer_next(OvpnTokenizer *tok, OvpnToken *token) {
+    while (tok->pos && tok->pos < tok->end) {
+        const char *p = tok->pos;
+        while (p < tok->end && is_blank(*p)) p++;
+
+        const char *eol = line_end(tok, p);
+        if (p == eol || *p == '#' || *p == ';') {
+            advance_past(tok, eol);
+            continue;
+        }
+
+        memset(token, 0, sizeof(*token));
+        token->line = tok->line;
+
+        if (*p == '<') {
+            if (read_tag(tok, token, p, eol)) {
+                return true;
+            }
+            continue;
+        }
+
+        token->kind = OVPN_TOKEN_DIRECTIVE;
+        read_directive(token, p, eol);
+        advance_past(tok, eol);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Compare a span with a C string
+ */
+bool ovpn_span_equals(OvpnSpan span, const char *str) {
+    size_t len = strlen(str);
+    return span.len == len && memcmp(span.start, str, len) == 0;
+}
+
+/**
+ * Parse a span as a non-negative decimal integer
+ */
+int ovpn_span_to_int(OvpnSpan span) {
+    if (span.len == 0 || span.len > 9) {
+        return -1;
+    }
+
+    int value = 0;
+    for (size_t i = 0; i < span.len; i++) {
+        if (span.start[i] < '0' || span.start[i] > '9') {
+            return -1;
+        }
+        value = value * 10 + (span.start[i] - '0');
+    }
+    return value;
+}
+
+/**
+ * Copy a span into a new string
+ */
+char* ovpn_span_dup(OvpnSpan span) {
+    return g_strndup(span.start, span.len);
+}
+
+/**
+ * Port/proto defaults in effect while parsing
+ */
+typedef struct {
+    int default_port;            /* Global port/rport */
+    OvpnSpan default_proto;      /* Global proto */
+    bool in_connection;
+    guint block_start;           /* First remote of the current <connection> */
+    int block_port;
+    OvpnSpan block_proto;
+} ParseState;
+
+/**
+ * Fill in port/proto that remote lines left unspecified
+ */
+static void apply_remote_defaults(GArray *remotes, guint from, int port, OvpnSpan protocol) {
+    for (guint i = from; i < remotes->len; i++) {
+        OvpnRemote *remote = &g_array_index(remotes, OvpnRemote, i);
+        if (remote->port <= 0 && port > 0) {
+            remote->port = port;
+        }
+        if (!remote->protocol && protocol.start) {
+            remote->protocol = ovpn_span_dup(protocol);
+        }
+    }
+}
+
+/**
+ * Replace a string field with a span's contents
+ */
+static void set_field(char **field, OvpnSpan span) {
+    g_free(*field);
+    *field = ovpn_span_dup(span);
+}
+
+/**
+ * Apply one directive to the profile
+ */
+static void apply_directive(OvpnProfile *profile, GArray *remotes, ParseState *state,
+                            const OvpnToken *token) {
+    OvpnSpan name = token->name;
+    unsigned int argc = token->argc;
+
+    if (ovpn_span_equals(name, "remote") && argc >= 1) {
+        OvpnRemote remote = {0};
+        remote.host = ovpn_span_dup(token->args[0]);
+        remote.port = argc >= 2 ? ovpn_span_to_int(token->args[1]) : 0;
+        remote.protocol = argc >= 3 ? ovpn_span_dup(token->args[2]) : NULL;
+        g_array_append_val(remotes, remote);
+    } else if (ovpn_span_equals(name, "remote-random")) {
+        profile->remote_random = true;
+    } else if (ovpn_span_equals(name, "proto") && argc >= 1) {
+        if (state->in_connection) {
+            state->block_proto = token->args[0];
+        } else {
+            state->default_proto = token->args[0];
+        }
+    } else if ((ovpn_span_equals(name, "port") || ovpn_span_equals(name, "rport")) && argc >= 1) {
+        if (state->in_connection) {
+            state->block_port = ovpn_span_to_int(token->args[0]);
+        } else {
+            state->default_port = ovpn_span_to_int(token->args[0]);
+        }
+    } else if (ovpn_span_equals(name, "dev") && argc >= 1) {
+        set_field(&profile->dev, token->args[0]);
+    } else if (ovpn_span_equals(name, "cipher") && argc >= 1) {
+        set_field(&profile->cipher, token->args[0]);
+    } else if ((ovpn_span_equals(name, "data-ciphers") ||
+                ovpn_span_equals(name, "ncp-ciphers")) && argc >= 1) {
+        set_field(&profile->data_ciphers, token->args[0]);
+    } else if (ovpn_span_equals(name, "auth") && argc >= 1) {
+        set_field(&profile->auth, token->args[0]);
+    } else if (ovpn_span_equals(name, "comp-lzo")) {
+        g_clear_pointer(&profile->compression, g_free);
+        if (argc == 0 || !ovpn_span_equals(token->args[0], "no")) {
+            profile->compression = g_strdup("lzo");
+        }
+    } else if (ovpn_span_equals(name, "compress")) {
+        g_free(profile->compression);
+        profile->compression = argc >= 1 ? ovpn_span_dup(token->args[0]) : g_strdup("stub");
+    } else if (ovpn_span_equals(name, "route-nopull")) {
+        profile->route_nopull = true;
+    } else if (ovpn_span_equals(name, "tun-mtu") && argc >= 1) {
+        profile->tun_mtu = ovpn_span_to_int(token->args[0]);
+    } else if (ovpn_span_equals(name, "link-mtu") && argc >= 1) {
+        profile->link_mtu = ovpn_span_to_int(token->args[0]);
+    } else if (ovpn_span_equals(name, "fragment") && argc >= 1) {
+        profile->fragment = ovpn_span_to_int(token->args[0]);
+    } else if (ovpn_span_equals(name, "mssfix")) {
+        profile->mssfix = argc >= 1 ? ovpn_span_to_int(token->args[0]) : -1;
+    }
+}
+
+/**
+ * Parse a profile
+ */
+OvpnProfile* ovpn_profile_parse(const char *buf, size_t len) {
+    OvpnProfile *profile = g_malloc0(sizeof(OvpnProfile));
+    if (!buf) {
+        return profile;
+    }
+
+    GArray *remotes = g_array_new(FALSE, TRUE, sizeof(OvpnRemote));
+    ParseState state = {0};
+    OvpnTokenizer tok;
+    OvpnToken token;
+
+    ovpn_tokenizer_init(&tok, buf, len);
+    while (ovpn_tokenizer_next(&tok, &token)) {
+        switch (token.kind) {
+        case OVPN_TOKEN_DIRECTIVE:
+            apply_directive(profile, remotes, &state, &token);
+            break;
+        case OVPN_TOKEN_BLOCK_START:
+            state.in_connection = true;
+            state.block_start = remotes->len;
+            state.block_port = 0;
+            state.block_proto = (OvpnSpan){ NULL, 0 };
+            break;
+        case OVPN_TOKEN_BLOCK_END:
+            if (state.in_connection) {
+                apply_remote_defaults(remotes, state.block_start,
+                                      state.block_port, state.block_proto);
+                state.in_connection = false;
+            }
+            break;
+        case OVPN_TOKEN_INLINE:
+            profile->inline_blocks++;
+            break;
+        }
+    }
+
+    /* Global defaults, then OpenVPN's own */
+    apply_remote_defaults(remotes, 0, state.default_port, state.default_proto);
+    apply_remote_defaults(remotes, 0, 1194, (OvpnSpan){ "udp", 3 });
+
+    if (state.default_proto.start) {
+        profile->proto = ovpn_span_dup(state.default_proto);
+    }
+
+    profile->remote_count = remotes->len;
+    profile->remotes = (OvpnRemote *)g_array_free(remotes, profile->remote_count == 0);
+
+    return profile;
+}
+
+/**
+ * Free a profile
+ */
+void ovpn_profile_free(OvpnProfile *profile) {
+    if (!profile) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < profile->remote_count; i++) {
+        g_free(profile->remotes[i].host);
+        g_free(profile->remotes[i].protocol);
+    }
+    g_free(profile->remotes);
+    g_free(profile->proto);
+    g_free(profile->dev);
+    g_free(profile->cipher);
+    g_free(profile->data_ciphers);
+    g_free(profile->auth);
+    g_free(profile->compression);
+    g_free(profile);
+}
@@ -0,0 +1,157 @@
+#ifndef OVPN_PROFILE_H
+#define OVPN_PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * OpenVPN Profile Parser
+ *
+ * A streaming tokenizer that walks a .ovpn buffer once and yields
+ * directives as spans into the buffer (no copies, no allocation), plus a
+ * structured OvpnProfile built on top of it. Inline blocks such as <ca>
+ * or <tls-crypt> are skipped by scanning straight to their closing tag.
+ */
+
+/* Maximum arguments kept per directive; extra arguments are dropped */
+#define OVPN_TOKEN_MAX_ARGS 8
+
+/**
+ * A slice of the profile buffer (not NUL-terminated)
+ */
+typedef struct {
+    const char *start;
+    size_t len;
+} OvpnSpan;
+
+/**
+ * Token kinds
+ */
+typedef enum {
+    OVPN_TOKEN_DIRECTIVE,        /* "name arg..." line */
+    OVPN_TOKEN_BLOCK_START,      /* <connection> */
+    OVPN_TOKEN_BLOCK_END,        /* </connection> */
+    OVPN_TOKEN_INLINE            /* <tag>...</tag> inline file, body in .body */
+} OvpnTokenKind;
+
+/**
+ * One token
+ */
+typedef struct {
+    OvpnTokenKind kind;
+    OvpnSpan name;                           /* Directive or tag name */
+    OvpnSpan args[OVPN_TOKEN_MAX_ARGS];      /* Arguments, quotes removed */
+    unsigned int argc;
+    OvpnSpan body;                           /* Inline block contents */
+    unsigned int line;                       /* 1-based line of the token */
+} OvpnToken;
+
+/**
+ * Tokenizer state; lives on the caller's stack
+ */
+typedef struct {
+    const char *pos;
+    const char *end;
+    unsigned int line;
+} OvpnTokenizer;
+
+/**
+ * Start tokenizing a buffer
+ *
+ * @param tok Tokenizer
+ * @param buf Profile contents (must outlive the tokens)
+ * @param len Length of buf in bytes
+ */
+void ovpn_tokenizer_init(OvpnTokenizer *tok, const char *buf, size_t len);
+
+/**
+ * Get the next token
+ *
+ * Comments, blank lines and trailing "# ..." comments are skipped.
+ * Quoted arguments are returned without their quotes; escape sequences
+ * inside them are left as written.
+ *
+ * @param tok Tokenizer
+ * @param token Output token (spans point into the buffer)
+ * @return true if a token was produced, false at end of buffer
+ */
+bool ovpn_tokenizer_next(OvpnTokenizer *tok, OvpnToken *token);
+
+/**
+ * Compare a span with a C string
+ *
+ * @param span Span
+ * @param str NUL-terminated string
+ * @return true if equal
+ */
+bool ovpn_span_equals(OvpnSpan span, const char *str);
+
+/**
+ * Parse a span as a non-negative decimal integer
+ *
+ * @param span Span
+ * @return Value, or -1 if the span is not a number
+ */
+int ovpn_span_to_int(OvpnSpan span);
+
+/**
+ * Copy a span into a new string
+ *
+ * @param span Span
+ * @return Newly allocated string (free with g_free)
+ */
+char* ovpn_span_dup(OvpnSpan span);
+
+/**
+ * One remote endpoint
+ */
+typedef struct {
+    char *host;              /* Hostname or IP */
+    int port;                /* Port, defaults applied */
+    char *protocol;          /* Protocol, defaults applied */
+} OvpnRemote;
+
+/**
+ * Settings of a profile that the UI cares about
+ */
+typedef struct {
+    OvpnRemote *remotes;     /* In profile order */
+    unsigned int remote_count;
+    bool remote_random;
+
+    char *proto;             /* Global "proto", or NULL */
+    char *dev;               /* "dev" (tun/tap/...), or NULL */
+    char *cipher;            /* "cipher", or NULL */
+    char *data_ciphers;      /* "data-ciphers" / "ncp-ciphers", or NULL */
+    char *auth;              /* "auth" digest, or NULL */
+    char *compression;       /* "lzo", "lz4", "stub"..., or NULL if off */
+    bool route_nopull;
+
+    int tun_mtu;             /* 0 if unset */
+    int link_mtu;            /* 0 if unset */
+    int fragment;            /* 0 if unset */
+    int mssfix;              /* 0 if unset, -1 for OpenVPN's default */
+
+    unsigned int inline_blocks; /* Inline files skipped (<ca>, <cert>...) */
+} OvpnProfile;
+
+/**
+ * Parse a profile
+ *
+ * Remotes without an explicit port/proto inherit the enclosing
+ * <connection> block's, then the global ones, then 1194/udp.
+ *
+ * @param buf Profile contents
+ * @param len Length of buf in bytes
+ * @return New profile (never NULL; free with ovpn_profile_free)
+ */
+OvpnProfile* ovpn_profile_parse(const char *buf, size_t len);
+
+/**
+ * Free a profile
+ *
+ * @param profile Profile to free
+ */
+void ovpn_profile_free(OvpnProfile *profile);
+
+#endif /* OVPN_PROFILE_H */
@@ -0,0 +1,441 @@
+#include "scheduler.h"
+#include "logger.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Wakeups with at least this much slack on every due job use second timers */
+#define SCHED_SECONDS_TOLERANCE_MS  1000
+/* How long the power supply reading is trusted */
+#define SCHED_BATTERY_CACHE_US      (60 * G_USEC_PER_SEC)
+#define SCHED_POWER_SUPPLY_DIR      "/sys/class/power_supply"
+
+/**
+ * Registered job
+ */
+typedef struct {
+    guint id;
+    char *name;
+    guint period_ms[SCHED_ACTIVITY_COUNT];
+    guint tolerance_ms;
+    SchedPriority priority;
+    SchedJobFunc func;
+    gpointer user_data;
+
+    gint64 last_run_us;             /* Period anchor: due time of the last run, or registration */
+    gint64 next_due_us;             /* 0 while suspended */
+    bool removed;                   /* Freed once no wakeup is running */
+
+    SchedJobStats stats;
+} SchedJob;
+
+/**
+ * Scheduler state (main thread only)
+ */
+static struct {
+    GPtrArray *jobs;                /* SchedJob* (owned) */
+    guint next_id;
+    guint timer_id;
+    bool running;                   /* Inside a wakeup */
+    bool activity_stale;            /* Update requested during a wakeup */
+    guint64 wakeups;
+
+    SchedActivity activity;
+    SchedActivityFunc activity_func;
+    gpointer activity_data;
+
+    gint64 battery_checked_us;
+    bool on_battery;
+} sched = {
+    .activity = SCHED_ACTIVITY_NORMAL
+};
+
+static void rearm(void);
+
+/* ──── Jobs ──── */
+
+static SchedJob *find_job(guint id) {
+    if (!sched.jobs || id == 0) {
+        return NULL;
+    }
+
+    for (guint i = 0; i < sched.jobs->len; i++) {
+        SchedJob *job = g_ptr_array_index(sched.jobs, i);
+        if (job->id == id && !job->removed) {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+static void job_free(gpointer data) {
+    SchedJob *job = data;
+    g_free(job->name);
+    g_free(job);
+}
+
+/**
+ * Set the next due time from the last run and the current period
+ */
+static void job_reschedule(SchedJob *job) {
+    guint period = job->period_ms[sched.activity];
+    job->next_due_us = period ? job->last_run_us + (gint64)period * 1000 : 0;
+}
+
+/**
+ * Free removed jobs; only outside a wakeup
+ */
+static void purge_removed(void) {
+    for (guint i = sched.jobs->len; i > 0; i--) {
+        SchedJob *job = g_ptr_array_index(sched.jobs, i - 1);
+        if (job->removed) {
+            g_ptr_array_remove_index(sched.jobs, i - 1);
+        }
+    }
+}
+
+/* ──── Activity ──── */
+
+/**
+ * Re-evaluate the activity level; jobs whose period changed move to
+ * one new period after their last run
+ *
+ * @return true if the activity changed
+ */
+static bool update_activity(void) {
+    if (!sched.activity_func || !sched.jobs) {
+        return false;
+    }
+
+    SchedActivity activity = sched.activity_func(sched.activity_data);
+    if (activity >= SCHED_ACTIVITY_COUNT || activity == sched.activity) {
+        return false;
+    }
+
+    if (logger_verbose(2)) {
+        static const char *const names[] = { "active", "normal", "idle" };
+        logger_debug("Scheduler: activity %s -> %s",
+                     names[sched.activity], names[activity]);
+    }
+    sched.activity = activity;
+
+    for (guint i = 0; i < sched.jobs->len; i++) {
+        SchedJob *job = g_ptr_array_index(sched.jobs, i);
+        if (!job->removed) {
+            job_reschedule(job);
+        }
+    }
+    return true;
+}
+
+/* ──── Wakeups ──── */
+
+static gint compare_due_jobs(gconstpointer a, gconstpointer b) {
+    const SchedJob *ja = *(const SchedJob *const *)a;
+    const SchedJob *jb = *(const SchedJob *const *)b;
+
+    if (ja->priority != jb->priority) {
+        return ja->priority < jb->priority ? -1 : 1;
+    }
+    if (ja->next_due_us != jb->next_due_us) {
+        return ja->next_due_us < jb->next_due_us ? -1 : 1;
+    }
+    return ja->id < jb->id ? -1 : 1;
+}
+
+static void run_job(SchedJob *job) {
+    gint64 due = job->next_due_us;
+    gint64 start = g_get_monotonic_time();
+    gint64 late = start - due;
+
+    gboolean keep = job->func(job->user_data);
+
+    gint64 elapsed = g_get_monotonic_time() - start;
+    job->stats.runs++;
+    job->stats.total_us += elapsed;
+    job->stats.last_us = elapsed;
+    job->stats.total_late_us += late;
+    if (elapsed > job->stats.max_us) {
+        job->stats.max_us = elapsed;
+    }
+
+    if (keep == G_SOURCE_REMOVE) {
+        job->removed = true;
+        return;
+    }
+
+    /* The callback may have removed itself or changed its period.
+     * Anchoring on the due time keeps coalescing delays from adding up;
+     * after a long stall the schedule restarts from now instead of
+     * running a burst of missed periods. */
+    if (!job->removed) {
+        guint period = job->period_ms[sched.activity];
+        job->last_run_us = late < (gint64)period * 1000 ? due : start;
+        job_reschedule(job);
+    }
+}
+
+static gboolean on_wakeup(gpointer user_data) {
+    (void)user_data;
+
+    sched.timer_id = 0;
+    sched.wakeups++;
+    update_activity();
+
+    /* Everything whose window has opened runs now */
+    gint64 now = g_get_monotonic_time();
+    GPtrArray *due = g_ptr_array_new();
+    for (guint i = 0; i < sched.jobs->len; i++) {
+        SchedJob *job = g_ptr_array_index(sched.jobs, i);
+        if (!job->removed && job->next_due_us &&
+            job->next_due_us - (gint64)job->tolerance_ms * 1000 <= now) {
+            g_ptr_array_add(due, job);
+        }
+    }
+    g_ptr_array_sort(due, compare_due_jobs);
+
+    sched.running = true;
+    for (guint i = 0; i < due->len; i++) {
+        SchedJob *job = g_ptr_array_index(due, i);
+        if (!job->removed) {
+            run_job(job);
+        }
+    }
+    sched.running = false;
+    g_ptr_array_free(due, TRUE);
+
+    if (sched.activity_stale) {
+        sched.activity_stale = false;
+        update_activity();
+    }
+    purge_removed();
+    rearm();
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Arm the timer for the next wakeup
+ *
+ * The wakeup lands at the earliest deadline (due + tolerance) of any
+ * job, which is as late as possible and so picks up the most other jobs
+ * whose window has opened by then. If every one of those tolerates a
+ * second, a second timer aimed just before the deadline is used instead.
+ */
+static void rearm(void) {
+    if (sched.timer_id) {
+        g_source_remove(sched.timer_id);
+        sched.timer_id = 0;
+    }
+    if (!sched.jobs) {
+        return;
+    }
+
+    gint64 deadline = G_MAXINT64;
+    for (guint i = 0; i < sched.jobs->len; i++) {
+        SchedJob *job = g_ptr_array_index(sched.jobs, i);
+        if (!job->removed && job->next_due_us) {
+            deadline = MIN(deadline, job->next_due_us + (gint64)job->tolerance_ms * 1000);
+        }
+    }
+    if (deadline == G_MAXINT64) {
+        return;
+    }
+
+    bool coarse = true;
+    for (guint i = 0; i < sched.jobs->len && coarse; i++) {
+        SchedJob *job = g_ptr_array_index(sched.jobs, i);
+        if (!job->removed && job->next_due_us &&
+            job->next_due_us - (gint64)job->tolerance_ms * 1000 <= deadline &&
+            job->tolerance_ms < SCHED_SECONDS_TOLERANCE_MS) {
+            coarse = false;
+        }
+    }
+
+    gint64 delay_ms = MAX(0, (deadline - g_get_monotonic_time()) / 1000);
+
+    /* A second timer fires up to a second after its interval */
+    if (coarse && delay_ms >= 2000) {
+        sched.timer_id = g_timeout_add_seconds((guint)(delay_ms / 1000 - 1), on_wakeup, NULL);
+    } else {
+        sched.timer_id = g_timeout_add((guint)delay_ms, on_wakeup, NULL);
+    }
+}
+
+/* ──── Public API ──── */
+
+guint scheduler_add(const SchedJobSpec *spec, SchedJobFunc func, gpointer user_data) {
+    if (!spec || !func) {
+        return 0;
+    }
+
+    if (!sched.jobs) {
+        sched.jobs = g_ptr_array_new_with_free_func(job_free);
+    }
+
+    SchedJob *job = g_malloc0(sizeof(SchedJob));
+    job->id = ++sched.next_id;
+    job->name = g_strdup(spec->name ? spec->name : "job");
+    memcpy(job->period_ms, spec->period_ms, sizeof(job->period_ms));
+    job->tolerance_ms = spec->tolerance_ms;
+    job->priority = spec->priority;
+    job->func = func;
+    job->user_data = user_data;
+    job->last_run_us = g_get_monotonic_time();
+    job_reschedule(job);
+
+    g_ptr_array_add(sched.jobs, job);
+    if (!sched.running) {
+        rearm();
+    }
+    return job->id;
+}
+
+void scheduler_remove(guint id) {
+    SchedJob *job = find_job(id);
+    if (!job) {
+        return;
+    }
+
+    job->removed = true;
+    if (!sched.running) {
+        purge_removed();
+        rearm();
+    }
+}
+
+void scheduler_set_period(guint id, guint period_ms) {
+    SchedJob *job = find_job(id);
+    if (!job) {
+        return;
+    }
+
+    for (int i = 0; i < SCHED_ACTIVITY_COUNT; i++) {
+        job->period_ms[i] = period_ms;
+    }
+    job_reschedule(job);
+    if (!sched.running) {
+        rearm();
+    }
+}
+
+void scheduler_set_activity_func(SchedActivityFunc func, gpointer user_data) {
+    sched.activity_func = func;
+    sched.activity_data = user_data;
+}
+
+void scheduler_update_activity(void) {
+    /* Jobs queued in a running wakeup keep their due times until it ends */
+    if (sched.running) {
+        sched.activity_stale = true;
+    } else if (update_activity()) {
+        rearm();
+    }
+}
+
+SchedActivity scheduler_get_activity(void) {
+    return sched.activity;
+}
+
+/**
+ * Read a one-line sysfs attribute of a power supply
+ */
+static bool read_supply_attr(const char *supply, const char *attr, char *buf, size_t size) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s/%s", SCHED_POWER_SUPPLY_DIR, supply, attr);
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    bool ok = fgets(buf, (int)size, f) != NULL;
+    fclose(f);
+    if (ok) {
+        buf[strcspn(buf, "\n")] = '\0';
+    }
+    return ok;
+}
+
+bool scheduler_on_battery(void) {
+    gint64 now = g_get_monotonic_time();
+    if (sched.battery_checked_us && now - sched.battery_checked_us < SCHED_BATTERY_CACHE_US) {
+        return sched.on_battery;
+    }
+    sched.battery_checked_us = now;
+
+    GDir *dir = g_dir_open(SCHED_POWER_SUPPLY_DIR, 0, NULL);
+    if (!dir) {
+        sched.on_battery = false;
+        return false;
+    }
+
+    /* Any online external supply (Mains, USB, ...) means not on battery */
+    bool battery = false;
+    bool external = false;
+    const char *supply;
+    while ((supply = g_dir_read_name(dir)) != NULL) {
+        char type[32], online[8];
+        if (!read_supply_attr(supply, "type", type, sizeof(type))) {
+            continue;
+        }
+        if (strcmp(type, "Battery") == 0) {
+            battery = true;
+        } else if (read_supply_attr(supply, "online", online, sizeof(online)) &&
+                   strcmp(online, "1") == 0) {
+            external = true;
+        }
+    }
+    g_dir_close(dir);
+
+    sched.on_battery = battery && !external;
+    return sched.on_battery;
+}
+
+bool scheduler_get_stats(guint id, SchedJobStats *stats) {
+    SchedJob *job = find_job(id);
+    if (!job || !stats) {
+        return false;
+    }
+
+    *stats = job->stats;
+    return true;
+}
+
+void scheduler_log_stats(void) {
+    if (!sched.jobs) {
+        return;
+    }
+
+    logger_info("Scheduler: %" G_GUINT64_FORMAT " wakeups", sched.wakeups);
+    for (guint i = 0; i < sched.jobs->len; i++) {
+        SchedJob *job = g_ptr_array_index(sched.jobs, i);
+        if (job->removed) {
+            continue;
+        }
+
+        const SchedJobStats *s = &job->stats;
+        gint64 runs = (gint64)MAX(s->runs, 1);
+        logger_info("Scheduler: %-10s %6" G_GUINT64_FORMAT " runs, avg %.2f ms, "
+                    "max %.2f ms, avg lateness %+.1f ms",
+                    job->name, s->runs,
+                    s->total_us / (double)runs / 1000.0,
+                    s->max_us / 1000.0,
+                    s->total_late_us / (double)runs / 1000.0);
+    }
+}
+
+void scheduler_cleanup(void) {
+    if (logger_verbose(1)) {
+        scheduler_log_stats();
+    }
+
+    if (sched.timer_id) {
+        g_source_remove(sched.timer_id);
+        sched.timer_id = 0;
+    }
+    if (sched.jobs) {
+        g_ptr_array_free(sched.jobs, TRUE);
+        sched.jobs = NULL;
+    }
+    sched.activity_func = NULL;
+    sched.activity_data = NULL;
+    sched.activity = SCHED_ACTIVITY_NORMAL;
+}
@@ -0,0 +1,168 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <glib.h>
+#include <stdbool.h>
+
+/**
+ * Periodic Job Scheduler
+ *
+ * One main-loop timer drives every periodic job in the process. Jobs
+ * declare a period and a tolerance; each wakeup runs every job whose
+ * window [due - tolerance, due + tolerance] it falls in, so jobs with
+ * compatible rates share wakeups instead of each waking the process on
+ * its own. Wakeups whose jobs all tolerate a second or more are
+ * scheduled with g_timeout_add_seconds() to line up with the rest of
+ * the session's timers.
+ *
+ * A job can have a different period per activity level. The activity
+ * is re-evaluated on every wakeup through an optional callback, and
+ * whenever scheduler_update_activity() signals that it may have changed;
+ * a change reschedules the jobs straight away.
+ *
+ * Main thread only.
+ */
+
+/**
+ * Activity level, selecting each job's period
+ */
+typedef enum {
+    SCHED_ACTIVITY_ACTIVE,      /* Something is changing (connecting) */
+    SCHED_ACTIVITY_NORMAL,
+    SCHED_ACTIVITY_IDLE,        /* Nothing to watch, or on battery */
+    SCHED_ACTIVITY_COUNT
+} SchedActivity;
+
+/**
+ * Order of jobs within one wakeup
+ */
+typedef enum {
+    SCHED_PRIORITY_HIGH,        /* User-visible updates */
+    SCHED_PRIORITY_NORMAL,
+    SCHED_PRIORITY_LOW          /* Background work */
+} SchedPriority;
+
+/**
+ * Job description
+ */
+typedef struct {
+    const char *name;                          /* For stats and logs */
+    guint period_ms[SCHED_ACTIVITY_COUNT];     /* Per activity; 0 suspends the job */
+    guint tolerance_ms;                        /* Allowed deviation from the due time */
+    SchedPriority priority;
+} SchedJobSpec;
+
+/* Same period at every activity level */
+#define SCHED_PERIOD(ms) { (ms), (ms), (ms) }
+
+/**
+ * Job callback
+ *
+ * @param user_data Data passed to scheduler_add
+ * @return G_SOURCE_CONTINUE to keep the job, G_SOURCE_REMOVE to drop it
+ */
+typedef gboolean (*SchedJobFunc)(gpointer user_data);
+
+/**
+ * Called on every wakeup to pick the activity level
+ *
+ * @param user_data Data passed to scheduler_set_activity_func
+ * @return Activity level
+ */
+typedef SchedActivity (*SchedActivityFunc)(gpointer user_data);
+
+/**
+ * Per-job run statistics
+ */
+typedef struct {
+    guint64 runs;
+    gint64 total_us;                           /* Time spent in the callback */
+    gint64 max_us;
+    gint64 last_us;
+    gint64 total_late_us;                      /* Sum of run time minus due time */
+} SchedJobStats;
+
+/**
+ * Register a periodic job
+ *
+ * The first run is one period from now.
+ *
+ * @param spec Job description (copied; name is duplicated)
+ * @param func Callback
+ * @param user_data Data passed to func
+ * @return Job id (> 0), or 0 on invalid arguments
+ */
+guint scheduler_add(const SchedJobSpec *spec, SchedJobFunc func, gpointer user_data);
+
+/**
+ * Remove a job
+ *
+ * Safe from within any job's callback.
+ *
+ * @param id Job id
+ */
+void scheduler_remove(guint id);
+
+/**
+ * Change a job's period at every activity level
+ *
+ * The next run moves to one new period after the last run.
+ *
+ * @param id Job id
+ * @param period_ms New period (0 suspends the job)
+ */
+void scheduler_set_period(guint id, guint period_ms);
+
+/**
+ * Set the activity callback
+ *
+ * @param func Callback (NULL for always NORMAL)
+ * @param user_data Data passed to func
+ */
+void scheduler_set_activity_func(SchedActivityFunc func, gpointer user_data);
+
+/**
+ * Re-evaluate the activity level now instead of at the next wakeup
+ *
+ * Call when something the activity callback looks at has changed. Jobs
+ * whose period shrinks and are already past their new due time run on
+ * the next main loop iteration.
+ */
+void scheduler_update_activity(void);
+
+/**
+ * Get the current activity level
+ *
+ * @return Activity level as of the last wakeup or update
+ */
+SchedActivity scheduler_get_activity(void);
+
+/**
+ * Check whether the machine runs on battery
+ *
+ * Reads /sys/class/power_supply, cached for a minute.
+ *
+ * @return true if no mains supply is online and a battery is present
+ */
+bool scheduler_on_battery(void);
+
+/**
+ * Get a job's run statistics
+ *
+ * @param id Job id
+ * @param stats Output statistics
+ * @return true if the job exists
+ */
+bool scheduler_get_stats(guint id, SchedJobStats *stats);
+
+/**
+ * Log the statistics of all jobs and the wakeup count
+ */
+void scheduler_log_stats(void);
+
+/**
+ * Remove all jobs and stop the timer
+ */
+void scheduler_cleanup(void);
+
+#endif /* SCHEDULER_H */
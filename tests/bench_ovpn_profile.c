@@ -0,0 +1,290 @@
+/**
+ * Profile parser benchmark
+ *
+ * Times ovpn_profile_parse against the line-splitting parser it replaced
+ * on generated profiles of about 100 KB: a few dozen remotes, a
+ * <connection> block and inline certificates, keys and tls-crypt. Both
+ * parsers must agree on the remotes, or the run fails.
+ *
+ * Usage: bench_ovpn_profile [iterations]
+ */
+#include "utils/ovpn_profile.h"
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DEFAULT_ITERATIONS 200
+#define BENCH_PROFILE_BYTES (100 * 1024)
+#define BENCH_REMOTES 32
+
+/**
+ * Remotes found by the legacy parser
+ */
+typedef struct {
+    OvpnRemote *remotes;
+    unsigned int remote_count;
+    bool remote_random;
+} LegacyProfile;
+
+/* --- Legacy parser, as in config_client.c before the tokenizer --- */
+
+static void apply_remote_defaults(GArray *remotes, guint from, int port, const char *protocol) {
+    for (guint i = from; i < remotes->len; i++) {
+        OvpnRemote *remote = &g_array_index(remotes, OvpnRemote, i);
+        if (remote->port <= 0 && port > 0) {
+            remote->port = port;
+        }
+        if (!remote->protocol && protocol) {
+            remote->protocol = g_strdup(protocol);
+        }
+    }
+}
+
+static void legacy_parse(const char *config_content, LegacyProfile *config) {
+    config->remotes = NULL;
+    config->remote_count = 0;
+    config->remote_random = false;
+
+    /* Split config into lines */
+    char **lines = g_strsplit(config_content, "\n", -1);
+    if (!lines) {
+        return;
+    }
+
+    GArray *remotes = g_array_new(FALSE, TRUE, sizeof(OvpnRemote));
+    int default_port = 0;
+    char *default_proto = NULL;
+    bool in_connection = false;
+    guint block_start = 0;
+    int block_port = 0;
+    char *block_proto = NULL;
+    char *inline_end = NULL;     /* Closing tag of the inline block being skipped */
+
+    for (int i = 0; lines[i] != NULL; i++) {
+        char *line = g_strstrip(lines[i]);
+
+        /* Skip comments and empty lines */
+        if (line[0] == '#' || line[0] == ';' || line[0] == '\0') {
+            continue;
+        }
+
+        if (inline_end) {
+            if (g_ascii_strcasecmp(line, inline_end) == 0) {
+                g_clear_pointer(&inline_end, g_free);
+            }
+            continue;
+        }
+
+        if (line[0] == '<') {
+            if (g_ascii_strcasecmp(line, "<connection>") == 0) {
+                in_connection = true;
+                block_start = remotes->len;
+                block_port = 0;
+                g_clear_pointer(&block_proto, g_free);
+            } else if (g_ascii_strcasecmp(line, "</connection>") == 0) {
+                apply_remote_defaults(remotes, block_start, block_port, block_proto);
+                in_connection = false;
+            } else if (line[1] != '/') {
+                inline_end = g_strdup_printf("</%s", line + 1);
+            }
+            continue;
+        }
+
+        /* Tokenize: directive plus up to three arguments */
+        char **parts = g_strsplit_set(line, " \t", -1);
+        const char *argv[4] = { NULL, NULL, NULL, NULL };
+        int argc = 0;
+        for (int j = 0; parts[j] != NULL && argc < 4; j++) {
+            if (parts[j][0] != '\0') {
+                argv[argc++] = parts[j];
+            }
+        }
+
+        if (argc >= 2 && strcmp(argv[0], "remote") == 0) {
+            OvpnRemote remote = {0};
+            remote.host = g_strdup(argv[1]);
+            remote.port = argc >= 3 ? atoi(argv[2]) : 0;
+            remote.protocol = argc >= 4 ? g_strdup(argv[3]) : NULL;
+            g_array_append_val(remotes, remote);
+        } else if (argc >= 1 && strcmp(argv[0], "remote-random") == 0) {
+            config->remote_random = true;
+        } else if (argc >= 2 && strcmp(argv[0], "proto") == 0) {
+            char **target = in_connection ? &block_proto : &default_proto;
+            g_free(*target);
+            *target = g_strdup(argv[1]);
+        } else if (argc >= 2 && (strcmp(argv[0], "port") == 0 ||
+                                 strcmp(argv[0], "rport") == 0)) {
+            if (in_connection) {
+                block_port = atoi(argv[1]);
+            } else {
+                default_port = atoi(argv[1]);
+            }
+        }
+
+        g_strfreev(parts);
+    }
+
+    /* Global defaults, then OpenVPN's own */
+    apply_remote_defaults(remotes, 0, default_port, default_proto);
+    apply_remote_defaults(remotes, 0, 1194, "udp");
+
+    g_free(inline_end);
+    g_free(block_proto);
+    g_free(default_proto);
+    g_strfreev(lines);
+
+    config->remote_count = remotes->len;
+    config->remotes = (OvpnRemote *)g_array_free(remotes, FALSE);
+}
+
+static void legacy_free(LegacyProfile *config) {
+    for (unsigned int i = 0; i < config->remote_count; i++) {
+        g_free(config->remotes[i].host);
+        g_free(config->remotes[i].protocol);
+    }
+    g_free(config->remotes);
+}
+
+/* --- Benchmark --- */
+
+/**
+ * Append an inline block of base64-looking lines
+ */
+static void append_inline(GString *out, const char *tag, size_t bytes, GRand *rand) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    g_string_append_printf(out, "<%s>\n-----BEGIN %s-----\n", tag, tag);
+    for (size_t written = 0; written < bytes; written += 65) {
+        for (int i = 0; i < 64; i++) {
+            g_string_append_c(out, alphabet[g_rand_int_range(rand, 0, 64)]);
+        }
+        g_string_append_c(out, '\n');
+    }
+    g_string_append_printf(out, "-----END %s-----\n</%s>\n", tag, tag);
+}
+
+/**
+ * Build a profile of about BENCH_PROFILE_BYTES
+ */
+static char* build_profile(void) {
+    GRand *rand = g_rand_new_with_seed(0x0b5e55ed);
+    GString *out = g_string_sized_new(BENCH_PROFILE_BYTES + 4096);
+
+    g_string_append(out,
+        "# Generated benchmark profile\n"
+        "client\n"
+        "dev tun\n"
+        "proto udp\n"
+        "port 1194\n"
+        "remote-random\n"
+        "resolv-retry infinite\n"
+        "nobind\n"
+        "cipher AES-256-GCM\n"
+        "data-ciphers AES-256-GCM:CHACHA20-POLY1305\n"
+        "auth SHA256\n"
+        "tun-mtu 1500\n"
+        "mssfix 1450\n"
+        "verb 3\n");
+
+    for (int i = 0; i < BENCH_REMOTES; i++) {
+        if (i % 3 == 0) {
+            g_string_append_printf(out, "remote vpn%02d.example.net\n", i);
+        } else {
+            g_string_append_printf(out, "remote 198.51.100.%d %d %s  ; server %d\n",
+                                   i + 1, 1194 + i, i % 2 ? "tcp" : "udp", i);
+        }
+    }
+    g_string_append(out,
+        "<connection>\n"
+        "remote backup.example.net\n"
+        "proto tcp-client\n"
+        "port 443\n"
+        "</connection>\n");
+
+    size_t inline_bytes = (BENCH_PROFILE_BYTES - out->len) / 4;
+    append_inline(out, "ca", inline_bytes, rand);
+    append_inline(out, "cert", inline_bytes, rand);
+    append_inline(out, "key", inline_bytes, rand);
+    append_inline(out, "tls-crypt", inline_bytes, rand);
+
+    g_rand_free(rand);
+    return g_string_free(out, FALSE);
+}
+
+/**
+ * Check that both parsers found the same remotes
+ */
+static bool same_remotes(const OvpnProfile *profile, const LegacyProfile *legacy) {
+    if (profile->remote_count != legacy->remote_count ||
+        profile->remote_random != legacy->remote_random) {
+        return false;
+    }
+    for (unsigned int i = 0; i < profile->remote_count; i++) {
+        const OvpnRemote *a = &profile->remotes[i];
+        const OvpnRemote *b = &legacy->remotes[i];
+        if (g_strcmp0(a->host, b->host) != 0 || a->port != b->port ||
+            g_strcmp0(a->protocol, b->protocol) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void report(const char *name, gint64 elapsed_us, unsigned int iterations, size_t len) {
+    double per_parse_us = (double)elapsed_us / iterations;
+    double mb_per_sec = (double)len * iterations / elapsed_us;   /* bytes/us == MB/s */
+
+    printf("%-8s %10.1f us/parse %10.1f MB/s\n", name, per_parse_us, mb_per_sec);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int iterations = BENCH_DEFAULT_ITERATIONS;
+    if (argc > 1) {
+        iterations = (unsigned int)strtoul(argv[1], NULL, 10);
+        if (iterations == 0) {
+            fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    char *content = build_profile();
+    size_t len = strlen(content);
+
+    /* Results must match before timing means anything */
+    OvpnProfile *profile = ovpn_profile_parse(content, len);
+    LegacyProfile legacy;
+    legacy_parse(content, &legacy);
+    bool same = same_remotes(profile, &legacy);
+    unsigned int remotes = profile->remote_count;
+    ovpn_profile_free(profile);
+    legacy_free(&legacy);
+    if (!same) {
+        fprintf(stderr, "Parsers disagree on the remotes\n");
+        g_free(content);
+        return 1;
+    }
+
+    printf("Profile: %zu bytes, %u remotes, %u iterations\n", len, remotes, iterations);
+
+    gint64 start = g_get_monotonic_time();
+    for (unsigned int i = 0; i < iterations; i++) {
+        legacy_parse(content, &legacy);
+        legacy_free(&legacy);
+    }
+    gint64 legacy_us = MAX(g_get_monotonic_time() - start, 1);
+
+    start = g_get_monotonic_time();
+    for (unsigned int i = 0; i < iterations; i++) {
+        ovpn_profile_free(ovpn_profile_parse(content, len));
+    }
+    gint64 tokenizer_us = MAX(g_get_monotonic_time() - start, 1);
+
+    report("legacy", legacy_us, iterations, len);
+    report("current", tokenizer_us, iterations, len);
+    printf("Speedup: %.1fx\n", (double)legacy_us / tokenizer_us);
+
+    g_free(content);
+    return 0;
+}
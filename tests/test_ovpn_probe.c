@@ -0,0 +1,265 @@
+/**
+ * OpenVPN handshake probe against a local responder
+ *
+ * The responder answers a P_CONTROL_HARD_RESET_CLIENT_V2 with a
+ * P_CONTROL_HARD_RESET_SERVER_V2 over UDP, or over TCP with the 16-bit
+ * length framing. A TCP listener that accepts but never answers must
+ * not count as a reply.
+ */
+#include "monitoring/ovpn_probe.h"
+#include "monitoring/dns_cache.h"
+#include <glib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define TEST_TIMEOUT_MS 1000
+
+#define P_CONTROL_HARD_RESET_CLIENT_V2  7
+#define P_CONTROL_HARD_RESET_SERVER_V2  8
+
+typedef struct {
+    int listen_fd;
+    int conn_fd;
+    int type;
+    bool silent;                /* TCP: accept, then never answer */
+    guint watch_id;
+    guint conn_watch_id;
+    unsigned int resets;        /* Client resets received */
+} Responder;
+
+typedef struct {
+    GMainLoop *loop;
+    int result;
+    bool done;
+} ProbeResult;
+
+/**
+ * Build the server's reset reply acknowledging a client reset
+ */
+static size_t build_server_reset(const uint8_t *client, size_t len, uint8_t *out) {
+    if (len < 1 + OVPN_SESSION_ID_LEN + 1 ||
+        (client[0] >> 3) != P_CONTROL_HARD_RESET_CLIENT_V2) {
+        return 0;
+    }
+
+    uint8_t *p = out;
+    *p++ = P_CONTROL_HARD_RESET_SERVER_V2 << 3;
+    memset(p, 0x5a, OVPN_SESSION_ID_LEN);           /* Server session id */
+    p += OVPN_SESSION_ID_LEN;
+    *p++ = 1;                                       /* One ack */
+    memset(p, 0, 4);                                /* Acks packet id 0 */
+    p += 4;
+    memcpy(p, client + 1, OVPN_SESSION_ID_LEN);     /* Client session id */
+    p += OVPN_SESSION_ID_LEN;
+    memset(p, 0, 4);                                /* Message packet id */
+    p += 4;
+    return (size_t)(p - out);
+}
+
+static gboolean on_udp_request(GIOChannel *channel, GIOCondition condition, gpointer data) {
+    Responder *responder = data;
+    uint8_t buf[1536], reply[64];
+    struct sockaddr_storage peer;
+    socklen_t peer_len = sizeof(peer);
+    (void)channel;
+    (void)condition;
+
+    ssize_t n = recvfrom(responder->listen_fd, buf, sizeof(buf), 0,
+                         (struct sockaddr *)&peer, &peer_len);
+    size_t len = n > 0 ? build_server_reset(buf, (size_t)n, reply) : 0;
+    if (len > 0) {
+        responder->resets++;
+        sendto(responder->listen_fd, reply, len, 0, (struct sockaddr *)&peer, peer_len);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean on_tcp_request(GIOChannel *channel, GIOCondition condition, gpointer data) {
+    Responder *responder = data;
+    uint8_t buf[1536], reply[2 + 64];
+    (void)channel;
+    (void)condition;
+
+    /* The probe's reset fits one segment on loopback */
+    ssize_t n = recv(responder->conn_fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+        responder->conn_watch_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    if (n < 2 || (size_t)((buf[0] << 8) | buf[1]) != (size_t)n - 2) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    size_t len = build_server_reset(buf + 2, (size_t)n - 2, reply + 2);
+    if (len > 0) {
+        responder->resets++;
+        reply[0] = (uint8_t)(len >> 8);
+        reply[1] = (uint8_t)(len & 0xff);
+        g_assert_cmpint(send(responder->conn_fd, reply, len + 2, MSG_NOSIGNAL), ==, len + 2);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean on_tcp_accept(GIOChannel *channel, GIOCondition condition, gpointer data) {
+    Responder *responder = data;
+    (void)channel;
+    (void)condition;
+
+    int fd = accept(responder->listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return G_SOURCE_CONTINUE;
+    }
+    if (responder->conn_fd >= 0) {
+        close(responder->conn_fd);
+    }
+    responder->conn_fd = fd;
+
+    if (!responder->silent) {
+        GIOChannel *conn = g_io_channel_unix_new(fd);
+        responder->conn_watch_id = g_io_add_watch(conn, G_IO_IN | G_IO_HUP,
+                                                  on_tcp_request, responder);
+        g_io_channel_unref(conn);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Start a responder on an ephemeral loopback port
+ *
+ * @return Port number
+ */
+static int responder_start(Responder *responder, int type, bool silent) {
+    struct sockaddr_in addr = { .sin_family = AF_INET };
+    socklen_t addr_len = sizeof(addr);
+
+    memset(responder, 0, sizeof(*responder));
+    responder->type = type;
+    responder->silent = silent;
+    responder->conn_fd = -1;
+    responder->listen_fd = socket(AF_INET, type | SOCK_CLOEXEC, 0);
+    g_assert_cmpint(responder->listen_fd, >=, 0);
+
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    g_assert_cmpint(bind(responder->listen_fd, (struct sockaddr *)&addr, sizeof(addr)), ==, 0);
+    g_assert_cmpint(getsockname(responder->listen_fd, (struct sockaddr *)&addr, &addr_len), ==, 0);
+    if (type == SOCK_STREAM) {
+        g_assert_cmpint(listen(responder->listen_fd, 4), ==, 0);
+    }
+
+    GIOChannel *channel = g_io_channel_unix_new(responder->listen_fd);
+    responder->watch_id = g_io_add_watch(channel, G_IO_IN,
+                                         type == SOCK_STREAM ? on_tcp_accept : on_udp_request,
+                                         responder);
+    g_io_channel_unref(channel);
+
+    return ntohs(addr.sin_port);
+}
+
+static void responder_stop(Responder *responder) {
+    if (responder->conn_watch_id > 0) {
+        g_source_remove(responder->conn_watch_id);
+    }
+    g_source_remove(responder->watch_id);
+    if (responder->conn_fd >= 0) {
+        close(responder->conn_fd);
+    }
+    close(responder->listen_fd);
+}
+
+static void on_probe_done(const char *hostname, int result, void *user_data) {
+    ProbeResult *probe = user_data;
+    (void)hostname;
+
+    probe->result = result;
+    probe->done = true;
+    g_main_loop_quit(probe->loop);
+}
+
+static gboolean on_test_timeout(gpointer user_data) {
+    g_main_loop_quit(user_data);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Probe 127.0.0.1:port and wait for the callback
+ */
+static int run_probe(int port, const char *protocol) {
+    ProbeResult probe = { .loop = g_main_loop_new(NULL, FALSE) };
+
+    g_assert_cmpint(ovpn_probe_async("127.0.0.1", port, protocol, TEST_TIMEOUT_MS,
+                                     on_probe_done, &probe), ==, PING_SUCCESS);
+
+    guint guard = g_timeout_add(TEST_TIMEOUT_MS * 4, on_test_timeout, probe.loop);
+    g_main_loop_run(probe.loop);
+    g_source_remove(guard);
+    g_main_loop_unref(probe.loop);
+
+    g_assert_true(probe.done);
+    return probe.result;
+}
+
+static void test_udp_reply(void) {
+    Responder responder;
+    int port = responder_start(&responder, SOCK_DGRAM, false);
+
+    int result = run_probe(port, "udp");
+    g_assert_cmpint(result, >=, 0);
+    g_assert_cmpuint(responder.resets, ==, 1);
+
+    responder_stop(&responder);
+}
+
+static void test_tcp_reply(void) {
+    Responder responder;
+    int port = responder_start(&responder, SOCK_STREAM, false);
+
+    int result = run_probe(port, "tcp-client");
+    g_assert_cmpint(result, >=, 0);
+    g_assert_cmpuint(responder.resets, ==, 1);
+
+    responder_stop(&responder);
+}
+
+static void test_tcp_open_port_without_reply(void) {
+    Responder responder;
+    int port = responder_start(&responder, SOCK_STREAM, true);
+
+    g_assert_cmpint(run_probe(port, "tcp"), ==, PING_TIMEOUT);
+
+    responder_stop(&responder);
+}
+
+static void test_reset_framing(void) {
+    uint8_t sid[OVPN_SESSION_ID_LEN] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t udp[64], tcp[64], reply[64];
+
+    size_t udp_len = ovpn_probe_build_reset(sid, OVPN_PROBE_UDP, udp, sizeof(udp));
+    size_t tcp_len = ovpn_probe_build_reset(sid, OVPN_PROBE_TCP, tcp, sizeof(tcp));
+    g_assert_cmpuint(tcp_len, ==, udp_len + 2);
+    g_assert_cmpuint((size_t)((tcp[0] << 8) | tcp[1]), ==, udp_len);
+    g_assert_cmpmem(tcp + 2, udp_len, udp, udp_len);
+
+    size_t reply_len = build_server_reset(udp, udp_len, reply);
+    g_assert_true(ovpn_probe_is_reset_reply(reply, reply_len, sid));
+    sid[0] ^= 0xff;
+    g_assert_false(ovpn_probe_is_reset_reply(reply, reply_len, sid));
+    g_assert_false(ovpn_probe_is_reset_reply(udp, udp_len, sid));
+}
+
+int main(int argc, char *argv[]) {
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/ovpn_probe/reset_framing", test_reset_framing);
+    g_test_add_func("/ovpn_probe/udp_reply", test_udp_reply);
+    g_test_add_func("/ovpn_probe/tcp_reply", test_tcp_reply);
+    g_test_add_func("/ovpn_probe/tcp_open_port_without_reply", test_tcp_open_port_without_reply);
+
+    int status = g_test_run();
+    ovpn_probe_cleanup();
+    dns_cache_cleanup();
+    return status;
+}